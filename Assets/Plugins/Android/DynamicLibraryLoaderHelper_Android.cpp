@@ -1,4 +1,8 @@
 #include <dlfcn.h>
+#include <stddef.h>
+#include <future>
+#include <string>
+#include <tuple>
 
 #define STATIC_EXPORT(return_type) extern "C" return_type
 #define DLL_EXPORT(return_value) extern "C" __declspec(dllexport) return_value  __stdcall
@@ -53,6 +57,64 @@ FUN_EXPORT(void *) DLLH_load_library_at_path(void *ctx, const char *library_path
     return to_return;
 }
 
+//-------------------------------------------------------------------------
+// Starts loading library_path on a worker thread, so that the caller can
+// get on with other startup work while the loader maps and relocates it.
+// Returns a ticket that has to be passed to DLLH_wait_library exactly once,
+// before the context is destroyed, or null if no thread could be started.
+FUN_EXPORT(void *) DLLH_load_library_async(void *ctx, const char *library_path)
+{
+    if (ctx == nullptr || library_path == nullptr)
+    {
+        return nullptr;
+    }
+
+    DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+    try
+    {
+        return new std::future<void*>(std::async(std::launch::async, [dllh_ctx, path = std::string(library_path)]()
+        {
+            return DLLH_Android_load_library_at_path(dllh_ctx, path.c_str());
+        }));
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+//-------------------------------------------------------------------------
+// True once DLLH_wait_library would return without blocking
+FUN_EXPORT(bool) DLLH_poll_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    if (ticket == nullptr)
+    {
+        return false;
+    }
+
+    std::future<void*> *load = static_cast<std::future<void*>*>(ticket);
+    return load->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+//-------------------------------------------------------------------------
+// Blocks until the load behind ticket is done, then frees the ticket and
+// returns what DLLH_load_library_at_path would have
+FUN_EXPORT(void *) DLLH_wait_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    if (ticket == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::future<void*> *load = static_cast<std::future<void*>*>(ticket);
+    void *to_return = load->get();
+    delete load;
+
+    return to_return;
+}
+
 //-------------------------------------------------------------------------
 FUN_EXPORT(bool) DLLH_unload_library_at_path(void *ctx, void *library_handle)
 {
@@ -72,3 +134,51 @@ FUN_EXPORT(void *) DLLH_load_function_with_name(void *ctx, void *library_handle,
 
     return to_return;
 }
+
+//-------------------------------------------------------------------------
+// Resolves count functions in one call, so that managed code binding
+// hundreds of SDK functions only crosses into native code once. Functions
+// that aren't found are null in out_functions. Returns how many were found.
+FUN_EXPORT(size_t) DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+    if (function_names == nullptr || out_functions == nullptr)
+    {
+        return 0;
+    }
+
+    DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out_functions[i] = function_names[i] != nullptr ? DLLH_Android_load_function_with_name(dllh_ctx, library_handle, function_names[i]) : nullptr;
+        if (out_functions[i] != nullptr)
+        {
+            ++found;
+        }
+    }
+
+    return found;
+}
+
+//-------------------------------------------------------------------------
+// There are no lazy stubs on this platform, so functions are looked up
+// straight away
+FUN_EXPORT(void *) DLLH_load_function_lazily(void *ctx, void *library_handle, const char *function)
+{
+    return DLLH_load_function_with_name(ctx, library_handle, function);
+}
+
+//-------------------------------------------------------------------------
+FUN_EXPORT(size_t) DLLH_load_functions_lazily(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+    return DLLH_load_functions_with_names(ctx, library_handle, function_names, out_functions, count);
+}
+
+//-------------------------------------------------------------------------
+// Function pointers aren't tracked on this platform, so unloading never
+// waits on them
+FUN_EXPORT(size_t) DLLH_release_functions(void *ctx, void *library_handle)
+{
+    std::ignore = ctx, library_handle;
+    return 0;
+}
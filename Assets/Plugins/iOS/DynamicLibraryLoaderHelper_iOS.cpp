@@ -3,6 +3,10 @@
 
 #include <assert.h>
 #include <dlfcn.h>
+#include <stddef.h>
+#include <future>
+#include <string>
+#include <tuple>
 
 #define STATIC_EXPORT(return_type) extern "C" return_type
 
@@ -41,6 +45,64 @@ STATIC_EXPORT(void *) DLLH_load_library_at_path(void *ctx, const char *library_p
 	return to_return;
 }
 
+//-------------------------------------------------------------------------
+// Starts loading library_path on a worker thread, so that the caller can
+// get on with other startup work while the loader maps and relocates it.
+// Returns a ticket that has to be passed to DLLH_wait_library exactly once,
+// before the context is destroyed, or null if no thread could be started.
+STATIC_EXPORT(void *) DLLH_load_library_async(void *ctx, const char *library_path)
+{
+	if (ctx == nullptr || library_path == nullptr)
+	{
+		return nullptr;
+	}
+
+	DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+	try
+	{
+		return new std::future<void*>(std::async(std::launch::async, [dllh_ctx, path = std::string(library_path)]()
+		{
+			return DLLH_iOS_load_library_at_path(dllh_ctx, path.c_str());
+		}));
+	}
+	catch (const std::exception&)
+	{
+		return nullptr;
+	}
+}
+
+//-------------------------------------------------------------------------
+// True once DLLH_wait_library would return without blocking
+STATIC_EXPORT(bool) DLLH_poll_library(void *ctx, void *ticket)
+{
+	std::ignore = ctx;
+	if (ticket == nullptr)
+	{
+		return false;
+	}
+
+	std::future<void*> *load = static_cast<std::future<void*>*>(ticket);
+	return load->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+//-------------------------------------------------------------------------
+// Blocks until the load behind ticket is done, then frees the ticket and
+// returns what DLLH_load_library_at_path would have
+STATIC_EXPORT(void *) DLLH_wait_library(void *ctx, void *ticket)
+{
+	std::ignore = ctx;
+	if (ticket == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::future<void*> *load = static_cast<std::future<void*>*>(ticket);
+	void *to_return = load->get();
+	delete load;
+
+	return to_return;
+}
+
 //-------------------------------------------------------------------------
 // This returns a bare function pointer that is only valid as long as the library_handle and context are
 // valid
@@ -54,6 +116,45 @@ STATIC_EXPORT(void*) DLLH_load_function_with_name(void *ctx, void *library_handl
 	return to_return;
 }
 
+//-------------------------------------------------------------------------
+// Resolves count functions in one call, so that managed code binding
+// hundreds of SDK functions only crosses into native code once. Functions
+// that aren't found are null in out_functions. Returns how many were found.
+STATIC_EXPORT(size_t) DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+	if (function_names == nullptr || out_functions == nullptr)
+	{
+		return 0;
+	}
+
+	DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+	size_t found = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		out_functions[i] = function_names[i] != nullptr ? DLLH_iOS_load_function_with_name(dllh_ctx, library_handle, function_names[i]) : nullptr;
+		if (out_functions[i] != nullptr)
+		{
+			++found;
+		}
+	}
+
+	return found;
+}
+
+//-------------------------------------------------------------------------
+// There are no lazy stubs on this platform, so functions are looked up
+// straight away
+STATIC_EXPORT(void *) DLLH_load_function_lazily(void *ctx, void *library_handle, const char *function)
+{
+	return DLLH_load_function_with_name(ctx, library_handle, function);
+}
+
+//-------------------------------------------------------------------------
+STATIC_EXPORT(size_t) DLLH_load_functions_lazily(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+	return DLLH_load_functions_with_names(ctx, library_handle, function_names, out_functions, count);
+}
+
 //-------------------------------------------------------------------------
 void * DLLH_iOS_load_library_at_path(DLLHContext *ctx, const char *library_path)
 {
@@ -79,3 +180,12 @@ void * DLLH_iOS_load_function_with_name(DLLHContext *ctx, void *library_handle,
 STATIC_EXPORT(void) DLLH_unload_library_at_path(const char *library_path)
 {
 }
+
+//-------------------------------------------------------------------------
+// Function pointers aren't tracked on this platform, so unloading never
+// waits on them
+STATIC_EXPORT(size_t) DLLH_release_functions(void *ctx, void *library_handle)
+{
+	std::ignore = ctx, library_handle;
+	return 0;
+}
@@ -291,6 +291,16 @@ protected EOSConfig() : base("EpicOnlineServicesConfig.json")
             3)]
         public string ThreadAffinity_RTCIO;
 
+        /// <summary>
+        /// Memory Allocator; where the allocator handed to the EOS SDK gets
+        /// its memory from. Either "System" or "Pooled"; left empty, the
+        /// native default (System) is used.
+        /// </summary>
+        [ConfigField("Memory Allocator", ConfigFieldType.Text,
+            "Where the EOS SDK gets its memory from: System or Pooled.",
+            3)]
+        public string memoryAllocatorBackend;
+
         #endregion
 
         #region Overlay Options
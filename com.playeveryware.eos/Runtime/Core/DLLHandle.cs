@@ -172,6 +172,18 @@ protected override bool ReleaseHandle()
             return didUnload;
         }
 
+        //-------------------------------------------------------------------------
+        // Call once every delegate and function pointer loaded from this library
+        // has been dropped (for the EOS SDK, after Bindings.Unhook), otherwise
+        // disposing the handle leaves the library loaded
+        public void ReleaseFunctions()
+        {
+            if (handle != IntPtr.Zero)
+            {
+                SystemDynamicLibrary.Instance.ReleaseFunctions(handle);
+            }
+        }
+
         //-------------------------------------------------------------------------
         public Delegate LoadFunctionAsDelegate(Type functionType, string functionName)
         {
@@ -185,6 +197,13 @@ public System.IntPtr LoadFunctionAsIntPtr(string functionName)
             return functionPointer;
         }
 
+        //-------------------------------------------------------------------------
+        // See SystemDynamicLibrary.LoadFunctionLazilyWithName
+        public System.IntPtr LoadFunctionAsLazyIntPtr(string functionName)
+        {
+            return SystemDynamicLibrary.Instance.LoadFunctionLazilyWithName(handle, functionName);
+        }
+
         //-------------------------------------------------------------------------
         public void ConfigureFromLibraryDelegateFieldOnClassWithFunctionName(Type clazz, Type delegateType,
             string functionName)
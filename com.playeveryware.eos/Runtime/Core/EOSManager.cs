@@ -440,9 +440,17 @@ private Result InitializePlatformInterface()
                 initOptions.options.ProductVersion = configData.productVersion;
                 initOptions.options.OverrideThreadAffinity = new InitializeThreadAffinity();
 
-                initOptions.options.AllocateMemoryFunction = IntPtr.Zero;
-                initOptions.options.ReallocateMemoryFunction = IntPtr.Zero;
-                initOptions.options.ReleaseMemoryFunction = IntPtr.Zero;
+                if (Enum.TryParse(configData.memoryAllocatorBackend, true, out SystemMemory.AllocatorBackend allocatorBackend))
+                {
+                    SystemMemory.SetAllocatorBackend(allocatorBackend);
+                }
+
+                // Zero where the native allocator isn't available, which leaves
+                // the SDK on its own
+                SystemMemory.GetAllocatorFunctions(out IntPtr allocateMemoryFunction, out IntPtr reallocateMemoryFunction, out IntPtr releaseMemoryFunction);
+                initOptions.options.AllocateMemoryFunction = allocateMemoryFunction;
+                initOptions.options.ReallocateMemoryFunction = reallocateMemoryFunction;
+                initOptions.options.ReleaseMemoryFunction = releaseMemoryFunction;
 
                 var overrideThreadAffinity = new InitializeThreadAffinity();
 
@@ -1545,8 +1553,16 @@ public void Tick()
                         {
                             // do anything needed to inform EOS systems they need to suspend
                             s_state = EOSState.Suspended;
+
+                            // Nothing will be allocated for a while, so give back what the
+                            // native allocator is holding on to
+                            SystemMemory.Trim();
                         }
                     }
+
+                    // The allocator can't call out while the SDK is in the middle of
+                    // an allocation, so budget events wait for the tick
+                    SystemMemory.DeliverMemoryBudgetEvents();
                 }
             }
 
@@ -148,8 +148,14 @@ static public DLLHandle LoadDynamicLibrary(string libraryName)
             // be mindful to only do this at the very end of the app usage
             static public void UnloadAllLibraries()
             {
+#if EOS_DYNAMIC_BINDINGS
+                // The bindings hold function pointers into the EOS SDK, which
+                // must be dropped before the library's functions are released
+                Epic.OnlineServices.Bindings.Unhook();
+#endif
                 foreach(var entry in LoadedDLLs)
                 {
+                    entry.Value.ReleaseFunctions();
                     entry.Value.Dispose();
                 }
                 LoadedDLLs.Clear();
@@ -165,12 +171,16 @@ static public void LoadDelegatesWithEOSBindingAPI()
                 print($"Loading EOS binary {EOSBinaryName}");
                 var eosLibraryHandle = LoadDynamicLibrary(EOSBinaryName);
 
+                // Most of the SDK is never called in a given session, so the functions
+                // are bound lazily where the helper library can. Names are still checked
+                // against what the SDK exports, so a missing function is a
+                // DynamicBindingException here as before.
                 Epic.OnlineServices.Bindings.Hook<DLLHandle>(eosLibraryHandle, (DLLHandle handle, string functionName) => {
                 // TODO: Add conditions for all flags (unless OSX is the only one that's weird?)
 #if UNITY_EDITOR_OSX
                     return handle.LoadFunctionAsIntPtr(functionName.Trim('_'));
 #else
-                    return handle.LoadFunctionAsIntPtr(functionName);
+                    return handle.LoadFunctionAsLazyIntPtr(functionName);
 #endif
                  });
 
@@ -185,6 +195,10 @@ static private void ForceUnloadEOSLibrary()
 #if EOS_DYNAMIC_BINDINGS
                 Epic.OnlineServices.Bindings.Unhook();
 #endif
+                if (LoadedDLLs.TryGetValue(EOSBinaryName, out DLLHandle eosLibraryHandle))
+                {
+                    eosLibraryHandle.ReleaseFunctions();
+                }
 
 #if UNITY_EDITOR
                 IntPtr existingHandle;
@@ -119,10 +119,18 @@ public partial class SystemDynamicLibrary
 #if !UNITY_SWITCH && !UNITY_PS4 && !UNITY_PS5
         [DllImport(DLLHBinaryName)]
         private static extern bool DLLH_unload_library_at_path(IntPtr ctx, IntPtr library_handle);
+
+        [DllImport(DLLHBinaryName)]
+        private static extern UIntPtr DLLH_release_functions(IntPtr ctx, IntPtr library_handle);
 #endif
 
         [DllImport(DLLHBinaryName, SetLastError = true, CharSet = CharSet.Ansi)]
         private static extern IntPtr DLLH_load_function_with_name(IntPtr ctx, IntPtr library_handle, string function);
+
+#if !UNITY_SWITCH && !UNITY_PS4 && !UNITY_PS5
+        [DllImport(DLLHBinaryName, CharSet = CharSet.Ansi)]
+        private static extern IntPtr DLLH_load_function_lazily(IntPtr ctx, IntPtr library_handle, string function);
+#endif
 #endif
         private IntPtr DLLHContex;
 
@@ -201,6 +209,21 @@ public bool UnloadLibrary(IntPtr libraryHandle)
         }
 
 
+        //-------------------------------------------------------------------------
+        // Promises that no function loaded from libraryHandle will be called again,
+        // which UnloadLibrary waits on before it lets go of the last reference.
+        // Returns how many function pointers were outstanding.
+        public int ReleaseFunctions(IntPtr libraryHandle)
+        {
+#if EOS_DISABLE
+        return 0;
+#elif UNITY_EDITOR_WIN || (UNITY_EDITOR_OSX || UNITY_EDITOR_LINUX) || UNITY_SWITCH || UNITY_PS4 || UNITY_PS5
+            return 0;
+#else
+        return (int)DLLH_release_functions(DLLHContex, libraryHandle);
+#endif
+        }
+
         //-------------------------------------------------------------------------
         // TODO: evaluate if we can just use DLLH_load_function; it might make it
         // more difficult to iterate on the DLLH dll if the Unity Editor holds a lock
@@ -213,6 +236,24 @@ public IntPtr LoadFunctionWithName(IntPtr libraryHandle, string functionName)
             return GetProcAddress(libraryHandle, functionName);
 #else
         return DLLH_load_function_with_name(DLLHContex, libraryHandle, functionName);
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Like LoadFunctionWithName, but where the helper library has lazy stubs
+        // the function isn't looked up until it's first called. It's checked
+        // against the library's exports, so one the library doesn't have is still
+        // IntPtr.Zero.
+        public IntPtr LoadFunctionLazilyWithName(IntPtr libraryHandle, string functionName)
+        {
+#if EOS_DISABLE
+        return IntPtr.Zero;
+#elif UNITY_EDITOR_WIN || (UNITY_EDITOR_OSX || UNITY_EDITOR_LINUX)
+            return GetProcAddress(libraryHandle, functionName);
+#elif UNITY_SWITCH || UNITY_PS4 || UNITY_PS5
+        return DLLH_load_function_with_name(DLLHContex, libraryHandle, functionName);
+#else
+        return DLLH_load_function_lazily(DLLHContex, libraryHandle, functionName);
 #endif
         }
     }
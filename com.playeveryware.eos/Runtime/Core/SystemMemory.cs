@@ -20,7 +20,7 @@
 * SOFTWARE.
 */
 
-#if UNITY_PS5 || UNITY_PS4 || UNITY_GAMECORE_XBOXONE || UNITY_GAMECORE_SCARLETT || UNITY_SWITCH
+#if UNITY_STANDALONE || UNITY_EDITOR_WIN || UNITY_PS4 || UNITY_PS5 || UNITY_GAMECORE_XBOXONE || UNITY_GAMECORE_SCARLETT || UNITY_SWITCH
 #define ENABLE_GET_ALLOCATOR_FUNCTION
 #endif
 
@@ -50,6 +50,138 @@ public struct MemCounters
             public Int64 currentMemoryAllocatedInBytes;
         };
 
+        // Mirror the MEM_COUNTERS* defines in the native Memory.h
+        public const Int32 MemCountersExApiLatest = 3;
+        public const int MemCountersSizeClassCount = 32;
+        public const int MemCountersMaxThreads = 32;
+
+        // One entry per thread that has allocated. The last entry, with a
+        // threadId of 0, is shared by threads that found no free one; an
+        // exited thread's entry goes to the next new thread once its blocks
+        // are freed, and its counts move to the last entry.
+        [StructLayout(LayoutKind.Sequential, Pack = 8)]
+        public struct MemThreadCounters
+        {
+            public UInt64 threadId;
+            public Int64 currentMemoryAllocatedInBytes;
+            public Int64 totalMemoryAllocatedInBytes;
+            public UInt64 allocCount;
+        };
+
+        // Managed copy of the native MemCountersEx. It's a class with its arrays
+        // allocated up front so that GetAllocationCountersEx can refill the same
+        // instance every frame without generating garbage.
+        public class MemCountersEx
+        {
+            public Int32 threadCount;
+            public Int64 currentMemoryAllocatedInBytes;
+            public Int64 peakMemoryAllocatedInBytes;
+            public UInt64 allocCount;
+            public UInt64 reallocCount;
+            public UInt64 freeCount;
+            public readonly UInt64[] sizeHistogram = new UInt64[MemCountersSizeClassCount];
+            public readonly MemThreadCounters[] threads = new MemThreadCounters[MemCountersMaxThreads];
+
+            // The large block arena; its blocks are in the totals above too
+            public Int64 largeBlockCommittedInBytes;
+            public Int64 largeBlockUsedInBytes;
+            public Int64 largeBlockPeakUsedInBytes;
+            public Int64 largeBlockExplicitHugePageInBytes;
+            public UInt64 largeBlockAllocCount;
+        };
+
+        // Byte offsets into the native MemCountersEx
+        private const int MemCountersExThreadCountOffset = 4;
+        private const int MemCountersExCurrentOffset = 8;
+        private const int MemCountersExPeakOffset = 16;
+        private const int MemCountersExAllocCountOffset = 24;
+        private const int MemCountersExReallocCountOffset = 32;
+        private const int MemCountersExFreeCountOffset = 40;
+        private const int MemCountersExHistogramOffset = 48;
+        private const int MemCountersExThreadsOffset = MemCountersExHistogramOffset + 8 * MemCountersSizeClassCount;
+        private const int MemThreadCountersSize = 32;
+        private const int MemCountersExLargeBlockOffset = MemCountersExThreadsOffset + MemThreadCountersSize * MemCountersMaxThreads;
+        private const int MemCountersExSize = MemCountersExLargeBlockOffset + 8 * 5;
+
+        // Native buffer reused by every GetAllocationCountersEx call
+        private static IntPtr s_countersExBuffer = IntPtr.Zero;
+
+        // Mirrors MemAllocatorBackend in the native Memory.h
+        public enum AllocatorBackend : Int32
+        {
+            System = 0,
+            Pooled = 1,
+        }
+
+        // Mirrors HeapProfileFormat in the native HeapProfiler.h
+        public enum HeapProfileFormat : Int32
+        {
+            // Legacy text heap profile read by pprof
+            Pprof = 0,
+            // One line per stack, for flamegraph.pl and speedscope
+            CollapsedStacks = 1,
+        }
+
+        // Mirrors MemBudgetEvent in the native Memory.h
+        public enum MemoryBudgetEvent : Int32
+        {
+            SoftLimitExceeded = 0,
+            // Allocations now come from the emergency arena
+            HardLimitExceeded = 1,
+            // An allocation failed because the emergency arena was full
+            EmergencyArenaExhausted = 2,
+        }
+
+        // Mirrors MEM_BUDGET_STATUS_API_LATEST in the native Memory.h
+        public const Int32 MemBudgetStatusApiLatest = 1;
+
+        // Mirrors MemBudgetStatus in the native Memory.h
+        [StructLayout(LayoutKind.Sequential, Pack = 8)]
+        public struct MemBudgetStatus
+        {
+            public Int32 apiVersion;
+            public Int32 isOverSoftLimit;
+            public Int32 isOverHardLimit;
+            public Int32 reserved;
+            public Int64 softLimitInBytes;
+            public Int64 hardLimitInBytes;
+            public Int64 currentMemoryAllocatedInBytes;
+            public Int64 emergencyCapacityInBytes;
+            public Int64 emergencyUsedInBytes;
+            public Int64 emergencyPeakInBytes;
+            public UInt64 softLimitExceededCount;
+            public UInt64 hardLimitExceededCount;
+            public UInt64 emergencyExhaustedCount;
+        }
+
+        // Mirrors MEM_LIVE_ALLOCATION_API_LATEST in the native Memory.h
+        public const Int32 MemLiveAllocationApiLatest = 1;
+
+        // Mirrors MEM_TICKS_PER_SECOND and MEM_LIVE_ALLOCATION_AGE_UNKNOWN in the
+        // native Memory.h
+        public const UInt64 MemTicksPerSecond = 1000;
+        public const UInt64 MemLiveAllocationAgeUnknown = UInt64.MaxValue;
+
+        // Mirrors MemLiveAllocation in the native Memory.h
+        [StructLayout(LayoutKind.Sequential, Pack = 8)]
+        public struct MemLiveAllocation
+        {
+            public UInt64 address;
+            public UInt64 sizeInBytes;
+            public UInt64 ageInTicks;
+            public UInt64 threadId;
+            public UInt32 alignmentInBytes;
+            public UInt32 reserved;
+        }
+
+        public delegate void MemoryBudgetCallback(MemoryBudgetEvent budgetEvent, Int64 currentBytes);
+
+        private delegate void MemBudgetCallback(Int32 budgetEvent, Int64 currentBytes, IntPtr userData);
+
+        // Kept here so the delegates outlive the native pointer to them
+        private static MemoryBudgetCallback s_memoryBudgetCallback;
+        private static readonly MemBudgetCallback s_nativeMemoryBudgetCallback = OnMemoryBudgetEvent;
+
         public delegate IntPtr EOS_GenericAlignAlloc(size_t sizeInBytes, size_t alignmentInBytes);
 
         public delegate IntPtr EOS_GenericAlignRealloc(IntPtr ptr, size_t sizeInBytes, size_t alignmentInBytes);
@@ -88,6 +220,8 @@ static public void GenericFree(IntPtr ptr)
         }
 
         //-------------------------------------------------------------------------
+        // Native function pointers for the memory hooks in InitializeOptions, or
+        // IntPtr.Zero for the SDK to use its own allocator.
         static public void GetAllocatorFunctions(out IntPtr alloc, out IntPtr realloc, out IntPtr free)
         {
 #if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE && ENABLE_GET_ALLOCATOR_FUNCTION
@@ -99,6 +233,246 @@ static public void GetAllocatorFunctions(out IntPtr alloc, out IntPtr realloc, o
 #endif
         }
 
+        //-------------------------------------------------------------------------
+        // Picks where the functions from GetAllocatorFunctions get their memory
+        // from. Call this before the EOS SDK is initialized.
+        static public bool SetAllocatorBackend(AllocatorBackend backend)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_SetAllocatorBackend((Int32)backend);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Refills counters with the native allocator's statistics. Doesn't lock or
+        // allocate, so it's fine to poll every frame, but it reuses one native
+        // buffer and so should only be called from one thread at a time.
+        // Returns false if the native library was built without counters.
+        static public bool GetAllocationCountersEx(MemCountersEx counters)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            if (s_countersExBuffer == IntPtr.Zero)
+            {
+                s_countersExBuffer = Marshal.AllocHGlobal(MemCountersExSize);
+            }
+
+            Marshal.WriteInt32(s_countersExBuffer, 0, MemCountersExApiLatest);
+            if (!Mem_GetAllocationCountersEx(s_countersExBuffer))
+            {
+                return false;
+            }
+
+            counters.threadCount = Marshal.ReadInt32(s_countersExBuffer, MemCountersExThreadCountOffset);
+            counters.currentMemoryAllocatedInBytes = Marshal.ReadInt64(s_countersExBuffer, MemCountersExCurrentOffset);
+            counters.peakMemoryAllocatedInBytes = Marshal.ReadInt64(s_countersExBuffer, MemCountersExPeakOffset);
+            counters.allocCount = (UInt64)Marshal.ReadInt64(s_countersExBuffer, MemCountersExAllocCountOffset);
+            counters.reallocCount = (UInt64)Marshal.ReadInt64(s_countersExBuffer, MemCountersExReallocCountOffset);
+            counters.freeCount = (UInt64)Marshal.ReadInt64(s_countersExBuffer, MemCountersExFreeCountOffset);
+
+            for (int i = 0; i < MemCountersSizeClassCount; ++i)
+            {
+                counters.sizeHistogram[i] = (UInt64)Marshal.ReadInt64(s_countersExBuffer, MemCountersExHistogramOffset + 8 * i);
+            }
+
+            for (int i = 0; i < MemCountersMaxThreads; ++i)
+            {
+                int offset = MemCountersExThreadsOffset + MemThreadCountersSize * i;
+                counters.threads[i].threadId = (UInt64)Marshal.ReadInt64(s_countersExBuffer, offset);
+                counters.threads[i].currentMemoryAllocatedInBytes = Marshal.ReadInt64(s_countersExBuffer, offset + 8);
+                counters.threads[i].totalMemoryAllocatedInBytes = Marshal.ReadInt64(s_countersExBuffer, offset + 16);
+                counters.threads[i].allocCount = (UInt64)Marshal.ReadInt64(s_countersExBuffer, offset + 24);
+            }
+
+            counters.largeBlockCommittedInBytes = Marshal.ReadInt64(s_countersExBuffer, MemCountersExLargeBlockOffset);
+            counters.largeBlockUsedInBytes = Marshal.ReadInt64(s_countersExBuffer, MemCountersExLargeBlockOffset + 8);
+            counters.largeBlockPeakUsedInBytes = Marshal.ReadInt64(s_countersExBuffer, MemCountersExLargeBlockOffset + 16);
+            counters.largeBlockExplicitHugePageInBytes = Marshal.ReadInt64(s_countersExBuffer, MemCountersExLargeBlockOffset + 24);
+            counters.largeBlockAllocCount = (UInt64)Marshal.ReadInt64(s_countersExBuffer, MemCountersExLargeBlockOffset + 32);
+
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Has the native allocator record a backtrace for roughly one allocation
+        // per intervalInBytes allocated; 0 turns sampling off. 512KiB is a good
+        // default for long sessions.
+        static public void SetHeapProfileSampleInterval(UInt64 intervalInBytes)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            Mem_SetHeapProfileSampleInterval(intervalInBytes);
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Writes the estimated live native memory per allocation stack to path
+        static public bool WriteHeapProfile(string path, HeapProfileFormat format)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_WriteHeapProfile(path, (Int32)format);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Gives native memory the allocator is holding on to, but not using,
+        // back to the OS. Returns the bytes released where that can be told.
+        static public UInt64 Trim()
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_Trim();
+#else
+            return 0;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Has the native allocator trim itself once no allocations have been made
+        // for idleTimeoutMs; 0 turns it off
+        static public bool SetIdleTrimTimeout(UInt64 idleTimeoutMs)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_SetIdleTrimTimeout(idleTimeoutMs);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Sends native allocations of thresholdInBytes or more, such as the SDK's
+        // audio, packet and transfer buffers, to an arena of capacityInBytes that
+        // keeps its pages between buffers and asks for huge pages. Pass 0 for
+        // either to turn it off. Fails while any of its blocks are allocated.
+        static public bool SetLargeBlockArena(UInt64 thresholdInBytes, UInt64 capacityInBytes)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_SetLargeBlockArena(thresholdInBytes, capacityInBytes);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Records every native allocation, reallocation and free to path until
+        // StopAllocationTrace is called. The file can be replayed against other
+        // allocator backends with the AllocationTraceReplay tool.
+        static public bool StartAllocationTrace(string path)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_StartAllocationTrace(path);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        static public bool StopAllocationTrace()
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_StopAllocationTrace();
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Limits on the native memory the EOS SDK has allocated, in bytes; 0 turns
+        // a limit off. Past the hard limit, allocations are served from an
+        // emergency arena of emergencyArenaInBytes that is committed up front.
+        // Best set before EOS_Initialize.
+        static public bool SetMemoryBudget(Int64 softLimitInBytes, Int64 hardLimitInBytes, UInt64 emergencyArenaInBytes)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_SetMemoryBudget(softLimitInBytes, hardLimitInBytes, emergencyArenaInBytes);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // The allocator only flags budget events; callback is called for them
+        // from DeliverMemoryBudgetEvents, which EOSManager calls every tick
+        static public void SetMemoryBudgetCallback(MemoryBudgetCallback callback)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            s_memoryBudgetCallback = callback;
+            Mem_SetMemoryBudgetCallback(callback == null ? IntPtr.Zero : Marshal.GetFunctionPointerForDelegate(s_nativeMemoryBudgetCallback), IntPtr.Zero);
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Calls the budget callback, on this thread, for each kind of event
+        // flagged since the last call. Returns how many there were.
+        static public UInt32 DeliverMemoryBudgetEvents()
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_DeliverMemoryBudgetEvents();
+#else
+            return 0;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        static public bool GetMemoryBudgetStatus(out MemBudgetStatus status)
+        {
+            status = new MemBudgetStatus { apiVersion = MemBudgetStatusApiLatest };
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_GetMemoryBudgetStatus(ref status);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Records when each native block is allocated, so that snapshots and the
+        // leak report have ages. Costs a clock read per allocation.
+        static public bool SetAllocationAgeTracking(bool enabled)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_SetAllocationAgeTracking(enabled);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Fills allocations with as many live native blocks as fit. Returns how
+        // many blocks are live, which is more than were written when the array is
+        // too small, or -1 if snapshots aren't available.
+        static public Int64 SnapshotLiveAllocations(MemLiveAllocation[] allocations)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            UInt64 capacity = allocations == null ? 0 : (UInt64)allocations.Length;
+            return Mem_SnapshotLiveAllocations(MemLiveAllocationApiLatest, allocations, capacity);
+#else
+            return -1;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        // Writes the live native blocks to path, totalled by size class and by
+        // thread. NativeRender does this by itself when the plugin is unloaded.
+        static public bool WriteLeakReport(string path)
+        {
+#if DYNAMIC_MEMORY_ALLOCATION_AVAILABLE
+            return Mem_WriteLeakReport(path);
+#else
+            return false;
+#endif
+        }
+
+        //-------------------------------------------------------------------------
+        [AOT.MonoPInvokeCallback(typeof(MemBudgetCallback))]
+        private static void OnMemoryBudgetEvent(Int32 budgetEvent, Int64 currentBytes, IntPtr userData)
+        {
+            s_memoryBudgetCallback?.Invoke((MemoryBudgetEvent)budgetEvent, currentBytes);
+        }
+
         private const string DLLHBinaryName =
 #if DLLHELPER_HAS_INTERNAL_LINKAGE
         "__Internal";
@@ -118,6 +492,65 @@ static public void GetAllocatorFunctions(out IntPtr alloc, out IntPtr realloc, o
         [DllImport(DLLHBinaryName)]
         static public extern void Mem_generic_free(IntPtr ptr);
 
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_SetAllocatorBackend(Int32 backend);
+
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_GetAllocationCountersEx(IntPtr data);
+
+        [DllImport(DLLHBinaryName)]
+        static private extern void Mem_SetHeapProfileSampleInterval(UInt64 interval_in_bytes);
+
+        [DllImport(DLLHBinaryName, CharSet = CharSet.Ansi)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_WriteHeapProfile(string path, Int32 format);
+
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_SetMemoryBudget(Int64 soft_limit_in_bytes, Int64 hard_limit_in_bytes, UInt64 emergency_arena_in_bytes);
+
+        [DllImport(DLLHBinaryName)]
+        static private extern void Mem_SetMemoryBudgetCallback(IntPtr callback, IntPtr user_data);
+
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_GetMemoryBudgetStatus(ref MemBudgetStatus data);
+
+        [DllImport(DLLHBinaryName)]
+        static private extern UInt32 Mem_DeliverMemoryBudgetEvents();
+
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_SetAllocationAgeTracking([MarshalAs(UnmanagedType.I1)] bool enabled);
+
+        [DllImport(DLLHBinaryName)]
+        static private extern Int64 Mem_SnapshotLiveAllocations(Int32 api_version, [Out] MemLiveAllocation[] buffer, UInt64 capacity);
+
+        [DllImport(DLLHBinaryName, CharSet = CharSet.Ansi)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_WriteLeakReport(string path);
+
+        [DllImport(DLLHBinaryName)]
+        static private extern UInt64 Mem_Trim();
+
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_SetIdleTrimTimeout(UInt64 idle_timeout_ms);
+
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_SetLargeBlockArena(UInt64 threshold_in_bytes, UInt64 capacity_in_bytes);
+
+        [DllImport(DLLHBinaryName, CharSet = CharSet.Ansi)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_StartAllocationTrace(string path);
+
+        [DllImport(DLLHBinaryName)]
+        [return: MarshalAs(UnmanagedType.I1)]
+        static private extern bool Mem_StopAllocationTrace();
+
         // This is currently not implemented
 #if ENABLE_GET_ALLOCATION_COUNTERS
     [DllImport(DLLHBinaryName)]
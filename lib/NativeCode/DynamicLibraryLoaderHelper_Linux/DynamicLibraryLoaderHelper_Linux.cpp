@@ -26,32 +26,157 @@
 #include <assert.h>
 #include <dlfcn.h>
 #include <stdio.h>
-#include <map>
+#include <string.h>
+#include <forward_list>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <libgen.h>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <link.h>
 
+#include "LazyStubs.h"
+#include "LibraryLoading.h"
+#include "LoaderTrace.h"
+#include "ModuleRegistry.h"
+
 #define STATIC_EXPORT(return_type) extern "C" return_type
 
-std::map <std::string,std::string> baseNameToPath;
+// Set in a DT_VERSYM entry for symbols that aren't the default version
+#define DLLH_VERSYM_HIDDEN 0x8000
+
+// What dlsym returned for each name asked of one library, including the
+// names it didn't find, and, once a function has been asked for lazily,
+// every function name the library exports, so that only those get stubs.
+// The names are copied into owned_names, the ones read from the dynamic
+// symbol table all into one string, so that they outlive the library's
+// string table should it be unmapped first.
+struct DLLHSymbolCache
+{
+    std::unordered_map<std::string_view, void*> functions;
+    std::unordered_set<std::string_view> exported_names;
+    bool exported_names_read = false;
+    std::forward_list<std::string> owned_names;
+};
+
+// Every function a library exports at its default version, as indices
+// into its dynamic symbol table
+struct DLLHExports
+{
+    const struct link_map *map = nullptr;
+    const ElfW(Sym) *symbols = nullptr;
+    const char *strings = nullptr;
+    std::vector<size_t> indices;
+    size_t name_bytes = 0;
+};
+
+// What the context knows about one library. reference_count is the number
+// of loads through the context not yet matched by an unload; the library
+// is only dlclosed for as many times as the context dlopened it.
+// outstanding_functions counts the function pointers handed out since the
+// last DLLH_release_functions, which have to be released before the last
+// reference can be dropped. Lazy stubs count as function pointers, and are
+// unmapped along with the entry.
+struct DLLHLibrary
+{
+    size_t reference_count = 0;
+    size_t outstanding_functions = 0;
+    DLLHSymbolCache symbol_cache;
+    std::unique_ptr<lazy_stubs::StubArena, lazy_stubs::ArenaDeleter> lazy_stubs;
+};
 
+// Libraries are keyed by handle, which dlopen can hand out again for a
+// different library once the first is unloaded. Entries are dropped when
+// the last reference is unloaded through the context, when any dlclose
+// DLLH makes unloads the library, FreeLibrary's included, and, for
+// libraries unloaded behind our back, before the next load through the
+// context.
 struct DLLHContext
 {
+    std::mutex lock;
+    std::unordered_map<void*, DLLHLibrary> libraries;
+    unsigned long long loader_unload_count = 0;
 };
 
+// Every live context. Taken before any context's lock.
+static std::mutex s_contexts_lock;
+static std::unordered_set<DLLHContext*> s_contexts;
+
+//-------------------------------------------------------------------------
+// Every dlopen, dlsym and dlclose DLLH makes goes through these, so that
+// they can be timed and their errors kept for the calling thread, see
+// LoaderTrace.h. With recording off the cost is one relaxed load.
+static void * traced_dlopen(const char *library_path, int flags)
+{
+    const bool recording = loader_trace::is_recording();
+    const uint64_t start_ns = recording ? loader_trace::now_ns() : 0;
+
+    void *handle = dlopen(library_path, flags);
+
+    if (recording)
+    {
+        loader_trace::record(DLLH_LOADER_OPEN, library_path, handle, start_ns, loader_trace::now_ns(), handle != nullptr);
+    }
+    if (handle == nullptr)
+    {
+        loader_trace::set_error(DLLH_LOADER_OPEN, library_path, nullptr, dlerror());
+    }
+    return handle;
+}
+
+//-------------------------------------------------------------------------
+static void * traced_dlsym(void *library_handle, const char *function)
+{
+    const bool recording = loader_trace::is_recording();
+    const uint64_t start_ns = recording ? loader_trace::now_ns() : 0;
+
+    void *function_ptr = dlsym(library_handle, function);
+
+    if (recording)
+    {
+        loader_trace::record(DLLH_LOADER_SYMBOL, function, library_handle, start_ns, loader_trace::now_ns(), function_ptr != nullptr);
+    }
+    if (function_ptr == nullptr)
+    {
+        loader_trace::set_error(DLLH_LOADER_SYMBOL, function, library_handle, dlerror());
+    }
+    return function_ptr;
+}
+
+//-------------------------------------------------------------------------
+static int traced_dlclose(void *library_handle)
+{
+    const bool recording = loader_trace::is_recording();
+    const uint64_t start_ns = recording ? loader_trace::now_ns() : 0;
+
+    const int result = dlclose(library_handle);
+
+    if (recording)
+    {
+        loader_trace::record(DLLH_LOADER_CLOSE, nullptr, library_handle, start_ns, loader_trace::now_ns(), result == 0);
+    }
+    if (result != 0)
+    {
+        loader_trace::set_error(DLLH_LOADER_CLOSE, nullptr, library_handle, dlerror());
+    }
+    return result;
+}
+
+static bool close_library(void *library_handle);
+
 //-------------------------------------------------------------------------
 STATIC_EXPORT(void*) LoadLibrary(const char *library_path)
 {
-    std::string filename = std::string(basename((char*)library_path));
-    std::string stemname = filename.substr(0, filename.find_last_of("."));
-   
-    void* handle = dlopen(library_path, RTLD_NOW);
+    void* handle = traced_dlopen(library_path, RTLD_NOW);
     if(handle == nullptr)
     {
         return nullptr;
     }
     
-    baseNameToPath[stemname] = std::string(library_path);
+    module_registry::add(library_path, handle);
 
     return handle;
 }
@@ -60,107 +185,523 @@ STATIC_EXPORT(void*) LoadLibrary(const char *library_path)
 // pretend windows like function
 STATIC_EXPORT(bool) FreeLibrary(void *library_handle)
 {
-    dlclose(library_handle);
-    
-    if(dlerror())
+    // Out of the registry first, so that GetModuleHandle can't hand out
+    // a library that's going away
+    module_registry::release(library_handle);
+
+    return close_library(library_handle);
+}
+
+//-------------------------------------------------------------------------
+// The registry holds a loader reference for every library in it, so
+// there's no need to check with dlopen(RTLD_NOLOAD) that it's still loaded
+STATIC_EXPORT(void*) GetModuleHandle(const char *stemname)
+{
+    return module_registry::find(stemname);
+}
+
+//-------------------------------------------------------------------------
+STATIC_EXPORT(void*) GetProcAddress(void *library_handle, const char *function_name)
+{
+    return traced_dlsym(library_handle, function_name);
+}
+
+//-------------------------------------------------------------------------
+static int collect_module_callback(struct dl_phdr_info *info, size_t size, void *data)
+{
+    DLLHModuleInfo module = {};
+    module.base_address = static_cast<uint64_t>(info->dlpi_addr);
+    for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i)
     {
-        return false;
+        if (info->dlpi_phdr[i].p_type == PT_LOAD)
+        {
+            module.mapped_bytes += info->dlpi_phdr[i].p_memsz;
+            module.segment_count++;
+        }
     }
-    
-    return true;
+
+    const char *path = info->dlpi_name != nullptr ? info->dlpi_name : "";
+    const size_t length = strnlen(path, sizeof(module.path) - 1);
+    memcpy(module.path, path, length);
+    module.path[length] = '\0';
+
+    static_cast<std::vector<DLLHModuleInfo>*>(data)->push_back(module);
+    return 0;
 }
 
 //-------------------------------------------------------------------------
-STATIC_EXPORT(void*) GetModuleHandle(const char *stemname)
+// Every library loaded in the process, in load order. The executable
+// comes first, with an empty path.
+static std::vector<DLLHModuleInfo> loaded_modules()
+{
+    std::vector<DLLHModuleInfo> modules;
+    dl_iterate_phdr(collect_module_callback, &modules);
+    return modules;
+}
+
+//-------------------------------------------------------------------------
+// Writes the calling thread's last loader error to debug.txt
+STATIC_EXPORT(void) GetError()
 {
-    if(baseNameToPath.find(stemname) == baseNameToPath.end())
+    FILE *file = fopen("debug.txt", "w");
+    if (file == nullptr)
     {
-        return nullptr;
+        return;
     }
-        
-    void *to_return = dlopen(baseNameToPath[stemname].c_str(), RTLD_NOLOAD);
-    
-    if(to_return == nullptr)
+
+    fprintf(file, "TryDynamicLinking \n");
+    DLLHLoaderError error;
+    if (loader_trace::last_error(&error))
     {
-        baseNameToPath.erase(stemname);
+        fprintf(file, "A dynamic linking error occurred: (%s)\n", error.message);
     }
-    // dlopen increments the ref handle, so make sure to 
-    // release the ref handle. See `man dlopen`
-    if (to_return)
+    fclose(file);
+}
+
+//-------------------------------------------------------------------------
+// Writes the loaded libraries to libs.txt
+STATIC_EXPORT(void) PrintLibs()
+{
+    FILE *file = fopen("libs.txt", "w");
+    if (file == nullptr)
     {
-        dlclose(to_return);
+        return;
     }
 
-    return to_return;
+    const std::vector<DLLHModuleInfo> modules = loaded_modules();
+    for (size_t i = 0; i < modules.size(); ++i)
+    {
+        fprintf(file, "lib num %zu : %s\n", i, modules[i].path);
+    }
+    fclose(file);
 }
 
 //-------------------------------------------------------------------------
-STATIC_EXPORT(void*) GetProcAddress(void *library_handle, const char *function_name)
+static int read_unload_count_callback(struct dl_phdr_info *info, size_t size, void *data)
 {
-    return dlsym(library_handle, function_name);
+    *static_cast<unsigned long long*>(data) = info->dlpi_subs;
+    return 1;
 }
 
 //-------------------------------------------------------------------------
-STATIC_EXPORT(void) GetError()
+// Number of libraries the dynamic loader has unloaded so far
+static unsigned long long loader_unload_count()
 {
-    char *errstr;
+    unsigned long long unload_count = 0;
+    dl_iterate_phdr(read_unload_count_callback, &unload_count);
+    return unload_count;
+}
 
-    errstr = dlerror();
-    
-    freopen("debug.txt", "w", stdout);
-    printf ("TryDynamicLinking \n");
-    if (errstr != NULL)
-    printf ("A dynamic linking error occurred: (%s)\n", errstr);
-    fclose (stdout);
+//-------------------------------------------------------------------------
+// dl_iterate_phdr holds the loader's lock while it calls back, so the
+// link map list can't change under the walk. Only needs to be called once.
+static int collect_loaded_handles_callback(struct dl_phdr_info *info, size_t size, void *data)
+{
+    std::unordered_set<void*> *loaded_handles = static_cast<std::unordered_set<void*>*>(data);
+    for (struct link_map *map = _r_debug.r_map; map != nullptr; map = map->l_next)
+    {
+        loaded_handles->insert(map);
+    }
+    return 1;
+}
 
+//-------------------------------------------------------------------------
+// glibc's dlopen handles are the libraries' link maps, so a handle that
+// isn't in the list any more belongs to a library that has been unloaded
+static void drop_unloaded_libraries(DLLHContext *ctx)
+{
+    std::unordered_set<void*> loaded_handles;
+    dl_iterate_phdr(collect_loaded_handles_callback, &loaded_handles);
+
+    for (auto library = ctx->libraries.begin(); library != ctx->libraries.end(); )
+    {
+        if (loaded_handles.count(library->first) == 0)
+        {
+            library = ctx->libraries.erase(library);
+        }
+        else
+        {
+            // Handles still loaded may have been unloaded and loaded again
+            library->second.symbol_cache = DLLHSymbolCache();
+            ++library;
+        }
+    }
 }
 
-static int print_lib_callback(struct dl_phdr_info *info, size_t size, void *data)
+//-------------------------------------------------------------------------
+// dlcloses library_handle and, if that unloaded it, has every context
+// forget it. A library still loaded afterwards may have been unloaded and
+// loaded again by another thread in between, so its cached functions are
+// dropped either way.
+static bool close_library(void *library_handle)
 {
-    int* counter = (int*)data;
-    printf("lib num %d : %s\n",*counter,info->dlpi_name);
-    (*counter)++;
-    return 0;
+    std::lock_guard<std::mutex> contexts_lock(s_contexts_lock);
+    const bool closed = traced_dlclose(library_handle) == 0;
+
+    std::unordered_set<void*> loaded_handles;
+    dl_iterate_phdr(collect_loaded_handles_callback, &loaded_handles);
+    const bool unloaded = loaded_handles.count(library_handle) == 0;
+
+    for (DLLHContext *ctx : s_contexts)
+    {
+        std::lock_guard<std::mutex> scope_lock(ctx->lock);
+        auto library = ctx->libraries.find(library_handle);
+        if (library == ctx->libraries.end())
+        {
+            continue;
+        }
+
+        if (unloaded)
+        {
+            ctx->libraries.erase(library);
+        }
+        else
+        {
+            library->second.symbol_cache = DLLHSymbolCache();
+        }
+    }
+    return closed;
 }
 
-STATIC_EXPORT(void) PrintLibs()
+//-------------------------------------------------------------------------
+// Values in the dynamic section are relocated by glibc but not by every
+// loader
+static uintptr_t dynamic_address(const struct link_map *map, ElfW(Addr) value)
+{
+    return value < map->l_addr ? map->l_addr + value : value;
+}
+
+//-------------------------------------------------------------------------
+// DT_GNU_HASH doesn't store the symbol count; it's one past the end of the
+// chain that starts at the highest bucket
+static size_t gnu_hash_symbol_count(const uint32_t *gnu_hash)
+{
+    const uint32_t bucket_count = gnu_hash[0];
+    const uint32_t symbol_offset = gnu_hash[1];
+    const uint32_t bloom_size = gnu_hash[2];
+    const uint32_t *buckets = reinterpret_cast<const uint32_t*>(reinterpret_cast<const ElfW(Addr)*>(gnu_hash + 4) + bloom_size);
+    const uint32_t *chains = buckets + bucket_count;
+
+    uint32_t last_symbol = 0;
+    for (uint32_t i = 0; i < bucket_count; ++i)
+    {
+        last_symbol = buckets[i] > last_symbol ? buckets[i] : last_symbol;
+    }
+    if (last_symbol < symbol_offset)
+    {
+        return symbol_offset;
+    }
+
+    while ((chains[last_symbol - symbol_offset] & 1) == 0)
+    {
+        ++last_symbol;
+    }
+    return last_symbol + 1;
+}
+
+//-------------------------------------------------------------------------
+// IFUNCs are included, though only dlsym can give their address, since it
+// has to run their resolver. False if the table can't be read.
+static bool read_exports(void *library_handle, DLLHExports *out_exports)
+{
+    struct link_map *map = nullptr;
+    if (dlinfo(library_handle, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr || map->l_ld == nullptr)
+    {
+        return false;
+    }
+
+    const ElfW(Sym) *symbols = nullptr;
+    const char *strings = nullptr;
+    const ElfW(Half) *versions = nullptr;
+    size_t symbol_count = 0;
+    for (const ElfW(Dyn) *entry = map->l_ld; entry->d_tag != DT_NULL; ++entry)
+    {
+        switch (entry->d_tag)
+        {
+        case DT_SYMTAB:
+            symbols = reinterpret_cast<const ElfW(Sym)*>(dynamic_address(map, entry->d_un.d_ptr));
+            break;
+        case DT_STRTAB:
+            strings = reinterpret_cast<const char*>(dynamic_address(map, entry->d_un.d_ptr));
+            break;
+        case DT_VERSYM:
+            versions = reinterpret_cast<const ElfW(Half)*>(dynamic_address(map, entry->d_un.d_ptr));
+            break;
+        case DT_HASH:
+            symbol_count = reinterpret_cast<const uint32_t*>(dynamic_address(map, entry->d_un.d_ptr))[1];
+            break;
+        case DT_GNU_HASH:
+            if (symbol_count == 0)
+            {
+                symbol_count = gnu_hash_symbol_count(reinterpret_cast<const uint32_t*>(dynamic_address(map, entry->d_un.d_ptr)));
+            }
+            break;
+        }
+    }
+    if (symbols == nullptr || strings == nullptr)
+    {
+        return false;
+    }
+
+    out_exports->map = map;
+    out_exports->symbols = symbols;
+    out_exports->strings = strings;
+    for (size_t i = 1; i < symbol_count; ++i)
+    {
+        const ElfW(Sym)& symbol = symbols[i];
+        const unsigned char type = ELF64_ST_TYPE(symbol.st_info);
+        const unsigned char binding = ELF64_ST_BIND(symbol.st_info);
+        const bool is_exported_function = symbol.st_shndx != SHN_UNDEF
+            && (type == STT_FUNC || type == STT_GNU_IFUNC)
+            && (binding == STB_GLOBAL || binding == STB_WEAK)
+            && ELF64_ST_VISIBILITY(symbol.st_other) == STV_DEFAULT;
+        const bool is_default_version = versions == nullptr || (versions[i] & DLLH_VERSYM_HIDDEN) == 0;
+
+        if (is_exported_function && is_default_version)
+        {
+            out_exports->indices.push_back(i);
+            out_exports->name_bytes += strlen(strings + symbol.st_name);
+        }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Adds every function the library itself exports, at its default version,
+// to the cache. IFUNCs are left to dlsym, which has to run their resolver.
+static size_t prefill_symbol_cache(DLLHSymbolCache& cache, void *library_handle)
+{
+    DLLHExports exports;
+    if (!read_exports(library_handle, &exports))
+    {
+        return 0;
+    }
+
+    // Reserved up front, so that the names never move once they're keys
+    std::string& names = cache.owned_names.emplace_front();
+    names.reserve(exports.name_bytes);
+
+    size_t added = 0;
+    for (size_t i : exports.indices)
+    {
+        const ElfW(Sym)& symbol = exports.symbols[i];
+        const std::string_view name(exports.strings + symbol.st_name);
+        if (ELF64_ST_TYPE(symbol.st_info) == STT_GNU_IFUNC || cache.functions.count(name) != 0)
+        {
+            continue;
+        }
+
+        const size_t offset = names.size();
+        names.append(name);
+        void *address = reinterpret_cast<void*>(exports.map->l_addr + symbol.st_value);
+        cache.functions.emplace(std::string_view(names.data() + offset, name.size()), address);
+        ++added;
+    }
+    return added;
+}
+
+//-------------------------------------------------------------------------
+// Read once, the first time a function of the library is asked for lazily.
+// Left empty if the table can't be read, so that every name is looked up
+// straight away.
+static void read_exported_names(DLLHSymbolCache& cache, void *library_handle)
 {
-    freopen("libs.txt", "w", stdout);
-    int counter = 0;
-    dl_iterate_phdr(print_lib_callback, &counter);
-    fclose (stdout);
+    cache.exported_names_read = true;
+
+    DLLHExports exports;
+    if (!read_exports(library_handle, &exports))
+    {
+        return;
+    }
+
+    std::string& names = cache.owned_names.emplace_front();
+    names.reserve(exports.name_bytes);
+    cache.exported_names.reserve(exports.indices.size());
+    for (size_t i : exports.indices)
+    {
+        const size_t offset = names.size();
+        names.append(exports.strings + exports.symbols[i].st_name);
+        cache.exported_names.emplace(names.data() + offset, names.size() - offset);
+    }
 }
 
 //-------------------------------------------------------------------------
+// Libraries unloaded behind the context's back are forgotten before the
+// dlopen, which may hand out one of their handles again, since the
+// context's references to them went with them
 void * DLLH_linux_load_library_at_path(DLLHContext *ctx, const char *library_path)
 {
-    void *to_return = dlopen(library_path, RTLD_NOW);
+    {
+        std::lock_guard<std::mutex> scope_lock(ctx->lock);
+        const unsigned long long unload_count = loader_unload_count();
+        if (unload_count != ctx->loader_unload_count)
+        {
+            drop_unloaded_libraries(ctx);
+            ctx->loader_unload_count = unload_count;
+        }
+    }
+
+    void *to_return = traced_dlopen(library_path, RTLD_NOW);
+
+    if (to_return != nullptr)
+    {
+        std::lock_guard<std::mutex> scope_lock(ctx->lock);
+        ctx->libraries[to_return].reference_count++;
+    }
    
     return to_return; 
 }
 
 //-------------------------------------------------------------------------
-// TODO: Handle the actual module instead of all symbols
+// dlsym on a handle searches the library and then its dependencies, which
+// can't change while it's loaded, so both hits and misses are kept. Nothing
+// is kept for a library the context didn't load, since it wouldn't find out
+// when that one is unloaded.
 void * DLLH_linux_load_function_with_name(DLLHContext *ctx, void *library_handle, const char *function)
 {
+    if (ctx == nullptr)
+    {
+        return traced_dlsym(library_handle, function);
+    }
+
+    std::lock_guard<std::mutex> scope_lock(ctx->lock);
+    auto found_library = ctx->libraries.find(library_handle);
+    if (found_library == ctx->libraries.end())
+    {
+        return traced_dlsym(library_handle, function);
+    }
+    DLLHLibrary& library = found_library->second;
+    DLLHSymbolCache& cache = library.symbol_cache;
+
     void *output_ptr = nullptr;
+    auto cached = cache.functions.find(std::string_view(function));
+    if (cached != cache.functions.end())
+    {
+        output_ptr = cached->second;
+    }
+    else
+    {
+        output_ptr = traced_dlsym(library_handle, function);
 
-    output_ptr = dlsym(library_handle, function);
+        cache.owned_names.emplace_front(function);
+        cache.functions.emplace(std::string_view(cache.owned_names.front()), output_ptr);
+    }
+
+    if (output_ptr != nullptr)
+    {
+        library.outstanding_functions++;
+    }
 
     return output_ptr;
 }
 
+//-------------------------------------------------------------------------
+// Functions already looked up are handed out as they are; others the
+// library exports get a stub that looks them up through traced_dlsym when
+// first called. Anything else, which may be missing or come from one of
+// the library's dependencies, is looked up now, as is everything without
+// stubs for this architecture, or memory for them.
+void * DLLH_linux_load_function_lazily(DLLHContext *ctx, void *library_handle, const char *function)
+{
+    if (ctx != nullptr && lazy_stubs::is_supported())
+    {
+        std::lock_guard<std::mutex> scope_lock(ctx->lock);
+        auto found_library = ctx->libraries.find(library_handle);
+        if (found_library == ctx->libraries.end())
+        {
+            return traced_dlsym(library_handle, function);
+        }
+        DLLHLibrary& library = found_library->second;
+
+        void *output_ptr = nullptr;
+        auto cached = library.symbol_cache.functions.find(std::string_view(function));
+        if (cached != library.symbol_cache.functions.end())
+        {
+            output_ptr = cached->second;
+        }
+        else
+        {
+            if (!library.symbol_cache.exported_names_read)
+            {
+                read_exported_names(library.symbol_cache, library_handle);
+            }
+            if (library.symbol_cache.exported_names.count(std::string_view(function)) != 0)
+            {
+                if (library.lazy_stubs == nullptr)
+                {
+                    library.lazy_stubs.reset(lazy_stubs::create_arena(&traced_dlsym));
+                }
+                output_ptr = lazy_stubs::make_stub(library.lazy_stubs.get(), library_handle, function);
+            }
+        }
+
+        if (output_ptr != nullptr)
+        {
+            library.outstanding_functions++;
+            return output_ptr;
+        }
+        if (cached != library.symbol_cache.functions.end())
+        {
+            return nullptr;
+        }
+    }
+
+    return DLLH_linux_load_function_with_name(ctx, library_handle, function);
+}
+
+//-------------------------------------------------------------------------
+// Drops one of the context's references to library_handle. The last one
+// is kept, and false returned, while function pointers from the library
+// are still outstanding, since calling through them after the library is
+// unmapped would crash.
+bool DLLH_linux_unload_library_at_path(DLLHContext *ctx, void *library_handle)
+{
+    {
+        std::lock_guard<std::mutex> scope_lock(ctx->lock);
+        auto library = ctx->libraries.find(library_handle);
+        if (library == ctx->libraries.end() || library->second.reference_count == 0)
+        {
+            return false;
+        }
+
+        if (library->second.reference_count == 1)
+        {
+            if (library->second.outstanding_functions != 0)
+            {
+                return false;
+            }
+            ctx->libraries.erase(library);
+        }
+        else
+        {
+            library->second.reference_count--;
+        }
+    }
+
+    return close_library(library_handle);
+}
+
 //-------------------------------------------------------------------------
 // Create heap data for storing random things, if need be on a given platform
 STATIC_EXPORT(void *) DLLH_create_context()
 {
-    return new DLLHContext();
+    DLLHContext *ctx = new DLLHContext();
+
+    std::lock_guard<std::mutex> contexts_lock(s_contexts_lock);
+    s_contexts.insert(ctx);
+    return ctx;
 }
 
 //-------------------------------------------------------------------------
+// Libraries the context still holds references to stay loaded
 STATIC_EXPORT(void) DLLH_destroy_context(void *context)
 {
-    delete static_cast<DLLHContext *>(context);
+    DLLHContext *ctx = static_cast<DLLHContext *>(context);
+    {
+        std::lock_guard<std::mutex> contexts_lock(s_contexts_lock);
+        s_contexts.erase(ctx);
+    }
+    delete ctx;
 }
 
 //-------------------------------------------------------------------------
@@ -178,6 +719,33 @@ STATIC_EXPORT(void *) DLLH_load_library_at_path(void *ctx, const char *library_p
     return to_return;
 }
 
+//-------------------------------------------------------------------------
+// Starts loading library_path on a worker thread, so that the caller can
+// get on with other startup work while the loader maps and relocates it.
+// Returns a ticket that has to be passed to DLLH_wait_library exactly once,
+// before the context is destroyed, or null if no thread could be started.
+STATIC_EXPORT(void *) DLLH_load_library_async(void *ctx, const char *library_path)
+{
+    return library_loading::load_async(static_cast<DLLHContext*>(ctx), library_path, &DLLH_linux_load_library_at_path);
+}
+
+//-------------------------------------------------------------------------
+// True once DLLH_wait_library would return without blocking
+STATIC_EXPORT(bool) DLLH_poll_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    return library_loading::poll(ticket);
+}
+
+//-------------------------------------------------------------------------
+// Blocks until the load behind ticket is done, then frees the ticket and
+// returns what DLLH_load_library_at_path would have
+STATIC_EXPORT(void *) DLLH_wait_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    return library_loading::wait(ticket);
+}
+
 //-------------------------------------------------------------------------
 // This returns a bare function pointer that is only valid as long as the library_handle and context are
 // valid
@@ -192,9 +760,173 @@ STATIC_EXPORT(void *) DLLH_load_function_with_name(void *ctx, void *library_hand
 }
 
 //-------------------------------------------------------------------------
-// TODO: unload the library correct? I don't know if that's actually a good
-// idea on linux or not
-STATIC_EXPORT(void) DLLH_unload_library_at_path(const char *library_path)
+// Resolves count functions in one call, so that managed code binding
+// hundreds of SDK functions only crosses into native code once. Functions
+// that aren't found are null in out_functions. Returns how many were found.
+STATIC_EXPORT(size_t) DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+    return library_loading::load_functions(static_cast<DLLHContext*>(ctx), library_handle, function_names, out_functions, count, &DLLH_linux_load_function_with_name);
+}
+
+//-------------------------------------------------------------------------
+// Like DLLH_load_function_with_name, but a function that hasn't been
+// looked up yet comes back as a stub that looks it up the first time it's
+// called, so binding every SDK function at startup only pays for the ones
+// that get used. Stubs are only valid while the library is; they count
+// towards DLLH_release_functions like any other function pointer. Only
+// functions the library's dynamic symbol table has get stubs, so one it
+// doesn't have is null, as from DLLH_load_function_with_name. Where there
+// are no stubs (anything but x86-64), this is DLLH_load_function_with_name.
+STATIC_EXPORT(void *) DLLH_load_function_lazily(void *ctx, void *library_handle, const char *function)
+{
+    if (function == nullptr)
+    {
+        return nullptr;
+    }
+
+    DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+    return DLLH_linux_load_function_lazily(dllh_ctx, library_handle, function);
+}
+
+//-------------------------------------------------------------------------
+// DLLH_load_function_lazily for count functions in one call. Returns how
+// many of out_functions aren't null.
+STATIC_EXPORT(size_t) DLLH_load_functions_lazily(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+    return library_loading::load_functions(static_cast<DLLHContext*>(ctx), library_handle, function_names, out_functions, count, &DLLH_linux_load_function_lazily);
+}
+
+//-------------------------------------------------------------------------
+// Fills the context's symbol cache for library_handle with every function
+// the library exports, so that later lookups of them never reach dlsym.
+// Returns the number of functions added, none for a library the context
+// didn't load.
+STATIC_EXPORT(size_t) DLLH_prefill_symbol_cache(void *ctx, void *library_handle)
+{
+    if (ctx == nullptr || library_handle == nullptr)
+    {
+        return 0;
+    }
+
+    DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+    std::lock_guard<std::mutex> scope_lock(dllh_ctx->lock);
+
+    auto library = dllh_ctx->libraries.find(library_handle);
+    if (library == dllh_ctx->libraries.end())
+    {
+        return 0;
+    }
+    return prefill_symbol_cache(library->second.symbol_cache, library_handle);
+}
+
+//-------------------------------------------------------------------------
+// Tells the context that none of the function pointers it has handed out
+// for library_handle will be called again, so that the library can be
+// unloaded. Returns how many were outstanding.
+STATIC_EXPORT(size_t) DLLH_release_functions(void *ctx, void *library_handle)
 {
+    if (ctx == nullptr || library_handle == nullptr)
+    {
+        return 0;
+    }
+
+    DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+    std::lock_guard<std::mutex> scope_lock(dllh_ctx->lock);
+
+    auto library = dllh_ctx->libraries.find(library_handle);
+    if (library == dllh_ctx->libraries.end())
+    {
+        return 0;
+    }
+
+    const size_t released = library->second.outstanding_functions;
+    library->second.outstanding_functions = 0;
+    return released;
 }
 
+//-------------------------------------------------------------------------
+// Drops one reference taken by DLLH_load_library_at_path. Dropping the
+// last one unloads the library, but only once DLLH_release_functions has
+// been called for it; until then this returns false and leaves it loaded.
+// Returns false for libraries the context didn't load.
+STATIC_EXPORT(bool) DLLH_unload_library_at_path(void *ctx, void *library_handle)
+{
+    if (ctx == nullptr || library_handle == nullptr)
+    {
+        return false;
+    }
+
+    DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+    return DLLH_linux_unload_library_at_path(dllh_ctx, library_handle);
+}
+
+//-------------------------------------------------------------------------
+// Starts or stops timing the loader calls DLLH makes
+STATIC_EXPORT(void) DLLH_set_loader_trace(bool enabled)
+{
+    loader_trace::set_recording(enabled);
+}
+
+//-------------------------------------------------------------------------
+// Fills buffer with up to capacity of what query asks for (see
+// DLLHLoaderQuery) and returns how many there are, which may be more than
+// capacity. Returns -1 for an unknown query or API version.
+STATIC_EXPORT(int64_t) DLLH_query_loader_info(int32_t api_version, int32_t query, void *buffer, uint64_t capacity)
+{
+    if (api_version != DLLH_LOADER_INFO_API_LATEST || (buffer == nullptr && capacity != 0))
+    {
+        return -1;
+    }
+
+    switch (query)
+    {
+    case DLLH_LOADER_QUERY_EVENTS:
+        return static_cast<int64_t>(loader_trace::events(static_cast<DLLHLoaderEvent*>(buffer), static_cast<size_t>(capacity)));
+
+    case DLLH_LOADER_QUERY_MODULES:
+    {
+        const std::vector<DLLHModuleInfo> modules = loaded_modules();
+        for (size_t i = 0; i < modules.size() && i < capacity; ++i)
+        {
+            static_cast<DLLHModuleInfo*>(buffer)[i] = modules[i];
+        }
+        return static_cast<int64_t>(modules.size());
+    }
+
+    case DLLH_LOADER_QUERY_LAST_ERROR:
+    {
+        DLLHLoaderError error;
+        if (!loader_trace::last_error(&error))
+        {
+            return 0;
+        }
+        if (capacity > 0)
+        {
+            *static_cast<DLLHLoaderError*>(buffer) = error;
+        }
+        return 1;
+    }
+
+    default:
+        return -1;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Writes the recorded loader calls to path as a Chrome trace
+STATIC_EXPORT(bool) DLLH_write_loader_chrome_trace(const char *path)
+{
+    if (path == nullptr)
+    {
+        return false;
+    }
+
+    FILE *file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    const bool written = loader_trace::write_chrome_trace(file);
+    return fclose(file) == 0 && written;
+}
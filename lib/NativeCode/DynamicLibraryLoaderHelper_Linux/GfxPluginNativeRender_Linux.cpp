@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// GfxPluginNativeRender_Linux.cpp : The exports Unity and the C# side look
+// for in GfxPluginNativeRender. Unity calls UnityPluginLoad for any plugin
+// whose name starts with GfxPlugin, before any managed code runs. The work
+// is done in PluginBootstrap.cpp, which the Windows build shares.
+
+#include "pch.h"
+#include "PluginBootstrap.h"
+
+typedef void (*log_flush_function_t)(const char* str);
+
+//-------------------------------------------------------------------------
+DLL_EXPORT(void) UnityPluginLoad(void*)
+{
+    plugin_bootstrap::load();
+}
+
+//-------------------------------------------------------------------------
+DLL_EXPORT(void) UnityPluginUnload()
+{
+    plugin_bootstrap::unload();
+}
+
+//-------------------------------------------------------------------------
+DLL_EXPORT(void *) EOS_GetPlatformInterface()
+{
+    return plugin_bootstrap::platform_handle();
+}
+
+//-------------------------------------------------------------------------
+DLL_EXPORT(void) global_log_flush_with_function(log_flush_function_t log_flush_function)
+{
+    plugin_bootstrap::flush_log_with_function(log_flush_function);
+}
@@ -26,32 +26,34 @@
 #include <assert.h>
 #include <dlfcn.h>
 #include <stdio.h>
-#include <map>
-#include <string>
-#include <libgen.h>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <mach-o/dyld.h>
 
-#define STATIC_EXPORT(return_type) extern "C" return_type
+#include "LibraryLoading.h"
+#include "ModuleRegistry.h"
 
-std::map <std::string,std::string> baseNameToPath;
+#define STATIC_EXPORT(return_type) extern "C" return_type
 
 struct DLLHContext
 {
+    std::mutex lock;
+    // dlopen calls made through the context that haven't been matched by
+    // an unload, per library handle
+    std::unordered_map<void*, unsigned int> reference_counts;
 };
 
 //-------------------------------------------------------------------------
 STATIC_EXPORT(void*) LoadLibrary(const char *library_path)
 {
-    std::string filename = std::string(basename((char*)library_path));
-    std::string stemname = filename.substr(0, filename.find_last_of("."));
-   
     void* handle = dlopen(library_path, RTLD_NOW);
     if(handle == nullptr)
     {
         return nullptr;
     }
     
-    baseNameToPath[stemname] = std::string(library_path);
+    module_registry::add(library_path, handle);
 
     return handle;
 }
@@ -60,6 +62,10 @@ STATIC_EXPORT(void*) LoadLibrary(const char *library_path)
 // pretend windows like function
 STATIC_EXPORT(bool) FreeLibrary(void *library_handle)
 {
+    // Out of the registry first, so that GetModuleHandle can't hand out
+    // a library that's going away
+    module_registry::release(library_handle);
+
     dlclose(library_handle);
     
     if(dlerror())
@@ -71,27 +77,11 @@ STATIC_EXPORT(bool) FreeLibrary(void *library_handle)
 }
 
 //-------------------------------------------------------------------------
+// The registry holds a loader reference for every library in it, so
+// there's no need to check with dlopen(RTLD_NOLOAD) that it's still loaded
 STATIC_EXPORT(void*) GetModuleHandle(const char *stemname)
 {
-    if(baseNameToPath.find(stemname) == baseNameToPath.end())
-    {
-        return nullptr;
-    }
-        
-    void *to_return = dlopen(baseNameToPath[stemname].c_str(), RTLD_NOLOAD);
-    
-    if(to_return == nullptr)
-    {
-        baseNameToPath.erase(stemname);
-    }
-    // dlopen increments the ref handle, so make sure to 
-    // release the ref handle. See `man dlopen`
-    if (to_return)
-    {
-        dlclose(to_return);
-    }
-
-    return to_return;
+    return module_registry::find(stemname);
 }
 
 //-------------------------------------------------------------------------
@@ -129,10 +119,39 @@ STATIC_EXPORT(void) PrintLibs()
 void * DLLH_macOS_load_library_at_path(DLLHContext *ctx, const char *library_path)
 {
     void *to_return = dlopen(library_path, RTLD_NOW);
+
+    if (to_return != nullptr)
+    {
+        std::lock_guard<std::mutex> scope_lock(ctx->lock);
+        ctx->reference_counts[to_return]++;
+    }
    
     return to_return; 
 }
 
+//-------------------------------------------------------------------------
+// Drops one of the context's references to library_handle. Function
+// pointers aren't tracked on this platform, so it's up to the caller not
+// to call through them once the last one is gone.
+bool DLLH_macOS_unload_library_at_path(DLLHContext *ctx, void *library_handle)
+{
+    {
+        std::lock_guard<std::mutex> scope_lock(ctx->lock);
+        auto references = ctx->reference_counts.find(library_handle);
+        if (references == ctx->reference_counts.end())
+        {
+            return false;
+        }
+
+        if (--references->second == 0)
+        {
+            ctx->reference_counts.erase(references);
+        }
+    }
+
+    return dlclose(library_handle) == 0;
+}
+
 //-------------------------------------------------------------------------
 // TODO: Handle the actual module instead of all symbols
 void * DLLH_macOS_load_function_with_name(DLLHContext *ctx, void *library_handle, const char *function)
@@ -172,6 +191,33 @@ STATIC_EXPORT(void *) DLLH_load_library_at_path(void *ctx, const char *library_p
     return to_return;
 }
 
+//-------------------------------------------------------------------------
+// Starts loading library_path on a worker thread, so that the caller can
+// get on with other startup work while the loader maps and relocates it.
+// Returns a ticket that has to be passed to DLLH_wait_library exactly once,
+// before the context is destroyed, or null if no thread could be started.
+STATIC_EXPORT(void *) DLLH_load_library_async(void *ctx, const char *library_path)
+{
+    return library_loading::load_async(static_cast<DLLHContext*>(ctx), library_path, &DLLH_macOS_load_library_at_path);
+}
+
+//-------------------------------------------------------------------------
+// True once DLLH_wait_library would return without blocking
+STATIC_EXPORT(bool) DLLH_poll_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    return library_loading::poll(ticket);
+}
+
+//-------------------------------------------------------------------------
+// Blocks until the load behind ticket is done, then frees the ticket and
+// returns what DLLH_load_library_at_path would have
+STATIC_EXPORT(void *) DLLH_wait_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    return library_loading::wait(ticket);
+}
+
 //-------------------------------------------------------------------------
 // This returns a bare function pointer that is only valid as long as the library_handle and context are
 // valid
@@ -186,9 +232,46 @@ STATIC_EXPORT(void *) DLLH_load_function_with_name(void *ctx, void *library_hand
 }
 
 //-------------------------------------------------------------------------
-// TODO: unload the library correct? I don't know if that's actually a good
-// idea on macos or not
-STATIC_EXPORT(void) DLLH_unload_library_at_path(const char *library_path)
+// Resolves count functions in one call, so that managed code binding
+// hundreds of SDK functions only crosses into native code once. Functions
+// that aren't found are null in out_functions. Returns how many were found.
+STATIC_EXPORT(size_t) DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+    return library_loading::load_functions(static_cast<DLLHContext*>(ctx), library_handle, function_names, out_functions, count, &DLLH_macOS_load_function_with_name);
+}
+
+//-------------------------------------------------------------------------
+// There are no lazy stubs on this platform, so functions are looked up
+// straight away
+STATIC_EXPORT(void *) DLLH_load_function_lazily(void *ctx, void *library_handle, const char *function)
+{
+    return DLLH_load_function_with_name(ctx, library_handle, function);
+}
+
+//-------------------------------------------------------------------------
+STATIC_EXPORT(size_t) DLLH_load_functions_lazily(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
 {
+    return DLLH_load_functions_with_names(ctx, library_handle, function_names, out_functions, count);
+}
+
+//-------------------------------------------------------------------------
+// Returns false for libraries the context didn't load
+STATIC_EXPORT(bool) DLLH_unload_library_at_path(void *ctx, void *library_handle)
+{
+    if (ctx == nullptr || library_handle == nullptr)
+    {
+        return false;
+    }
+
+    DLLHContext *dllh_ctx = static_cast<DLLHContext*>(ctx);
+    return DLLH_macOS_unload_library_at_path(dllh_ctx, library_handle);
 }
 
+//-------------------------------------------------------------------------
+// Function pointers aren't tracked on this platform, so unloading never
+// waits on them
+STATIC_EXPORT(size_t) DLLH_release_functions(void *ctx, void *library_handle)
+{
+    std::ignore = ctx, library_handle;
+    return 0;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+#include <atomic>
+
+//-------------------------------------------------------------------------
+// Records every Mem_generic_* call to a binary file, so that real SDK
+// traffic can be replayed offline against different allocators (see
+// tools/AllocationTraceReplay.cpp).
+//
+// Each thread appends events to its own single producer ring buffer
+// without locking; a background thread drains the rings to the file every
+// few milliseconds. If a ring fills up faster than it's drained, events
+// are dropped and counted rather than blocking the allocating thread.
+//
+// File layout: an AllocationTraceHeader followed by AllocationTraceEvents.
+// Events from different threads are interleaved in drain order, so sort
+// by timestamp to replay them. Frees are recorded before the block is
+// released and allocations after the block is obtained, so a block's free
+// never sorts before its allocation even across threads. A realloc is
+// only recorded once the new block is known, but with a timestamp taken
+// before the old one was released, for the same reason.
+#define ALLOCATION_TRACE_MAGIC "EOSMTRC"
+#define ALLOCATION_TRACE_VERSION 1
+
+// Per thread, in events; must be a power of two
+#define ALLOCATION_TRACE_RING_SIZE 16384
+
+#define ALLOCATION_TRACE_DRAIN_INTERVAL_MS 5
+
+enum class AllocationTraceEventType : uint8_t
+{
+    Alloc = 0,
+    // old_pointer was resized to size_in_bytes and now lives at pointer
+    Realloc = 1,
+    Free = 2,
+    // First event from a thread: pointer holds its OS thread id
+    Thread = 3,
+    // size_in_bytes events were lost from thread_index's ring
+    Dropped = 4,
+};
+
+struct AllocationTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t event_size;
+};
+
+struct AllocationTraceEvent
+{
+    // Since recording started
+    uint64_t timestamp_ns;
+    uint64_t pointer;
+    uint64_t old_pointer;
+    uint64_t size_in_bytes;
+    uint16_t thread_index;
+    AllocationTraceEventType type;
+    uint8_t alignment_log2;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(AllocationTraceEvent) == 40, "AllocationTraceEvent is part of the file format");
+
+namespace allocation_trace
+{
+    namespace detail
+    {
+        extern std::atomic<bool> recording;
+    }
+
+    // Fails if a trace is already being recorded or the file can't be
+    // created
+    bool start(const char *path);
+
+    // Drains what's left and closes the file. Returns false if nothing was
+    // being recorded or the file couldn't be written.
+    bool stop();
+
+    inline bool is_recording()
+    {
+        return detail::recording.load(std::memory_order_relaxed);
+    }
+
+    // Time since recording started, for an event that's recorded later
+    uint64_t now_ns();
+
+    // Only call when is_recording(). timestamp_ns is from now_ns().
+    void record(AllocationTraceEventType type, const void *pointer, const void *old_pointer, size_t size_in_bytes, size_t alignment_in_bytes, uint64_t timestamp_ns);
+
+    inline void record(AllocationTraceEventType type, const void *pointer, const void *old_pointer, size_t size_in_bytes, size_t alignment_in_bytes)
+    {
+        record(type, pointer, old_pointer, size_in_bytes, alignment_in_bytes, now_ns());
+    }
+}
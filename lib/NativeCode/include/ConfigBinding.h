@@ -0,0 +1,184 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct json_value_s;
+
+//-------------------------------------------------------------------------
+// Filling a config struct from a JSON object in one pass over its keys,
+// from a table of the struct's fields rather than a chain of strcmp calls.
+//
+// A Schema is built at compile time from the fields' names and what binds
+// each one. It finds a seed for which the names hash to distinct slots, so
+// looking up a key costs a hash of the key, one table read and one compare
+// against the only name it could be, however many fields there are. Two
+// fields with the same name, or names no seed separates, fail to compile.
+//
+// The binding itself, which needs json.h, is in PluginBootstrap.cpp along
+// with the schemas for EOSConfig, SandboxDeploymentOverride, LogLevelConfig
+// and EOSSteamConfig.
+namespace config_binding
+{
+    template<typename Config>
+    struct FieldDescriptor
+    {
+        const char *name;
+        // Stores the value in the config. A value of a type the field can't
+        // take is skipped.
+        void (*bind)(json_value_s *value, Config *out_config);
+    };
+
+    //-------------------------------------------------------------------------
+    constexpr size_t key_length(const char *key)
+    {
+        size_t length = 0;
+        while (key[length] != '\0')
+        {
+            length++;
+        }
+        return length;
+    }
+
+    //-------------------------------------------------------------------------
+    // FNV-1a
+    constexpr uint32_t hash_key(const char *key, size_t length)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<uint8_t>(key[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    //-------------------------------------------------------------------------
+    constexpr uint32_t slot_for(uint32_t key_hash, uint32_t seed, uint32_t slot_bits)
+    {
+        return ((key_hash ^ seed) * 0x9E3779B1u) >> (32 - slot_bits);
+    }
+
+    // Called, and so not a constant expression, when a schema can't be built
+    inline void schema_has_duplicate_field_name() { abort(); }
+    inline void schema_has_no_perfect_hash() { abort(); }
+
+    template<typename Config, size_t FieldCount>
+    class Schema
+    {
+    public:
+        static_assert(FieldCount > 0 && FieldCount < 255, "A schema has between 1 and 254 fields");
+
+        // At least twice as many slots as fields, so a seed is quick to find
+        static constexpr uint32_t slot_bits = [] {
+            uint32_t bits = 1;
+            while ((size_t(1) << bits) < FieldCount * 2)
+            {
+                bits++;
+            }
+            return bits;
+        }();
+        static constexpr size_t slot_count = size_t(1) << slot_bits;
+        static constexpr uint8_t empty_slot = 0xFF;
+
+        //-------------------------------------------------------------------------
+        constexpr explicit Schema(const FieldDescriptor<Config> (&fields)[FieldCount])
+            : m_fields()
+            , m_name_lengths()
+            , m_name_hashes()
+            , m_slots()
+            , m_seed(0)
+        {
+            for (size_t i = 0; i < FieldCount; ++i)
+            {
+                m_fields[i] = fields[i];
+                m_name_lengths[i] = key_length(fields[i].name);
+                m_name_hashes[i] = hash_key(fields[i].name, m_name_lengths[i]);
+                for (size_t j = 0; j < i; ++j)
+                {
+                    if (names_equal(i, j))
+                    {
+                        schema_has_duplicate_field_name();
+                    }
+                }
+            }
+
+            for (uint32_t seed = 0; seed < 100000; ++seed)
+            {
+                if (try_seed(seed))
+                {
+                    return;
+                }
+            }
+            schema_has_no_perfect_hash();
+        }
+
+        //-------------------------------------------------------------------------
+        // The field named key, which needn't be null terminated, or null
+        const FieldDescriptor<Config> * find(const char *key, size_t length) const
+        {
+            const uint8_t index = m_slots[slot_for(hash_key(key, length), m_seed, slot_bits)];
+            if (index == empty_slot || m_name_lengths[index] != length || memcmp(m_fields[index].name, key, length) != 0)
+            {
+                return nullptr;
+            }
+            return &m_fields[index];
+        }
+
+        constexpr size_t field_count() const { return FieldCount; }
+        constexpr const FieldDescriptor<Config>& field(size_t index) const { return m_fields[index]; }
+        constexpr uint32_t seed() const { return m_seed; }
+
+    private:
+        //-------------------------------------------------------------------------
+        constexpr bool names_equal(size_t a, size_t b) const
+        {
+            if (m_name_lengths[a] != m_name_lengths[b])
+            {
+                return false;
+            }
+            for (size_t i = 0; i < m_name_lengths[a]; ++i)
+            {
+                if (m_fields[a].name[i] != m_fields[b].name[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //-------------------------------------------------------------------------
+        constexpr bool try_seed(uint32_t seed)
+        {
+            for (size_t slot = 0; slot < slot_count; ++slot)
+            {
+                m_slots[slot] = empty_slot;
+            }
+            for (size_t i = 0; i < FieldCount; ++i)
+            {
+                const uint32_t slot = slot_for(m_name_hashes[i], seed, slot_bits);
+                if (m_slots[slot] != empty_slot)
+                {
+                    return false;
+                }
+                m_slots[slot] = static_cast<uint8_t>(i);
+            }
+            m_seed = seed;
+            return true;
+        }
+
+        FieldDescriptor<Config> m_fields[FieldCount];
+        size_t m_name_lengths[FieldCount];
+        uint32_t m_name_hashes[FieldCount];
+        uint8_t m_slots[slot_count];
+        uint32_t m_seed;
+    };
+
+    //-------------------------------------------------------------------------
+    template<typename Config, size_t FieldCount>
+    constexpr Schema<Config, FieldCount> make_schema(const FieldDescriptor<Config> (&fields)[FieldCount])
+    {
+        return Schema<Config, FieldCount>(fields);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+#include <string>
+
+#include "PluginBootstrap.h"
+
+//-------------------------------------------------------------------------
+// A binary copy of a config the bootstrap has already parsed out of JSON,
+// so that later starts can skip the parse. plugin_bootstrap writes one
+// beside each config file and maps it in on the next start.
+//
+// A cache remembers the hash and size of the JSON it was made from. If the
+// JSON doesn't match any more, or the cache was written by a different
+// version or is damaged, decode turns it down and the JSON is parsed as
+// before.
+//
+// File layout: a ConfigCacheHeader followed by the payload. Numbers are
+// little endian, and a string is its uint32_t length followed by its
+// bytes. Lists are a uint32_t count followed by the items.
+#define CONFIG_CACHE_MAGIC "EOSCFGC"
+// Bump when the payload of any kind changes, including a field being added,
+// or when the same JSON comes to parse differently, as the cache of it
+// would otherwise still be believed
+#define CONFIG_CACHE_VERSION 2
+
+// What the cache is named beside the JSON it was made from
+#define CONFIG_CACHE_EXTENSION ".cache"
+
+enum class ConfigCacheKind : uint32_t
+{
+    EOS = 1,
+    LogLevel = 2,
+    Steam = 3,
+};
+
+struct ConfigCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    ConfigCacheKind kind;
+    // Of the JSON the config was parsed from
+    uint64_t source_hash;
+    uint64_t source_size;
+    // Of what follows the header
+    uint64_t payload_size;
+    uint64_t payload_hash;
+};
+
+namespace config_cache
+{
+    // FNV-1a; to notice a changed file, not to resist a hostile one
+    uint64_t hash_bytes(const void *data, size_t size);
+
+    std::string encode(const EOSConfig& config, const void *source, size_t source_size);
+    std::string encode(const LogLevelConfig& config, const void *source, size_t source_size);
+    std::string encode(const EOSSteamConfig& config, const void *source, size_t source_size);
+
+    // False, leaving out_config alone, unless data is an intact cache of
+    // this kind and version made from exactly source
+    bool decode(const void *data, size_t size, const void *source, size_t source_size, EOSConfig *out_config);
+    bool decode(const void *data, size_t size, const void *source, size_t source_size, LogLevelConfig *out_config);
+    bool decode(const void *data, size_t size, const void *source, size_t source_size, EOSSteamConfig *out_config);
+}
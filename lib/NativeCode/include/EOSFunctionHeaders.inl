@@ -0,0 +1,56 @@
+// Generated by tools/GenerateEOSFunctionTable.cpp from the EOS SDK headers.
+// Don't edit by hand; run `make eos_function_table` after updating the SDK.
+
+#include "eos_achievements.h"
+#include "eos_achievements_types.h"
+#include "eos_anticheatclient.h"
+#include "eos_anticheatserver.h"
+#include "eos_auth.h"
+#include "eos_auth_types.h"
+#include "eos_common.h"
+#include "eos_connect.h"
+#include "eos_connect_types.h"
+#include "eos_custominvites.h"
+#include "eos_ecom.h"
+#include "eos_ecom_types.h"
+#include "eos_friends.h"
+#include "eos_init.h"
+#include "eos_integratedplatform.h"
+#include "eos_integratedplatform_types.h"
+#include "eos_kws.h"
+#include "eos_kws_types.h"
+#include "eos_leaderboards.h"
+#include "eos_leaderboards_types.h"
+#include "eos_lobby.h"
+#include "eos_lobby_types.h"
+#include "eos_logging.h"
+#include "eos_metrics.h"
+#include "eos_mods.h"
+#include "eos_mods_types.h"
+#include "eos_p2p.h"
+#include "eos_playerdatastorage.h"
+#include "eos_playerdatastorage_types.h"
+#include "eos_presence.h"
+#include "eos_presence_types.h"
+#include "eos_progressionsnapshot.h"
+#include "eos_reports.h"
+#include "eos_rtc.h"
+#include "eos_rtc_admin.h"
+#include "eos_rtc_admin_types.h"
+#include "eos_rtc_audio.h"
+#include "eos_rtc_audio_types.h"
+#include "eos_rtc_data.h"
+#include "eos_sanctions.h"
+#include "eos_sanctions_types.h"
+#include "eos_sdk.h"
+#include "eos_sessions.h"
+#include "eos_sessions_types.h"
+#include "eos_stats.h"
+#include "eos_stats_types.h"
+#include "eos_titlestorage.h"
+#include "eos_titlestorage_types.h"
+#include "eos_types.h"
+#include "eos_ui.h"
+#include "eos_userinfo.h"
+#include "eos_userinfo_types.h"
+#include "eos_version.h"
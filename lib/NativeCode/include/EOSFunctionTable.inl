@@ -0,0 +1,738 @@
+// Generated by tools/GenerateEOSFunctionTable.cpp from the EOS SDK headers.
+// Don't edit by hand; run `make eos_function_table` after updating the SDK.
+//
+// EOS_FUNCTION(name, binding), where binding is EOS_FUNCTION_REQUIRED or
+// EOS_FUNCTION_LAZY. See EOSFunctions.h.
+
+// eos_achievements.h
+EOS_FUNCTION(EOS_Achievements_QueryDefinitions, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_GetAchievementDefinitionCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyAchievementDefinitionV2ByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyAchievementDefinitionV2ByAchievementId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_QueryPlayerAchievements, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_GetPlayerAchievementCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyPlayerAchievementByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyPlayerAchievementByAchievementId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_UnlockAchievements, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_AddNotifyAchievementsUnlockedV2, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_RemoveNotifyAchievementsUnlocked, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyAchievementDefinitionByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyAchievementDefinitionByAchievementId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_GetUnlockedAchievementCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyUnlockedAchievementByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_CopyUnlockedAchievementByAchievementId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_AddNotifyAchievementsUnlocked, EOS_FUNCTION_LAZY)
+
+// eos_achievements_types.h
+EOS_FUNCTION(EOS_Achievements_DefinitionV2_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_PlayerAchievement_Release, EOS_FUNCTION_LAZY)
+
+// eos_achievements_types_deprecated.inl
+EOS_FUNCTION(EOS_Achievements_Definition_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Achievements_UnlockedAchievement_Release, EOS_FUNCTION_LAZY)
+
+// eos_anticheatclient.h
+EOS_FUNCTION(EOS_AntiCheatClient_AddNotifyMessageToServer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_RemoveNotifyMessageToServer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_AddNotifyMessageToPeer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_RemoveNotifyMessageToPeer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_AddNotifyPeerActionRequired, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_RemoveNotifyPeerActionRequired, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_AddNotifyPeerAuthStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_RemoveNotifyPeerAuthStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_AddNotifyClientIntegrityViolated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_RemoveNotifyClientIntegrityViolated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_BeginSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_EndSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_PollStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_AddExternalIntegrityCatalog, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_ReceiveMessageFromServer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_GetProtectMessageOutputLength, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_ProtectMessage, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_UnprotectMessage, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_RegisterPeer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_UnregisterPeer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatClient_ReceiveMessageFromPeer, EOS_FUNCTION_LAZY)
+
+// eos_anticheatserver.h
+EOS_FUNCTION(EOS_AntiCheatServer_AddNotifyMessageToClient, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_RemoveNotifyMessageToClient, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_AddNotifyClientActionRequired, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_RemoveNotifyClientActionRequired, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_AddNotifyClientAuthStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_RemoveNotifyClientAuthStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_BeginSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_EndSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_RegisterClient, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_UnregisterClient, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_ReceiveMessageFromClient, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_SetClientDetails, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_SetGameSessionId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_SetClientNetworkState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_GetProtectMessageOutputLength, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_ProtectMessage, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_UnprotectMessage, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_RegisterEvent, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogEvent, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogGameRoundStart, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogGameRoundEnd, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogPlayerSpawn, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogPlayerDespawn, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogPlayerRevive, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogPlayerTick, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogPlayerUseWeapon, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogPlayerUseAbility, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_AntiCheatServer_LogPlayerTakeDamage, EOS_FUNCTION_LAZY)
+
+// eos_auth.h
+EOS_FUNCTION(EOS_Auth_Login, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_Logout, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_LinkAccount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_DeletePersistentAuth, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_VerifyUserAuth, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_GetLoggedInAccountsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_GetLoggedInAccountByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_GetLoginStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_CopyUserAuthToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_CopyIdToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_QueryIdToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_VerifyIdToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_GetSelectedAccountId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_GetMergedAccountsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_GetMergedAccountByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_AddNotifyLoginStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_RemoveNotifyLoginStatusChanged, EOS_FUNCTION_LAZY)
+
+// eos_auth_types.h
+EOS_FUNCTION(EOS_Auth_Token_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Auth_IdToken_Release, EOS_FUNCTION_LAZY)
+
+// eos_common.h
+EOS_FUNCTION(EOS_EResult_ToString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_EResult_IsOperationComplete, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ByteArray_ToString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_EpicAccountId_IsValid, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_EpicAccountId_ToString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_EpicAccountId_FromString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ProductUserId_IsValid, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ProductUserId_ToString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ProductUserId_FromString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ContinuanceToken_ToString, EOS_FUNCTION_LAZY)
+
+// eos_connect.h
+EOS_FUNCTION(EOS_Connect_Login, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_Logout, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_CreateUser, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_LinkAccount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_UnlinkAccount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_CreateDeviceId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_DeleteDeviceId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_TransferDeviceIdAccount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_QueryExternalAccountMappings, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_QueryProductUserIdMappings, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_GetExternalAccountMapping, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_GetProductUserIdMapping, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_GetProductUserExternalAccountCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_CopyProductUserExternalAccountByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_CopyProductUserExternalAccountByAccountType, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_CopyProductUserExternalAccountByAccountId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_CopyProductUserInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_GetLoggedInUsersCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_GetLoggedInUserByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_GetLoginStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_AddNotifyAuthExpiration, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_RemoveNotifyAuthExpiration, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_AddNotifyLoginStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_RemoveNotifyLoginStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_CopyIdToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_VerifyIdToken, EOS_FUNCTION_LAZY)
+
+// eos_connect_types.h
+EOS_FUNCTION(EOS_Connect_ExternalAccountInfo_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Connect_IdToken_Release, EOS_FUNCTION_LAZY)
+
+// eos_custominvites.h
+EOS_FUNCTION(EOS_CustomInvites_SetCustomInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_SendCustomInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifyCustomInviteReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifyCustomInviteReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifyCustomInviteAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifyCustomInviteAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifyCustomInviteRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifyCustomInviteRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_FinalizeInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_SendRequestToJoin, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifyRequestToJoinResponseReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifyRequestToJoinResponseReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifyRequestToJoinReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifyRequestToJoinReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifySendCustomNativeInviteRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifySendCustomNativeInviteRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifyRequestToJoinAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifyRequestToJoinAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AddNotifyRequestToJoinRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RemoveNotifyRequestToJoinRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_AcceptRequestToJoin, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_CustomInvites_RejectRequestToJoin, EOS_FUNCTION_LAZY)
+
+// eos_ecom.h
+EOS_FUNCTION(EOS_Ecom_QueryOwnership, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_QueryOwnershipBySandboxIds, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_QueryOwnershipToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_QueryEntitlements, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_QueryEntitlementToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_QueryOffers, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_Checkout, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_RedeemEntitlements, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetLastRedeemedEntitlementsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyLastRedeemedEntitlementByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetEntitlementsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetEntitlementsByNameCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyEntitlementByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyEntitlementByNameAndIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyEntitlementById, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetOfferCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyOfferByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyOfferById, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetOfferItemCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyOfferItemByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyItemById, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetOfferImageInfoCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyOfferImageInfoByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetItemImageInfoCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyItemImageInfoByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetItemReleaseCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyItemReleaseByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_GetTransactionCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyTransactionByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CopyTransactionById, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_Transaction_GetTransactionId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_Transaction_GetEntitlementsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_Transaction_CopyEntitlementByIndex, EOS_FUNCTION_LAZY)
+
+// eos_ecom_types.h
+EOS_FUNCTION(EOS_Ecom_Entitlement_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CatalogItem_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CatalogOffer_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_KeyImageInfo_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_CatalogRelease_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Ecom_Transaction_Release, EOS_FUNCTION_LAZY)
+
+// eos_friends.h
+EOS_FUNCTION(EOS_Friends_QueryFriends, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_SendInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_AcceptInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_RejectInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_GetFriendsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_GetFriendAtIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_GetStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_AddNotifyFriendsUpdate, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_RemoveNotifyFriendsUpdate, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_GetBlockedUsersCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_GetBlockedUserAtIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_AddNotifyBlockedUsersUpdate, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Friends_RemoveNotifyBlockedUsersUpdate, EOS_FUNCTION_LAZY)
+
+// eos_init.h
+EOS_FUNCTION(EOS_Initialize, EOS_FUNCTION_REQUIRED)
+EOS_FUNCTION(EOS_Shutdown, EOS_FUNCTION_REQUIRED)
+EOS_FUNCTION(EOS_Platform_Create, EOS_FUNCTION_REQUIRED)
+EOS_FUNCTION(EOS_Platform_Release, EOS_FUNCTION_REQUIRED)
+
+// eos_integratedplatform.h
+EOS_FUNCTION(EOS_IntegratedPlatformOptionsContainer_Add, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_IntegratedPlatform_SetUserLoginStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_IntegratedPlatform_AddNotifyUserLoginStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_IntegratedPlatform_RemoveNotifyUserLoginStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_IntegratedPlatform_SetUserPreLogoutCallback, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_IntegratedPlatform_ClearUserPreLogoutCallback, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_IntegratedPlatform_FinalizeDeferredUserLogout, EOS_FUNCTION_LAZY)
+
+// eos_integratedplatform_types.h
+EOS_FUNCTION(EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_IntegratedPlatformOptionsContainer_Release, EOS_FUNCTION_LAZY)
+
+// eos_kws.h
+EOS_FUNCTION(EOS_KWS_QueryAgeGate, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_CreateUser, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_QueryPermissions, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_UpdateParentEmail, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_RequestPermissions, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_GetPermissionsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_CopyPermissionByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_GetPermissionByKey, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_AddNotifyPermissionsUpdateReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_KWS_RemoveNotifyPermissionsUpdateReceived, EOS_FUNCTION_LAZY)
+
+// eos_kws_types.h
+EOS_FUNCTION(EOS_KWS_PermissionStatus_Release, EOS_FUNCTION_LAZY)
+
+// eos_leaderboards.h
+EOS_FUNCTION(EOS_Leaderboards_QueryLeaderboardDefinitions, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_GetLeaderboardDefinitionCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_CopyLeaderboardDefinitionByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_CopyLeaderboardDefinitionByLeaderboardId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_QueryLeaderboardRanks, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_GetLeaderboardRecordCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_CopyLeaderboardRecordByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_CopyLeaderboardRecordByUserId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_QueryLeaderboardUserScores, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_GetLeaderboardUserScoreCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_CopyLeaderboardUserScoreByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_CopyLeaderboardUserScoreByUserId, EOS_FUNCTION_LAZY)
+
+// eos_leaderboards_types.h
+EOS_FUNCTION(EOS_Leaderboards_Definition_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_LeaderboardUserScore_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Leaderboards_LeaderboardRecord_Release, EOS_FUNCTION_LAZY)
+
+// eos_leaderboards_types_deprecated.inl
+EOS_FUNCTION(EOS_Leaderboards_LeaderboardDefinition_Release, EOS_FUNCTION_LAZY)
+
+// eos_lobby.h
+EOS_FUNCTION(EOS_Lobby_CreateLobby, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_DestroyLobby, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_JoinLobby, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_JoinLobbyById, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_LeaveLobby, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_UpdateLobbyModification, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_UpdateLobby, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_PromoteMember, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_KickMember, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_HardMuteMember, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyLobbyUpdateReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyLobbyUpdateReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyLobbyMemberUpdateReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyLobbyMemberUpdateReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyLobbyMemberStatusReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyLobbyMemberStatusReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_SendInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RejectInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_QueryInvites, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_GetInviteCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_GetInviteIdByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_CreateLobbySearch, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyLobbyInviteReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyLobbyInviteReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyLobbyInviteAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyLobbyInviteAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyLobbyInviteRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyLobbyInviteRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyJoinLobbyAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyJoinLobbyAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifySendLobbyNativeInviteRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifySendLobbyNativeInviteRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_CopyLobbyDetailsHandleByInviteId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_CopyLobbyDetailsHandleByUiEventId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_CopyLobbyDetailsHandle, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_GetRTCRoomName, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_IsRTCRoomConnected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyRTCRoomConnectionChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyRTCRoomConnectionChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_GetConnectString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_ParseConnectString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_AddNotifyLeaveLobbyRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_RemoveNotifyLeaveLobbyRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_SetBucketId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_SetPermissionLevel, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_SetMaxMembers, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_SetInvitesAllowed, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_AddAttribute, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_RemoveAttribute, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_AddMemberAttribute, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_RemoveMemberAttribute, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyModification_SetAllowedPlatformIds, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_GetLobbyOwner, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_CopyInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_CopyMemberInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_GetAttributeCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_CopyAttributeByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_CopyAttributeByKey, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_GetMemberCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_GetMemberByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_GetMemberAttributeCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_CopyMemberAttributeByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_CopyMemberAttributeByKey, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_Find, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_SetLobbyId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_SetTargetUserId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_SetParameter, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_RemoveParameter, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_SetMaxResults, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_GetSearchResultCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_CopySearchResultByIndex, EOS_FUNCTION_LAZY)
+
+// eos_lobby_types.h
+EOS_FUNCTION(EOS_LobbyModification_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbySearch_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_Info_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Lobby_Attribute_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_LobbyDetails_MemberInfo_Release, EOS_FUNCTION_LAZY)
+
+// eos_logging.h
+EOS_FUNCTION(EOS_Logging_SetCallback, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Logging_SetLogLevel, EOS_FUNCTION_LAZY)
+
+// eos_metrics.h
+EOS_FUNCTION(EOS_Metrics_BeginPlayerSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Metrics_EndPlayerSession, EOS_FUNCTION_LAZY)
+
+// eos_mods.h
+EOS_FUNCTION(EOS_Mods_InstallMod, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Mods_UninstallMod, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Mods_EnumerateMods, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Mods_CopyModInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Mods_UpdateMod, EOS_FUNCTION_LAZY)
+
+// eos_mods_types.h
+EOS_FUNCTION(EOS_Mods_ModInfo_Release, EOS_FUNCTION_LAZY)
+
+// eos_p2p.h
+EOS_FUNCTION(EOS_P2P_SendPacket, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_GetNextReceivedPacketSize, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_ReceivePacket, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_AddNotifyPeerConnectionRequest, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_RemoveNotifyPeerConnectionRequest, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_AddNotifyPeerConnectionEstablished, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_RemoveNotifyPeerConnectionEstablished, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_AddNotifyPeerConnectionInterrupted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_RemoveNotifyPeerConnectionInterrupted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_AddNotifyPeerConnectionClosed, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_RemoveNotifyPeerConnectionClosed, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_AcceptConnection, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_CloseConnection, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_CloseConnections, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_QueryNATType, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_GetNATType, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_SetRelayControl, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_GetRelayControl, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_SetPortRange, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_GetPortRange, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_SetPacketQueueSize, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_GetPacketQueueInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_AddNotifyIncomingPacketQueueFull, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_RemoveNotifyIncomingPacketQueueFull, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_P2P_ClearPacketQueue, EOS_FUNCTION_LAZY)
+
+// eos_playerdatastorage.h
+EOS_FUNCTION(EOS_PlayerDataStorage_QueryFile, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_QueryFileList, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_CopyFileMetadataByFilename, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_GetFileMetadataCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_CopyFileMetadataAtIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_DuplicateFile, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_DeleteFile, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_ReadFile, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_WriteFile, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorage_DeleteCache, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorageFileTransferRequest_GetFileRequestState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorageFileTransferRequest_GetFilename, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorageFileTransferRequest_CancelRequest, EOS_FUNCTION_LAZY)
+
+// eos_playerdatastorage_types.h
+EOS_FUNCTION(EOS_PlayerDataStorage_FileMetadata_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PlayerDataStorageFileTransferRequest_Release, EOS_FUNCTION_LAZY)
+
+// eos_presence.h
+EOS_FUNCTION(EOS_Presence_QueryPresence, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_HasPresence, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_CopyPresence, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_CreatePresenceModification, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_SetPresence, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_AddNotifyOnPresenceChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_RemoveNotifyOnPresenceChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_AddNotifyJoinGameAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_RemoveNotifyJoinGameAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Presence_GetJoinInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PresenceModification_SetStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PresenceModification_SetRawRichText, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PresenceModification_SetData, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PresenceModification_DeleteData, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PresenceModification_SetJoinInfo, EOS_FUNCTION_LAZY)
+
+// eos_presence_types.h
+EOS_FUNCTION(EOS_Presence_Info_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_PresenceModification_Release, EOS_FUNCTION_LAZY)
+
+// eos_progressionsnapshot.h
+EOS_FUNCTION(EOS_ProgressionSnapshot_BeginSnapshot, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ProgressionSnapshot_AddProgression, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ProgressionSnapshot_SubmitSnapshot, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ProgressionSnapshot_EndSnapshot, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ProgressionSnapshot_DeleteSnapshot, EOS_FUNCTION_LAZY)
+
+// eos_reports.h
+EOS_FUNCTION(EOS_Reports_SendPlayerBehaviorReport, EOS_FUNCTION_LAZY)
+
+// eos_rtc.h
+EOS_FUNCTION(EOS_RTC_GetAudioInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_GetDataInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_JoinRoom, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_LeaveRoom, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_BlockParticipant, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_AddNotifyDisconnected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_RemoveNotifyDisconnected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_AddNotifyParticipantStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_RemoveNotifyParticipantStatusChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_SetSetting, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_SetRoomSetting, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_AddNotifyRoomStatisticsUpdated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTC_RemoveNotifyRoomStatisticsUpdated, EOS_FUNCTION_LAZY)
+
+// eos_rtc_admin.h
+EOS_FUNCTION(EOS_RTCAdmin_QueryJoinRoomToken, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAdmin_CopyUserTokenByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAdmin_CopyUserTokenByUserId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAdmin_Kick, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAdmin_SetParticipantHardMute, EOS_FUNCTION_LAZY)
+
+// eos_rtc_admin_types.h
+EOS_FUNCTION(EOS_RTCAdmin_UserToken_Release, EOS_FUNCTION_LAZY)
+
+// eos_rtc_audio.h
+EOS_FUNCTION(EOS_RTCAudio_SendAudio, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_UpdateSending, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_UpdateReceiving, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_UpdateSendingVolume, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_UpdateReceivingVolume, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_UpdateParticipantVolume, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_AddNotifyParticipantUpdated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RemoveNotifyParticipantUpdated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_AddNotifyAudioDevicesChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RemoveNotifyAudioDevicesChanged, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_AddNotifyAudioInputState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RemoveNotifyAudioInputState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_AddNotifyAudioOutputState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RemoveNotifyAudioOutputState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_AddNotifyAudioBeforeSend, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RemoveNotifyAudioBeforeSend, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_AddNotifyAudioBeforeRender, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RemoveNotifyAudioBeforeRender, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RegisterPlatformUser, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_UnregisterPlatformUser, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_QueryInputDevicesInformation, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_GetInputDevicesCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_CopyInputDeviceInformationByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_QueryOutputDevicesInformation, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_GetOutputDevicesCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_CopyOutputDeviceInformationByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_SetInputDeviceSettings, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_SetOutputDeviceSettings, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_RegisterPlatformAudioUser, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_UnregisterPlatformAudioUser, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_GetAudioInputDevicesCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_GetAudioInputDeviceByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_GetAudioOutputDevicesCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_GetAudioOutputDeviceByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_SetAudioInputSettings, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_SetAudioOutputSettings, EOS_FUNCTION_LAZY)
+
+// eos_rtc_audio_types.h
+EOS_FUNCTION(EOS_RTCAudio_InputDeviceInformation_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCAudio_OutputDeviceInformation_Release, EOS_FUNCTION_LAZY)
+
+// eos_rtc_data.h
+EOS_FUNCTION(EOS_RTCData_AddNotifyDataReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCData_RemoveNotifyDataReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCData_SendData, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCData_UpdateSending, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCData_UpdateReceiving, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCData_AddNotifyParticipantUpdated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_RTCData_RemoveNotifyParticipantUpdated, EOS_FUNCTION_LAZY)
+
+// eos_sanctions.h
+EOS_FUNCTION(EOS_Sanctions_QueryActivePlayerSanctions, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sanctions_GetPlayerSanctionCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sanctions_CopyPlayerSanctionByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sanctions_CreatePlayerSanctionAppeal, EOS_FUNCTION_LAZY)
+
+// eos_sanctions_types.h
+EOS_FUNCTION(EOS_Sanctions_PlayerSanction_Release, EOS_FUNCTION_LAZY)
+
+// eos_sdk.h
+EOS_FUNCTION(EOS_Platform_Tick, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetMetricsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetAuthInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetConnectInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetEcomInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetUIInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetFriendsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetPresenceInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetSessionsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetLobbyInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetUserInfoInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetP2PInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetRTCInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetRTCAdminInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetPlayerDataStorageInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetTitleStorageInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetAchievementsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetStatsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetLeaderboardsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetModsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetAntiCheatClientInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetAntiCheatServerInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetProgressionSnapshotInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetReportsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetSanctionsInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetKWSInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetCustomInvitesInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetIntegratedPlatformInterface, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetActiveCountryCode, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetActiveLocaleCode, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetOverrideCountryCode, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetOverrideLocaleCode, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_SetOverrideCountryCode, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_SetOverrideLocaleCode, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_CheckForLauncherAndRestart, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetDesktopCrossplayStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_SetApplicationStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetApplicationStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_SetNetworkStatus, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Platform_GetNetworkStatus, EOS_FUNCTION_LAZY)
+
+// eos_sessions.h
+EOS_FUNCTION(EOS_Sessions_CreateSessionModification, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_UpdateSessionModification, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_UpdateSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_DestroySession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_JoinSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_StartSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_EndSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RegisterPlayers, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_UnregisterPlayers, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_SendInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RejectInvite, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_QueryInvites, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_GetInviteCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_GetInviteIdByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_CreateSessionSearch, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_CopyActiveSessionHandle, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_AddNotifySessionInviteReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RemoveNotifySessionInviteReceived, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_AddNotifySessionInviteAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RemoveNotifySessionInviteAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_AddNotifySessionInviteRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RemoveNotifySessionInviteRejected, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_AddNotifyJoinSessionAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RemoveNotifyJoinSessionAccepted, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_CopySessionHandleByInviteId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_CopySessionHandleByUiEventId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_CopySessionHandleForPresence, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_IsUserInSession, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_DumpSessionState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_AddNotifyLeaveSessionRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RemoveNotifyLeaveSessionRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_AddNotifySendSessionNativeInviteRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Sessions_RemoveNotifySendSessionNativeInviteRequested, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_SetBucketId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_SetHostAddress, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_SetPermissionLevel, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_SetJoinInProgressAllowed, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_SetMaxPlayers, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_SetInvitesAllowed, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_SetAllowedPlatformIds, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_AddAttribute, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionModification_RemoveAttribute, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ActiveSession_CopyInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ActiveSession_GetRegisteredPlayerCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ActiveSession_GetRegisteredPlayerByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionDetails_CopyInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionDetails_GetSessionAttributeCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionDetails_CopySessionAttributeByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionDetails_CopySessionAttributeByKey, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_SetSessionId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_SetTargetUserId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_SetParameter, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_RemoveParameter, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_SetMaxResults, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_Find, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_GetSearchResultCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_CopySearchResultByIndex, EOS_FUNCTION_LAZY)
+
+// eos_sessions_types.h
+EOS_FUNCTION(EOS_SessionModification_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ActiveSession_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionDetails_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionSearch_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionDetails_Attribute_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_SessionDetails_Info_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ActiveSession_Info_Release, EOS_FUNCTION_LAZY)
+
+// eos_stats.h
+EOS_FUNCTION(EOS_Stats_IngestStat, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Stats_QueryStats, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Stats_GetStatsCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Stats_CopyStatByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_Stats_CopyStatByName, EOS_FUNCTION_LAZY)
+
+// eos_stats_types.h
+EOS_FUNCTION(EOS_Stats_Stat_Release, EOS_FUNCTION_LAZY)
+
+// eos_titlestorage.h
+EOS_FUNCTION(EOS_TitleStorage_QueryFile, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorage_QueryFileList, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorage_CopyFileMetadataByFilename, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorage_GetFileMetadataCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorage_CopyFileMetadataAtIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorage_ReadFile, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorage_DeleteCache, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorageFileTransferRequest_GetFileRequestState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorageFileTransferRequest_GetFilename, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorageFileTransferRequest_CancelRequest, EOS_FUNCTION_LAZY)
+
+// eos_titlestorage_types.h
+EOS_FUNCTION(EOS_TitleStorage_FileMetadata_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_TitleStorageFileTransferRequest_Release, EOS_FUNCTION_LAZY)
+
+// eos_types.h
+EOS_FUNCTION(EOS_EApplicationStatus_ToString, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_ENetworkStatus_ToString, EOS_FUNCTION_LAZY)
+
+// eos_ui.h
+EOS_FUNCTION(EOS_UI_ShowFriends, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_HideFriends, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_GetFriendsVisible, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_GetFriendsExclusiveInput, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_AddNotifyDisplaySettingsUpdated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_RemoveNotifyDisplaySettingsUpdated, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_SetToggleFriendsKey, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_GetToggleFriendsKey, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_IsValidKeyCombination, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_SetToggleFriendsButton, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_GetToggleFriendsButton, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_IsValidButtonCombination, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_SetDisplayPreference, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_GetNotificationLocationPreference, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_AcknowledgeEventId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_ReportInputState, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_PrePresent, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_ShowBlockPlayer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_ShowReportPlayer, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_PauseSocialOverlay, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_IsSocialOverlayPaused, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_AddNotifyMemoryMonitor, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_RemoveNotifyMemoryMonitor, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UI_ShowNativeProfile, EOS_FUNCTION_LAZY)
+
+// eos_userinfo.h
+EOS_FUNCTION(EOS_UserInfo_QueryUserInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_QueryUserInfoByDisplayName, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_QueryUserInfoByExternalAccount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_CopyUserInfo, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_GetExternalUserInfoCount, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_CopyExternalUserInfoByIndex, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_CopyExternalUserInfoByAccountType, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_CopyExternalUserInfoByAccountId, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_CopyBestDisplayName, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_CopyBestDisplayNameWithPlatform, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_GetLocalPlatformType, EOS_FUNCTION_LAZY)
+
+// eos_userinfo_types.h
+EOS_FUNCTION(EOS_UserInfo_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_ExternalUserInfo_Release, EOS_FUNCTION_LAZY)
+EOS_FUNCTION(EOS_UserInfo_BestDisplayName_Release, EOS_FUNCTION_LAZY)
+
+// eos_version.h
+EOS_FUNCTION(EOS_GetVersion, EOS_FUNCTION_LAZY)
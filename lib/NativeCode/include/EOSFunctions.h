@@ -0,0 +1,105 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+
+#if PLATFORM_WINDOWS
+#include "Windows/eos_Windows_base.h"
+#endif
+#include "EOSFunctionHeaders.inl"
+
+//-------------------------------------------------------------------------
+// Every function the EOS SDK headers declare, as a struct of typed
+// function pointers that native code calls through instead of keeping its
+// own GetProcAddress/dlsym globals. The list is generated into
+// EOSFunctionTable.inl by tools/GenerateEOSFunctionTable.cpp; the types
+// come from the SDK headers themselves, so a signature change in an SDK
+// update is a compile error rather than a bad call.
+//
+// eos_functions::resolve fills the struct in one pass from a loaded SDK
+// library. The few functions the bootstrap can't do without are
+// EOS_FUNCTION_REQUIRED and looked up there and then. The rest are
+// EOS_FUNCTION_LAZY: their members point at a thunk that looks the
+// function up the first time it's called and caches it, so startup only
+// pays for what it uses. A lazy function the library doesn't have returns
+// EOS_NotImplemented, a null handle or zero, as suits its return type.
+enum EOSFunctionBinding : uint32_t
+{
+    EOS_FUNCTION_REQUIRED = 0,
+    EOS_FUNCTION_LAZY = 1,
+};
+
+// How eos_functions::resolve treats EOS_FUNCTION_LAZY entries
+enum EOSFunctionResolveMode : uint32_t
+{
+    EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL = 0,
+    EOS_FUNCTIONS_RESOLVE_UP_FRONT = 1,
+};
+
+enum class EOSFunctionId : uint32_t
+{
+#define EOS_FUNCTION(name, binding) name,
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+};
+
+struct EOSFunctionDescriptor
+{
+    const char *name;
+    // What 32 bit Windows decorates the __stdcall name with: _name@bytes
+    uint32_t stdcall_argument_bytes;
+    EOSFunctionBinding binding;
+};
+
+struct EOSFunctions
+{
+#define EOS_FUNCTION(name, binding) decltype(&::name) name;
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+};
+
+namespace eos_functions
+{
+    namespace detail
+    {
+        // Arguments are pushed in 4 byte slots
+        template<typename Result, typename... Arguments>
+        constexpr uint32_t stdcall_argument_bytes(Result (EOS_CALL *)(Arguments...))
+        {
+            return (0u + ... + static_cast<uint32_t>((sizeof(Arguments) + 3) & ~static_cast<size_t>(3)));
+        }
+    }
+
+    // Indexed by EOSFunctionId
+    inline constexpr EOSFunctionDescriptor descriptors[] =
+    {
+#define EOS_FUNCTION(name, binding) { #name, detail::stdcall_argument_bytes(static_cast<decltype(&::name)>(nullptr)), binding },
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+    };
+
+    inline constexpr size_t function_count = sizeof(descriptors) / sizeof(descriptors[0]);
+
+    // GetProcAddress or dlsym, or something that wraps them
+    typedef void *(*LoadFunction)(void *library_handle, const char *function_name);
+
+    constexpr const EOSFunctionDescriptor& descriptor(EOSFunctionId id)
+    {
+        return descriptors[static_cast<size_t>(id)];
+    }
+
+    // Fills out_functions from library_handle, which must stay loaded for as
+    // long as they're called. Returns false if a required function is
+    // missing, naming it in out_missing_name when that isn't null; lazy
+    // functions are then left alone too. Resolving again, for another
+    // library, starts over.
+    bool resolve(void *library_handle, LoadFunction load_function, EOSFunctionResolveMode mode, EOSFunctions *out_functions, const char **out_missing_name = nullptr);
+
+    // Whether the library resolved from has the function. Looks a lazy
+    // function up if it hasn't been called yet.
+    bool is_available(EOSFunctionId id);
+
+    // Forgets the library, before it's unloaded. Lazy functions that
+    // haven't been looked up yet stay missing until the next resolve, so
+    // nothing may call through the struct while this runs.
+    void reset();
+}
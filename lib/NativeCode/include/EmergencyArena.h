@@ -0,0 +1,46 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+#include <atomic>
+
+//-------------------------------------------------------------------------
+// A fixed block of memory, committed up front, that Memory.cpp allocates
+// from once the hard memory budget has been reached (see MemoryBudget.h).
+//
+// Blocks carry a 16 byte boundary tag so that neighbours can be coalesced
+// on free, and free blocks are kept on a single first fit list behind a
+// mutex. That's slow next to the regular backends, but the arena is only
+// meant to carry the process until memory is released.
+namespace emergency_arena
+{
+    namespace detail
+    {
+        extern std::atomic<uintptr_t> begin;
+        extern std::atomic<uintptr_t> end;
+    }
+
+    // Commits capacity_in_bytes for the arena, replacing any previous one;
+    // 0 releases it. Fails while any block is still allocated.
+    bool reserve(size_t capacity_in_bytes);
+
+    // Returns nullptr when there's no room
+    void * alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+
+    // Only valid for pointers where owns() is true. Returns nullptr and
+    // leaves the block alone when there's no room.
+    void * realloc(void *pointer, size_t size_in_bytes, size_t alignment_in_bytes);
+
+    void free(void *pointer);
+
+    // Lock free; safe to call on any pointer
+    inline bool owns(const void *pointer)
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+        return address >= detail::begin.load(std::memory_order_relaxed) && address < detail::end.load(std::memory_order_relaxed);
+    }
+
+    size_t block_size(const void *pointer);
+
+    // Used bytes include each block's header and padding
+    void usage(int64_t *out_capacity, int64_t *out_used, int64_t *out_peak);
+}
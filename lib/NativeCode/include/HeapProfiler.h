@@ -0,0 +1,76 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <atomic>
+
+//-------------------------------------------------------------------------
+// Sampling heap profiler behind the Mem_generic_* hooks.
+//
+// Allocations are sampled as a Poisson process over bytes allocated, the
+// way tcmalloc does it: each thread counts down an exponentially
+// distributed number of bytes, with a mean of the sample interval, and the
+// allocation that crosses zero has its backtrace recorded. Sampled blocks
+// are flagged in the allocation tracker, so frees only reach the profiler
+// for blocks that were actually sampled.
+//
+// When the interval is 0, the only cost per allocation is one relaxed load.
+#define HEAP_PROFILER_MAX_FRAMES 32
+
+// The interval tcmalloc defaults to; a handful of samples per MiB
+#define HEAP_PROFILER_DEFAULT_SAMPLE_INTERVAL (512 * 1024)
+
+enum class HeapProfileFormat : int32_t
+{
+    // Legacy text heap profile read by pprof ("heap_v2")
+    Pprof = 0,
+    // One "outermost;...;innermost bytes" line per stack, for flamegraph.pl
+    // and speedscope
+    CollapsedStacks = 1,
+};
+
+namespace heap_profiler
+{
+    namespace detail
+    {
+        extern std::atomic<uint64_t> sample_interval;
+    }
+
+    // 0 turns sampling off. Samples already taken are kept until their
+    // blocks are freed.
+    void set_sample_interval(uint64_t interval_in_bytes);
+
+    inline bool is_enabled()
+    {
+        return detail::sample_interval.load(std::memory_order_relaxed) != 0;
+    }
+
+    // Counts size_in_bytes against the calling thread's countdown. Only
+    // call when is_enabled().
+    bool should_sample(size_t size_in_bytes);
+
+    // Records a backtrace for a block should_sample() picked
+    void record_sample(void *pointer, size_t size_in_bytes);
+
+    void remove_sample(void *pointer);
+
+    size_t live_sample_count();
+
+    // Estimated live bytes and blocks, grouped by allocation stack
+    bool write_profile(FILE *file, HeapProfileFormat format);
+}
+
+// Implemented per platform
+namespace platform
+{
+    // Return addresses of the calling thread's stack, innermost first,
+    // leaving out the skip_count innermost frames
+    int capture_backtrace(void **frames, int max_frames, int skip_count);
+
+    // Human readable name for a code address, e.g. "module!symbol"
+    void describe_address(const void *address, char *buffer, size_t buffer_size);
+
+    // Appends the process memory map in the form pprof expects after a
+    // "MAPPED_LIBRARIES:" line. Does nothing where there isn't one.
+    void write_mapped_libraries(FILE *file);
+}
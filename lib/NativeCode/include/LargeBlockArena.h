@@ -0,0 +1,80 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+#include <atomic>
+
+// Granularity of the arena's blocks; it's also the most alignment a block
+// is guaranteed
+#define LARGE_BLOCK_ARENA_PAGE_SIZE (64 * 1024)
+
+//-------------------------------------------------------------------------
+// Where Memory.cpp sends allocations of at least a threshold size, such as
+// the SDK's RTC audio buffers, P2P packet queues and storage transfer
+// buffers. Plain allocations that size each get a private mapping that is
+// unmapped again on free, so every new buffer pays for its page faults and
+// is spread over 4 KiB pages.
+//
+// The arena is one reservation of address space that is committed in
+// huge page sized units as it's used (see platform::commit_pages) and kept
+// committed, so a freed buffer's pages are reused by the next one. Blocks
+// are runs of LARGE_BLOCK_ARENA_PAGE_SIZE pages, carved from the front of
+// the reservation or from size binned free lists, and neighbouring free
+// runs are coalesced. Everything is behind one mutex, which is fine for
+// allocations this size.
+namespace large_block_arena
+{
+    namespace detail
+    {
+        extern std::atomic<uintptr_t> begin;
+        extern std::atomic<uintptr_t> end;
+        extern std::atomic<size_t> threshold;
+    }
+
+    struct Usage
+    {
+        int64_t committed_in_bytes;
+        int64_t used_in_bytes;
+        int64_t peak_used_in_bytes;
+        // The part of committed_in_bytes that is certainly huge pages
+        int64_t explicit_huge_page_in_bytes;
+        uint64_t alloc_count;
+    };
+
+    // Reserves capacity_in_bytes of address space and sends allocations of
+    // threshold_in_bytes or more to it. A threshold or capacity of 0 turns
+    // the arena off. Fails while any block is still allocated.
+    bool configure(size_t threshold_in_bytes, size_t capacity_in_bytes);
+
+    // Lock free
+    inline bool wants(size_t size_in_bytes)
+    {
+        const size_t threshold = detail::threshold.load(std::memory_order_relaxed);
+        return threshold != 0 && size_in_bytes >= threshold;
+    }
+
+    // Returns nullptr when the arena is full or alignment_in_bytes is more
+    // than LARGE_BLOCK_ARENA_PAGE_SIZE
+    void * alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+
+    // Only valid for pointers where owns() is true. Resizes the block where
+    // it is, or returns nullptr and leaves it alone if that isn't possible.
+    void * realloc_in_place(void *pointer, size_t size_in_bytes);
+
+    void free(void *pointer);
+
+    // Lock free; safe to call on any pointer
+    inline bool owns(const void *pointer)
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+        return address >= detail::begin.load(std::memory_order_relaxed) && address < detail::end.load(std::memory_order_relaxed);
+    }
+
+    // Whole pages, so it may be more than was asked for
+    size_t block_size(const void *pointer);
+
+    // Decommits every huge page unit that no block uses. Returns the bytes
+    // released.
+    size_t trim();
+
+    void usage(Usage *out_usage);
+}
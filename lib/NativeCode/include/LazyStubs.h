@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+
+//-------------------------------------------------------------------------
+// Function pointers that stand in for a library function until it's first
+// called, so that binding hundreds of functions up front doesn't pay for
+// looking up the ones that are never used.
+//
+// Each stub is a few instructions that jump through a slot of their own.
+// The slot starts out pointing at a shared resolver, which saves the
+// argument registers, looks the function up, stores it in the slot and
+// jumps to it with the arguments as they were. Every later call goes
+// straight through the slot, so the stub works for any signature and
+// costs one indirect jump. The code pages are never writable once the
+// stubs are written; only the slots change.
+//
+// Stubs exist for x86-64 ELF only. Elsewhere is_supported is false and
+// callers look functions up straight away instead.
+namespace lazy_stubs
+{
+    // Looks the function up for real; dlsym, or something that wraps it
+    typedef void *(*ResolveFunction)(void *library_handle, const char *function_name);
+
+    struct StubArena;
+
+    bool is_supported();
+
+    // Returns null if stubs aren't supported or there's no memory
+    StubArena * create_arena(ResolveFunction resolve_function);
+
+    // Unmaps every stub the arena made, so none of them may be called again
+    void destroy_arena(StubArena *arena);
+
+    // Returns a stub for function_name in library_handle, or null if there's
+    // no memory. Each call makes a new stub. Calling a stub for a function
+    // the library doesn't have aborts, naming the function on stderr, so
+    // only hand out stubs for functions that must be there. Calls for the
+    // same arena have to be serialized; calls through the stubs don't.
+    void * make_stub(StubArena *arena, void *library_handle, const char *function_name);
+
+    // Stubs that have been called at least once
+    size_t resolved_count(const StubArena *arena);
+
+    struct ArenaDeleter
+    {
+        void operator()(StubArena *arena) const
+        {
+            destroy_arena(arena);
+        }
+    };
+}
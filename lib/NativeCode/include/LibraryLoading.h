@@ -0,0 +1,32 @@
+#pragma once
+#include <stddef.h>
+
+struct DLLHContext;
+
+//-------------------------------------------------------------------------
+// What the DLLH exports for loading a library in the background and for
+// looking up many functions at once have in common across platforms.
+// Each platform passes in its own way of loading a library or a function
+// through its context.
+namespace library_loading
+{
+    typedef void * (*LoadLibraryFunction)(DLLHContext *ctx, const char *library_path);
+    typedef void * (*LoadFunctionFunction)(DLLHContext *ctx, void *library_handle, const char *function);
+
+    // Starts load_library(ctx, library_path) on a worker thread. Returns a
+    // ticket that has to be passed to wait exactly once, before the context
+    // is destroyed, or null if no thread could be started.
+    void * load_async(DLLHContext *ctx, const char *library_path, LoadLibraryFunction load_library);
+
+    // True once wait would return without blocking
+    bool poll(void *ticket);
+
+    // Blocks until the load behind ticket is done, then frees the ticket and
+    // returns what load_library did
+    void * wait(void *ticket);
+
+    // Looks up each of function_names with load_function, null names and
+    // functions that aren't found being null in out_functions. Returns how
+    // many were found.
+    size_t load_functions(DLLHContext *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count, LoadFunctionFunction load_function);
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <atomic>
+
+//-------------------------------------------------------------------------
+// Timings of the dynamic loader calls DLLH makes, and the last loader
+// error seen by each thread, for finding out where startup time goes
+// without redirecting stdout.
+//
+// Recording is off until asked for. Once on, every dlopen, dlsym and
+// dlclose goes into a fixed size ring buffer, so that a long session keeps
+// the most recent DLLH_LOADER_TRACE_CAPACITY calls. Errors are kept
+// whether or not recording is on.
+//
+// The structs here are handed to managed code through
+// DLLH_query_loader_info, so their layout is part of the API.
+#define DLLH_LOADER_INFO_API_LATEST 1
+
+// Must be a power of two
+#define DLLH_LOADER_TRACE_CAPACITY 4096
+
+// Longer names and messages are cut short
+#define DLLH_LOADER_NAME_LENGTH 96
+#define DLLH_LOADER_MESSAGE_LENGTH 256
+#define DLLH_LOADER_PATH_LENGTH 256
+
+enum DLLHLoaderOperation : uint32_t
+{
+    DLLH_LOADER_OPEN = 0,
+    DLLH_LOADER_SYMBOL = 1,
+    DLLH_LOADER_CLOSE = 2,
+};
+
+struct DLLHLoaderEvent
+{
+    // Since the helper was loaded
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint64_t thread_id;
+    uint64_t handle;
+    uint32_t operation;
+    uint32_t succeeded;
+    // Library path for opens, function name for symbols, empty for closes
+    char name[DLLH_LOADER_NAME_LENGTH];
+};
+
+struct DLLHLoaderError
+{
+    uint64_t handle;
+    uint32_t operation;
+    uint32_t reserved;
+    char name[DLLH_LOADER_NAME_LENGTH];
+    // What dlerror said
+    char message[DLLH_LOADER_MESSAGE_LENGTH];
+};
+
+// One loaded library, from the platform's list of loaded images
+struct DLLHModuleInfo
+{
+    uint64_t base_address;
+    // Sum of the library's loadable segments
+    uint64_t mapped_bytes;
+    uint32_t segment_count;
+    uint32_t reserved;
+    char path[DLLH_LOADER_PATH_LENGTH];
+};
+
+// What DLLH_query_loader_info fills the buffer with
+enum DLLHLoaderQuery : int32_t
+{
+    // DLLHLoaderEvents, oldest first
+    DLLH_LOADER_QUERY_EVENTS = 0,
+    // DLLHModuleInfos, in load order
+    DLLH_LOADER_QUERY_MODULES = 1,
+    // One DLLHLoaderError for the calling thread, if it has seen one
+    DLLH_LOADER_QUERY_LAST_ERROR = 2,
+};
+
+static_assert(sizeof(DLLHLoaderEvent) == 136, "DLLHLoaderEvent is part of the managed API");
+static_assert(sizeof(DLLHLoaderError) == 368, "DLLHLoaderError is part of the managed API");
+static_assert(sizeof(DLLHModuleInfo) == 280, "DLLHModuleInfo is part of the managed API");
+
+namespace loader_trace
+{
+    namespace detail
+    {
+        extern std::atomic<bool> recording;
+    }
+
+    void set_recording(bool enabled);
+
+    inline bool is_recording()
+    {
+        return detail::recording.load(std::memory_order_relaxed);
+    }
+
+    // Nanoseconds since the helper was loaded
+    uint64_t now_ns();
+
+    // Only call when is_recording()
+    void record(DLLHLoaderOperation operation, const char *name, const void *handle, uint64_t start_ns, uint64_t end_ns, bool succeeded);
+
+    // Copies up to capacity of the recorded events, oldest first, and
+    // returns how many there are
+    size_t events(DLLHLoaderEvent *out_events, size_t capacity);
+
+    // Replaces the calling thread's last error
+    void set_error(DLLHLoaderOperation operation, const char *name, const void *handle, const char *message);
+
+    // False if the calling thread hasn't seen an error
+    bool last_error(DLLHLoaderError *out_error);
+
+    // The recorded events in the Chrome trace event format, for
+    // chrome://tracing or Perfetto
+    bool write_chrome_trace(FILE *file);
+}
@@ -2,6 +2,10 @@
 #include <stddef.h>
 #include <inttypes.h>
 
+// The huge page size on x86-64 and arm64 Linux, and the unit that
+// platform::commit_pages asks for huge pages in
+#define PLATFORM_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
 // These function need to be implemented on each platform
 namespace platform
 {
@@ -11,9 +15,174 @@ namespace platform
     size_t mem_usable_size(void* pointer);
 
     void free_aligned(void *pointer);
+
+    // Whole pages straight from the OS, for allocator internals such as the
+    // pool's slabs that need a large alignment without paying for it in
+    // padding. alignment_in_bytes must be a power of two.
+    void * alloc_pages(size_t size_in_bytes, size_t alignment_in_bytes);
+    void free_pages(void *pointer, size_t size_in_bytes);
+
+    // Address space with nothing behind it, for allocator internals that
+    // commit memory as they go. alignment_in_bytes must be a power of two.
+    void * reserve_pages(size_t size_in_bytes, size_t alignment_in_bytes);
+    void release_pages(void *pointer, size_t size_in_bytes);
+
+    // Backs part of a reservation with zeroed memory. Ranges that are
+    // multiples of PLATFORM_HUGE_PAGE_SIZE ask for huge pages where the
+    // platform has them; *out_explicit_huge_pages is set when they were
+    // guaranteed rather than just advised.
+    bool commit_pages(void *pointer, size_t size_in_bytes, bool *out_explicit_huge_pages);
+
+    // Hands the memory back to the OS; the range stays reserved
+    void decommit_pages(void *pointer, size_t size_in_bytes);
+
+    // OS level id of the calling thread, as shown by debuggers and profilers
+    uint64_t current_thread_id();
+
+    // Monotonic milliseconds from an arbitrary start, cheap enough to read
+    // on every allocation. Only as fine grained as the scheduler tick.
+    uint64_t coarse_milliseconds();
+
+    // Asks the system allocator to give free memory back to the OS. Returns
+    // the bytes released where the platform reports it, otherwise 0.
+    size_t trim();
 }
 
 struct MemCounters
 {
     int64_t currentMemoryAllocatedInBytes;
 };
+
+// MemCounters was version 1. Version 2 ends at threads; callers built
+// against it are still served.
+#define MEM_COUNTERSEX_API_LATEST 3
+
+// Bucket i of sizeHistogram counts requests of [2^(i-1), 2^i) bytes; bucket
+// 0 counts 0 byte requests and the last bucket everything too big for the rest
+#define MEM_COUNTERS_SIZE_CLASS_COUNT 32
+
+// Threads past the first MEM_COUNTERS_MAX_THREADS - 1 alive at once to
+// allocate share the last entry, which has a threadId of 0. An exited
+// thread's entry is handed on once its blocks have all been freed, and its
+// counts then move to the last entry.
+#define MEM_COUNTERS_MAX_THREADS 32
+
+struct MemThreadCounters
+{
+    uint64_t threadId;
+    // Live bytes allocated by this thread, wherever they end up being freed
+    int64_t currentMemoryAllocatedInBytes;
+    int64_t totalMemoryAllocatedInBytes;
+    uint64_t allocCount;
+};
+
+// Filled in by Mem_GetAllocationCountersEx. Set apiVersion to
+// MEM_COUNTERSEX_API_LATEST before the call. Each field is read without
+// locking, so fields may be a few operations apart from one another.
+struct MemCountersEx
+{
+    int32_t apiVersion;
+    int32_t threadCount;
+    int64_t currentMemoryAllocatedInBytes;
+    int64_t peakMemoryAllocatedInBytes;
+    uint64_t allocCount;
+    uint64_t reallocCount;
+    uint64_t freeCount;
+    uint64_t sizeHistogram[MEM_COUNTERS_SIZE_CLASS_COUNT];
+    MemThreadCounters threads[MEM_COUNTERS_MAX_THREADS];
+
+    // The large block arena, see Mem_SetLargeBlockArena. Its blocks are in
+    // the totals above too; used bytes are whole 64 KiB pages.
+    int64_t largeBlockCommittedInBytes;
+    int64_t largeBlockUsedInBytes;
+    int64_t largeBlockPeakUsedInBytes;
+    // Committed bytes known to be huge pages; the rest were asked for, which
+    // the OS may or may not have honoured
+    int64_t largeBlockExplicitHugePageInBytes;
+    uint64_t largeBlockAllocCount;
+};
+
+// Calling convention of the memory hooks in EOS_InitializeOptions. The
+// FUN_EXPORT functions are __stdcall on Windows, so Mem_GetAllocatorFunctions
+// hands out shims with this convention instead of the exports themselves.
+#if _WIN64 || _WIN32
+#define MEM_EOS_CALL __cdecl
+#else
+#define MEM_EOS_CALL
+#endif
+
+typedef void* (MEM_EOS_CALL *MemAllocateFunc)(size_t size_in_bytes, size_t alignment_in_bytes);
+typedef void* (MEM_EOS_CALL *MemReallocateFunc)(void *pointer, size_t size_in_bytes, size_t alignment_in_bytes);
+typedef void (MEM_EOS_CALL *MemReleaseFunc)(void *pointer);
+
+// Where Mem_generic_align_alloc gets its memory from. Blocks are always
+// released to whichever backend handed them out, so switching is safe, but
+// the backend is meant to be picked once before EOS_Initialize.
+enum class MemAllocatorBackend : int32_t
+{
+    // platform::alloc_aligned and friends
+    System = 0,
+    // Size class slabs from MemoryPool.h, falling back to System for
+    // blocks that are too large to pool
+    Pooled = 1,
+};
+
+#define MEM_BUDGET_STATUS_API_LATEST 1
+
+// Passed to the callback registered with Mem_SetMemoryBudgetCallback
+enum class MemBudgetEvent : int32_t
+{
+    // Fired once each time usage climbs past the soft limit
+    SoftLimitExceeded = 0,
+    // Fired once each time usage climbs past the hard limit; allocations are
+    // served from the emergency arena until usage drops back below it
+    HardLimitExceeded = 1,
+    // Fired for every allocation the emergency arena had no room for
+    EmergencyArenaExhausted = 2,
+};
+
+// Called from Mem_DeliverMemoryBudgetEvents, on whichever thread calls
+// that, rather than from the allocation that crossed the limit.
+// current_bytes is the usage the event was flagged at.
+typedef void (*MemBudgetCallback)(int32_t budget_event, int64_t current_bytes, void *user_data);
+
+// Filled in by Mem_GetMemoryBudgetStatus. Set apiVersion to
+// MEM_BUDGET_STATUS_API_LATEST before the call.
+struct MemBudgetStatus
+{
+    int32_t apiVersion;
+    int32_t isOverSoftLimit;
+    int32_t isOverHardLimit;
+    int32_t reserved;
+    int64_t softLimitInBytes;
+    int64_t hardLimitInBytes;
+    int64_t currentMemoryAllocatedInBytes;
+    int64_t emergencyCapacityInBytes;
+    int64_t emergencyUsedInBytes;
+    int64_t emergencyPeakInBytes;
+    uint64_t softLimitExceededCount;
+    uint64_t hardLimitExceededCount;
+    uint64_t emergencyExhaustedCount;
+};
+
+#define MEM_LIVE_ALLOCATION_API_LATEST 1
+
+// Ages in MemLiveAllocation are in milliseconds
+#define MEM_TICKS_PER_SECOND 1000
+
+// ageInTicks of blocks allocated while Mem_SetAllocationAgeTracking was off
+#define MEM_LIVE_ALLOCATION_AGE_UNKNOWN UINT64_MAX
+
+// One live block, as written out by Mem_SnapshotLiveAllocations
+struct MemLiveAllocation
+{
+    uint64_t address;
+    uint64_t sizeInBytes;
+    // Time since the block was allocated; resizing a block doesn't reset it
+    uint64_t ageInTicks;
+    // OS id of the allocating thread, 0 for threads that had to share the
+    // last MemThreadCounters entry
+    uint64_t threadId;
+    uint32_t alignmentInBytes;
+    uint32_t reserved;
+};
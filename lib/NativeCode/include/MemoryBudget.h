@@ -0,0 +1,63 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+#include <atomic>
+#include "Memory.h"
+
+//-------------------------------------------------------------------------
+// Soft and hard limits on the bytes live through Mem_generic_*.
+//
+// Each allocation reserves its bytes before it's made and is checked
+// against the global byte count the memory counters keep plus everything
+// reserved, so threads allocating at the same time can't take usage past
+// the hard limit between them. The reservation is let go once the
+// allocation is counted.
+//
+// Above the soft limit the registered callback is told once, so that the
+// game can drop caches. Above the hard limit allocations come from the
+// emergency arena (EmergencyArena.h) until usage drops back below it.
+// Without an arena, or once it's full, they fail.
+//
+// The allocator only flags events: it runs on the SDK's threads, maybe
+// with the SDK's locks held, which is no place to call out to the game.
+// They're passed to the callback by deliver_events, from the game's tick.
+namespace memory_budget
+{
+    namespace detail
+    {
+        extern std::atomic<bool> enabled;
+    }
+
+    // 0 turns a limit off. Fails if the arena can't be reserved, or has to
+    // change size while blocks are still allocated from it.
+    bool set_limits(int64_t soft_limit_in_bytes, int64_t hard_limit_in_bytes, size_t emergency_arena_in_bytes);
+
+    void set_callback(MemBudgetCallback callback, void *user_data);
+
+    inline bool is_enabled()
+    {
+        return detail::enabled.load(std::memory_order_relaxed);
+    }
+
+    // Reserves size_in_bytes, or returns false, reserving nothing, when that
+    // many more would go over the hard limit
+    bool admit(size_t size_in_bytes);
+
+    // Lets go of what admit reserved, once the allocation has been counted
+    // or has failed
+    void release_reservation(size_t size_in_bytes);
+
+    // Call after memory has been released, so the limits can be re-armed
+    void on_release();
+
+    // Flags that the emergency arena was out of room
+    void report_exhausted();
+
+    // Passes the events flagged since the last call to the callback, on the
+    // calling thread, and returns how many there were. Each kind of event is
+    // passed once, with the byte count from when it last happened.
+    uint32_t deliver_events();
+
+    // Fills every field except apiVersion
+    void read_status(MemBudgetStatus *out_status);
+}
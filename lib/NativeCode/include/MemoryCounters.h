@@ -0,0 +1,46 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+
+struct MemCountersEx;
+
+//-------------------------------------------------------------------------
+// Statistics behind Mem_GetAllocationCounters(Ex).
+//
+// Totals that every thread updates (current and peak bytes) are relaxed
+// atomics. Everything else is kept per allocating thread, in a cache line
+// aligned slot that thread claims the first time it allocates, so the
+// common case never writes to memory shared with other threads. A slot
+// goes back to a free list when its thread exits, and is handed to another
+// thread once nothing allocated from it is live. Reading the counters sums
+// the slots.
+namespace memory_counters
+{
+    // Slot the calling thread's allocations are attributed to
+    uint32_t current_thread_slot();
+
+    // Bucket of MemCountersEx::sizeHistogram that size_in_bytes goes in
+    uint32_t size_class_for(size_t size_in_bytes);
+
+    void record_alloc(uint32_t thread_slot, size_t size_in_bytes);
+
+    // The new block is attributed to thread_slot; the old one is released
+    // from the slot that allocated it
+    void record_realloc(uint32_t thread_slot, uint32_t old_thread_slot, size_t old_size_in_bytes, size_t size_in_bytes);
+
+    // thread_slot is the slot of the thread that allocated the block
+    void record_free(uint32_t thread_slot, size_t size_in_bytes);
+
+    int64_t current_bytes();
+
+    // OS thread id of the thread that last claimed thread_slot; 0 for the
+    // slot shared by threads that found no other free
+    uint64_t thread_id(uint32_t thread_slot);
+
+    // Allocs, reallocs and frees so far; only useful for noticing activity
+    uint64_t operation_count();
+
+    // Fills the version 2 fields, apart from apiVersion; the large block
+    // arena's are up to the caller
+    void read(MemCountersEx *out_counters);
+}
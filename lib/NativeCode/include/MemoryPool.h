@@ -0,0 +1,57 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+
+//-------------------------------------------------------------------------
+// Size class pool used by the "Pooled" allocator backend in Memory.cpp.
+//
+// Small requests are rounded up to one of a fixed set of size classes and
+// carved out of 64KiB slabs. Each slab holds blocks of a single class and
+// keeps its own free list, so freeing a block never touches the system
+// allocator. Every block is aligned to the largest power of two that divides
+// its class size, which is how requested alignments are honoured.
+//
+// Requests that are too big, or need more alignment than any class offers,
+// are not pooled; alloc() returns nullptr and the caller falls back to the
+// platform:: functions.
+//
+// Each thread keeps a small magazine of free blocks per class in front of
+// the shared slabs, so the common alloc/free pair never takes a lock. Full
+// or empty magazines are exchanged with the slabs in batches. A block may be
+// freed on any thread; it simply lands in that thread's magazine and finds
+// its way back to its slab when the magazine overflows or the thread exits.
+#define MEMORY_POOL_SLAB_SIZE (64 * 1024)
+#define MEMORY_POOL_MAX_BLOCK_SIZE 2048
+
+// Set to 0 to have every pool operation go straight to the shared slabs
+#ifndef MEMORY_POOL_THREAD_CACHE
+#define MEMORY_POOL_THREAD_CACHE 1
+#endif
+
+namespace memory_pool
+{
+    void * alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+
+    // Only valid for pointers where owns() is true
+    void free(void *pointer);
+
+    // Lock free; safe to call on any pointer, including ones from the
+    // system allocator.
+    bool owns(const void *pointer);
+
+    // The usable size of a pooled block, i.e. its class size
+    size_t block_size(const void *pointer);
+
+    // True if a pooled block can be resized to size_in_bytes without moving
+    bool fits_in_place(const void *pointer, size_t size_in_bytes, size_t alignment_in_bytes);
+
+    // Hand every block cached by the calling thread back to the shared slabs.
+    // Happens automatically when a thread exits.
+    void flush_thread_cache();
+
+    // Returns every empty slab to the system, along with the calling
+    // thread's cache. Other threads flush their caches the next time they
+    // use the pool, so a later trim can release what those were holding.
+    // Returns the bytes released.
+    size_t trim();
+}
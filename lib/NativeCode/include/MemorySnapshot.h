@@ -0,0 +1,27 @@
+#pragma once
+#include <stddef.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+struct MemLiveAllocation;
+
+//-------------------------------------------------------------------------
+// Views of the blocks currently held in the allocation tracker, for soak
+// tests and for the leak report written when the plugin is unloaded.
+//
+// Both walk the tracker one shard at a time, so blocks allocated or freed
+// during the walk may or may not be included. Neither allocates through
+// Mem_generic_*, so the walk never shows up in itself.
+#define MEM_LEAK_REPORT_OLDEST_BLOCKS 32
+
+namespace memory_snapshot
+{
+    // Writes up to capacity blocks to out_allocations and returns how many
+    // were live; a larger return than capacity means the rest were dropped
+    size_t live_allocations(MemLiveAllocation *out_allocations, size_t capacity);
+
+    // Live blocks totalled by power of two size class and by allocating
+    // thread, followed by the oldest MEM_LEAK_REPORT_OLDEST_BLOCKS blocks
+    // of those allocated while ages were tracked
+    bool write_leak_report(FILE *file);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+
+//-------------------------------------------------------------------------
+// Hands memory the allocator is holding on to, but not using, back to the
+// OS: empty pool slabs, thread caches, spare tracker capacity, unused
+// large block arena units and whatever the C runtime heap has free. Meant for when the application is suspended
+// or has gone quiet, e.g. an idle dedicated server.
+//
+// Live blocks are never moved, and the emergency arena (EmergencyArena.h)
+// is left committed, since being there when memory is short is its job.
+namespace memory_trim
+{
+    // Returns the bytes released that could be accounted for; what the C
+    // runtime gives back isn't always reported
+    size_t trim();
+
+    // Trims from a background thread once no allocator calls have been made
+    // for idle_timeout_ms, then waits for activity before trimming again.
+    // 0 stops the thread.
+    void set_idle_timeout(uint64_t idle_timeout_ms);
+
+    // How many times the background thread has trimmed
+    uint64_t idle_trim_count();
+}
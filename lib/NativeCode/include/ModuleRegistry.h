@@ -0,0 +1,33 @@
+#pragma once
+#include <stddef.h>
+
+//-------------------------------------------------------------------------
+// Libraries loaded through the POSIX LoadLibrary export, by stem name (the
+// file name up to its last '.'), for GetModuleHandle.
+//
+// Lookups never take a lock: they read an immutable snapshot of the table,
+// which writers replace under a mutex (read-copy-update). A writer only
+// frees the snapshot it replaced once every lookup that could have seen it
+// has finished, using a pair of reader counts that alternate between
+// updates.
+//
+// Each entry holds the handle and the number of LoadLibrary calls that
+// haven't been matched by FreeLibrary. As long as that's above zero the
+// registry holds a loader reference, so a lookup can hand out the handle
+// without asking the loader whether the library is still there.
+namespace module_registry
+{
+    // Records one more reference to the library dlopen returned handle for.
+    // A library with the same stem at a different handle replaces the old
+    // entry, as GetModuleHandle only ever returned the latest.
+    void add(const char *library_path, void *handle);
+
+    // Drops one reference to handle, removing its entry at zero. Returns
+    // false if handle isn't registered.
+    bool release(void *handle);
+
+    // Returns the handle registered for stem, or null
+    void * find(const char *stem);
+
+    size_t module_count();
+}
@@ -0,0 +1,226 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if PLATFORM_WINDOWS
+#include "Windows/eos_Windows_base.h"
+#endif
+#include "eos_sdk.h"
+
+struct json_value_s;
+
+//-------------------------------------------------------------------------
+// What GfxPluginNativeRender does when Unity loads it, before any managed
+// code runs: read the EOS config, load the SDK, initialize it and create
+// the platform, which the managed side then picks up through
+// EOS_GetPlatformInterface.
+//
+// plugin_bootstrap is the same everywhere. What it needs from the OS, such
+// as where this module lives, loading libraries and reading files, comes
+// from bootstrap_platform, which each platform implements in its own file.
+
+#if PLATFORM_WINDOWS
+#if PLATFORM_64BITS
+#define BOOTSTRAP_DLL_PLATFORM "-Win64"
+#define BOOTSTRAP_STEAM_LIBRARY_NAME "steam_api64.dll"
+#define BOOTSTRAP_DLLH_LIBRARY_NAME "DynamicLibraryLoaderHelper-x64.dll"
+#else
+#define BOOTSTRAP_DLL_PLATFORM "-Win32"
+#define BOOTSTRAP_STEAM_LIBRARY_NAME "steam_api.dll"
+#define BOOTSTRAP_DLLH_LIBRARY_NAME "DynamicLibraryLoaderHelper-x86.dll"
+#endif
+#define BOOTSTRAP_SDK_LIBRARY_NAME "EOSSDK" BOOTSTRAP_DLL_PLATFORM "-Shipping.dll"
+#define BOOTSTRAP_OVERLAY_LIBRARY_NAME "EOSOVH" BOOTSTRAP_DLL_PLATFORM "-Shipping.dll"
+#define BOOTSTRAP_XAUDIO2_LIBRARY_NAME "xaudio2_9redist.dll"
+// Built by the editor with the config compiled in, so that it needn't ship
+// as a file
+#define BOOTSTRAP_GENERATED_CONFIG_LIBRARY_NAME "EOSGenerated.dll"
+// From the module, which is in <Game>_Data/Plugins/<arch>
+#define BOOTSTRAP_DATA_DIRECTORY "../.."
+#else
+#define BOOTSTRAP_SDK_LIBRARY_NAME "libEOSSDK-Linux-Shipping.so"
+#define BOOTSTRAP_STEAM_LIBRARY_NAME "libsteam_api.so"
+#define BOOTSTRAP_DLLH_LIBRARY_NAME "libDynamicLibraryLoaderHelper.so"
+// From the module, which is in <Game>_Data/Plugins
+#define BOOTSTRAP_DATA_DIRECTORY ".."
+#endif
+
+#define BOOTSTRAP_SERVICE_CONFIG_FILENAME "EpicOnlineServicesConfig.json"
+#define BOOTSTRAP_STEAM_CONFIG_FILENAME "eos_steam_config.json"
+#define BOOTSTRAP_LOGLEVEL_CONFIG_FILENAME "log_level_config.json"
+
+struct SandboxDeploymentOverride
+{
+    std::string sandboxID;
+    std::string deploymentID;
+};
+
+struct EOSConfig
+{
+    std::string productName;
+    std::string productVersion;
+
+    std::string productID;
+    std::string sandboxID;
+    std::string deploymentID;
+    std::vector<SandboxDeploymentOverride> sandboxDeploymentOverrides;
+
+    std::string clientSecret;
+    std::string clientID;
+    std::string encryptionKey;
+
+    std::string overrideCountryCode;
+    std::string overrideLocaleCode;
+
+    // this is called platformOptionsFlags in C#
+    uint64_t flags = 0;
+
+    uint32_t tickBudgetInMilliseconds = 0;
+    double taskNetworkTimeoutSeconds = 0.0;
+
+    uint64_t ThreadAffinity_networkWork = 0;
+    uint64_t ThreadAffinity_storageIO = 0;
+    uint64_t ThreadAffinity_webSocketIO = 0;
+    uint64_t ThreadAffinity_P2PIO = 0;
+    uint64_t ThreadAffinity_HTTPRequestIO = 0;
+    uint64_t ThreadAffinity_RTCIO = 0;
+
+    bool isServer = false;
+
+    // "System" or "Pooled"; see MemAllocatorBackend in Memory.h
+    std::string memoryAllocatorBackend;
+};
+
+struct LogLevelConfig
+{
+    std::vector<std::string> category;
+    std::vector<std::string> level;
+};
+
+struct EOSSteamConfig
+{
+    EOS_EIntegratedPlatformManagementFlags flags;
+    uint32_t steamSDKMajorVersion = 0;
+    uint32_t steamSDKMinorVersion = 0;
+    std::optional<std::string> OverrideLibraryPath;
+    std::vector<std::string> steamApiInterfaceVersionsArray;
+
+    EOSSteamConfig()
+    {
+        flags = static_cast<EOS_EIntegratedPlatformManagementFlags>(0);
+    }
+
+    bool isManagedByApplication()
+    {
+        return std::underlying_type<EOS_EIntegratedPlatformManagementFlags>::type(flags & EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_LibraryManagedByApplication);
+    }
+    bool isManagedBySDK()
+    {
+        return std::underlying_type<EOS_EIntegratedPlatformManagementFlags>::type(flags & EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_LibraryManagedBySDK);
+    }
+
+};
+
+namespace plugin_bootstrap
+{
+    // Everything UnityPluginLoad does. Problems are logged rather than
+    // returned, as there's no one to return them to; the managed side
+    // creates the platform itself when this didn't.
+    void load();
+
+    // Everything UnityPluginUnload does, bar the overlay
+    void unload();
+
+    // The platform load created, or null
+    EOS_HPlatform platform_handle();
+
+    EOSConfig eos_config_from_json_value(json_value_s *config_json);
+    LogLevelConfig log_config_from_json_value(json_value_s *config_json);
+    EOSSteamConfig eos_steam_config_from_json_value(json_value_s *config_json);
+
+    // Where the config files are looked for
+    std::filesystem::path get_path_for_eos_service_config(const std::string& config_filename);
+
+    // Null if the file can't be read or isn't JSON. The result is one
+    // allocation, freed with free().
+    json_value_s * read_config_json_from_path(const std::filesystem::path& path_to_config_json);
+
+    // The config in the JSON file, from the binary cache beside it when
+    // that was made from the same JSON, else parsed and cached for next
+    // time; see ConfigCache.h. Empty if the file can't be read or isn't
+    // JSON.
+    std::optional<EOSConfig> read_eos_config_from_path(const std::filesystem::path& path_to_config_json);
+    std::optional<LogLevelConfig> read_log_level_config_from_path(const std::filesystem::path& path_to_config_json);
+    std::optional<EOSSteamConfig> read_steam_config_from_path(const std::filesystem::path& path_to_config_json);
+
+    // Until the log is opened, lines are kept for flush_log_with_function
+    void log_open(const char *filename);
+    void log_close();
+    void log_printf(const char *format, ...);
+    void flush_log_with_function(void (*log_flush_function)(const char *str));
+
+    void log_inform(const char *log_string);
+    void log_warn(const char *log_string);
+    void log_error(const char *log_string);
+}
+
+namespace bootstrap_platform
+{
+    // The directory holding this module, or empty if it can't be found
+    std::filesystem::path module_directory();
+
+    void * load_library(const std::filesystem::path& library_path);
+
+    // A library the process already has loaded, by file name, without
+    // loading it; null if it isn't loaded
+    void * find_loaded_library(const char *library_name);
+
+    void * load_function(void *library_handle, const char *function_name);
+
+    // Looks up one of the FUN_EXPORT functions in DynamicLibraryLoaderHelper,
+    // which are __stdcall, and so decorated, on 32 bit Windows
+    void * load_dllh_function(void *library_handle, const char *function_name, uint32_t argument_bytes);
+
+    void unload_library(void *library_handle);
+
+    // Replaces the file in one step, so a reader never sees half of it.
+    // Where permissions are up to the file, only this user may read it, as
+    // configs hold the client secret.
+    bool write_file(const std::filesystem::path& path, const void *data, size_t size, std::string *out_error);
+
+    struct MappedFile
+    {
+        const void *data = nullptr;
+        size_t size = 0;
+        // Whatever else unmap_file needs
+        void *mapping = nullptr;
+        // Owned by the user the process runs as, and where the platform has
+        // the notion, writable by no one else. Only such files are trusted
+        // as caches, since the cache directory may be shared.
+        bool private_to_user = false;
+    };
+
+    // Read only, and shared with the page cache rather than copied. False,
+    // saying why in out_error, for a file that's missing, locked, empty or
+    // otherwise can't be mapped. The file mustn't be truncated while it's
+    // mapped.
+    bool map_file(const std::filesystem::path& path, MappedFile *out_mapped_file, std::string *out_error);
+    void unmap_file(MappedFile *mapped_file);
+
+    // For the SDK's cache and the leak report; ends with a separator
+    const char * cache_directory();
+
+    // The process's own arguments, program name included
+    std::vector<std::string> command_line_arguments();
+
+    bool local_time(time_t raw_time, tm *out_time_info);
+
+    // For when a log file isn't enough; may do nothing
+    void show_dialog(const char *message);
+}
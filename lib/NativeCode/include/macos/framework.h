@@ -0,0 +1,8 @@
+#pragma once
+
+// Configure platform defines
+#define PLATFORM_MACOS 1
+
+#define STATIC_EXPORT(return_type) extern "C" return_type
+
+#define DLL_EXPORT(return_value) extern "C" __attribute__((visibility("default"))) return_value
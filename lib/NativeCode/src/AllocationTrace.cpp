@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "AllocationTrace.h"
+#include "Memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#define ALLOCATION_TRACE_RING_MASK (ALLOCATION_TRACE_RING_SIZE - 1)
+
+static_assert((ALLOCATION_TRACE_RING_SIZE & ALLOCATION_TRACE_RING_MASK) == 0, "ALLOCATION_TRACE_RING_SIZE must be a power of two");
+
+namespace
+{
+    // Single producer (the owning thread), single consumer (the drain
+    // thread). head and tail only ever grow; the slot is the low bits.
+    struct TraceRing
+    {
+        alignas(64) std::atomic<uint64_t> head{ 0 };
+        alignas(64) std::atomic<uint64_t> tail{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<bool> abandoned{ false };
+
+        uint64_t os_thread_id = 0;
+        uint16_t thread_index = 0;
+
+        // Only touched by whoever holds s_registry_lock
+        bool announced = false;
+        TraceRing *next = nullptr;
+
+        AllocationTraceEvent events[ALLOCATION_TRACE_RING_SIZE];
+    };
+
+    // Rings live as long as their thread and are reused across recordings,
+    // so a thread that is part way through record() when a recording stops
+    // never writes into freed memory.
+    struct ThreadRing
+    {
+        TraceRing *ring = nullptr;
+
+        ~ThreadRing();
+    };
+
+    struct DrainThread
+    {
+        std::thread thread;
+
+        // A recording still running at exit, or when the library is
+        // unloaded, is stopped so that the thread is joined and the file
+        // is flushed
+        ~DrainThread();
+    };
+
+    std::mutex s_registry_lock;
+    TraceRing *s_rings = nullptr;
+    uint16_t s_next_thread_index = 0;
+
+    // Serialises start() and stop()
+    std::mutex s_session_lock;
+    FILE *s_file = nullptr;
+    bool s_write_failed = false;
+
+    std::mutex s_drain_wake_lock;
+    std::condition_variable s_drain_wake;
+    bool s_drain_stop_requested = false;
+
+    // Set by a thread whose ring is filling up, so that the drain thread
+    // doesn't miss the wakeup while it's busy draining
+    std::atomic<bool> s_drain_requested(false);
+
+    // After everything the drain thread uses, so that it's destroyed first
+    DrainThread s_drain_thread;
+
+    std::atomic<int64_t> s_start_ns(0);
+
+    thread_local ThreadRing s_thread_ring;
+
+    // Allocations made by thread_local destructors that run after ours
+    // aren't recorded
+    thread_local bool s_thread_ring_destroyed = false;
+}
+
+std::atomic<bool> allocation_trace::detail::recording(false);
+
+//-------------------------------------------------------------------------
+// The drain thread frees the ring once it has been emptied
+ThreadRing::~ThreadRing()
+{
+    if (ring != nullptr)
+    {
+        ring->abandoned.store(true, std::memory_order_release);
+        ring = nullptr;
+    }
+    s_thread_ring_destroyed = true;
+}
+
+//-------------------------------------------------------------------------
+static inline int64_t steady_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-------------------------------------------------------------------------
+static inline uint8_t log2_of(size_t alignment_in_bytes)
+{
+    uint8_t log2 = 0;
+    while (log2 < 63 && (static_cast<size_t>(1) << (log2 + 1)) <= alignment_in_bytes)
+    {
+        ++log2;
+    }
+    return log2;
+}
+
+//-------------------------------------------------------------------------
+// Rings are too big to be worth pooling and must not be allocated through
+// the allocator being traced
+static TraceRing* register_thread_ring()
+{
+    void *memory = calloc(1, sizeof(TraceRing));
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    TraceRing *ring = new (memory) TraceRing();
+    ring->os_thread_id = platform::current_thread_id();
+
+    std::lock_guard<std::mutex> scope_lock(s_registry_lock);
+    ring->thread_index = s_next_thread_index++;
+    ring->next = s_rings;
+    s_rings = ring;
+
+    return ring;
+}
+
+//-------------------------------------------------------------------------
+static void destroy_ring(TraceRing *ring)
+{
+    ring->~TraceRing();
+    free(ring);
+}
+
+//-------------------------------------------------------------------------
+static void write_events(const AllocationTraceEvent *events, size_t count)
+{
+    if (count != 0 && fwrite(events, sizeof(AllocationTraceEvent), count, s_file) != count)
+    {
+        s_write_failed = true;
+    }
+}
+
+//-------------------------------------------------------------------------
+static void write_marker(const TraceRing& ring, AllocationTraceEventType type, uint64_t pointer, uint64_t size_in_bytes)
+{
+    const int64_t since_start = steady_now_ns() - s_start_ns.load(std::memory_order_relaxed);
+
+    AllocationTraceEvent event = {};
+    event.timestamp_ns = since_start > 0 ? static_cast<uint64_t>(since_start) : 0;
+    event.pointer = pointer;
+    event.size_in_bytes = size_in_bytes;
+    event.thread_index = ring.thread_index;
+    event.type = type;
+    write_events(&event, 1);
+}
+
+//-------------------------------------------------------------------------
+// Caller holds s_registry_lock
+static void drain_ring(TraceRing& ring)
+{
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+
+    if (head == tail && ring.dropped.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    if (!ring.announced)
+    {
+        write_marker(ring, AllocationTraceEventType::Thread, ring.os_thread_id, 0);
+        ring.announced = true;
+    }
+
+    while (tail != head)
+    {
+        const size_t first = static_cast<size_t>(tail & ALLOCATION_TRACE_RING_MASK);
+        const uint64_t contiguous = ALLOCATION_TRACE_RING_SIZE - first;
+        const uint64_t count = head - tail < contiguous ? head - tail : contiguous;
+
+        write_events(&ring.events[first], static_cast<size_t>(count));
+        tail += count;
+    }
+    ring.tail.store(tail, std::memory_order_release);
+
+    const uint64_t dropped = ring.dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped != 0)
+    {
+        write_marker(ring, AllocationTraceEventType::Dropped, 0, dropped);
+    }
+}
+
+//-------------------------------------------------------------------------
+static void drain_all_rings()
+{
+    std::lock_guard<std::mutex> scope_lock(s_registry_lock);
+
+    TraceRing **link = &s_rings;
+    while (*link != nullptr)
+    {
+        TraceRing *ring = *link;
+
+        // Read before draining, so that an event pushed just before the
+        // thread exited isn't lost
+        const bool abandoned = ring->abandoned.load(std::memory_order_acquire);
+        drain_ring(*ring);
+
+        if (abandoned)
+        {
+            *link = ring->next;
+            destroy_ring(ring);
+        }
+        else
+        {
+            link = &ring->next;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+static void drain_thread_main()
+{
+    std::unique_lock<std::mutex> wake_lock(s_drain_wake_lock);
+    while (!s_drain_stop_requested)
+    {
+        s_drain_wake.wait_for(wake_lock, std::chrono::milliseconds(ALLOCATION_TRACE_DRAIN_INTERVAL_MS), []
+        {
+            return s_drain_stop_requested || s_drain_requested.load(std::memory_order_relaxed);
+        });
+        s_drain_requested.store(false, std::memory_order_relaxed);
+
+        wake_lock.unlock();
+        drain_all_rings();
+        wake_lock.lock();
+    }
+}
+
+//-------------------------------------------------------------------------
+bool allocation_trace::start(const char *path)
+{
+    if (path == nullptr)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> session_lock(s_session_lock);
+    if (s_file != nullptr)
+    {
+        return false;
+    }
+
+#if PLATFORM_WINDOWS
+    fopen_s(&s_file, path, "wb");
+#else
+    s_file = fopen(path, "wb");
+#endif
+    if (s_file == nullptr)
+    {
+        return false;
+    }
+
+    AllocationTraceHeader header = {};
+    memcpy(header.magic, ALLOCATION_TRACE_MAGIC, sizeof(ALLOCATION_TRACE_MAGIC));
+    header.version = ALLOCATION_TRACE_VERSION;
+    header.event_size = sizeof(AllocationTraceEvent);
+    s_write_failed = fwrite(&header, sizeof(header), 1, s_file) != 1;
+
+    {
+        // Throw away anything that was pushed after the last recording
+        // stopped
+        std::lock_guard<std::mutex> scope_lock(s_registry_lock);
+        for (TraceRing *ring = s_rings; ring != nullptr; ring = ring->next)
+        {
+            ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+            ring->dropped.store(0, std::memory_order_relaxed);
+            ring->announced = false;
+        }
+    }
+
+    s_drain_stop_requested = false;
+    s_drain_requested.store(false, std::memory_order_relaxed);
+    s_start_ns.store(steady_now_ns(), std::memory_order_relaxed);
+    s_drain_thread.thread = std::thread(drain_thread_main);
+    detail::recording.store(true, std::memory_order_release);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+bool allocation_trace::stop()
+{
+    std::lock_guard<std::mutex> session_lock(s_session_lock);
+    if (s_file == nullptr)
+    {
+        return false;
+    }
+
+    detail::recording.store(false, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> wake_lock(s_drain_wake_lock);
+        s_drain_stop_requested = true;
+    }
+    s_drain_wake.notify_one();
+    s_drain_thread.thread.join();
+
+    // Events from threads that saw the flag just before it was cleared
+    drain_all_rings();
+
+    const bool written = !s_write_failed;
+    const bool closed = fclose(s_file) == 0;
+    s_file = nullptr;
+
+    return written && closed;
+}
+
+//-------------------------------------------------------------------------
+DrainThread::~DrainThread()
+{
+    allocation_trace::stop();
+}
+
+//-------------------------------------------------------------------------
+uint64_t allocation_trace::now_ns()
+{
+    const int64_t since_start = steady_now_ns() - s_start_ns.load(std::memory_order_relaxed);
+    return since_start > 0 ? static_cast<uint64_t>(since_start) : 0;
+}
+
+//-------------------------------------------------------------------------
+void allocation_trace::record(AllocationTraceEventType type, const void *pointer, const void *old_pointer, size_t size_in_bytes, size_t alignment_in_bytes, uint64_t timestamp_ns)
+{
+    if (s_thread_ring_destroyed)
+    {
+        return;
+    }
+
+    TraceRing *ring = s_thread_ring.ring;
+    if (ring == nullptr)
+    {
+        ring = s_thread_ring.ring = register_thread_ring();
+        if (ring == nullptr)
+        {
+            return;
+        }
+    }
+
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= ALLOCATION_TRACE_RING_SIZE)
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    AllocationTraceEvent& event = ring->events[head & ALLOCATION_TRACE_RING_MASK];
+    event.timestamp_ns = timestamp_ns;
+    event.pointer = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+    event.old_pointer = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(old_pointer));
+    event.size_in_bytes = size_in_bytes;
+    event.thread_index = ring->thread_index;
+    event.type = type;
+    event.alignment_log2 = log2_of(alignment_in_bytes);
+    event.reserved = 0;
+
+    ring->head.store(head + 1, std::memory_order_release);
+
+    // Don't wait for the next interval if this thread is allocating faster
+    // than the rings are being drained. The lock is only taken once per
+    // request, so that the flag can't be set between the drain thread
+    // checking it and going to sleep.
+    if (head - ring->tail.load(std::memory_order_relaxed) >= ALLOCATION_TRACE_RING_SIZE / 2
+        && !s_drain_requested.load(std::memory_order_relaxed)
+        && !s_drain_requested.exchange(true, std::memory_order_relaxed))
+    {
+        {
+            std::lock_guard<std::mutex> wake_lock(s_drain_wake_lock);
+        }
+        s_drain_wake.notify_one();
+    }
+}
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// See ConfigCache.h
+
+#include "pch.h"
+#include "ConfigCache.h"
+#include <string.h>
+#include <type_traits>
+
+namespace
+{
+    // Appends the payload; see ConfigCache.h for the encoding
+    struct Writer
+    {
+        std::string bytes;
+
+        template<typename T>
+        void number(T value)
+        {
+            static_assert(std::is_arithmetic<T>::value, "numbers only");
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void string(const std::string& value)
+        {
+            number(static_cast<uint32_t>(value.size()));
+            bytes.append(value);
+        }
+
+        void strings(const std::vector<std::string>& values)
+        {
+            number(static_cast<uint32_t>(values.size()));
+            for (const std::string& value : values)
+            {
+                string(value);
+            }
+        }
+    };
+
+    // Reads the payload back. Once anything runs past the end, ok is false
+    // and everything after reads as zero or empty.
+    struct Reader
+    {
+        const char *cursor;
+        const char *end;
+        bool ok = true;
+
+        Reader(const void *data, size_t size)
+            : cursor(static_cast<const char*>(data)), end(static_cast<const char*>(data) + size)
+        {
+        }
+
+        bool take(size_t size, const char **out_bytes)
+        {
+            if (!ok || static_cast<size_t>(end - cursor) < size)
+            {
+                ok = false;
+                return false;
+            }
+            *out_bytes = cursor;
+            cursor += size;
+            return true;
+        }
+
+        template<typename T>
+        T number()
+        {
+            static_assert(std::is_arithmetic<T>::value, "numbers only");
+            T value = 0;
+            const char *bytes = nullptr;
+            if (take(sizeof(value), &bytes))
+            {
+                memcpy(&value, bytes, sizeof(value));
+            }
+            return value;
+        }
+
+        std::string string()
+        {
+            const uint32_t size = number<uint32_t>();
+            const char *bytes = nullptr;
+            if (!take(size, &bytes))
+            {
+                return {};
+            }
+            return std::string(bytes, size);
+        }
+
+        std::vector<std::string> strings()
+        {
+            std::vector<std::string> values;
+            const uint32_t count = number<uint32_t>();
+            for (uint32_t i = 0; i < count && ok; ++i)
+            {
+                values.push_back(string());
+            }
+            return values;
+        }
+
+        // Everything was read, and nothing was left over
+        bool finished() const
+        {
+            return ok && cursor == end;
+        }
+    };
+}
+
+//-------------------------------------------------------------------------
+uint64_t config_cache::hash_bytes(const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+//-------------------------------------------------------------------------
+static std::string finish_encoding(ConfigCacheKind kind, const Writer& payload, const void *source, size_t source_size)
+{
+    ConfigCacheHeader header = {};
+    memcpy(header.magic, CONFIG_CACHE_MAGIC, sizeof(header.magic));
+    header.version = CONFIG_CACHE_VERSION;
+    header.kind = kind;
+    header.source_hash = config_cache::hash_bytes(source, source_size);
+    header.source_size = source_size;
+    header.payload_size = payload.bytes.size();
+    header.payload_hash = config_cache::hash_bytes(payload.bytes.data(), payload.bytes.size());
+
+    std::string encoded(reinterpret_cast<const char*>(&header), sizeof(header));
+    encoded.append(payload.bytes);
+    return encoded;
+}
+
+//-------------------------------------------------------------------------
+// The payload, if data is an intact cache of kind made from source
+static bool open_payload(const void *data, size_t size, ConfigCacheKind kind, const void *source, size_t source_size, Reader *out_reader)
+{
+    ConfigCacheHeader header = {};
+    if (data == nullptr || size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    const char *payload = static_cast<const char*>(data) + sizeof(header);
+    const size_t payload_size = size - sizeof(header);
+    if (memcmp(header.magic, CONFIG_CACHE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != CONFIG_CACHE_VERSION
+        || header.kind != kind
+        || header.source_size != source_size
+        || header.payload_size != payload_size)
+    {
+        return false;
+    }
+
+    // The source is checked first as it's the one expected to change
+    if (header.source_hash != config_cache::hash_bytes(source, source_size)
+        || header.payload_hash != config_cache::hash_bytes(payload, payload_size))
+    {
+        return false;
+    }
+
+    *out_reader = Reader(payload, payload_size);
+    return true;
+}
+
+//-------------------------------------------------------------------------
+std::string config_cache::encode(const EOSConfig& config, const void *source, size_t source_size)
+{
+    Writer writer;
+    writer.string(config.productName);
+    writer.string(config.productVersion);
+    writer.string(config.productID);
+    writer.string(config.sandboxID);
+    writer.string(config.deploymentID);
+
+    writer.number(static_cast<uint32_t>(config.sandboxDeploymentOverrides.size()));
+    for (const SandboxDeploymentOverride& override_item : config.sandboxDeploymentOverrides)
+    {
+        writer.string(override_item.sandboxID);
+        writer.string(override_item.deploymentID);
+    }
+
+    writer.string(config.clientSecret);
+    writer.string(config.clientID);
+    writer.string(config.encryptionKey);
+    writer.string(config.overrideCountryCode);
+    writer.string(config.overrideLocaleCode);
+    writer.number(config.flags);
+    writer.number(config.tickBudgetInMilliseconds);
+    writer.number(config.taskNetworkTimeoutSeconds);
+    writer.number(config.ThreadAffinity_networkWork);
+    writer.number(config.ThreadAffinity_storageIO);
+    writer.number(config.ThreadAffinity_webSocketIO);
+    writer.number(config.ThreadAffinity_P2PIO);
+    writer.number(config.ThreadAffinity_HTTPRequestIO);
+    writer.number(config.ThreadAffinity_RTCIO);
+    writer.number(static_cast<uint8_t>(config.isServer));
+    writer.string(config.memoryAllocatorBackend);
+
+    return finish_encoding(ConfigCacheKind::EOS, writer, source, source_size);
+}
+
+//-------------------------------------------------------------------------
+bool config_cache::decode(const void *data, size_t size, const void *source, size_t source_size, EOSConfig *out_config)
+{
+    Reader reader(nullptr, 0);
+    if (!open_payload(data, size, ConfigCacheKind::EOS, source, source_size, &reader))
+    {
+        return false;
+    }
+
+    EOSConfig config;
+    config.productName = reader.string();
+    config.productVersion = reader.string();
+    config.productID = reader.string();
+    config.sandboxID = reader.string();
+    config.deploymentID = reader.string();
+
+    const uint32_t override_count = reader.number<uint32_t>();
+    for (uint32_t i = 0; i < override_count && reader.ok; ++i)
+    {
+        SandboxDeploymentOverride override_item;
+        override_item.sandboxID = reader.string();
+        override_item.deploymentID = reader.string();
+        config.sandboxDeploymentOverrides.push_back(override_item);
+    }
+
+    config.clientSecret = reader.string();
+    config.clientID = reader.string();
+    config.encryptionKey = reader.string();
+    config.overrideCountryCode = reader.string();
+    config.overrideLocaleCode = reader.string();
+    config.flags = reader.number<uint64_t>();
+    config.tickBudgetInMilliseconds = reader.number<uint32_t>();
+    config.taskNetworkTimeoutSeconds = reader.number<double>();
+    config.ThreadAffinity_networkWork = reader.number<uint64_t>();
+    config.ThreadAffinity_storageIO = reader.number<uint64_t>();
+    config.ThreadAffinity_webSocketIO = reader.number<uint64_t>();
+    config.ThreadAffinity_P2PIO = reader.number<uint64_t>();
+    config.ThreadAffinity_HTTPRequestIO = reader.number<uint64_t>();
+    config.ThreadAffinity_RTCIO = reader.number<uint64_t>();
+    config.isServer = reader.number<uint8_t>() != 0;
+    config.memoryAllocatorBackend = reader.string();
+
+    if (!reader.finished())
+    {
+        return false;
+    }
+    *out_config = std::move(config);
+    return true;
+}
+
+//-------------------------------------------------------------------------
+std::string config_cache::encode(const LogLevelConfig& config, const void *source, size_t source_size)
+{
+    Writer writer;
+    writer.strings(config.category);
+    writer.strings(config.level);
+
+    return finish_encoding(ConfigCacheKind::LogLevel, writer, source, source_size);
+}
+
+//-------------------------------------------------------------------------
+bool config_cache::decode(const void *data, size_t size, const void *source, size_t source_size, LogLevelConfig *out_config)
+{
+    Reader reader(nullptr, 0);
+    if (!open_payload(data, size, ConfigCacheKind::LogLevel, source, source_size, &reader))
+    {
+        return false;
+    }
+
+    LogLevelConfig config;
+    config.category = reader.strings();
+    config.level = reader.strings();
+
+    if (!reader.finished())
+    {
+        return false;
+    }
+    *out_config = std::move(config);
+    return true;
+}
+
+//-------------------------------------------------------------------------
+std::string config_cache::encode(const EOSSteamConfig& config, const void *source, size_t source_size)
+{
+    Writer writer;
+    writer.number(static_cast<int32_t>(config.flags));
+    writer.number(config.steamSDKMajorVersion);
+    writer.number(config.steamSDKMinorVersion);
+    writer.number(static_cast<uint8_t>(config.OverrideLibraryPath.has_value()));
+    writer.string(config.OverrideLibraryPath.value_or(std::string()));
+    writer.strings(config.steamApiInterfaceVersionsArray);
+
+    return finish_encoding(ConfigCacheKind::Steam, writer, source, source_size);
+}
+
+//-------------------------------------------------------------------------
+bool config_cache::decode(const void *data, size_t size, const void *source, size_t source_size, EOSSteamConfig *out_config)
+{
+    Reader reader(nullptr, 0);
+    if (!open_payload(data, size, ConfigCacheKind::Steam, source, source_size, &reader))
+    {
+        return false;
+    }
+
+    EOSSteamConfig config;
+    config.flags = static_cast<EOS_EIntegratedPlatformManagementFlags>(reader.number<int32_t>());
+    config.steamSDKMajorVersion = reader.number<uint32_t>();
+    config.steamSDKMinorVersion = reader.number<uint32_t>();
+    const bool has_override_library_path = reader.number<uint8_t>() != 0;
+    std::string override_library_path = reader.string();
+    if (has_override_library_path)
+    {
+        config.OverrideLibraryPath = std::move(override_library_path);
+    }
+    config.steamApiInterfaceVersionsArray = reader.strings();
+
+    if (!reader.finished())
+    {
+        return false;
+    }
+    *out_config = std::move(config);
+    return true;
+}
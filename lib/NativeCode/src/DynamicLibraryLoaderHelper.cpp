@@ -26,6 +26,8 @@
 #include "pch.h"
 #include "framework.h"
 #include "DLLHContext.h"
+#include "LibraryLoading.h"
+#include <tuple>
 
 #if PLATFORM_WINDOWS
 #include "DynamicLibraryLoaderHelper_Win32.h"
@@ -54,6 +56,33 @@ FUN_EXPORT(void *) DLLH_load_library_at_path(void *ctx, const char *library_path
     return to_return;
 }
 
+//-------------------------------------------------------------------------
+// Starts loading library_path on a worker thread, so that the caller can
+// get on with other startup work while the loader maps and relocates it.
+// Returns a ticket that has to be passed to DLLH_wait_library exactly once,
+// before the context is destroyed, or null if no thread could be started.
+FUN_EXPORT(void *) DLLH_load_library_async(void *ctx, const char *library_path)
+{
+    return library_loading::load_async(static_cast<DLLHContext*>(ctx), library_path, &platform::DLLH_load_library_at_path);
+}
+
+//-------------------------------------------------------------------------
+// True once DLLH_wait_library would return without blocking
+FUN_EXPORT(bool) DLLH_poll_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    return library_loading::poll(ticket);
+}
+
+//-------------------------------------------------------------------------
+// Blocks until the load behind ticket is done, then frees the ticket and
+// returns what DLLH_load_library_at_path would have
+FUN_EXPORT(void *) DLLH_wait_library(void *ctx, void *ticket)
+{
+    std::ignore = ctx;
+    return library_loading::wait(ticket);
+}
+
 
 //-------------------------------------------------------------------------
 FUN_EXPORT(bool) DLLH_unload_library_at_path(void *ctx, void *library_handle)
@@ -74,3 +103,35 @@ FUN_EXPORT(void *) DLLH_load_function_with_name(void *ctx, void *library_handle,
 
     return to_return;
 }
+
+//-------------------------------------------------------------------------
+// Resolves count functions in one call, so that managed code binding
+// hundreds of SDK functions only crosses into native code once. Functions
+// that aren't found are null in out_functions. Returns how many were found.
+FUN_EXPORT(size_t) DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+    return library_loading::load_functions(static_cast<DLLHContext*>(ctx), library_handle, function_names, out_functions, count, &platform::DLLH_load_function_with_name);
+}
+
+//-------------------------------------------------------------------------
+// There are no lazy stubs on this platform, so functions are looked up
+// straight away
+FUN_EXPORT(void *) DLLH_load_function_lazily(void *ctx, void *library_handle, const char *function)
+{
+    return DLLH_load_function_with_name(ctx, library_handle, function);
+}
+
+//-------------------------------------------------------------------------
+FUN_EXPORT(size_t) DLLH_load_functions_lazily(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count)
+{
+    return DLLH_load_functions_with_names(ctx, library_handle, function_names, out_functions, count);
+}
+
+//-------------------------------------------------------------------------
+// Function pointers aren't tracked on this platform, so unloading never
+// waits on them
+FUN_EXPORT(size_t) DLLH_release_functions(void *ctx, void *library_handle)
+{
+    std::ignore = ctx, library_handle;
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "EOSFunctions.h"
+#include <stdio.h>
+#include <atomic>
+#include <type_traits>
+
+namespace
+{
+    std::atomic<void*> s_library_handle(nullptr);
+    std::atomic<eos_functions::LoadFunction> s_load_function(nullptr);
+
+    // Null until looked up, then the function or &s_missing_function, so
+    // that a function the library doesn't have is only asked for once
+    std::atomic<void*> s_functions[eos_functions::function_count];
+    char s_missing_function;
+}
+
+//-------------------------------------------------------------------------
+// On 32 bit Windows the SDK's __stdcall exports only go by their
+// decorated names
+static void * load_by_name(void *library_handle, eos_functions::LoadFunction load_function, const EOSFunctionDescriptor& descriptor)
+{
+#if defined(_WIN32) && !defined(_WIN64)
+    char decorated_name[256];
+    snprintf(decorated_name, sizeof(decorated_name), "_%s@%u", descriptor.name, descriptor.stdcall_argument_bytes);
+    return load_function(library_handle, decorated_name);
+#else
+    return load_function(library_handle, descriptor.name);
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Returns the function, or null if the library doesn't have it. Two
+// threads can both do the lookup the first time; they get the same answer.
+static void * lookup(EOSFunctionId id)
+{
+    std::atomic<void*>& slot = s_functions[static_cast<size_t>(id)];
+    void *function = slot.load(std::memory_order_acquire);
+    if (function == nullptr)
+    {
+        void *library_handle = s_library_handle.load(std::memory_order_acquire);
+        eos_functions::LoadFunction load_function = s_load_function.load(std::memory_order_acquire);
+        if (library_handle == nullptr || load_function == nullptr)
+        {
+            return nullptr;
+        }
+
+        function = load_by_name(library_handle, load_function, eos_functions::descriptor(id));
+        if (function == nullptr)
+        {
+            function = &s_missing_function;
+        }
+        slot.store(function, std::memory_order_release);
+    }
+    return function != &s_missing_function ? function : nullptr;
+}
+
+//-------------------------------------------------------------------------
+// What a lazy function the library doesn't have returns
+template<typename Result>
+static Result missing_result()
+{
+    if constexpr (std::is_same_v<Result, EOS_EResult>)
+    {
+        return EOS_EResult::EOS_NotImplemented;
+    }
+    else if constexpr (!std::is_void_v<Result>)
+    {
+        return Result();
+    }
+}
+
+//-------------------------------------------------------------------------
+// Stands in for a lazy function until it's first called, and after that
+// forwards to it
+template<EOSFunctionId Id, typename Function>
+struct LazyThunk;
+
+template<EOSFunctionId Id, typename Result, typename... Arguments>
+struct LazyThunk<Id, Result (EOS_CALL *)(Arguments...)>
+{
+    static Result EOS_CALL call(Arguments... arguments)
+    {
+        auto function = reinterpret_cast<Result (EOS_CALL *)(Arguments...)>(lookup(Id));
+        if (function == nullptr)
+        {
+            return missing_result<Result>();
+        }
+        return function(arguments...);
+    }
+};
+
+//-------------------------------------------------------------------------
+template<EOSFunctionId Id, typename Function>
+static bool bind(Function& out_function, EOSFunctionResolveMode mode)
+{
+    const EOSFunctionDescriptor& descriptor = eos_functions::descriptor(Id);
+    if (descriptor.binding == EOS_FUNCTION_LAZY && mode == EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL)
+    {
+        out_function = &LazyThunk<Id, Function>::call;
+        return true;
+    }
+
+    void *function = lookup(Id);
+    if (function == nullptr)
+    {
+        out_function = &LazyThunk<Id, Function>::call;
+        return descriptor.binding == EOS_FUNCTION_LAZY;
+    }
+
+    out_function = reinterpret_cast<Function>(function);
+    return true;
+}
+
+//-------------------------------------------------------------------------
+bool eos_functions::resolve(void *library_handle, LoadFunction load_function, EOSFunctionResolveMode mode, EOSFunctions *out_functions, const char **out_missing_name)
+{
+    reset();
+    s_load_function.store(load_function, std::memory_order_release);
+    s_library_handle.store(library_handle, std::memory_order_release);
+
+    // Required functions come first so that a library missing one is
+    // turned away before anything else is looked up
+    EOSFunctions functions = {};
+#define EOS_FUNCTION(name, binding) \
+    if (binding == EOS_FUNCTION_REQUIRED && !bind<EOSFunctionId::name>(functions.name, mode)) \
+    { \
+        if (out_missing_name != nullptr) \
+        { \
+            *out_missing_name = #name; \
+        } \
+        reset(); \
+        return false; \
+    }
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+
+#define EOS_FUNCTION(name, binding) \
+    if (binding == EOS_FUNCTION_LAZY) \
+    { \
+        bind<EOSFunctionId::name>(functions.name, mode); \
+    }
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+
+    *out_functions = functions;
+    return true;
+}
+
+//-------------------------------------------------------------------------
+bool eos_functions::is_available(EOSFunctionId id)
+{
+    return lookup(id) != nullptr;
+}
+
+//-------------------------------------------------------------------------
+void eos_functions::reset()
+{
+    s_library_handle.store(nullptr, std::memory_order_release);
+    s_load_function.store(nullptr, std::memory_order_release);
+    for (std::atomic<void*>& slot : s_functions)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
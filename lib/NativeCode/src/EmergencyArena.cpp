@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "EmergencyArena.h"
+#include "Memory.h"
+#include <string.h>
+#include <mutex>
+
+#define ARENA_GRANULE 16
+#define ARENA_HEADER_SIZE 16
+// A free block needs room for its list links
+#define ARENA_MIN_BLOCK_SIZE 32
+#define ARENA_IN_USE 1ULL
+
+namespace
+{
+    struct ArenaBlock
+    {
+        // Including the header; the low bit is set while in use
+        uint64_t size_and_flags;
+        // 0 for the first block
+        uint64_t previous_size;
+    };
+
+    // Stored in the payload of free blocks
+    struct FreeLinks
+    {
+        ArenaBlock *next;
+        ArenaBlock *previous;
+    };
+
+    std::mutex s_lock;
+    char *s_memory = nullptr;
+    size_t s_mapped_size = 0;
+    ArenaBlock *s_free_list = nullptr;
+    int64_t s_capacity = 0;
+    int64_t s_used = 0;
+    int64_t s_peak = 0;
+}
+
+std::atomic<uintptr_t> emergency_arena::detail::begin(0);
+std::atomic<uintptr_t> emergency_arena::detail::end(0);
+
+//-------------------------------------------------------------------------
+static inline size_t round_up(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) & ~(multiple - 1);
+}
+
+//-------------------------------------------------------------------------
+static inline uint64_t size_of(const ArenaBlock *block)
+{
+    return block->size_and_flags & ~ARENA_IN_USE;
+}
+
+//-------------------------------------------------------------------------
+static inline bool in_use(const ArenaBlock *block)
+{
+    return (block->size_and_flags & ARENA_IN_USE) != 0;
+}
+
+//-------------------------------------------------------------------------
+static inline ArenaBlock* next_of(ArenaBlock *block)
+{
+    return reinterpret_cast<ArenaBlock*>(reinterpret_cast<char*>(block) + size_of(block));
+}
+
+//-------------------------------------------------------------------------
+static inline FreeLinks* links_of(ArenaBlock *block)
+{
+    return reinterpret_cast<FreeLinks*>(block + 1);
+}
+
+//-------------------------------------------------------------------------
+static inline ArenaBlock* header_of(const void *pointer)
+{
+    return reinterpret_cast<ArenaBlock*>(const_cast<char*>(static_cast<const char*>(pointer)) - ARENA_HEADER_SIZE);
+}
+
+//-------------------------------------------------------------------------
+static void push_free(ArenaBlock *block)
+{
+    FreeLinks *links = links_of(block);
+    links->previous = nullptr;
+    links->next = s_free_list;
+    if (s_free_list != nullptr)
+    {
+        links_of(s_free_list)->previous = block;
+    }
+    s_free_list = block;
+}
+
+//-------------------------------------------------------------------------
+static void unlink_free(ArenaBlock *block)
+{
+    FreeLinks *links = links_of(block);
+    if (links->previous != nullptr)
+    {
+        links_of(links->previous)->next = links->next;
+    }
+    else
+    {
+        s_free_list = links->next;
+    }
+    if (links->next != nullptr)
+    {
+        links_of(links->next)->previous = links->previous;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Writes a block's header and keeps its neighbour's back link in step. The
+// arena ends in an in use sentinel, so there is always a next block.
+static void set_block(ArenaBlock *block, uint64_t size, bool used, uint64_t previous_size)
+{
+    block->size_and_flags = size | (used ? ARENA_IN_USE : 0);
+    block->previous_size = previous_size;
+    next_of(block)->previous_size = size;
+}
+
+//-------------------------------------------------------------------------
+static void * alloc_locked(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    const size_t alignment = alignment_in_bytes < ARENA_GRANULE ? ARENA_GRANULE : alignment_in_bytes;
+    const size_t payload_size = round_up(size_in_bytes == 0 ? 1 : size_in_bytes, ARENA_GRANULE);
+
+    for (ArenaBlock *block = s_free_list; block != nullptr; block = links_of(block)->next)
+    {
+        const uint64_t size = size_of(block);
+        const uintptr_t start = reinterpret_cast<uintptr_t>(block) + ARENA_HEADER_SIZE;
+        uintptr_t payload = round_up(start, alignment);
+
+        // Whatever is skipped for alignment becomes a free block of its own,
+        // so it has to be big enough to be one
+        if (payload != start && payload - start < ARENA_MIN_BLOCK_SIZE)
+        {
+            payload += alignment;
+        }
+
+        const uint64_t lead = payload - start;
+        if (lead + ARENA_HEADER_SIZE + payload_size > size)
+        {
+            continue;
+        }
+
+        unlink_free(block);
+
+        const uint64_t used_previous_size = lead != 0 ? lead : block->previous_size;
+        ArenaBlock *used = block;
+        uint64_t used_size = size;
+        if (lead != 0)
+        {
+            used = header_of(reinterpret_cast<void*>(payload));
+            used_size = size - lead;
+            set_block(block, lead, false, block->previous_size);
+            push_free(block);
+        }
+
+        const uint64_t wanted = ARENA_HEADER_SIZE + payload_size;
+        if (used_size - wanted >= ARENA_MIN_BLOCK_SIZE)
+        {
+            set_block(used, wanted, true, used_previous_size);
+            ArenaBlock *tail = next_of(used);
+            set_block(tail, used_size - wanted, false, wanted);
+            push_free(tail);
+        }
+        else
+        {
+            set_block(used, used_size, true, used_previous_size);
+        }
+
+        s_used += static_cast<int64_t>(size_of(used));
+        if (s_used > s_peak)
+        {
+            s_peak = s_used;
+        }
+
+        return reinterpret_cast<void*>(payload);
+    }
+
+    return nullptr;
+}
+
+//-------------------------------------------------------------------------
+static void free_locked(void *pointer)
+{
+    ArenaBlock *block = header_of(pointer);
+    uint64_t size = size_of(block);
+    s_used -= static_cast<int64_t>(size);
+
+    ArenaBlock *next = next_of(block);
+    if (!in_use(next))
+    {
+        unlink_free(next);
+        size += size_of(next);
+    }
+
+    if (block->previous_size != 0)
+    {
+        ArenaBlock *previous = reinterpret_cast<ArenaBlock*>(reinterpret_cast<char*>(block) - block->previous_size);
+        if (!in_use(previous))
+        {
+            unlink_free(previous);
+            size += size_of(previous);
+            block = previous;
+        }
+    }
+
+    set_block(block, size, false, block->previous_size);
+    push_free(block);
+}
+
+//-------------------------------------------------------------------------
+bool emergency_arena::reserve(size_t capacity_in_bytes)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    if (s_used != 0)
+    {
+        return false;
+    }
+
+    if (s_memory != nullptr)
+    {
+        detail::begin.store(0, std::memory_order_relaxed);
+        detail::end.store(0, std::memory_order_relaxed);
+        platform::free_pages(s_memory, s_mapped_size);
+        s_memory = nullptr;
+        s_mapped_size = 0;
+        s_free_list = nullptr;
+        s_capacity = 0;
+        s_peak = 0;
+    }
+
+    if (capacity_in_bytes == 0)
+    {
+        return true;
+    }
+
+    // Room for the sentinel that stops coalescing at the end
+    const size_t capacity = round_up(capacity_in_bytes < ARENA_MIN_BLOCK_SIZE ? ARENA_MIN_BLOCK_SIZE : capacity_in_bytes, ARENA_GRANULE);
+    const size_t mapped_size = round_up(capacity + ARENA_HEADER_SIZE, 4096);
+    char *memory = static_cast<char*>(platform::alloc_pages(mapped_size, 4096));
+    if (memory == nullptr)
+    {
+        return false;
+    }
+
+    // Touch every page now, so that the memory is really there when it's
+    // needed rather than being committed at the worst possible time
+    memset(memory, 0, mapped_size);
+
+    ArenaBlock *first = reinterpret_cast<ArenaBlock*>(memory);
+    ArenaBlock *sentinel = reinterpret_cast<ArenaBlock*>(memory + capacity);
+    sentinel->size_and_flags = ARENA_IN_USE;
+    first->size_and_flags = capacity;
+    first->previous_size = 0;
+    sentinel->previous_size = capacity;
+
+    s_memory = memory;
+    s_mapped_size = mapped_size;
+    s_capacity = static_cast<int64_t>(capacity);
+    push_free(first);
+
+    detail::begin.store(reinterpret_cast<uintptr_t>(memory), std::memory_order_relaxed);
+    detail::end.store(reinterpret_cast<uintptr_t>(memory + capacity), std::memory_order_relaxed);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+void * emergency_arena::alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    if (s_memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    return alloc_locked(size_in_bytes, alignment_in_bytes);
+}
+
+//-------------------------------------------------------------------------
+void * emergency_arena::realloc(void *pointer, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+
+    const size_t old_size = size_of(header_of(pointer)) - ARENA_HEADER_SIZE;
+    const size_t alignment = alignment_in_bytes < ARENA_GRANULE ? ARENA_GRANULE : alignment_in_bytes;
+    const bool aligned = (reinterpret_cast<uintptr_t>(pointer) & (alignment - 1)) == 0;
+    if (aligned && size_in_bytes <= old_size)
+    {
+        return pointer;
+    }
+
+    void *to_return = alloc_locked(size_in_bytes, alignment_in_bytes);
+    if (to_return != nullptr)
+    {
+        memcpy(to_return, pointer, old_size < size_in_bytes ? old_size : size_in_bytes);
+        free_locked(pointer);
+    }
+
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+void emergency_arena::free(void *pointer)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    free_locked(pointer);
+}
+
+//-------------------------------------------------------------------------
+size_t emergency_arena::block_size(const void *pointer)
+{
+    return static_cast<size_t>(size_of(header_of(pointer))) - ARENA_HEADER_SIZE;
+}
+
+//-------------------------------------------------------------------------
+void emergency_arena::usage(int64_t *out_capacity, int64_t *out_used, int64_t *out_peak)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    *out_capacity = s_capacity;
+    *out_used = s_used;
+    *out_peak = s_peak;
+}
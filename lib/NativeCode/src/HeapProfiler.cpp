@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "HeapProfiler.h"
+#include <math.h>
+#include <string.h>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Leave out record_sample itself. The allocator hooks above it may or may
+// not have been inlined into one another, so they stay in the stack as its
+// leaf frames.
+#define HEAP_PROFILER_SKIPPED_FRAMES 1
+
+std::atomic<uint64_t> heap_profiler::detail::sample_interval(0);
+
+namespace
+{
+    struct StackRecord
+    {
+        void *frames[HEAP_PROFILER_MAX_FRAMES];
+        int frame_count;
+    };
+
+    struct LiveSample
+    {
+        size_t stack_index;
+        // What this one sample stands for once sampling is undone
+        double estimated_count;
+        double estimated_bytes;
+    };
+
+    struct StackTotals
+    {
+        double live_count = 0;
+        double live_bytes = 0;
+        double total_count = 0;
+        double total_bytes = 0;
+    };
+
+    // Sampled allocations are rare enough that a single lock is fine here
+    std::mutex s_lock;
+    std::vector<StackRecord> s_stacks;
+    std::vector<StackTotals> s_stack_totals;
+    std::unordered_multimap<uint64_t, size_t> s_stacks_by_hash;
+    std::unordered_map<void*, LiveSample> s_live_samples;
+
+    // Bumped whenever the interval changes, so each thread redraws its
+    // countdown from the new distribution
+    std::atomic<uint32_t> s_generation(1);
+
+    thread_local int64_t s_bytes_until_sample = 0;
+    thread_local uint32_t s_thread_generation = 0;
+    thread_local uint64_t s_random_state = 0;
+}
+
+//-------------------------------------------------------------------------
+// Uniform in (0, 1]
+static double next_random()
+{
+    if (s_random_state == 0)
+    {
+        s_random_state = reinterpret_cast<uintptr_t>(&s_random_state) ^ 0x9E3779B97F4A7C15ULL;
+    }
+
+    s_random_state ^= s_random_state >> 12;
+    s_random_state ^= s_random_state << 25;
+    s_random_state ^= s_random_state >> 27;
+    return static_cast<double>((s_random_state * 0x2545F4914F6CDD1DULL) >> 11 | 1) / 9007199254740992.0;
+}
+
+//-------------------------------------------------------------------------
+static int64_t next_sample_distance(uint64_t interval_in_bytes)
+{
+    const double distance = -log(next_random()) * static_cast<double>(interval_in_bytes);
+    return distance < 1.0 ? 1 : distance > 9.0e18 ? INT64_MAX : static_cast<int64_t>(distance);
+}
+
+//-------------------------------------------------------------------------
+static uint64_t hash_stack(void * const *frames, int frame_count)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < frame_count; ++i)
+    {
+        hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(frames[i]));
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+//-------------------------------------------------------------------------
+// Caller must hold s_lock
+static size_t intern_stack(void * const *frames, int frame_count)
+{
+    const uint64_t hash = hash_stack(frames, frame_count);
+    auto range = s_stacks_by_hash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        const StackRecord& stack = s_stacks[it->second];
+        if (stack.frame_count == frame_count && memcmp(stack.frames, frames, frame_count * sizeof(void*)) == 0)
+        {
+            return it->second;
+        }
+    }
+
+    StackRecord stack;
+    memcpy(stack.frames, frames, frame_count * sizeof(void*));
+    stack.frame_count = frame_count;
+
+    s_stacks.push_back(stack);
+    s_stack_totals.emplace_back();
+    s_stacks_by_hash.emplace(hash, s_stacks.size() - 1);
+
+    return s_stacks.size() - 1;
+}
+
+//-------------------------------------------------------------------------
+void heap_profiler::set_sample_interval(uint64_t interval_in_bytes)
+{
+    detail::sample_interval.store(interval_in_bytes, std::memory_order_relaxed);
+    s_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+bool heap_profiler::should_sample(size_t size_in_bytes)
+{
+    const uint32_t generation = s_generation.load(std::memory_order_relaxed);
+    const uint64_t interval = detail::sample_interval.load(std::memory_order_relaxed);
+
+    if (s_thread_generation != generation)
+    {
+        s_thread_generation = generation;
+        s_bytes_until_sample = next_sample_distance(interval);
+    }
+
+    s_bytes_until_sample -= static_cast<int64_t>(size_in_bytes);
+    if (s_bytes_until_sample >= 0)
+    {
+        return false;
+    }
+
+    s_bytes_until_sample = next_sample_distance(interval);
+    return interval != 0;
+}
+
+//-------------------------------------------------------------------------
+void heap_profiler::record_sample(void *pointer, size_t size_in_bytes)
+{
+    void *frames[HEAP_PROFILER_MAX_FRAMES];
+    const int frame_count = platform::capture_backtrace(frames, HEAP_PROFILER_MAX_FRAMES, HEAP_PROFILER_SKIPPED_FRAMES);
+
+    // A block of size S is sampled with probability 1 - e^(-S/interval);
+    // weighting the sample by the inverse gives unbiased estimates
+    const double interval = static_cast<double>(detail::sample_interval.load(std::memory_order_relaxed));
+    const double size = static_cast<double>(size_in_bytes);
+    const double probability = (interval > 0 && size > 0) ? 1.0 - exp(-size / interval) : 1.0;
+
+    LiveSample sample;
+    sample.estimated_count = 1.0 / probability;
+    sample.estimated_bytes = size / probability;
+
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    sample.stack_index = intern_stack(frames, frame_count);
+
+    StackTotals& totals = s_stack_totals[sample.stack_index];
+    totals.live_count += sample.estimated_count;
+    totals.live_bytes += sample.estimated_bytes;
+    totals.total_count += sample.estimated_count;
+    totals.total_bytes += sample.estimated_bytes;
+
+    s_live_samples[pointer] = sample;
+}
+
+//-------------------------------------------------------------------------
+void heap_profiler::remove_sample(void *pointer)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+
+    auto it = s_live_samples.find(pointer);
+    if (it == s_live_samples.end())
+    {
+        return;
+    }
+
+    StackTotals& totals = s_stack_totals[it->second.stack_index];
+    totals.live_count -= it->second.estimated_count;
+    totals.live_bytes -= it->second.estimated_bytes;
+
+    s_live_samples.erase(it);
+}
+
+//-------------------------------------------------------------------------
+size_t heap_profiler::live_sample_count()
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    return s_live_samples.size();
+}
+
+//-------------------------------------------------------------------------
+static inline uint64_t round_estimate(double estimate)
+{
+    return estimate > 0.5 ? static_cast<uint64_t>(estimate + 0.5) : 0;
+}
+
+//-------------------------------------------------------------------------
+// Samples are written already scaled, so the profile claims a sampling
+// rate of 1 and pprof leaves them alone. That keeps the numbers right even
+// if the interval was changed while samples were live.
+static void write_pprof(FILE *file, const std::vector<StackRecord>& stacks, const std::vector<StackTotals>& stack_totals)
+{
+    StackTotals sum;
+    for (const StackTotals& totals : stack_totals)
+    {
+        sum.live_count += totals.live_count;
+        sum.live_bytes += totals.live_bytes;
+        sum.total_count += totals.total_count;
+        sum.total_bytes += totals.total_bytes;
+    }
+
+    fprintf(file, "heap profile: %" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @ heap_v2/1\n",
+        round_estimate(sum.live_count), round_estimate(sum.live_bytes), round_estimate(sum.total_count), round_estimate(sum.total_bytes));
+
+    for (size_t i = 0; i < stacks.size(); ++i)
+    {
+        const StackTotals& totals = stack_totals[i];
+        fprintf(file, "%" PRIu64 ": %" PRIu64 " [%" PRIu64 ": %" PRIu64 "] @",
+            round_estimate(totals.live_count), round_estimate(totals.live_bytes), round_estimate(totals.total_count), round_estimate(totals.total_bytes));
+
+        for (int frame = 0; frame < stacks[i].frame_count; ++frame)
+        {
+            fprintf(file, " 0x%" PRIxPTR, reinterpret_cast<uintptr_t>(stacks[i].frames[frame]));
+        }
+        fprintf(file, "\n");
+    }
+
+    fprintf(file, "\nMAPPED_LIBRARIES:\n");
+    platform::write_mapped_libraries(file);
+}
+
+//-------------------------------------------------------------------------
+// Only stacks with live blocks are written, outermost frame first
+static void write_collapsed_stacks(FILE *file, const std::vector<StackRecord>& stacks, const std::vector<StackTotals>& stack_totals)
+{
+    char name[256];
+
+    for (size_t i = 0; i < stacks.size(); ++i)
+    {
+        const uint64_t live_bytes = round_estimate(stack_totals[i].live_bytes);
+        if (live_bytes == 0)
+        {
+            continue;
+        }
+
+        for (int frame = stacks[i].frame_count - 1; frame >= 0; --frame)
+        {
+            platform::describe_address(stacks[i].frames[frame], name, sizeof(name));
+
+            // ';' and ' ' are the format's separators
+            for (char *c = name; *c != '\0'; ++c)
+            {
+                if (*c == ';' || *c == ' ')
+                {
+                    *c = '_';
+                }
+            }
+            fprintf(file, frame > 0 ? "%s;" : "%s", name);
+        }
+        fprintf(file, " %" PRIu64 "\n", live_bytes);
+    }
+}
+
+//-------------------------------------------------------------------------
+bool heap_profiler::write_profile(FILE *file, HeapProfileFormat format)
+{
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    // Copy out so that symbolizing and file I/O happen without the lock
+    std::vector<StackRecord> stacks;
+    std::vector<StackTotals> stack_totals;
+    {
+        std::lock_guard<std::mutex> scope_lock(s_lock);
+        stacks = s_stacks;
+        stack_totals = s_stack_totals;
+    }
+
+    switch (format)
+    {
+    case HeapProfileFormat::Pprof:
+        write_pprof(file, stacks, stack_totals);
+        break;
+    case HeapProfileFormat::CollapsedStacks:
+        write_collapsed_stacks(file, stacks, stack_totals);
+        break;
+    default:
+        return false;
+    }
+
+    return ferror(file) == 0;
+}
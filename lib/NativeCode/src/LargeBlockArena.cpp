@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "LargeBlockArena.h"
+#include "Memory.h"
+#include <mutex>
+
+#define ARENA_UNIT_SIZE PLATFORM_HUGE_PAGE_SIZE
+#define ARENA_PAGES_PER_UNIT (ARENA_UNIT_SIZE / LARGE_BLOCK_ARENA_PAGE_SIZE)
+
+// Bin i holds free runs of exactly i pages, the last bin everything longer
+#define ARENA_BIN_COUNT 64
+
+#define ARENA_NO_PAGE UINT32_MAX
+
+#define ARENA_RUN_IN_USE 1u
+
+#define ARENA_UNIT_COMMITTED 1u
+#define ARENA_UNIT_EXPLICIT_HUGE_PAGES 2u
+
+namespace
+{
+    // Kept for the first and the last page of every run, so that a run's
+    // neighbours can be found from either side
+    struct PageRun
+    {
+        uint32_t page_count;
+        uint32_t flags;
+        // Free list links, only on the first page of free runs
+        uint32_t next;
+        uint32_t previous;
+    };
+
+    std::mutex s_lock;
+    char *s_memory = nullptr;
+    size_t s_page_count = 0;
+    PageRun *s_runs = nullptr;
+    uint8_t *s_units = nullptr;
+    size_t s_metadata_size = 0;
+
+    // Pages from here on have never been part of a run
+    size_t s_frontier = 0;
+
+    uint32_t s_bins[ARENA_BIN_COUNT];
+    uint64_t s_bin_mask = 0;
+
+    large_block_arena::Usage s_usage = {};
+}
+
+std::atomic<uintptr_t> large_block_arena::detail::begin(0);
+std::atomic<uintptr_t> large_block_arena::detail::end(0);
+std::atomic<size_t> large_block_arena::detail::threshold(0);
+
+//-------------------------------------------------------------------------
+static inline size_t round_up(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) & ~(multiple - 1);
+}
+
+//-------------------------------------------------------------------------
+static inline size_t pages_for(size_t size_in_bytes)
+{
+    return size_in_bytes == 0 ? 1 : round_up(size_in_bytes, LARGE_BLOCK_ARENA_PAGE_SIZE) / LARGE_BLOCK_ARENA_PAGE_SIZE;
+}
+
+//-------------------------------------------------------------------------
+static inline size_t page_of(const void *pointer)
+{
+    return static_cast<size_t>(static_cast<const char*>(pointer) - s_memory) / LARGE_BLOCK_ARENA_PAGE_SIZE;
+}
+
+//-------------------------------------------------------------------------
+static inline void* pointer_of(size_t page)
+{
+    return s_memory + page * LARGE_BLOCK_ARENA_PAGE_SIZE;
+}
+
+//-------------------------------------------------------------------------
+static inline size_t bin_for(size_t page_count)
+{
+    return page_count < ARENA_BIN_COUNT ? page_count : ARENA_BIN_COUNT - 1;
+}
+
+//-------------------------------------------------------------------------
+static void mark_run(size_t first_page, size_t page_count, uint32_t flags)
+{
+    PageRun& first = s_runs[first_page];
+    first.page_count = static_cast<uint32_t>(page_count);
+    first.flags = flags;
+
+    PageRun& last = s_runs[first_page + page_count - 1];
+    last.page_count = static_cast<uint32_t>(page_count);
+    last.flags = flags;
+}
+
+//-------------------------------------------------------------------------
+static void push_free(size_t first_page, size_t page_count)
+{
+    mark_run(first_page, page_count, 0);
+
+    const size_t bin = bin_for(page_count);
+    PageRun& run = s_runs[first_page];
+    run.previous = ARENA_NO_PAGE;
+    run.next = s_bins[bin];
+    if (run.next != ARENA_NO_PAGE)
+    {
+        s_runs[run.next].previous = static_cast<uint32_t>(first_page);
+    }
+    s_bins[bin] = static_cast<uint32_t>(first_page);
+    s_bin_mask |= 1ULL << bin;
+}
+
+//-------------------------------------------------------------------------
+static void unlink_free(size_t first_page)
+{
+    const PageRun& run = s_runs[first_page];
+    const size_t bin = bin_for(run.page_count);
+
+    if (run.previous != ARENA_NO_PAGE)
+    {
+        s_runs[run.previous].next = run.next;
+    }
+    else
+    {
+        s_bins[bin] = run.next;
+    }
+    if (run.next != ARENA_NO_PAGE)
+    {
+        s_runs[run.next].previous = run.previous;
+    }
+
+    if (s_bins[bin] == ARENA_NO_PAGE)
+    {
+        s_bin_mask &= ~(1ULL << bin);
+    }
+}
+
+//-------------------------------------------------------------------------
+static inline bool is_free_run_at(size_t page)
+{
+    return page < s_frontier && (s_runs[page].flags & ARENA_RUN_IN_USE) == 0;
+}
+
+//-------------------------------------------------------------------------
+// Frees a run, merging it with free neighbours; one that ends at the
+// frontier moves the frontier back instead
+static void release_run(size_t first_page, size_t page_count)
+{
+    if (is_free_run_at(first_page + page_count))
+    {
+        const size_t next_count = s_runs[first_page + page_count].page_count;
+        unlink_free(first_page + page_count);
+        page_count += next_count;
+    }
+
+    if (first_page > 0 && is_free_run_at(first_page - 1))
+    {
+        const size_t previous_count = s_runs[first_page - 1].page_count;
+        first_page -= previous_count;
+        page_count += previous_count;
+        unlink_free(first_page);
+    }
+
+    if (first_page + page_count == s_frontier)
+    {
+        s_frontier = first_page;
+        return;
+    }
+
+    push_free(first_page, page_count);
+}
+
+//-------------------------------------------------------------------------
+// Smallest free run of at least page_count pages, unlinked; the exact
+// bins are taken whole and the last bin is searched for the best fit
+static size_t take_free(size_t page_count)
+{
+    const size_t bin = bin_for(page_count);
+    if (bin < ARENA_BIN_COUNT - 1)
+    {
+        const uint64_t candidates = s_bin_mask & ~((1ULL << bin) - 1) & ~(1ULL << (ARENA_BIN_COUNT - 1));
+        if (candidates != 0)
+        {
+            size_t found_bin = bin;
+            while ((candidates & (1ULL << found_bin)) == 0)
+            {
+                ++found_bin;
+            }
+            const size_t first_page = s_bins[found_bin];
+            unlink_free(first_page);
+            return first_page;
+        }
+    }
+
+    size_t best = ARENA_NO_PAGE;
+    for (uint32_t page = s_bins[ARENA_BIN_COUNT - 1]; page != ARENA_NO_PAGE; page = s_runs[page].next)
+    {
+        if (s_runs[page].page_count >= page_count && (best == ARENA_NO_PAGE || s_runs[page].page_count < s_runs[best].page_count))
+        {
+            best = page;
+        }
+    }
+
+    if (best != ARENA_NO_PAGE)
+    {
+        unlink_free(best);
+    }
+    return best;
+}
+
+//-------------------------------------------------------------------------
+// Commits every unit the pages touch that isn't already
+static bool commit_range(size_t first_page, size_t page_count)
+{
+    const size_t first_unit = first_page / ARENA_PAGES_PER_UNIT;
+    const size_t last_unit = (first_page + page_count - 1) / ARENA_PAGES_PER_UNIT;
+
+    for (size_t unit = first_unit; unit <= last_unit; ++unit)
+    {
+        if (s_units[unit] & ARENA_UNIT_COMMITTED)
+        {
+            continue;
+        }
+
+        bool explicit_huge_pages = false;
+        if (!platform::commit_pages(s_memory + unit * ARENA_UNIT_SIZE, ARENA_UNIT_SIZE, &explicit_huge_pages))
+        {
+            return false;
+        }
+
+        s_units[unit] = ARENA_UNIT_COMMITTED | (explicit_huge_pages ? ARENA_UNIT_EXPLICIT_HUGE_PAGES : 0);
+        s_usage.committed_in_bytes += ARENA_UNIT_SIZE;
+        if (explicit_huge_pages)
+        {
+            s_usage.explicit_huge_page_in_bytes += ARENA_UNIT_SIZE;
+        }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Decommits the units that lie entirely within the pages
+static size_t decommit_range(size_t first_page, size_t page_count)
+{
+    const size_t first_unit = (first_page + ARENA_PAGES_PER_UNIT - 1) / ARENA_PAGES_PER_UNIT;
+    const size_t end_unit = (first_page + page_count) / ARENA_PAGES_PER_UNIT;
+
+    size_t released = 0;
+    for (size_t unit = first_unit; unit < end_unit; ++unit)
+    {
+        if ((s_units[unit] & ARENA_UNIT_COMMITTED) == 0)
+        {
+            continue;
+        }
+
+        platform::decommit_pages(s_memory + unit * ARENA_UNIT_SIZE, ARENA_UNIT_SIZE);
+        s_usage.committed_in_bytes -= ARENA_UNIT_SIZE;
+        if (s_units[unit] & ARENA_UNIT_EXPLICIT_HUGE_PAGES)
+        {
+            s_usage.explicit_huge_page_in_bytes -= ARENA_UNIT_SIZE;
+        }
+        s_units[unit] = 0;
+        released += ARENA_UNIT_SIZE;
+    }
+    return released;
+}
+
+//-------------------------------------------------------------------------
+static void add_used(int64_t page_delta)
+{
+    s_usage.used_in_bytes += page_delta * LARGE_BLOCK_ARENA_PAGE_SIZE;
+    if (s_usage.used_in_bytes > s_usage.peak_used_in_bytes)
+    {
+        s_usage.peak_used_in_bytes = s_usage.used_in_bytes;
+    }
+}
+
+//-------------------------------------------------------------------------
+static void release_locked()
+{
+    large_block_arena::detail::threshold.store(0, std::memory_order_relaxed);
+    large_block_arena::detail::begin.store(0, std::memory_order_relaxed);
+    large_block_arena::detail::end.store(0, std::memory_order_relaxed);
+
+    if (s_memory != nullptr)
+    {
+        platform::release_pages(s_memory, s_page_count * LARGE_BLOCK_ARENA_PAGE_SIZE);
+        platform::free_pages(s_runs, s_metadata_size);
+    }
+
+    s_memory = nullptr;
+    s_page_count = 0;
+    s_runs = nullptr;
+    s_units = nullptr;
+    s_metadata_size = 0;
+    s_frontier = 0;
+    s_bin_mask = 0;
+    s_usage = {};
+}
+
+//-------------------------------------------------------------------------
+bool large_block_arena::configure(size_t threshold_in_bytes, size_t capacity_in_bytes)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+
+    if (s_usage.used_in_bytes != 0)
+    {
+        return false;
+    }
+
+    const size_t capacity = round_up(capacity_in_bytes, ARENA_UNIT_SIZE);
+    if (threshold_in_bytes == 0 || capacity == 0)
+    {
+        release_locked();
+        return true;
+    }
+
+    if (capacity / LARGE_BLOCK_ARENA_PAGE_SIZE >= ARENA_NO_PAGE)
+    {
+        return false;
+    }
+
+    // Keep the reservation when only the threshold changes
+    if (capacity != s_page_count * LARGE_BLOCK_ARENA_PAGE_SIZE)
+    {
+        release_locked();
+
+        const size_t page_count = capacity / LARGE_BLOCK_ARENA_PAGE_SIZE;
+        const size_t unit_count = capacity / ARENA_UNIT_SIZE;
+        const size_t metadata_size = page_count * sizeof(PageRun) + unit_count;
+
+        char *memory = static_cast<char*>(platform::reserve_pages(capacity, ARENA_UNIT_SIZE));
+        void *metadata = memory != nullptr ? platform::alloc_pages(metadata_size, 0) : nullptr;
+        if (metadata == nullptr)
+        {
+            platform::release_pages(memory, capacity);
+            return false;
+        }
+
+        s_memory = memory;
+        s_page_count = page_count;
+        s_runs = static_cast<PageRun*>(metadata);
+        s_units = reinterpret_cast<uint8_t*>(s_runs + page_count);
+        s_metadata_size = metadata_size;
+        for (uint32_t& bin : s_bins)
+        {
+            bin = ARENA_NO_PAGE;
+        }
+
+        detail::begin.store(reinterpret_cast<uintptr_t>(memory), std::memory_order_relaxed);
+        detail::end.store(reinterpret_cast<uintptr_t>(memory) + capacity, std::memory_order_relaxed);
+    }
+
+    detail::threshold.store(threshold_in_bytes, std::memory_order_relaxed);
+    return true;
+}
+
+//-------------------------------------------------------------------------
+void * large_block_arena::alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    if (alignment_in_bytes > LARGE_BLOCK_ARENA_PAGE_SIZE || size_in_bytes > SIZE_MAX - LARGE_BLOCK_ARENA_PAGE_SIZE)
+    {
+        return nullptr;
+    }
+
+    const size_t page_count = pages_for(size_in_bytes);
+
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+
+    if (s_memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    size_t first_page = take_free(page_count);
+    size_t run_count = 0;
+    if (first_page != ARENA_NO_PAGE)
+    {
+        run_count = s_runs[first_page].page_count;
+    }
+    else if (page_count <= s_page_count - s_frontier)
+    {
+        first_page = s_frontier;
+        run_count = page_count;
+        s_frontier += page_count;
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    if (!commit_range(first_page, page_count))
+    {
+        release_run(first_page, run_count);
+        return nullptr;
+    }
+
+    mark_run(first_page, page_count, ARENA_RUN_IN_USE);
+    if (run_count > page_count)
+    {
+        release_run(first_page + page_count, run_count - page_count);
+    }
+
+    add_used(static_cast<int64_t>(page_count));
+    s_usage.alloc_count++;
+
+    return pointer_of(first_page);
+}
+
+//-------------------------------------------------------------------------
+// Grows into a free run or the frontier straight after the block, or gives
+// the pages it no longer needs back
+void * large_block_arena::realloc_in_place(void *pointer, size_t size_in_bytes)
+{
+    if (size_in_bytes > SIZE_MAX - LARGE_BLOCK_ARENA_PAGE_SIZE)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+
+    const size_t first_page = page_of(pointer);
+    const size_t page_count = s_runs[first_page].page_count;
+    const size_t new_page_count = pages_for(size_in_bytes);
+
+    if (new_page_count <= page_count)
+    {
+        if (new_page_count < page_count)
+        {
+            mark_run(first_page, new_page_count, ARENA_RUN_IN_USE);
+            release_run(first_page + new_page_count, page_count - new_page_count);
+            add_used(-static_cast<int64_t>(page_count - new_page_count));
+        }
+        return pointer;
+    }
+
+    const size_t next_page = first_page + page_count;
+    const size_t growth = new_page_count - page_count;
+
+    if (next_page == s_frontier)
+    {
+        if (growth > s_page_count - s_frontier || !commit_range(next_page, growth))
+        {
+            return nullptr;
+        }
+        s_frontier += growth;
+    }
+    else if (is_free_run_at(next_page) && s_runs[next_page].page_count >= growth)
+    {
+        if (!commit_range(next_page, growth))
+        {
+            return nullptr;
+        }
+
+        const size_t next_count = s_runs[next_page].page_count;
+        unlink_free(next_page);
+        if (next_count > growth)
+        {
+            push_free(next_page + growth, next_count - growth);
+        }
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    mark_run(first_page, new_page_count, ARENA_RUN_IN_USE);
+    add_used(static_cast<int64_t>(growth));
+
+    return pointer;
+}
+
+//-------------------------------------------------------------------------
+void large_block_arena::free(void *pointer)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+
+    const size_t first_page = page_of(pointer);
+    const size_t page_count = s_runs[first_page].page_count;
+
+    release_run(first_page, page_count);
+    add_used(-static_cast<int64_t>(page_count));
+}
+
+//-------------------------------------------------------------------------
+size_t large_block_arena::block_size(const void *pointer)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    return static_cast<size_t>(s_runs[page_of(pointer)].page_count) * LARGE_BLOCK_ARENA_PAGE_SIZE;
+}
+
+//-------------------------------------------------------------------------
+size_t large_block_arena::trim()
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+
+    if (s_memory == nullptr)
+    {
+        return 0;
+    }
+
+    size_t released = decommit_range(s_frontier, s_page_count - s_frontier);
+    for (size_t bin = 0; bin < ARENA_BIN_COUNT; ++bin)
+    {
+        for (uint32_t page = s_bins[bin]; page != ARENA_NO_PAGE; page = s_runs[page].next)
+        {
+            released += decommit_range(page, s_runs[page].page_count);
+        }
+    }
+    return released;
+}
+
+//-------------------------------------------------------------------------
+void large_block_arena::usage(Usage *out_usage)
+{
+    std::lock_guard<std::mutex> scope_lock(s_lock);
+    *out_usage = s_usage;
+}
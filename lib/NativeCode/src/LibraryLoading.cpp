@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "LibraryLoading.h"
+#include <chrono>
+#include <exception>
+#include <future>
+#include <string>
+
+//-------------------------------------------------------------------------
+void * library_loading::load_async(DLLHContext *ctx, const char *library_path, LoadLibraryFunction load_library)
+{
+    if (ctx == nullptr || library_path == nullptr)
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        return new std::future<void*>(std::async(std::launch::async, [ctx, path = std::string(library_path), load_library]()
+        {
+            return load_library(ctx, path.c_str());
+        }));
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+//-------------------------------------------------------------------------
+bool library_loading::poll(void *ticket)
+{
+    if (ticket == nullptr)
+    {
+        return false;
+    }
+
+    std::future<void*> *load = static_cast<std::future<void*>*>(ticket);
+    return load->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+//-------------------------------------------------------------------------
+void * library_loading::wait(void *ticket)
+{
+    if (ticket == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::future<void*> *load = static_cast<std::future<void*>*>(ticket);
+    void *to_return = load->get();
+    delete load;
+
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+size_t library_loading::load_functions(DLLHContext *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count, LoadFunctionFunction load_function)
+{
+    if (function_names == nullptr || out_functions == nullptr)
+    {
+        return 0;
+    }
+
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out_functions[i] = function_names[i] != nullptr ? load_function(ctx, library_handle, function_names[i]) : nullptr;
+        if (out_functions[i] != nullptr)
+        {
+            ++found;
+        }
+    }
+
+    return found;
+}
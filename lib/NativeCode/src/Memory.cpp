@@ -22,130 +22,447 @@
 
 #include "pch.h"
 #include "Memory.h"
+#include "AllocationTrace.h"
+#include "EmergencyArena.h"
+#include "HeapProfiler.h"
+#include "LargeBlockArena.h"
+#include "MemoryBudget.h"
+#include "MemoryCounters.h"
+#include "MemoryPool.h"
+#include "MemorySnapshot.h"
+#include "MemoryTracker.h"
+#include "MemoryTrim.h"
 #include <atomic>
-#include <mutex>
-#include <vector>
+#include <stdint.h>
+#include <string.h>
+#include <tuple>
 
-//#define DLLH_ENABLE_MEMORY_COUNTER 1
-//#define DLLH_USE_ATOMIC_MEMORY_COUNTER
-
-#ifdef DLLH_ENABLE_MEMORY_COUNTER
-
-#if DLLH_USE_ATOMIC_MEMORY_COUNTER
-static std::atomic_int64_t s_currentMemoryAllocatedInBytes(0);
-#else
-int64_t s_currentMemoryAllocatedInBytes;
+// Tracking is O(1) per call and thread safe, so it's on by default. Define
+// DLLH_ENABLE_MEMORY_COUNTER to 0 to compile it out entirely.
+#ifndef DLLH_ENABLE_MEMORY_COUNTER
+#define DLLH_ENABLE_MEMORY_COUNTER 1
 #endif
 
-std::mutex g_allocated_bytes_mutex;
-#endif
-std::vector<std::tuple<void*, size_t>> g_allocated_bytes;
+// old_block_size() of a system block the tracker doesn't hold
+#define UNKNOWN_BLOCK_SIZE SIZE_MAX
+
+static std::atomic<MemAllocatorBackend> s_allocator_backend(MemAllocatorBackend::System);
 
 //-------------------------------------------------------------------------
 int64_t readCurrentMemoryAllocatedInBytes()
 {
-#if DLLH_USE_ATOMIC_MEMORY_COUNTER
-    return s_currentMemoryAllocatedInBytes.load();
-#else
 #if DLLH_ENABLE_MEMORY_COUNTER
-    return s_currentMemoryAllocatedInBytes;
+    return memory_counters::current_bytes();
 #else
     return 0;
 #endif
+}
+
+//-------------------------------------------------------------------------
+static void remove_pointer(void* ptr)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    TrackedAllocation allocation;
+    if (memory_tracker::remove(ptr, &allocation))
+    {
+        memory_counters::record_free(allocation.thread_slot, allocation.size_in_bytes);
+        if (allocation.sampled)
+        {
+            heap_profiler::remove_sample(ptr);
+        }
+    }
+#else
+    std::ignore = ptr;
 #endif
 }
 
 //-------------------------------------------------------------------------
-static int64_t get_allocated_bytes_total()
+static inline uint8_t alignment_log2_for(size_t alignment_in_bytes)
 {
-    int64_t total = 0;
-    //std::lock_guard<std::mutex> scope_lock(g_allocated_bytes_mutex);
-    for (auto iter = g_allocated_bytes.begin(); iter != g_allocated_bytes.end(); ++iter)
+    uint8_t alignment_log2 = 0;
+    while (alignment_log2 < 63 && (static_cast<size_t>(2) << alignment_log2) <= alignment_in_bytes)
     {
-        total += std::get<1>(*iter);
+        ++alignment_log2;
     }
-    return total;
+    return alignment_log2;
 }
 
 //-------------------------------------------------------------------------
-static std::vector<std::tuple<void*, size_t>>::iterator get_matching_ptr(void* ptr)
+static void add_pointer(void* ptr, size_t size_in_bytes, size_t alignment_in_bytes)
 {
-#ifdef DLLH_ENABLE_MEMORY_COUNTER
-    if (ptr != nullptr)
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (ptr == nullptr)
     {
-        //std::lock_guard<std::mutex> scope_lock(g_allocated_bytes_mutex);
-        for(auto iter = g_allocated_bytes.begin(); iter != g_allocated_bytes.end(); ++iter)
-        {
-            if (std::get<0>(*iter) == ptr)
-            {
-                return iter;
-            }
-        }
+        return;
     }
+
+    const uint32_t thread_slot = memory_counters::current_thread_slot();
+    const bool sampled = heap_profiler::is_enabled() && heap_profiler::should_sample(size_in_bytes);
+
+    // Only what the tracker holds is counted, so that its free is too
+    if (!memory_tracker::add({ ptr, size_in_bytes, memory_tracker::allocation_tick(), static_cast<uint16_t>(thread_slot), alignment_log2_for(alignment_in_bytes), sampled }))
+    {
+        return;
+    }
+    memory_counters::record_alloc(thread_slot, size_in_bytes);
+    if (sampled)
+    {
+        heap_profiler::record_sample(ptr, size_in_bytes);
+    }
+#else
+    std::ignore = ptr, size_in_bytes, alignment_in_bytes;
 #endif
-    return g_allocated_bytes.end();
 }
 
 //-------------------------------------------------------------------------
-static size_t get_alloc_size(void* ptr)
+// Takes ptr's entry out before a realloc gives the block back to the
+// backend. Once the backend has moved or freed it, another thread can be
+// handed the same address, and that thread's entry mustn't be the one that
+// gets removed. Returns false if ptr isn't tracked.
+static bool take_pointer(void* ptr, TrackedAllocation *out_allocation)
 {
-#ifdef DLLH_ENABLE_MEMORY_COUNTER
-    auto iter = get_matching_ptr(ptr);
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (ptr == nullptr || !memory_tracker::remove(ptr, out_allocation))
+    {
+        return false;
+    }
 
-    if (iter != g_allocated_bytes.end())
+    if (out_allocation->sampled)
     {
-        return std::get<1>(*iter);
+        heap_profiler::remove_sample(ptr);
     }
+    return true;
 #else
-    std::ignore = ptr;
+    std::ignore = ptr, out_allocation;
+    return false;
 #endif
+}
 
-    return 0;
+//-------------------------------------------------------------------------
+// Puts back an entry take_pointer took out, when the realloc failed and the
+// block is still live. A sampled block gets the failed realloc's backtrace.
+static void restore_pointer(const TrackedAllocation& allocation)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (!memory_tracker::add(allocation))
+    {
+        memory_counters::record_free(allocation.thread_slot, allocation.size_in_bytes);
+        return;
+    }
+
+    if (allocation.sampled)
+    {
+        heap_profiler::record_sample(allocation.pointer, allocation.size_in_bytes);
+    }
+#else
+    std::ignore = allocation;
+#endif
 }
 
 //-------------------------------------------------------------------------
-static void remove_pointer(void* ptr)
+// ptr has been resized to size_in_bytes and now lives at new_ptr.
+// old_allocation is what take_pointer took out for it, or null if ptr
+// wasn't tracked.
+static void replace_pointer(void* ptr, const TrackedAllocation *old_allocation, void* new_ptr, size_t size_in_bytes, size_t alignment_in_bytes)
 {
-#ifdef DLLH_ENABLE_MEMORY_COUNTER
-    auto iter = get_matching_ptr(ptr);
-    if (iter != g_allocated_bytes.end())
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (ptr == nullptr)
+    {
+        add_pointer(new_ptr, size_in_bytes, alignment_in_bytes);
+        return;
+    }
+
+    const uint32_t thread_slot = memory_counters::current_thread_slot();
+    const TrackedAllocation allocation = old_allocation != nullptr
+        ? *old_allocation
+        : TrackedAllocation{ ptr, 0, memory_tracker::allocation_tick(), static_cast<uint16_t>(thread_slot), 0, false };
+
+    // The resized block is sampled as if it were a new allocation
+    const bool sampled = heap_profiler::is_enabled() && heap_profiler::should_sample(size_in_bytes);
+
+    // The block keeps its age, so a buffer that keeps growing still shows
+    // up as old in snapshots
+    if (!memory_tracker::add({ new_ptr, size_in_bytes, allocation.tick, static_cast<uint16_t>(thread_slot), alignment_log2_for(alignment_in_bytes), sampled }))
     {
-        // This crashes sometimes, as the ptr that's passed in isn't always valid, maybe????
-        size_t previous_size = get_alloc_size(ptr);
+        // Untracked from here on, so its free won't be counted either
+        if (old_allocation != nullptr)
+        {
+            memory_counters::record_free(allocation.thread_slot, allocation.size_in_bytes);
+        }
+        return;
+    }
 
-        //NN_LOG("MEM: remove ptr: (%p)", ptr);
-        s_currentMemoryAllocatedInBytes -= previous_size;
-        //std::lock_guard<std::mutex> scope_lock(g_allocated_bytes_mutex);
-        auto end_value = g_allocated_bytes.back();
-        *iter = end_value;
-        g_allocated_bytes.pop_back();
+    memory_counters::record_realloc(thread_slot, allocation.thread_slot, allocation.size_in_bytes, size_in_bytes);
+    if (sampled)
+    {
+        heap_profiler::record_sample(new_ptr, size_in_bytes);
     }
 #else
-    std::ignore = ptr;
+    std::ignore = ptr, old_allocation, new_ptr, size_in_bytes, alignment_in_bytes;
 #endif
 }
 
 //-------------------------------------------------------------------------
-static void add_pointer(void* ptr, size_t size_in_bytes)
+static void * backend_alloc(size_t size_in_bytes, size_t alignment_in_bytes)
 {
-#ifdef DLLH_ENABLE_MEMORY_COUNTER
-    //std::lock_guard<std::mutex> scope_lock(g_allocated_bytes_mutex);
-    g_allocated_bytes.push_back(std::tuple<void*,size_t>(ptr, size_in_bytes));
-    s_currentMemoryAllocatedInBytes += size_in_bytes;
+    if (large_block_arena::wants(size_in_bytes))
+    {
+        void *large = large_block_arena::alloc(size_in_bytes, alignment_in_bytes);
+        if (large != nullptr)
+        {
+            return large;
+        }
+    }
+
+    if (s_allocator_backend.load(std::memory_order_relaxed) == MemAllocatorBackend::Pooled)
+    {
+        void *pooled = memory_pool::alloc(size_in_bytes, alignment_in_bytes);
+        if (pooled != nullptr)
+        {
+            return pooled;
+        }
+    }
+
+    return platform::alloc_aligned(size_in_bytes, alignment_in_bytes);
+}
+
+//-------------------------------------------------------------------------
+static void backend_free(void *ptr)
+{
+    if (large_block_arena::owns(ptr))
+    {
+        large_block_arena::free(ptr);
+    }
+    else if (memory_pool::owns(ptr))
+    {
+        memory_pool::free(ptr);
+    }
+    else
+    {
+        platform::free_aligned(ptr);
+    }
+}
+
+//-------------------------------------------------------------------------
+// The size ptr was last asked for, which is what reallocs copy and measure
+// growth by. Only the tracker knows it for system blocks: on Windows they
+// come from _aligned_malloc, which platform::mem_usable_size can't size.
+// allocation is what take_pointer took out for ptr, or null.
+static size_t old_block_size(void *ptr, const TrackedAllocation *allocation)
+{
+    if (allocation != nullptr)
+    {
+        return allocation->size_in_bytes;
+    }
+    if (emergency_arena::owns(ptr))
+    {
+        return emergency_arena::block_size(ptr);
+    }
+    if (large_block_arena::owns(ptr))
+    {
+        return large_block_arena::block_size(ptr);
+    }
+    return memory_pool::owns(ptr) ? memory_pool::block_size(ptr) : UNKNOWN_BLOCK_SIZE;
+}
+
+//-------------------------------------------------------------------------
+// Large blocks stay in the arena as long as they can be resized where they
+// are, even below the threshold; otherwise they move wherever
+// backend_alloc puts the new size
+static void * large_block_realloc(void *ptr, size_t old_size_in_bytes, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    if (alignment_in_bytes <= LARGE_BLOCK_ARENA_PAGE_SIZE)
+    {
+        void *resized = large_block_arena::realloc_in_place(ptr, size_in_bytes);
+        if (resized != nullptr)
+        {
+            return resized;
+        }
+    }
+
+    void *to_return = backend_alloc(size_in_bytes, alignment_in_bytes);
+    if (to_return != nullptr)
+    {
+        memcpy(to_return, ptr, old_size_in_bytes < size_in_bytes ? old_size_in_bytes : size_in_bytes);
+        large_block_arena::free(ptr);
+    }
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+// old_size_in_bytes is old_block_size() of ptr
+static void * backend_realloc(void *ptr, size_t old_size_in_bytes, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    if (ptr == nullptr)
+    {
+        return backend_alloc(size_in_bytes, alignment_in_bytes);
+    }
+
+    if (large_block_arena::owns(ptr))
+    {
+        return large_block_realloc(ptr, old_size_in_bytes, size_in_bytes, alignment_in_bytes);
+    }
+
+    // Blocks that grow past the threshold move into the large block arena,
+    // unless there's no telling how much of them to copy
+    if (large_block_arena::wants(size_in_bytes) && old_size_in_bytes != UNKNOWN_BLOCK_SIZE)
+    {
+        void *large = large_block_arena::alloc(size_in_bytes, alignment_in_bytes);
+        if (large != nullptr)
+        {
+            memcpy(large, ptr, old_size_in_bytes < size_in_bytes ? old_size_in_bytes : size_in_bytes);
+            backend_free(ptr);
+            return large;
+        }
+    }
+
+    if (!memory_pool::owns(ptr))
+    {
+        return platform::realloc_aligned(ptr, size_in_bytes, alignment_in_bytes);
+    }
+
+    if (memory_pool::fits_in_place(ptr, size_in_bytes, alignment_in_bytes))
+    {
+        return ptr;
+    }
+
+    void *to_return = backend_alloc(size_in_bytes, alignment_in_bytes);
+    if (to_return != nullptr)
+    {
+        memcpy(to_return, ptr, old_size_in_bytes < size_in_bytes ? old_size_in_bytes : size_in_bytes);
+        memory_pool::free(ptr);
+    }
+
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+static void * emergency_alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    void *to_return = emergency_arena::alloc(size_in_bytes, alignment_in_bytes);
+    if (to_return == nullptr)
+    {
+        memory_budget::report_exhausted();
+    }
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+// Once an admitted allocation has been counted, or has failed
+static void release_reservation(size_t reserved_bytes)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (reserved_bytes != 0)
+    {
+        memory_budget::release_reservation(reserved_bytes);
+    }
 #else
-    std::ignore = ptr, size_in_bytes;
+    std::ignore = reserved_bytes;
 #endif
 }
+
 //-------------------------------------------------------------------------
+// Requests that would take usage over the hard memory budget are served
+// from the emergency arena instead. out_reserved_bytes receives what the
+// budget set aside for the allocation, for release_reservation.
+static void * budgeted_alloc(size_t size_in_bytes, size_t alignment_in_bytes, size_t *out_reserved_bytes)
+{
+    *out_reserved_bytes = 0;
+
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (memory_budget::is_enabled())
+    {
+        if (!memory_budget::admit(size_in_bytes))
+        {
+            return emergency_alloc(size_in_bytes, alignment_in_bytes);
+        }
+        *out_reserved_bytes = size_in_bytes;
+    }
+#endif
+
+    return backend_alloc(size_in_bytes, alignment_in_bytes);
+}
+
 //-------------------------------------------------------------------------
+// Blocks move into the emergency arena when growing them would go over the
+// hard limit, and back out once there's room under it again. old_size_in_bytes
+// is old_block_size() of ptr.
+static void * budgeted_realloc(void *ptr, size_t old_size_in_bytes, size_t size_in_bytes, size_t alignment_in_bytes, size_t *out_reserved_bytes)
+{
+    if (ptr == nullptr)
+    {
+        return budgeted_alloc(size_in_bytes, alignment_in_bytes, out_reserved_bytes);
+    }
+
+    *out_reserved_bytes = 0;
+
+    const bool in_arena = emergency_arena::owns(ptr);
+    void *to_return = nullptr;
+
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (memory_budget::is_enabled())
+    {
+        // A block of unknown size is admitted as if it were all new
+        const size_t old_size = old_size_in_bytes != UNKNOWN_BLOCK_SIZE ? old_size_in_bytes : 0;
+        const size_t growth = size_in_bytes > old_size ? size_in_bytes - old_size : 0;
+
+        const size_t admitted = in_arena ? size_in_bytes : growth;
+        if (memory_budget::admit(admitted))
+        {
+            *out_reserved_bytes = admitted;
+        }
+        else
+        {
+            if (in_arena)
+            {
+                to_return = emergency_arena::realloc(ptr, size_in_bytes, alignment_in_bytes);
+                if (to_return == nullptr)
+                {
+                    memory_budget::report_exhausted();
+                }
+                return to_return;
+            }
+
+            // There's no telling how much of a block of unknown size to copy
+            to_return = old_size_in_bytes != UNKNOWN_BLOCK_SIZE ? emergency_alloc(size_in_bytes, alignment_in_bytes) : nullptr;
+            if (to_return != nullptr)
+            {
+                memcpy(to_return, ptr, old_size < size_in_bytes ? old_size : size_in_bytes);
+                backend_free(ptr);
+            }
+            return to_return;
+        }
+    }
+#endif
+
+    if (!in_arena)
+    {
+        return backend_realloc(ptr, old_size_in_bytes, size_in_bytes, alignment_in_bytes);
+    }
+
+    to_return = backend_alloc(size_in_bytes, alignment_in_bytes);
+    if (to_return != nullptr)
+    {
+        memcpy(to_return, ptr, old_size_in_bytes < size_in_bytes ? old_size_in_bytes : size_in_bytes);
+        emergency_arena::free(ptr);
+    }
+    return to_return;
+}
 
 //-------------------------------------------------------------------------
 FUN_EXPORT(void *) Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes)
 {
     void * to_return = nullptr;
 
-    to_return = platform::alloc_aligned(size_in_bytes, alignment_in_bytes);
-    add_pointer(to_return, size_in_bytes);
+    size_t reserved_bytes = 0;
+    to_return = budgeted_alloc(size_in_bytes, alignment_in_bytes, &reserved_bytes);
+    add_pointer(to_return, size_in_bytes, alignment_in_bytes);
+    release_reservation(reserved_bytes);
+
+    if (allocation_trace::is_recording() && to_return != nullptr)
+    {
+        allocation_trace::record(AllocationTraceEventType::Alloc, to_return, nullptr, size_in_bytes, alignment_in_bytes);
+    }
 
     return to_return;
 }
@@ -155,10 +472,44 @@ FUN_EXPORT(void *) Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, si
 {
     void * to_return = nullptr;
 
-    to_return = platform::realloc_aligned(ptr, size_in_bytes, alignment_in_bytes);
+    TrackedAllocation allocation;
+    const bool tracked = take_pointer(ptr, &allocation);
 
-    remove_pointer(ptr);
-    add_pointer(to_return, size_in_bytes);
+    // Stamped before the old block can be handed to another thread, though
+    // it can only be recorded once the new one is known
+    const bool tracing = allocation_trace::is_recording();
+    const uint64_t trace_timestamp_ns = tracing ? allocation_trace::now_ns() : 0;
+
+    size_t reserved_bytes = 0;
+    const size_t old_size_in_bytes = ptr != nullptr ? old_block_size(ptr, tracked ? &allocation : nullptr) : 0;
+    to_return = budgeted_realloc(ptr, old_size_in_bytes, size_in_bytes, alignment_in_bytes, &reserved_bytes);
+
+    // A failed realloc leaves the original block untouched. Backends keep
+    // blocks resized to 0 bytes valid, so null always means failure.
+    if (to_return == nullptr)
+    {
+        release_reservation(reserved_bytes);
+        if (tracked)
+        {
+            restore_pointer(allocation);
+        }
+        return nullptr;
+    }
+
+    replace_pointer(ptr, tracked ? &allocation : nullptr, to_return, size_in_bytes, alignment_in_bytes);
+    release_reservation(reserved_bytes);
+
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (memory_budget::is_enabled())
+    {
+        memory_budget::on_release();
+    }
+#endif
+
+    if (tracing)
+    {
+        allocation_trace::record(AllocationTraceEventType::Realloc, to_return, ptr, size_in_bytes, alignment_in_bytes, trace_timestamp_ns);
+    }
 
     return to_return;
 }
@@ -166,23 +517,104 @@ FUN_EXPORT(void *) Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, si
 //-------------------------------------------------------------------------
 FUN_EXPORT(void) Mem_generic_free(void *ptr)
 {
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
     remove_pointer(ptr);
 
-    platform::free_aligned(ptr);
+    // Before the block can be handed out again, so the trace never shows
+    // it allocated twice
+    if (allocation_trace::is_recording())
+    {
+        allocation_trace::record(AllocationTraceEventType::Free, ptr, nullptr, 0, 0);
+    }
+
+    if (emergency_arena::owns(ptr))
+    {
+        emergency_arena::free(ptr);
+    }
+    else
+    {
+        backend_free(ptr);
+    }
+
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (memory_budget::is_enabled())
+    {
+        memory_budget::on_release();
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Returns false if backend isn't a known MemAllocatorBackend
+FUN_EXPORT(bool) Mem_SetAllocatorBackend(int32_t backend)
+{
+    switch (static_cast<MemAllocatorBackend>(backend))
+    {
+    case MemAllocatorBackend::System:
+    case MemAllocatorBackend::Pooled:
+        s_allocator_backend.store(static_cast<MemAllocatorBackend>(backend), std::memory_order_relaxed);
+        return true;
+    default:
+        return false;
+    }
+}
+
+//-------------------------------------------------------------------------
+FUN_EXPORT(int32_t) Mem_GetAllocatorBackend()
+{
+    return static_cast<int32_t>(s_allocator_backend.load(std::memory_order_relaxed));
+}
+
+//-------------------------------------------------------------------------
+static void* MEM_EOS_CALL eos_allocate_memory(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    return Mem_generic_align_alloc(size_in_bytes, alignment_in_bytes);
 }
 
 //-------------------------------------------------------------------------
+static void* MEM_EOS_CALL eos_reallocate_memory(void *pointer, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    return Mem_generic_align_realloc(pointer, size_in_bytes, alignment_in_bytes);
+}
+
+//-------------------------------------------------------------------------
+static void MEM_EOS_CALL eos_release_memory(void *pointer)
+{
+    Mem_generic_free(pointer);
+}
+
+//-------------------------------------------------------------------------
+// The functions to put in EOS_InitializeOptions' AllocateMemoryFunction,
+// ReallocateMemoryFunction and ReleaseMemoryFunction
 FUN_EXPORT(void) Mem_GetAllocatorFunctions(void** alloc, void** realloc, void** free)
 {
-    *alloc = reinterpret_cast<void*>(&Mem_generic_align_alloc);
-    *realloc = reinterpret_cast<void*>(&Mem_generic_align_realloc);
-    *free = reinterpret_cast<void*>(&Mem_generic_free);
+    *alloc = reinterpret_cast<void*>(static_cast<MemAllocateFunc>(&eos_allocate_memory));
+    *realloc = reinterpret_cast<void*>(static_cast<MemReallocateFunc>(&eos_reallocate_memory));
+    *free = reinterpret_cast<void*>(static_cast<MemReleaseFunc>(&eos_release_memory));
+}
+
+//-------------------------------------------------------------------------
+// Sends allocations of threshold_in_bytes or more to an arena of
+// capacity_in_bytes backed by huge pages where the platform allows. Off by
+// default; 0 for either turns it off again. Returns false if blocks are
+// still allocated from the arena or the address space isn't available.
+FUN_EXPORT(bool) Mem_SetLargeBlockArena(uint64_t threshold_in_bytes, uint64_t capacity_in_bytes)
+{
+    if (threshold_in_bytes > SIZE_MAX || capacity_in_bytes > SIZE_MAX)
+    {
+        return false;
+    }
+    return large_block_arena::configure(static_cast<size_t>(threshold_in_bytes), static_cast<size_t>(capacity_in_bytes));
 }
 
 //-------------------------------------------------------------------------
 FUN_EXPORT(void) Mem_GetAllocationCounters(void* data)
 {
-#ifdef DLLH_ENABLE_MEMORY_COUNTER
+#if DLLH_ENABLE_MEMORY_COUNTER
     MemCounters* mem_counters = reinterpret_cast<MemCounters*>(data);
 
     mem_counters->currentMemoryAllocatedInBytes = readCurrentMemoryAllocatedInBytes();
@@ -190,3 +622,240 @@ FUN_EXPORT(void) Mem_GetAllocationCounters(void* data)
     std::ignore = data;
 #endif
 }
+
+//-------------------------------------------------------------------------
+// data must point to a MemCountersEx with apiVersion set. Returns false if
+// the counters are compiled out or apiVersion isn't supported.
+FUN_EXPORT(bool) Mem_GetAllocationCountersEx(void* data)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    MemCountersEx* mem_counters = reinterpret_cast<MemCountersEx*>(data);
+    if (mem_counters == nullptr || mem_counters->apiVersion < 2 || mem_counters->apiVersion > MEM_COUNTERSEX_API_LATEST)
+    {
+        return false;
+    }
+
+    memory_counters::read(mem_counters);
+
+    if (mem_counters->apiVersion >= 3)
+    {
+        large_block_arena::Usage usage;
+        large_block_arena::usage(&usage);
+        mem_counters->largeBlockCommittedInBytes = usage.committed_in_bytes;
+        mem_counters->largeBlockUsedInBytes = usage.used_in_bytes;
+        mem_counters->largeBlockPeakUsedInBytes = usage.peak_used_in_bytes;
+        mem_counters->largeBlockExplicitHugePageInBytes = usage.explicit_huge_page_in_bytes;
+        mem_counters->largeBlockAllocCount = usage.alloc_count;
+    }
+    return true;
+#else
+    std::ignore = data;
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Samples roughly one allocation per interval_in_bytes allocated; 0 turns
+// the heap profiler off. Needs the memory counters.
+FUN_EXPORT(void) Mem_SetHeapProfileSampleInterval(uint64_t interval_in_bytes)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    heap_profiler::set_sample_interval(interval_in_bytes);
+#else
+    std::ignore = interval_in_bytes;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// format is a HeapProfileFormat. Returns false if the file couldn't be
+// written.
+FUN_EXPORT(bool) Mem_WriteHeapProfile(const char* path, int32_t format)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (path == nullptr)
+    {
+        return false;
+    }
+
+    FILE *file = nullptr;
+#if PLATFORM_WINDOWS
+    fopen_s(&file, path, "w");
+#else
+    file = fopen(path, "w");
+#endif
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    const bool written = heap_profiler::write_profile(file, static_cast<HeapProfileFormat>(format));
+    return fclose(file) == 0 && written;
+#else
+    std::ignore = path, format;
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Records when each block is allocated, for the ages in
+// Mem_SnapshotLiveAllocations and the leak report. Costs a clock read per
+// allocation, so it is off until turned on. Needs the memory counters.
+FUN_EXPORT(bool) Mem_SetAllocationAgeTracking(bool enabled)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    memory_tracker::set_track_ages(enabled);
+    return true;
+#else
+    std::ignore = enabled;
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Fills buffer with up to capacity MemLiveAllocation entries, one per block
+// live through Mem_generic_*. Returns the number of live blocks, which is
+// more than were written if buffer was too small; -1 if api_version isn't
+// supported or the memory counters are compiled out.
+FUN_EXPORT(int64_t) Mem_SnapshotLiveAllocations(int32_t api_version, void* buffer, uint64_t capacity)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (api_version != MEM_LIVE_ALLOCATION_API_LATEST)
+    {
+        return -1;
+    }
+
+    MemLiveAllocation* allocations = reinterpret_cast<MemLiveAllocation*>(buffer);
+    return static_cast<int64_t>(memory_snapshot::live_allocations(allocations, static_cast<size_t>(capacity)));
+#else
+    std::ignore = api_version, buffer, capacity;
+    return -1;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Writes the blocks still live to path as text, totalled by size class and
+// by thread, with the oldest listed individually. Called when the plugin is
+// unloaded, by which point anything left is a leak.
+FUN_EXPORT(bool) Mem_WriteLeakReport(const char* path)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    if (path == nullptr)
+    {
+        return false;
+    }
+
+    FILE *file = nullptr;
+#if PLATFORM_WINDOWS
+    fopen_s(&file, path, "w");
+#else
+    file = fopen(path, "w");
+#endif
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    const bool written = memory_snapshot::write_leak_report(file);
+    return fclose(file) == 0 && written;
+#else
+    std::ignore = path;
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Limits are in bytes live through Mem_generic_*; 0 turns a limit off.
+// emergency_arena_in_bytes is committed straight away and serves
+// allocations over the hard limit. Needs the memory counters. Returns false
+// if the arena couldn't be reserved, or has to change size while in use.
+FUN_EXPORT(bool) Mem_SetMemoryBudget(int64_t soft_limit_in_bytes, int64_t hard_limit_in_bytes, uint64_t emergency_arena_in_bytes)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    return memory_budget::set_limits(soft_limit_in_bytes, hard_limit_in_bytes, static_cast<size_t>(emergency_arena_in_bytes));
+#else
+    std::ignore = soft_limit_in_bytes, hard_limit_in_bytes, emergency_arena_in_bytes;
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// callback is a MemBudgetCallback, or null to stop being told
+FUN_EXPORT(void) Mem_SetMemoryBudgetCallback(void* callback, void* user_data)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    memory_budget::set_callback(reinterpret_cast<MemBudgetCallback>(callback), user_data);
+#else
+    std::ignore = callback, user_data;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Passes the budget events flagged since the last call to the callback, on
+// the calling thread; call it from the game's tick. Returns how many there
+// were.
+FUN_EXPORT(uint32_t) Mem_DeliverMemoryBudgetEvents()
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    return memory_budget::deliver_events();
+#else
+    return 0;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// data must point to a MemBudgetStatus with apiVersion set
+FUN_EXPORT(bool) Mem_GetMemoryBudgetStatus(void* data)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    MemBudgetStatus* status = reinterpret_cast<MemBudgetStatus*>(data);
+    if (status == nullptr || status->apiVersion != MEM_BUDGET_STATUS_API_LATEST)
+    {
+        return false;
+    }
+
+    memory_budget::read_status(status);
+    return true;
+#else
+    std::ignore = data;
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Gives memory the allocator is holding on to but not using back to the OS.
+// Worth calling when the application is suspended. Returns the bytes
+// released, where they can be told.
+FUN_EXPORT(uint64_t) Mem_Trim()
+{
+    return static_cast<uint64_t>(memory_trim::trim());
+}
+
+//-------------------------------------------------------------------------
+// Trims automatically once no allocations have been made for
+// idle_timeout_ms; 0 turns it off. Needs the memory counters, which is how
+// idleness is noticed.
+FUN_EXPORT(bool) Mem_SetIdleTrimTimeout(uint64_t idle_timeout_ms)
+{
+#if DLLH_ENABLE_MEMORY_COUNTER
+    memory_trim::set_idle_timeout(idle_timeout_ms);
+    return true;
+#else
+    std::ignore = idle_timeout_ms;
+    return false;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Records every Mem_generic_* call to path until Mem_StopAllocationTrace.
+// Returns false if a trace is already running or the file can't be created.
+FUN_EXPORT(bool) Mem_StartAllocationTrace(const char* path)
+{
+    return allocation_trace::start(path);
+}
+
+//-------------------------------------------------------------------------
+// Returns false if no trace was running or it couldn't be written in full
+FUN_EXPORT(bool) Mem_StopAllocationTrace()
+{
+    return allocation_trace::stop();
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "MemoryBudget.h"
+#include "EmergencyArena.h"
+#include "MemoryCounters.h"
+#include <mutex>
+
+// SystemMemory.cs marshals MemBudgetStatus as a sequential struct
+static_assert(sizeof(MemBudgetStatus) == 88, "update MemBudgetStatus in SystemMemory.cs");
+
+namespace
+{
+    std::atomic<int64_t> s_soft_limit(0);
+    std::atomic<int64_t> s_hard_limit(0);
+
+    // Bytes admitted but not yet counted by the memory counters
+    std::atomic<int64_t> s_reserved_bytes(0);
+
+    // Set by whichever thread crosses a limit first, so the callback fires
+    // once per crossing
+    std::atomic<bool> s_over_soft_limit(false);
+    std::atomic<bool> s_over_hard_limit(false);
+
+    // One bit per MemBudgetEvent waiting for deliver_events, and the byte
+    // count each was flagged with
+    std::atomic<uint32_t> s_pending_events(0);
+    std::atomic<int64_t> s_pending_bytes[3];
+
+    std::atomic<uint64_t> s_soft_limit_exceeded_count(0);
+    std::atomic<uint64_t> s_hard_limit_exceeded_count(0);
+    std::atomic<uint64_t> s_emergency_exhausted_count(0);
+
+    // Taken to change the limits or the callback, and to read the callback
+    std::mutex s_settings_lock;
+    size_t s_emergency_arena_size = 0;
+    MemBudgetCallback s_callback = nullptr;
+    void *s_callback_user_data = nullptr;
+}
+
+std::atomic<bool> memory_budget::detail::enabled(false);
+
+//-------------------------------------------------------------------------
+static void notify(MemBudgetEvent budget_event, int64_t current_bytes)
+{
+    const uint32_t event_index = static_cast<uint32_t>(budget_event);
+    s_pending_bytes[event_index].store(current_bytes, std::memory_order_relaxed);
+    s_pending_events.fetch_or(1u << event_index, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------
+bool memory_budget::set_limits(int64_t soft_limit_in_bytes, int64_t hard_limit_in_bytes, size_t emergency_arena_in_bytes)
+{
+    if (soft_limit_in_bytes < 0 || hard_limit_in_bytes < 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> scope_lock(s_settings_lock);
+
+    if (emergency_arena_in_bytes != s_emergency_arena_size)
+    {
+        if (!emergency_arena::reserve(emergency_arena_in_bytes))
+        {
+            return false;
+        }
+        s_emergency_arena_size = emergency_arena_in_bytes;
+    }
+
+    s_soft_limit.store(soft_limit_in_bytes, std::memory_order_relaxed);
+    s_hard_limit.store(hard_limit_in_bytes, std::memory_order_relaxed);
+    s_over_soft_limit.store(false, std::memory_order_relaxed);
+    s_over_hard_limit.store(false, std::memory_order_relaxed);
+    detail::enabled.store(soft_limit_in_bytes != 0 || hard_limit_in_bytes != 0, std::memory_order_relaxed);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+void memory_budget::set_callback(MemBudgetCallback callback, void *user_data)
+{
+    std::lock_guard<std::mutex> scope_lock(s_settings_lock);
+    s_callback = callback;
+    s_callback_user_data = user_data;
+}
+
+//-------------------------------------------------------------------------
+// The reservation is taken before the counters are read. Of two threads
+// admitting at once, the second to reserve sees the first's bytes either
+// reserved or, once released, counted, so between them they can't pass
+// the hard limit.
+bool memory_budget::admit(size_t size_in_bytes)
+{
+    const int64_t size = static_cast<int64_t>(size_in_bytes);
+    const int64_t reserved = s_reserved_bytes.fetch_add(size, std::memory_order_acq_rel) + size;
+    const int64_t projected = memory_counters::current_bytes() + reserved;
+
+    const int64_t soft_limit = s_soft_limit.load(std::memory_order_relaxed);
+    if (soft_limit != 0 && projected > soft_limit
+        && !s_over_soft_limit.load(std::memory_order_relaxed)
+        && !s_over_soft_limit.exchange(true, std::memory_order_relaxed))
+    {
+        s_soft_limit_exceeded_count.fetch_add(1, std::memory_order_relaxed);
+        notify(MemBudgetEvent::SoftLimitExceeded, projected);
+    }
+
+    const int64_t hard_limit = s_hard_limit.load(std::memory_order_relaxed);
+    if (hard_limit == 0 || projected <= hard_limit)
+    {
+        return true;
+    }
+
+    s_reserved_bytes.fetch_sub(size, std::memory_order_release);
+
+    if (!s_over_hard_limit.load(std::memory_order_relaxed) && !s_over_hard_limit.exchange(true, std::memory_order_relaxed))
+    {
+        s_hard_limit_exceeded_count.fetch_add(1, std::memory_order_relaxed);
+        notify(MemBudgetEvent::HardLimitExceeded, projected);
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------
+void memory_budget::release_reservation(size_t size_in_bytes)
+{
+    s_reserved_bytes.fetch_sub(static_cast<int64_t>(size_in_bytes), std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------
+void memory_budget::on_release()
+{
+    if (!s_over_soft_limit.load(std::memory_order_relaxed) && !s_over_hard_limit.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const int64_t current = memory_counters::current_bytes();
+    if (current <= s_hard_limit.load(std::memory_order_relaxed) && s_over_hard_limit.load(std::memory_order_relaxed))
+    {
+        s_over_hard_limit.store(false, std::memory_order_relaxed);
+    }
+    if (current <= s_soft_limit.load(std::memory_order_relaxed) && s_over_soft_limit.load(std::memory_order_relaxed))
+    {
+        s_over_soft_limit.store(false, std::memory_order_relaxed);
+    }
+}
+
+//-------------------------------------------------------------------------
+void memory_budget::report_exhausted()
+{
+    s_emergency_exhausted_count.fetch_add(1, std::memory_order_relaxed);
+    notify(MemBudgetEvent::EmergencyArenaExhausted, memory_counters::current_bytes());
+}
+
+//-------------------------------------------------------------------------
+// Events flagged while there's no callback are dropped here
+uint32_t memory_budget::deliver_events()
+{
+    const uint32_t pending_events = s_pending_events.exchange(0, std::memory_order_acquire);
+    if (pending_events == 0)
+    {
+        return 0;
+    }
+
+    MemBudgetCallback callback = nullptr;
+    void *user_data = nullptr;
+    {
+        std::lock_guard<std::mutex> scope_lock(s_settings_lock);
+        callback = s_callback;
+        user_data = s_callback_user_data;
+    }
+
+    uint32_t delivered = 0;
+    for (uint32_t event_index = 0; event_index < 3; ++event_index)
+    {
+        if ((pending_events & (1u << event_index)) == 0)
+        {
+            continue;
+        }
+
+        ++delivered;
+        if (callback != nullptr)
+        {
+            callback(static_cast<int32_t>(event_index), s_pending_bytes[event_index].load(std::memory_order_relaxed), user_data);
+        }
+    }
+    return delivered;
+}
+
+//-------------------------------------------------------------------------
+void memory_budget::read_status(MemBudgetStatus *out_status)
+{
+    out_status->isOverSoftLimit = s_over_soft_limit.load(std::memory_order_relaxed) ? 1 : 0;
+    out_status->isOverHardLimit = s_over_hard_limit.load(std::memory_order_relaxed) ? 1 : 0;
+    out_status->reserved = 0;
+    out_status->softLimitInBytes = s_soft_limit.load(std::memory_order_relaxed);
+    out_status->hardLimitInBytes = s_hard_limit.load(std::memory_order_relaxed);
+    out_status->currentMemoryAllocatedInBytes = memory_counters::current_bytes();
+    emergency_arena::usage(&out_status->emergencyCapacityInBytes, &out_status->emergencyUsedInBytes, &out_status->emergencyPeakInBytes);
+    out_status->softLimitExceededCount = s_soft_limit_exceeded_count.load(std::memory_order_relaxed);
+    out_status->hardLimitExceededCount = s_hard_limit_exceeded_count.load(std::memory_order_relaxed);
+    out_status->emergencyExhaustedCount = s_emergency_exhausted_count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "Memory.h"
+#include "MemoryCounters.h"
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+
+#define MEM_COUNTERS_NO_SLOT UINT32_MAX
+
+// SystemMemory.cs reads MemCountersEx by byte offset
+static_assert(offsetof(MemCountersEx, sizeHistogram) == 48, "update the offsets in SystemMemory.cs");
+static_assert(offsetof(MemCountersEx, threads) == 48 + 8 * MEM_COUNTERS_SIZE_CLASS_COUNT, "update the offsets in SystemMemory.cs");
+static_assert(sizeof(MemThreadCounters) == 32, "update the offsets in SystemMemory.cs");
+static_assert(offsetof(MemCountersEx, largeBlockCommittedInBytes) == 48 + 8 * MEM_COUNTERS_SIZE_CLASS_COUNT + 32 * MEM_COUNTERS_MAX_THREADS, "update the offsets in SystemMemory.cs");
+
+namespace
+{
+    // Only the owning thread bumps the totals and counts (apart from the
+    // shared overflow slot), but other threads update live_bytes when they
+    // free a block allocated here
+    struct alignas(64) ThreadCounters
+    {
+        std::atomic<uint64_t> thread_id{ 0 };
+        std::atomic<int64_t> live_bytes{ 0 };
+        std::atomic<uint64_t> total_bytes{ 0 };
+        std::atomic<uint64_t> alloc_count{ 0 };
+        std::atomic<uint64_t> realloc_count{ 0 };
+        std::atomic<uint64_t> free_count{ 0 };
+        std::atomic<uint64_t> size_histogram[MEM_COUNTERS_SIZE_CLASS_COUNT] = {};
+    };
+
+    // Hands the thread's slot back when it exits. Kept apart from
+    // s_thread_slot, which is read on every allocation and so stays
+    // trivially destructible.
+    struct ThreadSlotReleaser
+    {
+        bool owns_slot = false;
+
+        ~ThreadSlotReleaser();
+    };
+
+    ThreadCounters s_thread_counters[MEM_COUNTERS_MAX_THREADS];
+    std::atomic<uint32_t> s_claimed_slot_count(0);
+
+    // Slots whose thread has exited. One is only handed out again once
+    // every block allocated from it has been freed, so that a live block is
+    // never attributed to a thread that didn't allocate it. Until then it
+    // keeps the exited thread's id and counts.
+    std::mutex s_released_slots_lock;
+    uint32_t s_released_slots[MEM_COUNTERS_MAX_THREADS - 1];
+    uint32_t s_released_slot_count = 0;
+
+    alignas(64) std::atomic<int64_t> s_current_bytes(0);
+    alignas(64) std::atomic<int64_t> s_peak_bytes(0);
+
+    thread_local uint32_t s_thread_slot = MEM_COUNTERS_NO_SLOT;
+    thread_local ThreadSlotReleaser s_thread_slot_releaser;
+}
+
+//-------------------------------------------------------------------------
+// Whatever the thread allocates after this, from other thread_local
+// destructors, is attributed to the shared slot
+ThreadSlotReleaser::~ThreadSlotReleaser()
+{
+    if (owns_slot)
+    {
+        std::lock_guard<std::mutex> scope_lock(s_released_slots_lock);
+        s_released_slots[s_released_slot_count++] = s_thread_slot;
+        owns_slot = false;
+    }
+    s_thread_slot = MEM_COUNTERS_MAX_THREADS - 1;
+}
+
+//-------------------------------------------------------------------------
+uint32_t memory_counters::size_class_for(size_t size_in_bytes)
+{
+    uint32_t size_class = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    if (size_in_bytes != 0)
+    {
+        size_class = 64 - __builtin_clzll(static_cast<unsigned long long>(size_in_bytes));
+    }
+#else
+    for (; size_in_bytes != 0 && size_class < MEM_COUNTERS_SIZE_CLASS_COUNT - 1; size_in_bytes >>= 1)
+    {
+        ++size_class;
+    }
+#endif
+    return size_class < MEM_COUNTERS_SIZE_CLASS_COUNT ? size_class : MEM_COUNTERS_SIZE_CLASS_COUNT - 1;
+}
+
+//-------------------------------------------------------------------------
+// Counters only ever written by their owning thread don't need a locked
+// read-modify-write; the shared overflow slot does
+static inline void bump(std::atomic<uint64_t>& counter, uint64_t amount, uint32_t thread_slot)
+{
+    if (thread_slot < MEM_COUNTERS_MAX_THREADS - 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    else
+    {
+        counter.fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+//-------------------------------------------------------------------------
+static void add_current_bytes(int64_t delta)
+{
+    const int64_t current = s_current_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+
+    int64_t peak = s_peak_bytes.load(std::memory_order_relaxed);
+    while (current > peak && !s_peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+    {
+    }
+}
+
+//-------------------------------------------------------------------------
+// Moves the counts of a released slot's earlier thread to the shared slot,
+// so that the totals don't go backwards when the slot is handed out again.
+// Its live bytes are already zero.
+static void retire_slot_counts(ThreadCounters& counters)
+{
+    ThreadCounters& shared = s_thread_counters[MEM_COUNTERS_MAX_THREADS - 1];
+
+    shared.total_bytes.fetch_add(counters.total_bytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    shared.alloc_count.fetch_add(counters.alloc_count.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    shared.realloc_count.fetch_add(counters.realloc_count.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    shared.free_count.fetch_add(counters.free_count.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    for (uint32_t size_class = 0; size_class < MEM_COUNTERS_SIZE_CLASS_COUNT; ++size_class)
+    {
+        shared.size_histogram[size_class].fetch_add(counters.size_histogram[size_class].exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+//-------------------------------------------------------------------------
+// A released slot with nothing live, or else one never used before. The
+// released slots' lock orders the exited thread's last writes before the
+// new owner's.
+static uint32_t claim_slot()
+{
+    {
+        std::lock_guard<std::mutex> scope_lock(s_released_slots_lock);
+        for (uint32_t i = 0; i < s_released_slot_count; ++i)
+        {
+            const uint32_t slot = s_released_slots[i];
+            if (s_thread_counters[slot].live_bytes.load(std::memory_order_relaxed) == 0)
+            {
+                s_released_slots[i] = s_released_slots[--s_released_slot_count];
+                retire_slot_counts(s_thread_counters[slot]);
+                return slot;
+            }
+        }
+    }
+
+    const uint32_t claimed = s_claimed_slot_count.fetch_add(1, std::memory_order_relaxed);
+    return claimed < MEM_COUNTERS_MAX_THREADS - 1 ? claimed : MEM_COUNTERS_MAX_THREADS - 1;
+}
+
+//-------------------------------------------------------------------------
+uint32_t memory_counters::current_thread_slot()
+{
+    if (s_thread_slot == MEM_COUNTERS_NO_SLOT)
+    {
+        const uint32_t slot = claim_slot();
+        if (slot < MEM_COUNTERS_MAX_THREADS - 1)
+        {
+            s_thread_counters[slot].thread_id.store(platform::current_thread_id(), std::memory_order_relaxed);
+            s_thread_slot_releaser.owns_slot = true;
+        }
+        s_thread_slot = slot;
+    }
+
+    return s_thread_slot;
+}
+
+//-------------------------------------------------------------------------
+void memory_counters::record_alloc(uint32_t thread_slot, size_t size_in_bytes)
+{
+    ThreadCounters& counters = s_thread_counters[thread_slot];
+    const int64_t size = static_cast<int64_t>(size_in_bytes);
+
+    counters.live_bytes.fetch_add(size, std::memory_order_relaxed);
+    bump(counters.total_bytes, size_in_bytes, thread_slot);
+    bump(counters.alloc_count, 1, thread_slot);
+    bump(counters.size_histogram[memory_counters::size_class_for(size_in_bytes)], 1, thread_slot);
+
+    add_current_bytes(size);
+}
+
+//-------------------------------------------------------------------------
+void memory_counters::record_realloc(uint32_t thread_slot, uint32_t old_thread_slot, size_t old_size_in_bytes, size_t size_in_bytes)
+{
+    ThreadCounters& counters = s_thread_counters[thread_slot];
+    const int64_t old_size = static_cast<int64_t>(old_size_in_bytes);
+    const int64_t size = static_cast<int64_t>(size_in_bytes);
+
+    s_thread_counters[old_thread_slot].live_bytes.fetch_sub(old_size, std::memory_order_relaxed);
+    counters.live_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size > old_size)
+    {
+        bump(counters.total_bytes, static_cast<uint64_t>(size - old_size), thread_slot);
+    }
+    bump(counters.realloc_count, 1, thread_slot);
+    bump(counters.size_histogram[memory_counters::size_class_for(size_in_bytes)], 1, thread_slot);
+
+    add_current_bytes(size - old_size);
+}
+
+//-------------------------------------------------------------------------
+void memory_counters::record_free(uint32_t thread_slot, size_t size_in_bytes)
+{
+    const int64_t size = static_cast<int64_t>(size_in_bytes);
+
+    const uint32_t current_slot = current_thread_slot();
+
+    s_thread_counters[thread_slot].live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    bump(s_thread_counters[current_slot].free_count, 1, current_slot);
+
+    s_current_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+int64_t memory_counters::current_bytes()
+{
+    return s_current_bytes.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+uint64_t memory_counters::thread_id(uint32_t thread_slot)
+{
+    if (thread_slot >= MEM_COUNTERS_MAX_THREADS)
+    {
+        return 0;
+    }
+    return s_thread_counters[thread_slot].thread_id.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+uint64_t memory_counters::operation_count()
+{
+    uint64_t total = 0;
+    for (const ThreadCounters& counters : s_thread_counters)
+    {
+        total += counters.alloc_count.load(std::memory_order_relaxed)
+            + counters.realloc_count.load(std::memory_order_relaxed)
+            + counters.free_count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+//-------------------------------------------------------------------------
+void memory_counters::read(MemCountersEx *out_counters)
+{
+    const uint32_t claimed = s_claimed_slot_count.load(std::memory_order_relaxed);
+    const uint32_t thread_count = claimed < MEM_COUNTERS_MAX_THREADS ? claimed : MEM_COUNTERS_MAX_THREADS;
+
+    out_counters->threadCount = static_cast<int32_t>(thread_count);
+    out_counters->currentMemoryAllocatedInBytes = s_current_bytes.load(std::memory_order_relaxed);
+    out_counters->peakMemoryAllocatedInBytes = s_peak_bytes.load(std::memory_order_relaxed);
+    out_counters->allocCount = 0;
+    out_counters->reallocCount = 0;
+    out_counters->freeCount = 0;
+    for (uint64_t& bucket : out_counters->sizeHistogram)
+    {
+        bucket = 0;
+    }
+
+    for (uint32_t slot = 0; slot < MEM_COUNTERS_MAX_THREADS; ++slot)
+    {
+        const ThreadCounters& counters = s_thread_counters[slot];
+        MemThreadCounters& out_thread = out_counters->threads[slot];
+
+        out_thread.threadId = counters.thread_id.load(std::memory_order_relaxed);
+        out_thread.currentMemoryAllocatedInBytes = counters.live_bytes.load(std::memory_order_relaxed);
+        out_thread.totalMemoryAllocatedInBytes = static_cast<int64_t>(counters.total_bytes.load(std::memory_order_relaxed));
+        out_thread.allocCount = counters.alloc_count.load(std::memory_order_relaxed);
+
+        out_counters->allocCount += out_thread.allocCount;
+        out_counters->reallocCount += counters.realloc_count.load(std::memory_order_relaxed);
+        out_counters->freeCount += counters.free_count.load(std::memory_order_relaxed);
+        for (uint32_t size_class = 0; size_class < MEM_COUNTERS_SIZE_CLASS_COUNT; ++size_class)
+        {
+            out_counters->sizeHistogram[size_class] += counters.size_histogram[size_class].load(std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,638 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "Memory.h"
+#include "MemoryPool.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#define MEMORY_POOL_SLAB_MAGIC 0x534c4142u
+
+// Empty slabs beyond this many per class are handed back to the system
+#define MEMORY_POOL_MAX_EMPTY_SLABS_PER_CLASS 2
+
+// Each thread caches at most this many blocks, and roughly this many bytes,
+// per class. Magazines are refilled and drained half a magazine at a time.
+#define MEMORY_POOL_MAGAZINE_MAX_BLOCKS 64
+#define MEMORY_POOL_MAGAZINE_MIN_BLOCKS 4
+#define MEMORY_POOL_MAGAZINE_TARGET_BYTES (16 * 1024)
+
+// The slab map is a two level bitmap with one bit per slab sized piece of
+// the address space. User space addresses fit in 48 bits on every 64 bit
+// platform we ship on; a slab that lands outside of that is not pooled.
+#define MEMORY_POOL_SLAB_SHIFT 16
+#define MEMORY_POOL_SLAB_MAP_LEAF_BITS 16
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define MEMORY_POOL_ADDRESS_BITS 48
+#else
+#define MEMORY_POOL_ADDRESS_BITS 32
+#endif
+#define MEMORY_POOL_SLAB_MAP_ROOT_BITS (MEMORY_POOL_ADDRESS_BITS - MEMORY_POOL_SLAB_SHIFT - MEMORY_POOL_SLAB_MAP_LEAF_BITS)
+
+static_assert((1 << MEMORY_POOL_SLAB_SHIFT) == MEMORY_POOL_SLAB_SIZE, "slab shift doesn't match slab size");
+
+namespace
+{
+    // Class locks are held for a handful of instructions, where a
+    // std::mutex costs noticeably more than the work it protects. Spin
+    // briefly, then yield so a preempted holder can finish.
+    struct SpinLock
+    {
+        std::atomic<bool> locked{ false };
+
+        void lock()
+        {
+            for (int spin_count = 0; locked.exchange(true, std::memory_order_acquire); ++spin_count)
+            {
+                while (locked.load(std::memory_order_relaxed))
+                {
+                    if (++spin_count > 64)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+
+        void unlock()
+        {
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    struct SlabHeader
+    {
+        uint32_t magic;
+        uint32_t size_class;
+        uint32_t block_size;
+        uint32_t used_count;
+        uint32_t capacity;
+
+        // Links in the owning class' list of slabs that have room
+        SlabHeader *prev;
+        SlabHeader *next;
+        bool in_partial_list;
+
+        FreeBlock *free_list;
+
+        // Blocks from here on have never been handed out; carving them
+        // lazily keeps new slabs from being touched all at once
+        char *unused_begin;
+    };
+
+    constexpr uint32_t kClassSizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048 };
+    constexpr size_t kClassCount = sizeof(kClassSizes) / sizeof(kClassSizes[0]);
+
+    static_assert(kClassSizes[kClassCount - 1] == MEMORY_POOL_MAX_BLOCK_SIZE, "largest class doesn't match MEMORY_POOL_MAX_BLOCK_SIZE");
+
+    // Maps (size + 15) / 16 to the smallest class that can hold it
+    struct ClassLookup
+    {
+        uint8_t index[MEMORY_POOL_MAX_BLOCK_SIZE / 16 + 1];
+
+        constexpr ClassLookup() : index()
+        {
+            size_t class_index = 0;
+            for (size_t i = 0; i <= MEMORY_POOL_MAX_BLOCK_SIZE / 16; ++i)
+            {
+                while (kClassSizes[class_index] < i * 16)
+                {
+                    ++class_index;
+                }
+                index[i] = static_cast<uint8_t>(class_index);
+            }
+        }
+    };
+    constexpr ClassLookup kClassLookup;
+
+    struct alignas(64) SizeClass
+    {
+        SpinLock lock;
+        SlabHeader *partial_slabs = nullptr;
+        uint32_t empty_slab_count = 0;
+    };
+
+    SizeClass s_classes[kClassCount];
+
+#if MEMORY_POOL_THREAD_CACHE
+    struct MagazineCapacities
+    {
+        uint32_t blocks[kClassCount];
+
+        constexpr MagazineCapacities() : blocks()
+        {
+            for (size_t i = 0; i < kClassCount; ++i)
+            {
+                const uint32_t capacity = MEMORY_POOL_MAGAZINE_TARGET_BYTES / kClassSizes[i];
+                blocks[i] = capacity > MEMORY_POOL_MAGAZINE_MAX_BLOCKS ? MEMORY_POOL_MAGAZINE_MAX_BLOCKS
+                          : capacity < MEMORY_POOL_MAGAZINE_MIN_BLOCKS ? MEMORY_POOL_MAGAZINE_MIN_BLOCKS
+                          : capacity;
+            }
+        }
+    };
+    constexpr MagazineCapacities kMagazineCapacities;
+
+    struct Magazine
+    {
+        uint32_t count = 0;
+        void *blocks[MEMORY_POOL_MAGAZINE_MAX_BLOCKS] = {};
+    };
+
+    struct ThreadCache
+    {
+        Magazine magazines[kClassCount];
+
+        // Behind s_trim_epoch when a trim has asked every thread to flush
+        uint32_t trim_epoch = 0;
+
+        ~ThreadCache();
+    };
+
+    std::atomic<uint32_t> s_trim_epoch(0);
+
+    thread_local ThreadCache s_thread_cache;
+
+    // Set once s_thread_cache has been destroyed, so that frees made by
+    // other thread_local destructors that run later go straight to the slabs
+    thread_local bool s_thread_cache_destroyed = false;
+#endif
+
+    typedef std::atomic<uint64_t> SlabMapLeaf[(1 << MEMORY_POOL_SLAB_MAP_LEAF_BITS) / 64];
+    std::atomic<SlabMapLeaf*> s_slab_map[1 << MEMORY_POOL_SLAB_MAP_ROOT_BITS];
+}
+
+//-------------------------------------------------------------------------
+static inline size_t natural_alignment(size_t block_size)
+{
+    return block_size & (~block_size + 1);
+}
+
+//-------------------------------------------------------------------------
+static inline size_t round_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+//-------------------------------------------------------------------------
+static inline SlabHeader* slab_from_pointer(const void *pointer)
+{
+    return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(pointer) & ~static_cast<uintptr_t>(MEMORY_POOL_SLAB_SIZE - 1));
+}
+
+//-------------------------------------------------------------------------
+// Returns -1 if the request can't be pooled
+static int class_index_for(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    if (size_in_bytes > MEMORY_POOL_MAX_BLOCK_SIZE || alignment_in_bytes > MEMORY_POOL_MAX_BLOCK_SIZE)
+    {
+        return -1;
+    }
+
+    size_t class_index = kClassLookup.index[(size_in_bytes + 15) / 16];
+    while (class_index < kClassCount && natural_alignment(kClassSizes[class_index]) < alignment_in_bytes)
+    {
+        ++class_index;
+    }
+
+    return class_index < kClassCount ? static_cast<int>(class_index) : -1;
+}
+
+//-------------------------------------------------------------------------
+static bool slab_map_set(const void *slab, bool is_slab)
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(slab);
+#if MEMORY_POOL_ADDRESS_BITS < 64 && UINTPTR_MAX > 0xFFFFFFFFu
+    if (address >> MEMORY_POOL_ADDRESS_BITS)
+    {
+        return false;
+    }
+#endif
+    const size_t slab_index = address >> MEMORY_POOL_SLAB_SHIFT;
+    std::atomic<SlabMapLeaf*>& root_entry = s_slab_map[slab_index >> MEMORY_POOL_SLAB_MAP_LEAF_BITS];
+    SlabMapLeaf *leaf = root_entry.load(std::memory_order_acquire);
+
+    if (leaf == nullptr)
+    {
+        if (!is_slab)
+        {
+            return true;
+        }
+
+        // Leaves are never freed; there is one per 4GiB of address space in use
+        SlabMapLeaf *new_leaf = static_cast<SlabMapLeaf*>(calloc(1, sizeof(SlabMapLeaf)));
+        if (new_leaf == nullptr)
+        {
+            return false;
+        }
+
+        if (root_entry.compare_exchange_strong(leaf, new_leaf, std::memory_order_acq_rel))
+        {
+            leaf = new_leaf;
+        }
+        else
+        {
+            ::free(new_leaf);
+        }
+    }
+
+    const size_t bit = slab_index & ((1 << MEMORY_POOL_SLAB_MAP_LEAF_BITS) - 1);
+    const uint64_t mask = 1ULL << (bit & 63);
+    if (is_slab)
+    {
+        (*leaf)[bit >> 6].fetch_or(mask, std::memory_order_release);
+    }
+    else
+    {
+        (*leaf)[bit >> 6].fetch_and(~mask, std::memory_order_release);
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+bool memory_pool::owns(const void *pointer)
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+#if MEMORY_POOL_ADDRESS_BITS < 64 && UINTPTR_MAX > 0xFFFFFFFFu
+    if (address >> MEMORY_POOL_ADDRESS_BITS)
+    {
+        return false;
+    }
+#endif
+    const size_t slab_index = address >> MEMORY_POOL_SLAB_SHIFT;
+    SlabMapLeaf *leaf = s_slab_map[slab_index >> MEMORY_POOL_SLAB_MAP_LEAF_BITS].load(std::memory_order_acquire);
+
+    if (leaf == nullptr)
+    {
+        return false;
+    }
+
+    const size_t bit = slab_index & ((1 << MEMORY_POOL_SLAB_MAP_LEAF_BITS) - 1);
+    return ((*leaf)[bit >> 6].load(std::memory_order_acquire) >> (bit & 63)) & 1;
+}
+
+//-------------------------------------------------------------------------
+static void link_slab(SizeClass& size_class, SlabHeader *slab)
+{
+    slab->prev = nullptr;
+    slab->next = size_class.partial_slabs;
+    if (size_class.partial_slabs != nullptr)
+    {
+        size_class.partial_slabs->prev = slab;
+    }
+    size_class.partial_slabs = slab;
+    slab->in_partial_list = true;
+}
+
+//-------------------------------------------------------------------------
+static void unlink_slab(SizeClass& size_class, SlabHeader *slab)
+{
+    if (slab->prev != nullptr)
+    {
+        slab->prev->next = slab->next;
+    }
+    else
+    {
+        size_class.partial_slabs = slab->next;
+    }
+
+    if (slab->next != nullptr)
+    {
+        slab->next->prev = slab->prev;
+    }
+
+    slab->prev = nullptr;
+    slab->next = nullptr;
+    slab->in_partial_list = false;
+}
+
+//-------------------------------------------------------------------------
+static SlabHeader* create_slab(size_t class_index)
+{
+    void *memory = platform::alloc_pages(MEMORY_POOL_SLAB_SIZE, MEMORY_POOL_SLAB_SIZE);
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (!slab_map_set(memory, true))
+    {
+        platform::free_pages(memory, MEMORY_POOL_SLAB_SIZE);
+        return nullptr;
+    }
+
+    const uint32_t block_size = kClassSizes[class_index];
+    const size_t data_offset = round_up(sizeof(SlabHeader), natural_alignment(block_size));
+
+    SlabHeader *slab = static_cast<SlabHeader*>(memory);
+    slab->magic = MEMORY_POOL_SLAB_MAGIC;
+    slab->size_class = static_cast<uint32_t>(class_index);
+    slab->block_size = block_size;
+    slab->used_count = 0;
+    slab->capacity = static_cast<uint32_t>((MEMORY_POOL_SLAB_SIZE - data_offset) / block_size);
+    slab->prev = nullptr;
+    slab->next = nullptr;
+    slab->in_partial_list = false;
+    slab->free_list = nullptr;
+    slab->unused_begin = static_cast<char*>(memory) + data_offset;
+
+    return slab;
+}
+
+//-------------------------------------------------------------------------
+static void release_slab(SlabHeader *slab)
+{
+    slab->magic = 0;
+    slab_map_set(slab, false);
+    platform::free_pages(slab, MEMORY_POOL_SLAB_SIZE);
+}
+
+//-------------------------------------------------------------------------
+// Caller must hold size_class.lock
+static void * central_alloc(SizeClass& size_class, size_t class_index)
+{
+    SlabHeader *slab = size_class.partial_slabs;
+    if (slab == nullptr)
+    {
+        slab = create_slab(class_index);
+        if (slab == nullptr)
+        {
+            return nullptr;
+        }
+        link_slab(size_class, slab);
+        size_class.empty_slab_count++;
+    }
+
+    void *block = nullptr;
+    if (slab->free_list != nullptr)
+    {
+        block = slab->free_list;
+        slab->free_list = slab->free_list->next;
+    }
+    else
+    {
+        block = slab->unused_begin;
+        slab->unused_begin += slab->block_size;
+    }
+
+    if (slab->used_count++ == 0)
+    {
+        size_class.empty_slab_count--;
+    }
+
+    if (slab->used_count == slab->capacity)
+    {
+        unlink_slab(size_class, slab);
+    }
+
+    return block;
+}
+
+//-------------------------------------------------------------------------
+// Caller must hold size_class.lock
+static void central_free(SizeClass& size_class, void *pointer)
+{
+    SlabHeader *slab = slab_from_pointer(pointer);
+    assert(slab->magic == MEMORY_POOL_SLAB_MAGIC);
+
+    FreeBlock *block = static_cast<FreeBlock*>(pointer);
+    block->next = slab->free_list;
+    slab->free_list = block;
+
+    if (!slab->in_partial_list)
+    {
+        link_slab(size_class, slab);
+    }
+
+    if (--slab->used_count == 0)
+    {
+        if (size_class.empty_slab_count >= MEMORY_POOL_MAX_EMPTY_SLABS_PER_CLASS)
+        {
+            unlink_slab(size_class, slab);
+            release_slab(slab);
+        }
+        else
+        {
+            size_class.empty_slab_count++;
+        }
+    }
+}
+
+#if MEMORY_POOL_THREAD_CACHE
+//-------------------------------------------------------------------------
+// Returns how many blocks were written to out_blocks; fewer than count only
+// if the system is out of memory
+static uint32_t central_alloc_batch(size_t class_index, void **out_blocks, uint32_t count)
+{
+    SizeClass& size_class = s_classes[class_index];
+    std::lock_guard<SpinLock> scope_lock(size_class.lock);
+
+    uint32_t allocated = 0;
+    while (allocated < count)
+    {
+        void *block = central_alloc(size_class, class_index);
+        if (block == nullptr)
+        {
+            break;
+        }
+        out_blocks[allocated++] = block;
+    }
+
+    return allocated;
+}
+
+//-------------------------------------------------------------------------
+static void central_free_batch(size_t class_index, void **blocks, uint32_t count)
+{
+    SizeClass& size_class = s_classes[class_index];
+    std::lock_guard<SpinLock> scope_lock(size_class.lock);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        central_free(size_class, blocks[i]);
+    }
+}
+
+//-------------------------------------------------------------------------
+// One relaxed load on the fast path; a thread that hasn't seen the latest
+// trim flushes before going on
+static inline void flush_if_trimmed()
+{
+    const uint32_t trim_epoch = s_trim_epoch.load(std::memory_order_relaxed);
+    if (s_thread_cache.trim_epoch != trim_epoch)
+    {
+        memory_pool::flush_thread_cache();
+        s_thread_cache.trim_epoch = trim_epoch;
+    }
+}
+
+//-------------------------------------------------------------------------
+ThreadCache::~ThreadCache()
+{
+    memory_pool::flush_thread_cache();
+    s_thread_cache_destroyed = true;
+}
+#endif
+
+//-------------------------------------------------------------------------
+void * memory_pool::alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    const int class_index = class_index_for(size_in_bytes, alignment_in_bytes);
+    if (class_index < 0)
+    {
+        return nullptr;
+    }
+
+#if MEMORY_POOL_THREAD_CACHE
+    if (!s_thread_cache_destroyed)
+    {
+        flush_if_trimmed();
+
+        Magazine& magazine = s_thread_cache.magazines[class_index];
+        if (magazine.count == 0)
+        {
+            magazine.count = central_alloc_batch(class_index, magazine.blocks, kMagazineCapacities.blocks[class_index] / 2);
+            if (magazine.count == 0)
+            {
+                return nullptr;
+            }
+        }
+        return magazine.blocks[--magazine.count];
+    }
+#endif
+
+    SizeClass& size_class = s_classes[class_index];
+    std::lock_guard<SpinLock> scope_lock(size_class.lock);
+    return central_alloc(size_class, class_index);
+}
+
+//-------------------------------------------------------------------------
+void memory_pool::free(void *pointer)
+{
+    const SlabHeader *slab = slab_from_pointer(pointer);
+    assert(slab->magic == MEMORY_POOL_SLAB_MAGIC);
+    const size_t class_index = slab->size_class;
+
+#if MEMORY_POOL_THREAD_CACHE
+    if (!s_thread_cache_destroyed)
+    {
+        flush_if_trimmed();
+
+        Magazine& magazine = s_thread_cache.magazines[class_index];
+        const uint32_t capacity = kMagazineCapacities.blocks[class_index];
+        if (magazine.count == capacity)
+        {
+            // The bottom of the magazine holds the blocks that have been
+            // cached the longest; send those back and keep the warm ones
+            const uint32_t batch = capacity / 2;
+            central_free_batch(class_index, magazine.blocks, batch);
+            memmove(magazine.blocks, magazine.blocks + batch, (capacity - batch) * sizeof(void*));
+            magazine.count = capacity - batch;
+        }
+        magazine.blocks[magazine.count++] = pointer;
+        return;
+    }
+#endif
+
+    SizeClass& size_class = s_classes[class_index];
+    std::lock_guard<SpinLock> scope_lock(size_class.lock);
+    central_free(size_class, pointer);
+}
+
+//-------------------------------------------------------------------------
+void memory_pool::flush_thread_cache()
+{
+#if MEMORY_POOL_THREAD_CACHE
+    if (s_thread_cache_destroyed)
+    {
+        return;
+    }
+
+    for (size_t class_index = 0; class_index < kClassCount; ++class_index)
+    {
+        Magazine& magazine = s_thread_cache.magazines[class_index];
+        if (magazine.count > 0)
+        {
+            central_free_batch(class_index, magazine.blocks, magazine.count);
+            magazine.count = 0;
+        }
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------
+size_t memory_pool::trim()
+{
+#if MEMORY_POOL_THREAD_CACHE
+    s_trim_epoch.fetch_add(1, std::memory_order_relaxed);
+    if (!s_thread_cache_destroyed)
+    {
+        flush_thread_cache();
+        s_thread_cache.trim_epoch = s_trim_epoch.load(std::memory_order_relaxed);
+    }
+#endif
+
+    size_t released = 0;
+    for (SizeClass& size_class : s_classes)
+    {
+        std::lock_guard<SpinLock> scope_lock(size_class.lock);
+
+        SlabHeader *slab = size_class.partial_slabs;
+        while (slab != nullptr && size_class.empty_slab_count > 0)
+        {
+            SlabHeader *next = slab->next;
+            if (slab->used_count == 0)
+            {
+                unlink_slab(size_class, slab);
+                release_slab(slab);
+                size_class.empty_slab_count--;
+                released += MEMORY_POOL_SLAB_SIZE;
+            }
+            slab = next;
+        }
+    }
+
+    return released;
+}
+
+//-------------------------------------------------------------------------
+size_t memory_pool::block_size(const void *pointer)
+{
+    return slab_from_pointer(pointer)->block_size;
+}
+
+//-------------------------------------------------------------------------
+bool memory_pool::fits_in_place(const void *pointer, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    const size_t size_of_block = block_size(pointer);
+    return size_in_bytes <= size_of_block && alignment_in_bytes <= natural_alignment(size_of_block);
+}
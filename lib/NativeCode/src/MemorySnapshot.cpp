@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "Memory.h"
+#include "MemoryCounters.h"
+#include "MemorySnapshot.h"
+#include "MemoryTracker.h"
+#include <stdlib.h>
+
+// SystemMemory.cs reads MemLiveAllocation by byte offset
+static_assert(sizeof(MemLiveAllocation) == 40, "update the offsets in SystemMemory.cs");
+
+namespace
+{
+    struct SnapshotWriter
+    {
+        MemLiveAllocation *allocations;
+        size_t capacity;
+        size_t count;
+        uint32_t now;
+    };
+
+    struct BlockTotals
+    {
+        uint64_t blocks;
+        uint64_t bytes;
+    };
+
+    struct LeakTotals
+    {
+        uint32_t now;
+        BlockTotals total;
+        // The size classes of MemCountersEx::sizeHistogram
+        BlockTotals size_classes[MEM_COUNTERS_SIZE_CLASS_COUNT];
+        BlockTotals threads[MEM_COUNTERS_MAX_THREADS];
+
+        // Unordered until the report is written
+        TrackedAllocation oldest[MEM_LEAK_REPORT_OLDEST_BLOCKS];
+        size_t oldest_count;
+    };
+}
+
+//-------------------------------------------------------------------------
+static void write_live_allocation(const TrackedAllocation& allocation, void *context)
+{
+    SnapshotWriter& writer = *static_cast<SnapshotWriter*>(context);
+    if (writer.count < writer.capacity)
+    {
+        MemLiveAllocation& out = writer.allocations[writer.count];
+        out.address = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(allocation.pointer));
+        out.sizeInBytes = allocation.size_in_bytes;
+        out.ageInTicks = allocation.tick != TRACKER_NO_TICK ? static_cast<uint32_t>(writer.now - allocation.tick) : MEM_LIVE_ALLOCATION_AGE_UNKNOWN;
+        out.threadId = memory_counters::thread_id(allocation.thread_slot);
+        out.alignmentInBytes = 1u << allocation.alignment_log2;
+        out.reserved = 0;
+    }
+    writer.count++;
+}
+
+//-------------------------------------------------------------------------
+size_t memory_snapshot::live_allocations(MemLiveAllocation *out_allocations, size_t capacity)
+{
+    SnapshotWriter writer = { out_allocations, out_allocations != nullptr ? capacity : 0, 0, memory_tracker::current_tick() };
+    memory_tracker::for_each(&write_live_allocation, &writer);
+    return writer.count;
+}
+
+//-------------------------------------------------------------------------
+static void add_leak(const TrackedAllocation& allocation, void *context)
+{
+    LeakTotals& totals = *static_cast<LeakTotals*>(context);
+    const uint64_t size = allocation.size_in_bytes;
+
+    totals.total.blocks++;
+    totals.total.bytes += size;
+    const uint32_t size_class = memory_counters::size_class_for(allocation.size_in_bytes);
+    totals.size_classes[size_class].blocks++;
+    totals.size_classes[size_class].bytes += size;
+    totals.threads[allocation.thread_slot].blocks++;
+    totals.threads[allocation.thread_slot].bytes += size;
+
+    if (allocation.tick == TRACKER_NO_TICK)
+    {
+        return;
+    }
+
+    if (totals.oldest_count < MEM_LEAK_REPORT_OLDEST_BLOCKS)
+    {
+        totals.oldest[totals.oldest_count++] = allocation;
+        return;
+    }
+
+    // Replace the youngest of the oldest blocks kept so far
+    size_t youngest = 0;
+    for (size_t i = 1; i < totals.oldest_count; ++i)
+    {
+        if (static_cast<uint32_t>(totals.now - totals.oldest[i].tick) < static_cast<uint32_t>(totals.now - totals.oldest[youngest].tick))
+        {
+            youngest = i;
+        }
+    }
+    if (static_cast<uint32_t>(totals.now - allocation.tick) > static_cast<uint32_t>(totals.now - totals.oldest[youngest].tick))
+    {
+        totals.oldest[youngest] = allocation;
+    }
+}
+
+//-------------------------------------------------------------------------
+bool memory_snapshot::write_leak_report(FILE *file)
+{
+    // Too big for some thread stacks, and the report mustn't allocate
+    // through the allocator it is reporting on
+    LeakTotals *totals = static_cast<LeakTotals*>(calloc(1, sizeof(LeakTotals)));
+    if (totals == nullptr)
+    {
+        return false;
+    }
+    totals->now = memory_tracker::current_tick();
+    memory_tracker::for_each(&add_leak, totals);
+
+    fprintf(file, "live allocations: %" PRIu64 " blocks, %" PRIu64 " bytes\n", totals->total.blocks, totals->total.bytes);
+
+    fprintf(file, "\nby size class:\n");
+    for (uint32_t i = 0; i < MEM_COUNTERS_SIZE_CLASS_COUNT; ++i)
+    {
+        if (totals->size_classes[i].blocks == 0)
+        {
+            continue;
+        }
+
+        // The last class has no upper bound
+        const bool is_last = i == MEM_COUNTERS_SIZE_CLASS_COUNT - 1;
+        const uint64_t bound = is_last ? static_cast<uint64_t>(1) << (i - 1) : (static_cast<uint64_t>(1) << i) - 1;
+        fprintf(file, "  %s %20" PRIu64 " bytes: %10" PRIu64 " blocks, %14" PRIu64 " bytes\n",
+            is_last ? ">=" : "<=", bound, totals->size_classes[i].blocks, totals->size_classes[i].bytes);
+    }
+
+    fprintf(file, "\nby thread:\n");
+    for (uint32_t i = 0; i < MEM_COUNTERS_MAX_THREADS; ++i)
+    {
+        if (totals->threads[i].blocks != 0)
+        {
+            fprintf(file, "  thread %10" PRIu64 ": %10" PRIu64 " blocks, %14" PRIu64 " bytes\n",
+                memory_counters::thread_id(i), totals->threads[i].blocks, totals->threads[i].bytes);
+        }
+    }
+
+    if (totals->oldest_count != 0)
+    {
+        fprintf(file, "\noldest blocks:\n");
+    }
+    else if (totals->total.blocks != 0)
+    {
+        fprintf(file, "\nno allocation ages, see Mem_SetAllocationAgeTracking\n");
+    }
+    for (size_t i = 1; i < totals->oldest_count; ++i)
+    {
+        const TrackedAllocation allocation = totals->oldest[i];
+        size_t j = i;
+        for (; j > 0 && static_cast<uint32_t>(totals->now - totals->oldest[j - 1].tick) < static_cast<uint32_t>(totals->now - allocation.tick); --j)
+        {
+            totals->oldest[j] = totals->oldest[j - 1];
+        }
+        totals->oldest[j] = allocation;
+    }
+    for (size_t i = 0; i < totals->oldest_count; ++i)
+    {
+        const TrackedAllocation& allocation = totals->oldest[i];
+        fprintf(file, "  0x%" PRIxPTR ": %" PRIu64 " bytes, aligned to %u, %" PRIu32 " ms old, thread %" PRIu64 "\n",
+            reinterpret_cast<uintptr_t>(allocation.pointer), static_cast<uint64_t>(allocation.size_in_bytes),
+            1u << allocation.alignment_log2, static_cast<uint32_t>(totals->now - allocation.tick),
+            memory_counters::thread_id(allocation.thread_slot));
+    }
+
+    free(totals);
+    return ferror(file) == 0;
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "Memory.h"
+#include "MemoryTracker.h"
+#include <stdlib.h>
+#include <mutex>
+
+// Must be a power of two; the top bits of the pointer hash pick the shard
+#define TRACKER_SHARD_BITS 6
+#define TRACKER_SHARD_COUNT (1 << TRACKER_SHARD_BITS)
+
+// Must be a power of two
+#define TRACKER_INITIAL_SHARD_CAPACITY 256
+
+namespace
+{
+    // Padded out to a cache line so that threads working on neighbouring
+    // shards don't fight over the same line.
+    struct alignas(64) TrackerShard
+    {
+        std::mutex lock;
+        TrackedAllocation *slots = nullptr;
+        size_t capacity = 0;
+        size_t count = 0;
+    };
+
+    TrackerShard s_shards[TRACKER_SHARD_COUNT];
+
+    const uint64_t s_tick_epoch = platform::coarse_milliseconds();
+}
+
+std::atomic<bool> memory_tracker::detail::track_ages(false);
+
+//-------------------------------------------------------------------------
+// Pointers handed out by the allocator are at least 8 byte aligned, so the
+// low bits carry no information. Run them through a mixer so that both the
+// high bits (shard) and the low bits (slot) are well distributed.
+static inline uint64_t hash_pointer(const void *pointer)
+{
+    uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+//-------------------------------------------------------------------------
+static inline TrackerShard& shard_for_hash(uint64_t hash)
+{
+    return s_shards[hash >> (64 - TRACKER_SHARD_BITS)];
+}
+
+//-------------------------------------------------------------------------
+// Returns the slot holding pointer, or the empty slot where it would go
+static size_t probe(const TrackerShard& shard, const void *pointer, uint64_t hash)
+{
+    const size_t mask = shard.capacity - 1;
+    size_t index = hash & mask;
+
+    while (shard.slots[index].pointer != nullptr && shard.slots[index].pointer != pointer)
+    {
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+//-------------------------------------------------------------------------
+// Returns false, leaving the shard as it was, if there's no memory
+static bool rehash(TrackerShard& shard, size_t new_capacity)
+{
+    TrackedAllocation *new_slots = static_cast<TrackedAllocation*>(calloc(new_capacity, sizeof(TrackedAllocation)));
+    if (new_slots == nullptr)
+    {
+        return false;
+    }
+
+    TrackedAllocation *old_slots = shard.slots;
+    const size_t old_capacity = shard.capacity;
+
+    shard.slots = new_slots;
+    shard.capacity = new_capacity;
+
+    for (size_t i = 0; i < old_capacity; ++i)
+    {
+        if (old_slots[i].pointer != nullptr)
+        {
+            const size_t index = probe(shard, old_slots[i].pointer, hash_pointer(old_slots[i].pointer));
+            shard.slots[index] = old_slots[i];
+        }
+    }
+    free(old_slots);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Keep the load factor under 2/3 so probe sequences stay short
+static bool grow_if_needed(TrackerShard& shard)
+{
+    if (shard.slots != nullptr && (shard.count + 1) * 3 <= shard.capacity * 2)
+    {
+        return true;
+    }
+
+    const size_t new_capacity = shard.capacity == 0 ? TRACKER_INITIAL_SHARD_CAPACITY : shard.capacity * 2;
+    if (!rehash(shard, new_capacity))
+    {
+        // Keep going at a higher load factor as long as there is room left
+        return shard.slots != nullptr && shard.count + 1 < shard.capacity;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Backward shift deletion: entries further along the probe sequence are
+// moved into the hole, so the table never accumulates tombstones.
+static void erase_slot(TrackerShard& shard, size_t hole)
+{
+    const size_t mask = shard.capacity - 1;
+    size_t index = hole;
+
+    shard.slots[hole].pointer = nullptr;
+    shard.count--;
+
+    for (;;)
+    {
+        index = (index + 1) & mask;
+        if (shard.slots[index].pointer == nullptr)
+        {
+            break;
+        }
+
+        const size_t home = hash_pointer(shard.slots[index].pointer) & mask;
+        const bool home_in_range = hole <= index
+            ? (hole < home && home <= index)
+            : (hole < home || home <= index);
+
+        if (!home_in_range)
+        {
+            shard.slots[hole] = shard.slots[index];
+            shard.slots[index].pointer = nullptr;
+            hole = index;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+bool memory_tracker::add(const TrackedAllocation& allocation)
+{
+    if (allocation.pointer == nullptr)
+    {
+        return false;
+    }
+
+    const uint64_t hash = hash_pointer(allocation.pointer);
+    TrackerShard& shard = shard_for_hash(hash);
+    std::lock_guard<std::mutex> scope_lock(shard.lock);
+
+    if (!grow_if_needed(shard))
+    {
+        return false;
+    }
+
+    const size_t index = probe(shard, allocation.pointer, hash);
+    if (shard.slots[index].pointer == nullptr)
+    {
+        shard.count++;
+    }
+    shard.slots[index] = allocation;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+bool memory_tracker::remove(void *pointer, TrackedAllocation *out_allocation)
+{
+    if (pointer == nullptr)
+    {
+        return false;
+    }
+
+    const uint64_t hash = hash_pointer(pointer);
+    TrackerShard& shard = shard_for_hash(hash);
+    std::lock_guard<std::mutex> scope_lock(shard.lock);
+
+    if (shard.count == 0)
+    {
+        return false;
+    }
+
+    const size_t index = probe(shard, pointer, hash);
+    if (shard.slots[index].pointer == nullptr)
+    {
+        return false;
+    }
+
+    if (out_allocation != nullptr)
+    {
+        *out_allocation = shard.slots[index];
+    }
+    erase_slot(shard, index);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+bool memory_tracker::find(void *pointer, TrackedAllocation *out_allocation)
+{
+    if (pointer == nullptr)
+    {
+        return false;
+    }
+
+    const uint64_t hash = hash_pointer(pointer);
+    TrackerShard& shard = shard_for_hash(hash);
+    std::lock_guard<std::mutex> scope_lock(shard.lock);
+
+    if (shard.count == 0)
+    {
+        return false;
+    }
+
+    const size_t index = probe(shard, pointer, hash);
+    if (shard.slots[index].pointer == nullptr)
+    {
+        return false;
+    }
+
+    if (out_allocation != nullptr)
+    {
+        *out_allocation = shard.slots[index];
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// A shard is only shrunk to where it would be a third full, so that it
+// doesn't immediately have to grow again
+size_t memory_tracker::trim()
+{
+    size_t released = 0;
+    for (TrackerShard& shard : s_shards)
+    {
+        std::lock_guard<std::mutex> scope_lock(shard.lock);
+
+        size_t new_capacity = TRACKER_INITIAL_SHARD_CAPACITY;
+        while (new_capacity < shard.count * 3)
+        {
+            new_capacity *= 2;
+        }
+
+        const size_t old_capacity = shard.capacity;
+        if (new_capacity < old_capacity && rehash(shard, new_capacity))
+        {
+            released += (old_capacity - new_capacity) * sizeof(TrackedAllocation);
+        }
+    }
+    return released;
+}
+
+//-------------------------------------------------------------------------
+size_t memory_tracker::live_allocation_count()
+{
+    size_t total = 0;
+    for (TrackerShard& shard : s_shards)
+    {
+        std::lock_guard<std::mutex> scope_lock(shard.lock);
+        total += shard.count;
+    }
+    return total;
+}
+
+//-------------------------------------------------------------------------
+void memory_tracker::set_track_ages(bool enabled)
+{
+    detail::track_ages.store(enabled, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+uint32_t memory_tracker::current_tick()
+{
+    const uint32_t tick = static_cast<uint32_t>(platform::coarse_milliseconds() - s_tick_epoch);
+    return tick != TRACKER_NO_TICK ? tick : tick + 1;
+}
+
+//-------------------------------------------------------------------------
+size_t memory_tracker::for_each(void (*visit)(const TrackedAllocation& allocation, void *context), void *context)
+{
+    size_t visited = 0;
+    for (TrackerShard& shard : s_shards)
+    {
+        std::lock_guard<std::mutex> scope_lock(shard.lock);
+        for (size_t i = 0; i < shard.capacity; ++i)
+        {
+            if (shard.slots[i].pointer != nullptr)
+            {
+                visit(shard.slots[i], context);
+                ++visited;
+            }
+        }
+    }
+    return visited;
+}
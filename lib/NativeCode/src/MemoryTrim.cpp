@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "MemoryTrim.h"
+#include "LargeBlockArena.h"
+#include "Memory.h"
+#include "MemoryCounters.h"
+#include "MemoryPool.h"
+#include "MemoryTracker.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// How often the idle thread looks for activity, as a fraction of the timeout
+#define MEMORY_TRIM_POLLS_PER_TIMEOUT 4
+#define MEMORY_TRIM_MIN_POLL_MS 10
+#define MEMORY_TRIM_MAX_POLL_MS 1000
+
+namespace
+{
+    struct IdleTrimmer
+    {
+        std::mutex lock;
+        std::condition_variable wake;
+        std::thread thread;
+        uint64_t timeout_ms = 0;
+        bool stop_requested = false;
+
+        // The thread has to be gone before the rest of the allocator is torn
+        // down at exit
+        ~IdleTrimmer();
+    };
+
+    IdleTrimmer s_idle_trimmer;
+
+    // Serialises set_idle_timeout() so that only one caller starts or joins
+    // the thread
+    std::mutex s_idle_settings_lock;
+
+    std::atomic<uint64_t> s_idle_trim_count(0);
+}
+
+//-------------------------------------------------------------------------
+static void stop_idle_thread()
+{
+    {
+        std::lock_guard<std::mutex> scope_lock(s_idle_trimmer.lock);
+        s_idle_trimmer.stop_requested = true;
+    }
+    s_idle_trimmer.wake.notify_one();
+
+    if (s_idle_trimmer.thread.joinable())
+    {
+        s_idle_trimmer.thread.join();
+    }
+}
+
+//-------------------------------------------------------------------------
+IdleTrimmer::~IdleTrimmer()
+{
+    stop_idle_thread();
+}
+
+//-------------------------------------------------------------------------
+// Activity is judged by the memory counters' operation counts, which the
+// allocator keeps anyway, so being idle costs the allocating threads nothing
+static void idle_thread_main()
+{
+    using clock = std::chrono::steady_clock;
+
+    uint64_t last_operation_count = memory_counters::operation_count();
+    clock::time_point idle_since = clock::now();
+    bool trimmed = false;
+
+    std::unique_lock<std::mutex> wake_lock(s_idle_trimmer.lock);
+    while (!s_idle_trimmer.stop_requested)
+    {
+        const uint64_t timeout_ms = s_idle_trimmer.timeout_ms;
+        uint64_t poll_ms = timeout_ms / MEMORY_TRIM_POLLS_PER_TIMEOUT;
+        poll_ms = poll_ms < MEMORY_TRIM_MIN_POLL_MS ? MEMORY_TRIM_MIN_POLL_MS : poll_ms > MEMORY_TRIM_MAX_POLL_MS ? MEMORY_TRIM_MAX_POLL_MS : poll_ms;
+
+        s_idle_trimmer.wake.wait_for(wake_lock, std::chrono::milliseconds(poll_ms));
+        if (s_idle_trimmer.stop_requested)
+        {
+            break;
+        }
+
+        const uint64_t operation_count = memory_counters::operation_count();
+        if (operation_count != last_operation_count)
+        {
+            last_operation_count = operation_count;
+            idle_since = clock::now();
+            trimmed = false;
+            continue;
+        }
+
+        if (!trimmed && clock::now() - idle_since >= std::chrono::milliseconds(timeout_ms))
+        {
+            wake_lock.unlock();
+            memory_trim::trim();
+            s_idle_trim_count.fetch_add(1, std::memory_order_relaxed);
+            wake_lock.lock();
+            trimmed = true;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+size_t memory_trim::trim()
+{
+    size_t released = memory_pool::trim();
+    released += memory_tracker::trim();
+    released += large_block_arena::trim();
+
+    // Last, so that the C runtime can give back what the tracker just freed
+    released += platform::trim();
+
+    return released;
+}
+
+//-------------------------------------------------------------------------
+void memory_trim::set_idle_timeout(uint64_t idle_timeout_ms)
+{
+    std::lock_guard<std::mutex> settings_lock(s_idle_settings_lock);
+
+    if (idle_timeout_ms == 0)
+    {
+        stop_idle_thread();
+        return;
+    }
+
+    std::lock_guard<std::mutex> scope_lock(s_idle_trimmer.lock);
+    s_idle_trimmer.timeout_ms = idle_timeout_ms;
+    if (!s_idle_trimmer.thread.joinable())
+    {
+        s_idle_trimmer.stop_requested = false;
+        s_idle_trimmer.thread = std::thread(idle_thread_main);
+    }
+}
+
+//-------------------------------------------------------------------------
+uint64_t memory_trim::idle_trim_count()
+{
+    return s_idle_trim_count.load(std::memory_order_relaxed);
+}
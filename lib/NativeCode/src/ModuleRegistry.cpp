@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "ModuleRegistry.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    struct ModuleEntry
+    {
+        std::string stem;
+        void *handle;
+        size_t ref_count;
+    };
+
+    // Never changed once published. Keys point into the entries' stems.
+    struct ModuleSnapshot
+    {
+        std::unordered_map<std::string_view, const ModuleEntry*> by_stem;
+    };
+
+    std::mutex s_writer_lock;
+    std::atomic<const ModuleSnapshot*> s_snapshot(nullptr);
+
+    // Lookups count themselves in the slot for the current epoch; a writer
+    // moves the epoch on and then waits for the old slot to drain
+    std::atomic<unsigned> s_epoch(0);
+    std::atomic<size_t> s_readers[2];
+}
+
+//-------------------------------------------------------------------------
+static std::string_view stem_of(std::string_view library_path)
+{
+    const size_t slash = library_path.find_last_of('/');
+    std::string_view file_name = slash == std::string_view::npos ? library_path : library_path.substr(slash + 1);
+    return file_name.substr(0, file_name.find_last_of('.'));
+}
+
+//-------------------------------------------------------------------------
+// Returns the slot to pass to end_read
+static unsigned begin_read()
+{
+    for (;;)
+    {
+        const unsigned epoch = s_epoch.load();
+        s_readers[epoch & 1].fetch_add(1);
+
+        // The writer may have moved on and stopped waiting on this slot
+        // before it was counted in
+        if (s_epoch.load() == epoch)
+        {
+            return epoch & 1;
+        }
+        s_readers[epoch & 1].fetch_sub(1);
+    }
+}
+
+//-------------------------------------------------------------------------
+static void end_read(unsigned slot)
+{
+    s_readers[slot].fetch_sub(1);
+}
+
+//-------------------------------------------------------------------------
+// Called with s_writer_lock held. Takes ownership of next and of the
+// entries it holds, and frees the old snapshot along with old_entry (if
+// not null) once no lookup can still see them.
+static void publish(ModuleSnapshot *next, const ModuleEntry *old_entry)
+{
+    const ModuleSnapshot *previous = s_snapshot.exchange(next);
+
+    const unsigned epoch = s_epoch.fetch_add(1);
+    while (s_readers[epoch & 1].load() != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    delete previous;
+    delete old_entry;
+}
+
+//-------------------------------------------------------------------------
+static ModuleSnapshot * copy_snapshot()
+{
+    const ModuleSnapshot *current = s_snapshot.load();
+    return current != nullptr ? new ModuleSnapshot(*current) : new ModuleSnapshot();
+}
+
+//-------------------------------------------------------------------------
+void module_registry::add(const char *library_path, void *handle)
+{
+    if (library_path == nullptr || handle == nullptr)
+    {
+        return;
+    }
+
+    const std::string_view stem = stem_of(library_path);
+    std::lock_guard<std::mutex> scope_lock(s_writer_lock);
+
+    const ModuleSnapshot *current = s_snapshot.load();
+    const ModuleEntry *old_entry = nullptr;
+    if (current != nullptr)
+    {
+        auto found = current->by_stem.find(stem);
+        if (found != current->by_stem.end())
+        {
+            // Only ever written under the writer lock, and lookups only
+            // read the handle
+            if (found->second->handle == handle)
+            {
+                const_cast<ModuleEntry*>(found->second)->ref_count++;
+                return;
+            }
+            old_entry = found->second;
+        }
+    }
+
+    ModuleEntry *entry = new ModuleEntry{ std::string(stem), handle, 1 };
+    ModuleSnapshot *next = copy_snapshot();
+    next->by_stem.erase(stem);
+    next->by_stem.emplace(std::string_view(entry->stem), entry);
+
+    publish(next, old_entry);
+}
+
+//-------------------------------------------------------------------------
+bool module_registry::release(void *handle)
+{
+    if (handle == nullptr)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> scope_lock(s_writer_lock);
+
+    const ModuleSnapshot *current = s_snapshot.load();
+    if (current == nullptr)
+    {
+        return false;
+    }
+
+    for (const auto& stem_and_entry : current->by_stem)
+    {
+        ModuleEntry *entry = const_cast<ModuleEntry*>(stem_and_entry.second);
+        if (entry->handle != handle)
+        {
+            continue;
+        }
+
+        if (--entry->ref_count == 0)
+        {
+            ModuleSnapshot *next = copy_snapshot();
+            next->by_stem.erase(std::string_view(entry->stem));
+            publish(next, entry);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------
+void * module_registry::find(const char *stem)
+{
+    if (stem == nullptr)
+    {
+        return nullptr;
+    }
+
+    const unsigned slot = begin_read();
+
+    void *handle = nullptr;
+    const ModuleSnapshot *current = s_snapshot.load();
+    if (current != nullptr)
+    {
+        auto found = current->by_stem.find(std::string_view(stem));
+        if (found != current->by_stem.end())
+        {
+            handle = found->second->handle;
+        }
+    }
+
+    end_read(slot);
+    return handle;
+}
+
+//-------------------------------------------------------------------------
+size_t module_registry::module_count()
+{
+    const unsigned slot = begin_read();
+
+    const ModuleSnapshot *current = s_snapshot.load();
+    const size_t count = current != nullptr ? current->by_stem.size() : 0;
+
+    end_read(slot);
+    return count;
+}
@@ -0,0 +1,1670 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The platform independent part of GfxPluginNativeRender's bootstrap; see
+// PluginBootstrap.h. Moved here from NativeRender/dllmain.cpp so that the
+// Linux build can share it.
+
+#include "pch.h"
+#include "PluginBootstrap.h"
+#include "ConfigBinding.h"
+#include "ConfigCache.h"
+#include "EOSFunctions.h"
+#include "json.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#if PLATFORM_WINDOWS
+#include "Windows/eos_Windows.h"
+#endif
+#include "eos_logging.h"
+
+#define SHOW_DIALOG_BOX_ON_WARN 0
+
+namespace fs = std::filesystem;
+
+#ifdef BOOTSTRAP_GENERATED_CONFIG_LIBRARY_NAME
+typedef const char* (*GetConfigAsJSONString_t)();
+#endif
+
+//-------------------------------------------------------------------------
+// Fetched out of DynamicLibraryLoaderHelper
+typedef void (EOS_CALL *Mem_GetAllocatorFunctions_t)(void** alloc, void** realloc, void** free);
+typedef bool (EOS_CALL *Mem_SetAllocatorBackend_t)(int32_t backend);
+typedef bool (EOS_CALL *Mem_WriteLeakReport_t)(const char* path);
+
+// Fetched out of the EOS SDK; see EOSFunctions.h
+static EOSFunctions s_eos;
+
+static void *s_eos_sdk_lib_handle;
+static void *s_dllh_lib_handle;
+static EOS_HPlatform eos_platform_handle;
+#ifdef BOOTSTRAP_GENERATED_CONFIG_LIBRARY_NAME
+static GetConfigAsJSONString_t GetConfigAsJSONString;
+#endif
+
+using namespace plugin_bootstrap;
+
+//-------------------------------------------------------------------------
+static bool create_timestamp_str(char *final_timestamp, size_t final_timestamp_len)
+{
+    constexpr size_t buffer_len = 32;
+    char buffer[buffer_len];
+
+    if (buffer_len > final_timestamp_len)
+    {
+        return false;
+    }
+
+    time_t raw_time = time(NULL);
+    tm time_info = { 0 };
+
+    timespec time_spec = { 0 };
+    timespec_get(&time_spec, TIME_UTC);
+    if (!bootstrap_platform::local_time(raw_time, &time_info))
+    {
+        return false;
+    }
+
+    strftime(buffer, buffer_len, "%Y-%m-%dT%H:%M:%S", &time_info);
+    long milliseconds = (long)round(time_spec.tv_nsec / 1.0e6);
+    snprintf(final_timestamp, final_timestamp_len, "%s.%03ld", buffer, milliseconds);
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Strings from json_parse_flags_strings_in_source aren't null terminated, so
+// these go by string_size
+static bool json_string_is(const json_string_s *string, const char *literal)
+{
+    const size_t length = strlen(literal);
+    return string->string_size == length && memcmp(string->string, literal, length) == 0;
+}
+
+//-------------------------------------------------------------------------
+static uint64_t json_value_as_uint64(json_value_s *value, uint64_t default_value = 0)
+{
+    uint64_t val = 0;
+    json_number_s *n = json_value_as_number(value);
+
+    if (n != nullptr)
+    {
+        char *end = nullptr;
+        val = strtoull(n->number, &end, 10);
+    }
+    else
+    {
+        // try to treat it as a string, then parse as long
+        char *end = nullptr;
+        json_string_s* val_as_str = json_value_as_string(value);
+        if (val_as_str == nullptr || val_as_str->string_size == 0)
+        {
+            val = default_value;
+        }
+        else
+        {
+            val = strtoull(std::string(val_as_str->string, val_as_str->string_size).c_str(), &end, 10);
+        }
+    }
+
+    return val;
+}
+
+//-------------------------------------------------------------------------
+static uint32_t json_value_as_uint32(json_value_s* value, uint32_t default_value = 0)
+{
+    uint32_t val = 0;
+    json_number_s* n = json_value_as_number(value);
+
+    if (n != nullptr)
+    {
+        char* end = nullptr;
+        val = strtoul(n->number, &end, 10);
+    }
+    else
+    {
+        // try to treat it as a string, then parse as long
+        char* end = nullptr;
+        json_string_s* val_as_str = json_value_as_string(value);
+
+        if (val_as_str == nullptr || val_as_str->string_size == 0)
+        {
+            val = default_value;
+        }
+        else
+        {
+            val = strtoul(std::string(val_as_str->string, val_as_str->string_size).c_str(), &end, 10);
+        }
+    }
+
+    return val;
+}
+
+//-------------------------------------------------------------------------
+static double json_value_as_double(json_value_s* value, double default_value = 0.0)
+{
+    double val = 0.0;
+    json_number_s* n = json_value_as_number(value);
+
+    if (n != nullptr)
+    {
+        char* end = nullptr;
+        val = strtod(n->number, &end);
+    }
+    else
+    {
+        // try to treat it as a string, then parse as long
+        char* end = nullptr;
+        json_string_s* val_as_str = json_value_as_string(value);
+
+        if (val_as_str == nullptr || val_as_str->string_size == 0)
+        {
+            val = default_value;
+        }
+        else
+        {
+            val = strtod(std::string(val_as_str->string, val_as_str->string_size).c_str(), &end);
+        }
+    }
+
+    return val;
+}
+
+//-------------------------------------------------------------------------
+static const char* eos_loglevel_to_print_str(EOS_ELogLevel level)
+{
+    switch (level)
+    {
+    case EOS_ELogLevel::EOS_LOG_Off:
+        return "Off";
+        break;
+    case EOS_ELogLevel::EOS_LOG_Fatal:
+        return "Fatal";
+        break;
+    case EOS_ELogLevel::EOS_LOG_Error:
+        return "Error";
+        break;
+    case EOS_ELogLevel::EOS_LOG_Warning:
+        return "Warning";
+        break;
+    case EOS_ELogLevel::EOS_LOG_Info:
+        return "Info";
+        break;
+    case EOS_ELogLevel::EOS_LOG_Verbose:
+        return "Verbose";
+        break;
+    case EOS_ELogLevel::EOS_LOG_VeryVerbose:
+        return "VeryVerbose";
+        break;
+    default:
+        return nullptr;
+    }
+}
+
+static std::unordered_map<std::string, EOS_ELogLevel> const loglevel_str_map =
+{
+    {"Off",EOS_ELogLevel::EOS_LOG_Off},
+    {"Fatal",EOS_ELogLevel::EOS_LOG_Fatal},
+    {"Error",EOS_ELogLevel::EOS_LOG_Error},
+    {"Warning",EOS_ELogLevel::EOS_LOG_Warning},
+    {"Info",EOS_ELogLevel::EOS_LOG_Info},
+    {"Verbose",EOS_ELogLevel::EOS_LOG_Verbose},
+    {"VeryVerbose",EOS_ELogLevel::EOS_LOG_VeryVerbose},
+};
+
+//-------------------------------------------------------------------------
+static EOS_ELogLevel eos_loglevel_str_to_enum(const std::string& str)
+{
+    auto it = loglevel_str_map.find(str);
+    if (it != loglevel_str_map.end())
+    {
+        return it->second;
+    }
+    else
+    {
+        return EOS_ELogLevel::EOS_LOG_Verbose;
+    }
+}
+
+//-------------------------------------------------------------------------
+// load logs from more than one thread at once, so the file and the lines
+// waiting for it are only touched under s_log_lock
+static std::mutex s_log_lock;
+static FILE* log_file_s = nullptr;
+static std::vector<std::string> buffered_output;
+void plugin_bootstrap::log_close()
+{
+    std::lock_guard<std::mutex> lock(s_log_lock);
+    if (log_file_s)
+    {
+        fclose(log_file_s);
+        log_file_s = nullptr;
+        buffered_output.clear();
+    }
+}
+
+//-------------------------------------------------------------------------
+// Must be called with s_log_lock held
+static void write_log_line(const std::string& line)
+{
+    if (log_file_s != nullptr)
+    {
+        fputs(line.c_str(), log_file_s);
+        fputc('\n', log_file_s);
+        fflush(log_file_s);
+    }
+    else
+    {
+        buffered_output.push_back(line);
+    }
+}
+
+//-------------------------------------------------------------------------
+void plugin_bootstrap::log_printf(const char* format, ...)
+{
+    va_list arg_list;
+    va_start(arg_list, format);
+    va_list arg_list_copy;
+    va_copy(arg_list_copy, arg_list);
+    const size_t printed_length = vsnprintf(nullptr, 0, format, arg_list) + 1;
+    va_end(arg_list);
+
+    std::vector<char> buffer(printed_length);
+    vsnprintf(buffer.data(), printed_length, format, arg_list_copy);
+    va_end(arg_list_copy);
+
+    std::lock_guard<std::mutex> lock(s_log_lock);
+    write_log_line(std::string(buffer.data()));
+}
+
+//-------------------------------------------------------------------------
+void plugin_bootstrap::log_open(const char* filename)
+{
+    std::lock_guard<std::mutex> lock(s_log_lock);
+    if (log_file_s != nullptr)
+    {
+        fclose(log_file_s);
+        log_file_s = nullptr;
+    }
+#if PLATFORM_WINDOWS
+    fopen_s(&log_file_s, filename, "w");
+#else
+    log_file_s = fopen(filename, "w");
+#endif
+
+    if (log_file_s != nullptr && buffered_output.size() > 0)
+    {
+        std::vector<std::string> lines;
+        lines.swap(buffered_output);
+        for (const std::string& str : lines)
+        {
+            write_log_line(str);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+void plugin_bootstrap::flush_log_with_function(void (*log_flush_function)(const char* str))
+{
+    // Not called under the lock, in case it logs
+    std::vector<std::string> lines;
+    {
+        std::lock_guard<std::mutex> lock(s_log_lock);
+        lines.swap(buffered_output);
+    }
+
+    for (const std::string& str : lines)
+    {
+        log_flush_function(str.c_str());
+    }
+}
+
+//-------------------------------------------------------------------------
+static void log_base(const char* header, const char* message)
+{
+    constexpr size_t final_timestamp_len = 32;
+    char final_timestamp[final_timestamp_len] = { };
+    if (create_timestamp_str(final_timestamp, final_timestamp_len))
+    {
+        log_printf("%s NativePlugin (%s): %s", final_timestamp, header, message);
+    }
+    else
+    {
+        log_printf("NativePlugin (%s): %s", header, message);
+    }
+}
+
+//-------------------------------------------------------------------------
+// TODO: If possible, hook this up into a proper logging channel.s
+void plugin_bootstrap::log_warn(const char* log_string)
+{
+#if SHOW_DIALOG_BOX_ON_WARN
+    bootstrap_platform::show_dialog(log_string);
+#endif
+    log_base("WARNING", log_string);
+}
+
+//-------------------------------------------------------------------------
+void plugin_bootstrap::log_inform(const char* log_string)
+{
+    log_base("INFORM", log_string);
+}
+
+//-------------------------------------------------------------------------
+void plugin_bootstrap::log_error(const char* log_string)
+{
+    log_base("ERROR", log_string);
+}
+
+//-------------------------------------------------------------------------
+EXTERN_C void EOS_CALL eos_log_callback(const EOS_LogMessage* message)
+{
+    constexpr size_t final_timestamp_len = 32;
+    char final_timestamp[final_timestamp_len] = {0};
+
+    if (create_timestamp_str(final_timestamp, final_timestamp_len))
+    {
+        log_printf("%s %s (%s): %s", final_timestamp, message->Category, eos_loglevel_to_print_str(message->Level), message->Message);
+    }
+    else
+    {
+        log_printf("%s (%s): %s", message->Category, eos_loglevel_to_print_str(message->Level), message->Message);
+    }
+
+}
+
+//-------------------------------------------------------------------------
+static fs::path get_path_relative_to_current_module(const fs::path& relative_path)
+{
+    fs::path module_directory = bootstrap_platform::module_directory();
+    if (module_directory.empty())
+    {
+        return {};
+    }
+
+    return module_directory / relative_path;
+}
+
+//-------------------------------------------------------------------------
+static void* load_library_at_path(const fs::path& library_path)
+{
+    log_inform(("Loading path at " + library_path.u8string()).c_str());
+    return bootstrap_platform::load_library(library_path);
+}
+
+//-------------------------------------------------------------------------
+template<typename T>
+T load_function_with_name(void* library_handle, const char* function)
+{
+    return reinterpret_cast<T>(bootstrap_platform::load_function(library_handle, function));
+}
+
+//-------------------------------------------------------------------------
+// Points the SDK at the allocator in DynamicLibraryLoaderHelper so that its
+// memory shows up in the counters. The library is never unloaded, as the SDK
+// outlives this plugin. Without it the SDK keeps its own allocator.
+static void eos_set_allocator_functions(EOS_InitializeOptions& SDKOptions, const EOSConfig& eos_config)
+{
+    SDKOptions.AllocateMemoryFunction = nullptr;
+    SDKOptions.ReallocateMemoryFunction = nullptr;
+    SDKOptions.ReleaseMemoryFunction = nullptr;
+
+    if (s_dllh_lib_handle == nullptr)
+    {
+        s_dllh_lib_handle = load_library_at_path(get_path_relative_to_current_module(BOOTSTRAP_DLLH_LIBRARY_NAME));
+    }
+    if (s_dllh_lib_handle == nullptr)
+    {
+        log_warn("Couldn't find dll " BOOTSTRAP_DLLH_LIBRARY_NAME ", EOS will use its own allocator");
+        return;
+    }
+
+    auto Mem_GetAllocatorFunctions_ptr = reinterpret_cast<Mem_GetAllocatorFunctions_t>(bootstrap_platform::load_dllh_function(s_dllh_lib_handle, "Mem_GetAllocatorFunctions", 12));
+    auto Mem_SetAllocatorBackend_ptr = reinterpret_cast<Mem_SetAllocatorBackend_t>(bootstrap_platform::load_dllh_function(s_dllh_lib_handle, "Mem_SetAllocatorBackend", 4));
+    if (Mem_GetAllocatorFunctions_ptr == nullptr || Mem_SetAllocatorBackend_ptr == nullptr)
+    {
+        log_warn("Couldn't find the allocator in " BOOTSTRAP_DLLH_LIBRARY_NAME ", EOS will use its own");
+        return;
+    }
+
+    if (eos_config.memoryAllocatorBackend == "Pooled")
+    {
+        Mem_SetAllocatorBackend_ptr(1);
+    }
+    else if (eos_config.memoryAllocatorBackend == "System")
+    {
+        Mem_SetAllocatorBackend_ptr(0);
+    }
+    else if (!eos_config.memoryAllocatorBackend.empty())
+    {
+        log_warn(("Unknown memoryAllocatorBackend " + eos_config.memoryAllocatorBackend).c_str());
+    }
+
+    void* alloc_function = nullptr;
+    void* realloc_function = nullptr;
+    void* free_function = nullptr;
+    Mem_GetAllocatorFunctions_ptr(&alloc_function, &realloc_function, &free_function);
+
+    SDKOptions.AllocateMemoryFunction = reinterpret_cast<EOS_AllocateMemoryFunc>(alloc_function);
+    SDKOptions.ReallocateMemoryFunction = reinterpret_cast<EOS_ReallocateMemoryFunc>(realloc_function);
+    SDKOptions.ReleaseMemoryFunction = reinterpret_cast<EOS_ReleaseMemoryFunc>(free_function);
+}
+
+//-------------------------------------------------------------------------
+static void eos_init(const EOSConfig& eos_config)
+{
+    static int reserved[2] = {1, 1};
+    EOS_InitializeOptions SDKOptions = { 0 };
+    SDKOptions.ApiVersion = EOS_INITIALIZE_API_LATEST;
+    eos_set_allocator_functions(SDKOptions, eos_config);
+    SDKOptions.ProductName = eos_config.productName.c_str();
+    SDKOptions.ProductVersion = eos_config.productVersion.c_str();
+    SDKOptions.Reserved = reserved;
+    SDKOptions.SystemInitializeOptions = nullptr;
+
+    EOS_Initialize_ThreadAffinity overrideThreadAffinity = {0};
+
+    overrideThreadAffinity.ApiVersion = EOS_INITIALIZE_THREADAFFINITY_API_LATEST;
+
+    overrideThreadAffinity.HttpRequestIo = eos_config.ThreadAffinity_HTTPRequestIO;
+    overrideThreadAffinity.NetworkWork = eos_config.ThreadAffinity_networkWork;
+    overrideThreadAffinity.P2PIo = eos_config.ThreadAffinity_P2PIO;
+    overrideThreadAffinity.RTCIo = eos_config.ThreadAffinity_RTCIO;
+    overrideThreadAffinity.StorageIo = eos_config.ThreadAffinity_storageIO;
+    overrideThreadAffinity.WebSocketIo = eos_config.ThreadAffinity_webSocketIO;
+
+
+    SDKOptions.OverrideThreadAffinity = &overrideThreadAffinity;
+
+    log_inform("call EOS_Initialize");
+    EOS_EResult InitResult = s_eos.EOS_Initialize(&SDKOptions);
+    if (InitResult != EOS_EResult::EOS_Success)
+    {
+        log_error("Unable to do eos init");
+    }
+    s_eos.EOS_Logging_SetLogLevel(EOS_ELogCategory::EOS_LC_ALL_CATEGORIES, EOS_ELogLevel::EOS_LOG_VeryVerbose);
+    s_eos.EOS_Logging_SetCallback(&eos_log_callback);
+}
+
+//-------------------------------------------------------------------------
+// Anything still allocated through DynamicLibraryLoaderHelper by the time
+// the plugin is unloaded has leaked. The report goes next to the SDK cache.
+static void write_memory_leak_report()
+{
+    if (s_dllh_lib_handle == nullptr)
+    {
+        return;
+    }
+
+    auto Mem_WriteLeakReport_ptr = reinterpret_cast<Mem_WriteLeakReport_t>(bootstrap_platform::load_dllh_function(s_dllh_lib_handle, "Mem_WriteLeakReport", 4));
+    if (Mem_WriteLeakReport_ptr == nullptr)
+    {
+        return;
+    }
+
+    const std::string report_path = std::string(bootstrap_platform::cache_directory()) + "eos_memory_leak_report.txt";
+    if (Mem_WriteLeakReport_ptr(report_path.c_str()))
+    {
+        log_inform(("Wrote memory leak report to " + report_path).c_str());
+    }
+    else
+    {
+        log_warn(("Couldn't write memory leak report to " + report_path).c_str());
+    }
+}
+
+//-------------------------------------------------------------------------
+// On failure, logs why and returns false
+static bool map_config_file(const fs::path& path_to_config_json, bootstrap_platform::MappedFile *out_mapped_file)
+{
+    log_inform(("json path" + path_to_config_json.u8string()).c_str());
+
+    std::string error;
+    if (!bootstrap_platform::map_file(path_to_config_json, out_mapped_file, &error))
+    {
+        log_warn(("Couldn't read " + path_to_config_json.u8string() + ": " + error).c_str());
+        return false;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// On failure, logs where the JSON went wrong and returns null
+static json_value_s* parse_config_json(const fs::path& path_to_config_json, const bootstrap_platform::MappedFile& mapped_file, size_t flags)
+{
+    json_parse_result_s result = {};
+    json_value_s* config_json = json_parse_ex(mapped_file.data, mapped_file.size, flags, nullptr, nullptr, &result);
+    if (config_json == nullptr)
+    {
+        char location[96];
+        snprintf(location, sizeof(location), ": error %d at line %zu, column %zu", static_cast<int>(result.error), result.error_line_no, result.error_row_no);
+        log_warn(("Couldn't parse " + path_to_config_json.u8string() + location).c_str());
+    }
+    return config_json;
+}
+
+//-------------------------------------------------------------------------
+json_value_s* plugin_bootstrap::read_config_json_from_path(const fs::path& path_to_config_json)
+{
+    bootstrap_platform::MappedFile mapped_file;
+    if (!map_config_file(path_to_config_json, &mapped_file))
+    {
+        return nullptr;
+    }
+
+    // Copies the strings, as the result outlives the mapping
+    json_value_s* config_json = parse_config_json(path_to_config_json, mapped_file, json_parse_flags_default);
+    bootstrap_platform::unmap_file(&mapped_file);
+    return config_json;
+}
+
+//-------------------------------------------------------------------------
+// Where a config's cache goes: beside it, or where that can't be written,
+// such as in an install that's read only, in the cache directory under a
+// name that's unique to the config's path
+static fs::path config_cache_path(const fs::path& path_to_config_json, bool in_cache_directory)
+{
+    if (!in_cache_directory)
+    {
+        fs::path cache_path = path_to_config_json;
+        cache_path += CONFIG_CACHE_EXTENSION;
+        return cache_path;
+    }
+
+    // Named for the whole path, so configs with the same name don't share
+    const std::string path_string = path_to_config_json.u8string();
+    char path_hash[24];
+    snprintf(path_hash, sizeof(path_hash), "%016llx", static_cast<unsigned long long>(config_cache::hash_bytes(path_string.data(), path_string.size())));
+
+    return fs::u8path(bootstrap_platform::cache_directory()) / fs::u8path(std::string("eos_config_") + path_hash + "_" + path_to_config_json.filename().u8string() + CONFIG_CACHE_EXTENSION);
+}
+
+//-------------------------------------------------------------------------
+template<typename Config>
+static std::optional<Config> read_config_with_cache(const fs::path& path_to_config_json, const bootstrap_platform::MappedFile& json_file, Config (*config_from_json_value)(json_value_s*))
+{
+    // The cache directory is only for when the cache can't go beside the
+    // config, so it's only looked in when there's nothing beside it
+    std::string error;
+    for (int in_cache_directory = 0; in_cache_directory < 2; ++in_cache_directory)
+    {
+        const fs::path cache_path = config_cache_path(path_to_config_json, in_cache_directory != 0);
+        bootstrap_platform::MappedFile mapped_file;
+        if (!bootstrap_platform::map_file(cache_path, &mapped_file, &error))
+        {
+            continue;
+        }
+
+        // The cache directory may be shared with other users, so a cache
+        // anyone else could have written is no better than no cache
+        Config config;
+        const bool decoded = mapped_file.private_to_user
+            && config_cache::decode(mapped_file.data, mapped_file.size, json_file.data, json_file.size, &config);
+        bootstrap_platform::unmap_file(&mapped_file);
+        if (decoded)
+        {
+            log_inform(("Config read from cache " + cache_path.u8string()).c_str());
+            return config;
+        }
+    }
+
+    // The strings are copied out of the mapping as the config is filled in,
+    // so it needn't be copied first
+    json_value_s* config_json = parse_config_json(path_to_config_json, json_file, json_parse_flags_strings_in_source);
+    if (config_json == nullptr)
+    {
+        return std::nullopt;
+    }
+    Config config = config_from_json_value(config_json);
+    free(config_json);
+
+    const std::string encoded = config_cache::encode(config, json_file.data, json_file.size);
+    for (int in_cache_directory = 0; in_cache_directory < 2; ++in_cache_directory)
+    {
+        const fs::path cache_path = config_cache_path(path_to_config_json, in_cache_directory != 0);
+        if (bootstrap_platform::write_file(cache_path, encoded.data(), encoded.size(), &error))
+        {
+            break;
+        }
+        log_inform(("Couldn't write config cache " + cache_path.u8string() + ": " + error).c_str());
+    }
+
+    return config;
+}
+
+//-------------------------------------------------------------------------
+template<typename Config>
+static std::optional<Config> read_config_with_cache(const fs::path& path_to_config_json, Config (*config_from_json_value)(json_value_s*))
+{
+    bootstrap_platform::MappedFile json_file;
+    if (!map_config_file(path_to_config_json, &json_file))
+    {
+        return std::nullopt;
+    }
+
+    std::optional<Config> config = read_config_with_cache(path_to_config_json, json_file, config_from_json_value);
+    bootstrap_platform::unmap_file(&json_file);
+    return config;
+}
+
+//-------------------------------------------------------------------------
+std::optional<EOSConfig> plugin_bootstrap::read_eos_config_from_path(const fs::path& path_to_config_json)
+{
+    return read_config_with_cache(path_to_config_json, &eos_config_from_json_value);
+}
+
+//-------------------------------------------------------------------------
+std::optional<LogLevelConfig> plugin_bootstrap::read_log_level_config_from_path(const fs::path& path_to_config_json)
+{
+    return read_config_with_cache(path_to_config_json, &log_config_from_json_value);
+}
+
+//-------------------------------------------------------------------------
+std::optional<EOSSteamConfig> plugin_bootstrap::read_steam_config_from_path(const fs::path& path_to_config_json)
+{
+    return read_config_with_cache(path_to_config_json, &eos_steam_config_from_json_value);
+}
+
+//-------------------------------------------------------------------------
+static json_value_s* read_config_json_from_dll()
+{
+    struct json_value_s* config_json = nullptr;
+
+#ifdef BOOTSTRAP_GENERATED_CONFIG_LIBRARY_NAME
+	log_inform("Trying to load eos config via dll");
+    static void *eos_generated_library_handle = load_library_at_path(get_path_relative_to_current_module(BOOTSTRAP_GENERATED_CONFIG_LIBRARY_NAME));
+
+	if (!eos_generated_library_handle)
+	{
+		log_warn("No Generated DLL found (Might not be an error)");
+		return NULL;
+	}
+
+    GetConfigAsJSONString = load_function_with_name<GetConfigAsJSONString_t>(eos_generated_library_handle, "GetConfigAsJSONString");
+    
+    if(GetConfigAsJSONString)
+    {
+        const char* config_as_json_string = GetConfigAsJSONString();
+        if (config_as_json_string != nullptr)
+        {
+            size_t config_as_json_string_length = strlen(config_as_json_string);
+            config_json = json_parse(config_as_json_string, config_as_json_string_length);
+        }
+    }
+	else
+	{
+		log_warn("No function found");
+	}
+#endif
+
+    return config_json;
+}
+
+//-------------------------------------------------------------------------
+// Config fields are bound through the schemas below; see ConfigBinding.h
+template<typename Member>
+struct member_traits;
+
+template<typename Owner, typename Value>
+struct member_traits<Value Owner::*>
+{
+    typedef Owner owner;
+};
+
+template<auto Member>
+using owner_of = typename member_traits<decltype(Member)>::owner;
+
+//-------------------------------------------------------------------------
+template<typename Config, size_t FieldCount>
+static void bind_object(json_value_s *value, const config_binding::Schema<Config, FieldCount>& schema, Config *out_config)
+{
+    json_object_s *object = json_value_as_object(value);
+    if (object == nullptr)
+    {
+        return;
+    }
+
+    for (json_object_element_s *iter = object->start; iter != nullptr; iter = iter->next)
+    {
+        const config_binding::FieldDescriptor<Config> *field = schema.find(iter->name->string, iter->name->string_size);
+        if (field != nullptr)
+        {
+            field->bind(iter->value, out_config);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+template<auto Member>
+static void bind_string(json_value_s *value, owner_of<Member> *out_config)
+{
+    if (json_string_s *string = json_value_as_string(value))
+    {
+        out_config->*Member = std::string(string->string, string->string_size);
+    }
+}
+
+//-------------------------------------------------------------------------
+// For lists that are kept as one field per member of an object, such as
+// the categories and levels of the log level config
+template<auto Member>
+static void bind_string_appended(json_value_s *value, owner_of<Member> *out_config)
+{
+    if (json_string_s *string = json_value_as_string(value))
+    {
+        (out_config->*Member).emplace_back(string->string, string->string_size);
+    }
+}
+
+//-------------------------------------------------------------------------
+template<auto Member>
+static void bind_string_array(json_value_s *value, owner_of<Member> *out_config)
+{
+    json_array_s *array = json_value_as_array(value);
+    if (array == nullptr)
+    {
+        return;
+    }
+
+    for (json_array_element_s *e = array->start; e != nullptr; e = e->next)
+    {
+        bind_string_appended<Member>(e->value, out_config);
+    }
+}
+
+//-------------------------------------------------------------------------
+template<auto Member>
+static void bind_uint32(json_value_s *value, owner_of<Member> *out_config)
+{
+    out_config->*Member = json_value_as_uint32(value);
+}
+
+//-------------------------------------------------------------------------
+template<auto Member>
+static void bind_uint64(json_value_s *value, owner_of<Member> *out_config)
+{
+    out_config->*Member = json_value_as_uint64(value);
+}
+
+//-------------------------------------------------------------------------
+template<auto Member>
+static void bind_double(json_value_s *value, owner_of<Member> *out_config)
+{
+    out_config->*Member = json_value_as_double(value);
+}
+
+//-------------------------------------------------------------------------
+template<auto Member>
+static void bind_bool(json_value_s *value, owner_of<Member> *out_config)
+{
+    // In this JSON library, true and false are _technically_ different types.
+    if (json_value_is_true(value))
+    {
+        out_config->*Member = true;
+    }
+    else if (json_value_is_false(value))
+    {
+        out_config->*Member = false;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Replaces the list with one item per object in the array
+template<auto Member, const auto& ItemSchema>
+static void bind_object_array(json_value_s *value, owner_of<Member> *out_config)
+{
+    json_array_s *array = json_value_as_array(value);
+    if (array == nullptr)
+    {
+        return;
+    }
+
+    auto& items = out_config->*Member;
+    items.clear();
+    for (json_array_element_s *e = array->start; e != nullptr; e = e->next)
+    {
+        items.emplace_back();
+        bind_object(e->value, ItemSchema, &items.back());
+    }
+}
+
+//-------------------------------------------------------------------------
+// Binds the members of each object in the array into the config itself
+template<typename Config, const auto& ItemSchema>
+static void bind_each_object(json_value_s *value, Config *out_config)
+{
+    json_array_s *array = json_value_as_array(value);
+    if (array == nullptr)
+    {
+        return;
+    }
+
+    for (json_array_element_s *e = array->start; e != nullptr; e = e->next)
+    {
+        bind_object(e->value, ItemSchema, out_config);
+    }
+}
+
+//-------------------------------------------------------------------------
+static void bind_platform_options_flags(json_value_s *value, EOSConfig *out_config)
+{
+    json_array_s *flags = json_value_as_array(value);
+    if (flags == nullptr)
+    {
+        return;
+    }
+
+    uint64_t collected_flags = 0;
+    for (auto e = flags->start; e != nullptr; e = e->next)
+    {
+        json_string_s *flag = json_value_as_string(e->value);
+        if (flag == nullptr)
+        {
+            continue;
+        }
+
+        if (json_string_is(flag, "EOS_PF_LOADING_IN_EDITOR") || json_string_is(flag, "LoadingInEditor"))
+        {
+            collected_flags |= EOS_PF_LOADING_IN_EDITOR;
+        }
+
+        if (json_string_is(flag, "EOS_PF_DISABLE_OVERLAY") || json_string_is(flag, "DisableOverlay"))
+        {
+            collected_flags |= EOS_PF_DISABLE_OVERLAY;
+        }
+
+        if (json_string_is(flag, "EOS_PF_DISABLE_SOCIAL_OVERLAY") || json_string_is(flag, "DisableSocialOverlay"))
+        {
+            collected_flags |= EOS_PF_DISABLE_SOCIAL_OVERLAY;
+        }
+
+        if (json_string_is(flag, "EOS_PF_RESERVED1") || json_string_is(flag, "Reserved1"))
+        {
+            collected_flags |= EOS_PF_RESERVED1;
+        }
+
+        if (json_string_is(flag, "EOS_PF_WINDOWS_ENABLE_OVERLAY_D3D9") || json_string_is(flag, "WindowsEnableOverlayD3D9"))
+        {
+            collected_flags |= EOS_PF_WINDOWS_ENABLE_OVERLAY_D3D9;
+        }
+
+        if (json_string_is(flag, "EOS_PF_WINDOWS_ENABLE_OVERLAY_D3D10") || json_string_is(flag, "WindowsEnableOverlayD3D10"))
+        {
+            collected_flags |= EOS_PF_WINDOWS_ENABLE_OVERLAY_D3D10;
+        }
+
+        if (json_string_is(flag, "EOS_PF_WINDOWS_ENABLE_OVERLAY_OPENGL") || json_string_is(flag, "WindowsEnableOverlayOpengl"))
+        {
+            collected_flags |= EOS_PF_WINDOWS_ENABLE_OVERLAY_OPENGL;
+        }
+    }
+
+    out_config->flags = collected_flags;
+}
+
+//-------------------------------------------------------------------------
+static bool str_is_equal_to_any(const json_string_s *str, ...)
+{
+    bool to_return = false;
+    va_list arg_list;
+    va_start(arg_list, str);
+
+    const char *value = va_arg(arg_list, const char*);
+
+    while (value != NULL)
+    {
+        if (json_string_is(str, value))
+        {
+            to_return = true;
+            break;
+        }
+        value = va_arg(arg_list, const char*);
+    }
+
+    va_end(arg_list);
+
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+static void bind_integrated_platform_management_flags(json_value_s *value, EOSSteamConfig *out_config)
+{
+    json_array_s* flags = json_value_as_array(value);
+    if (flags == nullptr)
+    {
+        return;
+    }
+
+    EOS_EIntegratedPlatformManagementFlags collected_flags = static_cast<EOS_EIntegratedPlatformManagementFlags>(0);
+    bool flag_set = false;
+    for (auto e = flags->start; e != nullptr; e = e->next)
+    {
+        json_string_s *flag = json_value_as_string(e->value);
+        if (flag == nullptr)
+        {
+            continue;
+        }
+
+        if (str_is_equal_to_any(flag, "EOS_IPMF_Disabled", "Disabled", NULL))
+        {
+            collected_flags |= EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled;
+            flag_set = true;
+        }
+
+        else if (str_is_equal_to_any(flag, "EOS_IPMF_ManagedByApplication", "ManagedByApplication", "EOS_IPMF_LibraryManagedByApplication", "LibraryManagedByApplication", NULL))
+        {
+            collected_flags |= EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_LibraryManagedByApplication;
+            flag_set = true;
+        }
+        else if (str_is_equal_to_any(flag,"EOS_IPMF_ManagedBySDK", "ManagedBySDK", "EOS_IPMF_LibraryManagedBySDK", "LibraryManagedBySDK", NULL))
+        {
+            collected_flags |= EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_LibraryManagedBySDK;
+            flag_set = true;
+        }
+        else if (str_is_equal_to_any(flag, "EOS_IPMF_DisableSharedPresence", "DisableSharedPresence", "EOS_IPMF_DisablePresenceMirroring", "DisablePresenceMirroring", NULL))
+        {
+            collected_flags |= EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_DisablePresenceMirroring;
+            flag_set = true;
+        }
+        else if (str_is_equal_to_any(flag, "EOS_IPMF_DisableSessions", "DisableSessions", "EOS_IPMF_DisableSDKManagedSessions", "DisableSDKManagedSessions", NULL))
+        {
+            collected_flags |= EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_DisableSDKManagedSessions;
+            flag_set = true;
+        }
+        else if (str_is_equal_to_any(flag, "EOS_IPMF_PreferEOS", "PreferEOS", "EOS_IPMF_PreferEOSIdentity", "PreferEOSIdentity", NULL))
+        {
+            collected_flags |= EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_PreferEOSIdentity;
+            flag_set = true;
+        }
+        else if (str_is_equal_to_any(flag, "EOS_IPMF_PreferIntegrated", "PreferIntegrated", "EOS_IPMF_PreferIntegratedIdentity", "PreferIntegratedIdentity", NULL))
+        {
+            collected_flags |= EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_PreferIntegratedIdentity;
+            flag_set = true;
+        }
+    }
+
+    out_config->flags = flag_set ? collected_flags : EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled;
+}
+
+//-------------------------------------------------------------------------
+static void bind_override_library_path(json_value_s *value, EOSSteamConfig *out_config)
+{
+    json_string_s *override_library_path = json_value_as_string(value);
+    if (override_library_path == nullptr)
+    {
+        return;
+    }
+
+    if (!json_string_is(override_library_path, "NULL")
+        && !json_string_is(override_library_path, "null")
+        )
+    {
+        out_config->OverrideLibraryPath = std::string(override_library_path->string, override_library_path->string_size);
+    }
+}
+
+static constexpr config_binding::FieldDescriptor<SandboxDeploymentOverride> s_sandbox_deployment_override_fields[] =
+{
+    { "sandboxID", &bind_string<&SandboxDeploymentOverride::sandboxID> },
+    { "deploymentID", &bind_string<&SandboxDeploymentOverride::deploymentID> },
+};
+static constexpr auto s_sandbox_deployment_override_schema = config_binding::make_schema(s_sandbox_deployment_override_fields);
+
+static constexpr config_binding::FieldDescriptor<EOSConfig> s_eos_config_fields[] =
+{
+    { "productName", &bind_string<&EOSConfig::productName> },
+    { "productVersion", &bind_string<&EOSConfig::productVersion> },
+    { "productID", &bind_string<&EOSConfig::productID> },
+    { "sandboxID", &bind_string<&EOSConfig::sandboxID> },
+    { "deploymentID", &bind_string<&EOSConfig::deploymentID> },
+    { "sandboxDeploymentOverrides", &bind_object_array<&EOSConfig::sandboxDeploymentOverrides, s_sandbox_deployment_override_schema> },
+    { "clientID", &bind_string<&EOSConfig::clientID> },
+    { "clientSecret", &bind_string<&EOSConfig::clientSecret> },
+    { "encryptionKey", &bind_string<&EOSConfig::encryptionKey> },
+    { "overrideCountryCode", &bind_string<&EOSConfig::overrideCountryCode> },
+    { "overrideLocaleCode", &bind_string<&EOSConfig::overrideLocaleCode> },
+    { "platformOptionsFlags", &bind_platform_options_flags },
+    { "tickBudgetInMilliseconds", &bind_uint32<&EOSConfig::tickBudgetInMilliseconds> },
+    { "taskNetworkTimeoutSeconds", &bind_double<&EOSConfig::taskNetworkTimeoutSeconds> },
+    { "ThreadAffinity_networkWork", &bind_uint64<&EOSConfig::ThreadAffinity_networkWork> },
+    { "ThreadAffinity_storageIO", &bind_uint64<&EOSConfig::ThreadAffinity_storageIO> },
+    { "ThreadAffinity_webSocketIO", &bind_uint64<&EOSConfig::ThreadAffinity_webSocketIO> },
+    { "ThreadAffinity_P2PIO", &bind_uint64<&EOSConfig::ThreadAffinity_P2PIO> },
+    { "ThreadAffinity_HTTPRequestIO", &bind_uint64<&EOSConfig::ThreadAffinity_HTTPRequestIO> },
+    { "ThreadAffinity_RTCIO", &bind_uint64<&EOSConfig::ThreadAffinity_RTCIO> },
+    { "isServer", &bind_bool<&EOSConfig::isServer> },
+    { "memoryAllocatorBackend", &bind_string<&EOSConfig::memoryAllocatorBackend> },
+};
+static constexpr auto s_eos_config_schema = config_binding::make_schema(s_eos_config_fields);
+
+// Each member of LogCategoryLevelPairs
+static constexpr config_binding::FieldDescriptor<LogLevelConfig> s_log_category_level_pair_fields[] =
+{
+    { "Category", &bind_string_appended<&LogLevelConfig::category> },
+    { "Level", &bind_string_appended<&LogLevelConfig::level> },
+};
+static constexpr auto s_log_category_level_pair_schema = config_binding::make_schema(s_log_category_level_pair_fields);
+
+static constexpr config_binding::FieldDescriptor<LogLevelConfig> s_log_level_config_fields[] =
+{
+    { "LogCategoryLevelPairs", &bind_each_object<LogLevelConfig, s_log_category_level_pair_schema> },
+};
+static constexpr auto s_log_level_config_schema = config_binding::make_schema(s_log_level_config_fields);
+
+static constexpr config_binding::FieldDescriptor<EOSSteamConfig> s_steam_config_fields[] =
+{
+    { "flags", &bind_integrated_platform_management_flags },
+    { "overrideLibraryPath", &bind_override_library_path },
+    { "steamSDKMajorVersion", &bind_uint32<&EOSSteamConfig::steamSDKMajorVersion> },
+    { "steamSDKMinorVersion", &bind_uint32<&EOSSteamConfig::steamSDKMinorVersion> },
+    { "steamApiInterfaceVersionsArray", &bind_string_array<&EOSSteamConfig::steamApiInterfaceVersionsArray> },
+};
+static constexpr auto s_steam_config_schema = config_binding::make_schema(s_steam_config_fields);
+
+//-------------------------------------------------------------------------
+EOSConfig plugin_bootstrap::eos_config_from_json_value(json_value_s* config_json)
+{
+    EOSConfig eos_config;
+    bind_object(config_json, s_eos_config_schema, &eos_config);
+    return eos_config;
+}
+
+//-------------------------------------------------------------------------
+LogLevelConfig plugin_bootstrap::log_config_from_json_value(json_value_s* config_json)
+{
+    LogLevelConfig log_config;
+    bind_object(config_json, s_log_level_config_schema, &log_config);
+    return log_config;
+}
+
+//-------------------------------------------------------------------------
+EOSSteamConfig plugin_bootstrap::eos_steam_config_from_json_value(json_value_s *config_json)
+{
+    EOSSteamConfig eos_config;
+    bind_object(config_json, s_steam_config_schema, &eos_config);
+    return eos_config;
+}
+
+//-------------------------------------------------------------------------
+fs::path plugin_bootstrap::get_path_for_eos_service_config(const std::string& config_filename)
+{
+	fs::path packaged_data_path = get_path_relative_to_current_module(BOOTSTRAP_DATA_DIRECTORY);
+	std::error_code error_code;
+
+	log_inform("about to look with exists");
+	if (!fs::exists(packaged_data_path, error_code))
+	{
+		log_warn("Didn't find the path " BOOTSTRAP_DATA_DIRECTORY);
+		packaged_data_path = get_path_relative_to_current_module(fs::path("./Data/"));
+	}
+	
+	return packaged_data_path / "StreamingAssets" / "EOS" / config_filename;
+}
+
+//-------------------------------------------------------------------------
+#if PLATFORM_WINDOWS
+static void EOS_Platform_Options_debug_log(const EOS_Platform_Options& platform_options)
+{
+    std::stringstream output;
+    output << platform_options.ApiVersion << "\n";
+    output << platform_options.bIsServer << "\n";
+    output << platform_options.Flags << "\n";
+    output << platform_options.CacheDirectory << "\n";
+
+    output << platform_options.EncryptionKey << "\n";
+    if (platform_options.OverrideCountryCode)
+    {
+        output << platform_options.OverrideCountryCode << "\n";
+    }
+
+    if (platform_options.OverrideLocaleCode)
+    {
+        output << platform_options.OverrideLocaleCode << "\n";
+    }
+    output << platform_options.ProductId << "\n";
+    output << platform_options.SandboxId << "\n";
+    output << platform_options.DeploymentId << "\n";
+    output << platform_options.ClientCredentials.ClientId << "\n";
+    output << platform_options.ClientCredentials.ClientSecret << "\n";
+
+    auto *rtc_options = platform_options.RTCOptions;
+    auto *windows_rtc_options = (EOS_Windows_RTCOptions*)rtc_options->PlatformSpecificOptions;
+
+    output << windows_rtc_options->ApiVersion << "\n";
+    output << windows_rtc_options->XAudio29DllPath << "\n";
+
+    log_inform(output.str().c_str());
+}
+#endif
+
+//-------------------------------------------------------------------------
+// The steam library the application manages itself, whether or not it has
+// already loaded it
+static void* find_or_load_steam_library(const std::string& steam_dll_path)
+{
+    auto steam_dll_path_string = fs::u8path(steam_dll_path).filename().u8string();
+    void *steam_dll_handle = bootstrap_platform::find_loaded_library(steam_dll_path_string.c_str());
+
+    // Check the default name for the steam library
+    if (!steam_dll_handle)
+    {
+        steam_dll_handle = bootstrap_platform::find_loaded_library(BOOTSTRAP_STEAM_LIBRARY_NAME);
+    }
+
+    // in the case that it's not loaded, try to load it from the user provided path
+    if (!steam_dll_handle)
+    {
+        steam_dll_handle = load_library_at_path(fs::u8path(steam_dll_path));
+    }
+
+    return steam_dll_handle;
+}
+
+//-------------------------------------------------------------------------
+static void eos_call_steam_init(void* steam_dll_handle)
+{
+    if (steam_dll_handle != nullptr)
+    {
+        typedef bool (*SteamAPI_Init_t)();
+        SteamAPI_Init_t SteamAPI_Init = load_function_with_name<SteamAPI_Init_t>(steam_dll_handle, "SteamAPI_Init");
+
+        if (SteamAPI_Init != nullptr && SteamAPI_Init())
+        {
+            log_inform("Called SteamAPI_Init with success!");
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+static std::optional<LogLevelConfig> read_log_level_config()
+{
+    auto path_to_log_config_json = get_path_for_eos_service_config(BOOTSTRAP_LOGLEVEL_CONFIG_FILENAME);
+
+    if (!fs::exists(path_to_log_config_json))
+    {
+        log_inform("Log level config not found, using default log levels");
+        return std::nullopt;
+    }
+
+    return read_log_level_config_from_path(path_to_log_config_json);
+}
+
+//-------------------------------------------------------------------------
+static void eos_set_loglevel_via_config(const std::optional<LogLevelConfig>& optional_log_config)
+{
+    if (!optional_log_config.has_value() || !eos_functions::is_available(EOSFunctionId::EOS_Logging_SetLogLevel))
+    {
+        return;
+    }
+    const LogLevelConfig& log_config = optional_log_config.value();
+
+    // Validation to prevent out of range exception
+    if (log_config.category.size() != log_config.level.size())
+    {
+        log_warn("Log level config entries out of range");
+        return;
+    }
+
+    // Last in the vector is AllCategories, and will not be set
+    size_t individual_category_size = log_config.category.size() > 0 ? log_config.category.size() - 1 : 0;
+    if (individual_category_size == 0)
+    {
+        log_warn("Log level config entries empty");
+        return;
+    }
+
+    for (size_t i = 0; i < individual_category_size; i++)
+    {
+        s_eos.EOS_Logging_SetLogLevel((EOS_ELogCategory)i, eos_loglevel_str_to_enum(log_config.level[i]));
+    }
+
+    log_inform("Log levels set according to config");
+}
+
+//-------------------------------------------------------------------------
+// The Steam config, with the library path it names resolved against what's
+// on disk, and the library itself when the application manages Steam
+struct SteamBootstrap
+{
+    std::optional<EOSSteamConfig> config;
+    void* library_handle = nullptr;
+};
+
+//-------------------------------------------------------------------------
+static SteamBootstrap read_steam_config()
+{
+    SteamBootstrap steam;
+    auto path_to_steam_config_json = get_path_for_eos_service_config(BOOTSTRAP_STEAM_CONFIG_FILENAME);
+
+    std::optional<EOSSteamConfig> optional_steam_config;
+    if (fs::exists(path_to_steam_config_json))
+    {
+        optional_steam_config = read_steam_config_from_path(path_to_steam_config_json);
+    }
+
+    if (!optional_steam_config.has_value())
+    {
+        return steam;
+    }
+
+    EOSSteamConfig eos_steam_config = std::move(optional_steam_config.value());
+
+    if (eos_steam_config.OverrideLibraryPath.has_value())
+    {
+        if (!fs::exists(fs::u8path(eos_steam_config.OverrideLibraryPath.value())))
+        {
+            auto override_lib_path_as_str = fs::u8path(eos_steam_config.OverrideLibraryPath.value()).filename();
+            auto found_steam_path = get_path_relative_to_current_module(override_lib_path_as_str);
+
+            // Fall back and use the steam library name based on the
+            // type of binary the GfxPluginNativeRender
+            if (!fs::exists(found_steam_path) || eos_steam_config.OverrideLibraryPath.value().empty())
+            {
+                found_steam_path = get_path_relative_to_current_module(BOOTSTRAP_STEAM_LIBRARY_NAME);
+            }
+
+            if (fs::exists(found_steam_path))
+            {
+                eos_steam_config.OverrideLibraryPath = found_steam_path.u8string();
+            }
+        }
+    }
+    else
+    {
+        auto found_steam_path = get_path_relative_to_current_module(BOOTSTRAP_STEAM_LIBRARY_NAME);
+        if (fs::exists(found_steam_path))
+        {
+            eos_steam_config.OverrideLibraryPath = found_steam_path.u8string();
+        }
+    }
+
+    // SteamAPI_Init itself waits for the loading thread
+    if (eos_steam_config.isManagedByApplication() && eos_steam_config.OverrideLibraryPath.has_value())
+    {
+        steam.library_handle = find_or_load_steam_library(eos_steam_config.OverrideLibraryPath.value());
+        eos_steam_config.OverrideLibraryPath.reset();
+    }
+
+    steam.config = std::move(eos_steam_config);
+    return steam;
+}
+
+//-------------------------------------------------------------------------
+static void eos_create(EOSConfig& eosConfig, SteamBootstrap& steam)
+{
+    EOS_Platform_Options platform_options = {0};
+    platform_options.ApiVersion = EOS_PLATFORM_OPTIONS_API_LATEST;
+    platform_options.bIsServer = eosConfig.isServer;
+    platform_options.Flags = eosConfig.flags;
+    platform_options.CacheDirectory = bootstrap_platform::cache_directory();
+
+    platform_options.EncryptionKey = eosConfig.encryptionKey.length() > 0 ? eosConfig.encryptionKey.c_str() : nullptr;
+    platform_options.OverrideCountryCode = eosConfig.overrideCountryCode.length() > 0 ? eosConfig.overrideCountryCode.c_str() : nullptr;
+    platform_options.OverrideLocaleCode = eosConfig.overrideLocaleCode.length() > 0 ? eosConfig.overrideLocaleCode.c_str() : nullptr;
+    platform_options.ProductId = eosConfig.productID.c_str();
+    platform_options.SandboxId = eosConfig.sandboxID.c_str();
+    platform_options.DeploymentId = eosConfig.deploymentID.c_str();
+    platform_options.ClientCredentials.ClientId = eosConfig.clientID.c_str();
+    platform_options.ClientCredentials.ClientSecret = eosConfig.clientSecret.c_str();
+
+    platform_options.TickBudgetInMilliseconds = eosConfig.tickBudgetInMilliseconds;
+
+    if (eosConfig.taskNetworkTimeoutSeconds > 0)
+    {
+        platform_options.TaskNetworkTimeoutSeconds = &eosConfig.taskNetworkTimeoutSeconds;
+    }
+
+#if PLATFORM_WINDOWS
+    EOS_Platform_RTCOptions rtc_options = { 0 };
+
+    rtc_options.ApiVersion = EOS_PLATFORM_RTCOPTIONS_API_LATEST;
+    log_inform("setting up rtc");
+    fs::path xaudio2_dll_path = get_path_relative_to_current_module(BOOTSTRAP_XAUDIO2_LIBRARY_NAME);
+    std::string xaudio2_dll_path_as_string = xaudio2_dll_path.u8string();
+    EOS_Windows_RTCOptions windows_rtc_options = { 0 };
+    windows_rtc_options.ApiVersion = EOS_WINDOWS_RTCOPTIONS_API_LATEST;
+    windows_rtc_options.XAudio29DllPath = xaudio2_dll_path_as_string.c_str();
+    log_warn(xaudio2_dll_path_as_string.c_str());
+
+    if (!fs::exists(xaudio2_dll_path))
+    {
+        log_warn("Missing XAudio dll!");
+    }
+    rtc_options.PlatformSpecificOptions = &windows_rtc_options;
+    platform_options.RTCOptions = &rtc_options;
+#endif
+
+    // Defined here so that the version strings live long enough to be referenced by the create option
+    EOS_IntegratedPlatform_Options steam_integrated_platform_option = { 0 };
+    EOS_IntegratedPlatform_Steam_Options steam_platform = { 0 };
+    EOS_HIntegratedPlatformOptionsContainer integrated_platform_options_container = nullptr;
+    std::vector<char> steamApiInterfaceVersionsAsCharArray;
+
+    if (steam.config.has_value())
+    {
+        EOSSteamConfig& eos_steam_config = steam.config.value();
+        eos_call_steam_init(steam.library_handle);
+
+        if (eos_steam_config.OverrideLibraryPath.has_value())
+        {
+            steam_platform.OverrideLibraryPath = eos_steam_config.OverrideLibraryPath.value().c_str();
+        }
+
+        steam_platform.SteamMajorVersion = eos_steam_config.steamSDKMajorVersion;
+        steam_platform.SteamMinorVersion = eos_steam_config.steamSDKMinorVersion;
+
+        // For each element in the array (each of which is a string of an api version information)
+        // iterate across each character, and at the end of a string add a null terminator \0
+        // then add one more null terminator at the end of the array
+        for (const auto& currentFullValue : eos_steam_config.steamApiInterfaceVersionsArray)
+        {
+            for (char currentCharacter : currentFullValue)
+            {
+                steamApiInterfaceVersionsAsCharArray.push_back(currentCharacter);
+            }
+
+            steamApiInterfaceVersionsAsCharArray.push_back('\0');
+        }
+        steamApiInterfaceVersionsAsCharArray.push_back('\0');
+
+        steam_platform.SteamApiInterfaceVersionsArray = reinterpret_cast<char*>(steamApiInterfaceVersionsAsCharArray.data());
+                
+        auto size = steamApiInterfaceVersionsAsCharArray.size();
+
+        if (size > EOS_INTEGRATEDPLATFORM_STEAM_MAX_STEAMAPIINTERFACEVERSIONSARRAY_SIZE) 
+        {
+            log_error("Size given for SteamApiInterfaceVersionsAsCharArray exceeds the maximum value.");
+        }
+        else
+        {
+            // steam_platform needs to have a count of how many bytes the "array" is, stored in SteamApiInterfaceVersionsArrayBytes
+            // This has some fuzzy behavior; if you set it to 0 or count it up properly, there won't be a logged problem
+            // if you put a non-zero amount that is insufficient, there will be an unclear logged error message
+            steam_platform.SteamApiInterfaceVersionsArrayBytes = static_cast<uint32_t>(size);
+        }
+        
+        steam_integrated_platform_option.ApiVersion = EOS_INTEGRATEDPLATFORM_OPTIONS_API_LATEST;
+        steam_integrated_platform_option.Type = EOS_IPT_Steam;
+        steam_integrated_platform_option.Flags = eos_steam_config.flags;
+        steam_integrated_platform_option.InitOptions = &steam_platform;
+
+        steam_platform.ApiVersion = EOS_INTEGRATEDPLATFORM_STEAM_OPTIONS_API_LATEST;
+
+        EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainerOptions options = { EOS_INTEGRATEDPLATFORM_CREATEINTEGRATEDPLATFORMOPTIONSCONTAINER_API_LATEST };
+        s_eos.EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer(&options, &integrated_platform_options_container);
+        platform_options.IntegratedPlatformOptionsContainerHandle = integrated_platform_options_container;
+
+        EOS_IntegratedPlatformOptionsContainer_AddOptions addOptions = { EOS_INTEGRATEDPLATFORMOPTIONSCONTAINER_ADD_API_LATEST };
+        addOptions.Options = &steam_integrated_platform_option;
+        s_eos.EOS_IntegratedPlatformOptionsContainer_Add(integrated_platform_options_container, &addOptions);
+    }
+
+    //EOS_Platform_Options_debug_log(platform_options);
+    log_inform("run EOS_Platform_Create");
+    eos_platform_handle = s_eos.EOS_Platform_Create(&platform_options);
+    if (integrated_platform_options_container)
+    {
+        s_eos.EOS_IntegratedPlatformOptionsContainer_Release(integrated_platform_options_container);
+    }
+
+    if (!eos_platform_handle)
+    {
+        log_error("failed to create the platform");
+    }
+}
+
+//-------------------------------------------------------------------------
+// Only what eos_init and eos_create can't do without is looked up now; the
+// rest of the SDK is looked up the first time it's called
+static bool FetchEOSFunctionPointers()
+{
+    const char* missing_name = nullptr;
+    if (!eos_functions::resolve(s_eos_sdk_lib_handle, &bootstrap_platform::load_function, EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL, &s_eos, &missing_name))
+    {
+        log_warn((std::string("unable to find ") + missing_name).c_str());
+        return false;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Replaces *id with what follows any of the prefixes on the command line.
+// The last match wins.
+static void apply_command_line_override(const std::vector<std::string>& arguments, const char *prefix, const char *other_prefix, const char *description, std::string *id)
+{
+    for (const std::string& argument : arguments)
+    {
+        const char *match = nullptr;
+        if (argument.rfind(prefix, 0) == 0)
+        {
+            match = prefix;
+        }
+        else if (argument.rfind(other_prefix, 0) == 0)
+        {
+            match = other_prefix;
+        }
+        if (match != nullptr)
+        {
+            std::string value = argument.substr(strlen(match));
+            if (!value.empty())
+            {
+                log_inform((std::string(description) + " override specified: " + value).c_str());
+                *id = value;
+            }
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+// The EOS config, from EOSGenerated or the config file, with the sandbox
+// and deployment overrides applied
+static std::optional<EOSConfig> read_eos_config()
+{
+    auto path_to_config_json = get_path_for_eos_service_config(BOOTSTRAP_SERVICE_CONFIG_FILENAME);
+    std::optional<EOSConfig> optional_eos_config;
+
+    // EOSGenerated is already in memory, so there's nothing to cache
+    json_value_s* eos_config_as_json = read_config_json_from_dll();
+    if (eos_config_as_json)
+    {
+        optional_eos_config = eos_config_from_json_value(eos_config_as_json);
+        free(eos_config_as_json);
+    }
+    else if (fs::exists(path_to_config_json))
+    {
+        optional_eos_config = read_eos_config_from_path(path_to_config_json);
+    }
+
+    if (!optional_eos_config.has_value())
+    {
+        log_warn("Failed to load a valid json config for EOS");
+        return std::nullopt;
+    }
+
+    EOSConfig eos_config = std::move(optional_eos_config.value());
+
+    //support sandbox and deployment id override via command line arguments
+    const std::vector<std::string> arguments = bootstrap_platform::command_line_arguments();
+    apply_command_line_override(arguments, "-eossandboxid=", "-epicsandboxid=", "Sandbox ID", &eos_config.sandboxID);
+
+    //check if a deployment id override exists for sandbox id
+    for (unsigned i = 0; i < eos_config.sandboxDeploymentOverrides.size(); ++i)
+    {
+        if (eos_config.sandboxID == eos_config.sandboxDeploymentOverrides[i].sandboxID)
+        {
+            log_inform(("Sandbox Deployment ID override specified: " + eos_config.sandboxDeploymentOverrides[i].deploymentID).c_str());
+            eos_config.deploymentID = eos_config.sandboxDeploymentOverrides[i].deploymentID;
+        }
+    }
+
+    apply_command_line_override(arguments, "-eosdeploymentid=", "-epicdeploymentid=", "Deployment ID", &eos_config.deploymentID);
+
+    return eos_config;
+}
+
+//-------------------------------------------------------------------------
+// Fills in s_eos from the SDK next to this module
+static bool load_sdk_library()
+{
+    s_eos_sdk_lib_handle = load_library_at_path(get_path_relative_to_current_module(BOOTSTRAP_SDK_LIBRARY_NAME));
+    if (!s_eos_sdk_lib_handle)
+    {
+        log_warn("Couldn't find dll " BOOTSTRAP_SDK_LIBRARY_NAME);
+        return false;
+    }
+
+    return FetchEOSFunctionPointers();
+}
+
+//-------------------------------------------------------------------------
+static double milliseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//-------------------------------------------------------------------------
+// Logs how long one of load's phases took, when it goes out of scope
+struct PhaseTimer
+{
+    const char* phase_name;
+    std::chrono::steady_clock::time_point start;
+
+    explicit PhaseTimer(const char* name) : phase_name(name), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~PhaseTimer()
+    {
+        char message[128];
+        snprintf(message, sizeof(message), "Bootstrap phase %s took %.3f ms", phase_name, milliseconds_since(start));
+        log_inform(message);
+    }
+};
+
+//-------------------------------------------------------------------------
+// Runs one of load's phases on a thread of its own
+template<typename Function>
+static auto start_phase(const char* phase_name, Function function) -> std::future<decltype(function())>
+{
+    return std::async(std::launch::async, [phase_name, function]()
+    {
+        PhaseTimer timer(phase_name);
+        return function();
+    });
+}
+
+//-------------------------------------------------------------------------
+// Reading the configs, loading the SDK and finding the Steam library don't
+// depend on each other, so they run at the same time and are joined before
+// the SDK is initialized. Each phase logs how long it took, and the whole
+// how long it took from start to finish, which is less than their sum by
+// however much they overlapped.
+void plugin_bootstrap::load()
+{
+#if _DEBUG
+    bootstrap_platform::show_dialog("You may attach a debugger to the DLL");
+#endif
+
+    const auto load_start = std::chrono::steady_clock::now();
+
+    auto eos_config_phase = start_phase("config", &read_eos_config);
+    auto log_level_config_phase = start_phase("log level config", &read_log_level_config);
+    auto steam_phase = start_phase("steam config", &read_steam_config);
+    auto sdk_library_phase = start_phase("sdk library", &load_sdk_library);
+
+    std::optional<EOSConfig> eos_config = eos_config_phase.get();
+    std::optional<LogLevelConfig> log_level_config = log_level_config_phase.get();
+    SteamBootstrap steam = steam_phase.get();
+    const bool has_sdk = sdk_library_phase.get();
+
+#if _DEBUG
+    log_open("gfx_log.txt");
+#endif
+
+    if (!eos_config.has_value())
+    {
+        // The SDK was loaded on the chance there'd be a config for it
+        s_eos = {};
+        eos_functions::reset();
+        bootstrap_platform::unload_library(s_eos_sdk_lib_handle);
+        s_eos_sdk_lib_handle = NULL;
+        return;
+    }
+
+    log_inform("On UnityPluginLoad");
+
+    if (has_sdk)
+    {
+        log_inform("start eos init");
+
+        {
+            PhaseTimer timer("init");
+            eos_init(eos_config.value());
+            eos_set_loglevel_via_config(log_level_config);
+        }
+
+        {
+            PhaseTimer timer("create");
+            //log_warn("start eos create");
+            eos_create(eos_config.value(), steam);
+        }
+
+        // This code is commented out because the handle is now handed off to the C# code
+        //EOS_Platform_Release(eos_platform_handle);
+        //eos_platform_handle = NULL;
+        //log_warn("start eos shutdown");
+        //EOS_Shutdown();
+        //log_warn("unload eos sdk");
+        //unload_library(s_eos_sdk_lib_handle);
+
+        s_eos_sdk_lib_handle = NULL;
+        s_eos = {};
+        eos_functions::reset();
+    }
+
+    char message[128];
+    snprintf(message, sizeof(message), "Bootstrap took %.3f ms", milliseconds_since(load_start));
+    log_inform(message);
+}
+
+//-------------------------------------------------------------------------
+void plugin_bootstrap::unload()
+{
+    write_memory_leak_report();
+
+    log_close();
+}
+
+//-------------------------------------------------------------------------
+EOS_HPlatform plugin_bootstrap::platform_handle()
+{
+    return eos_platform_handle;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// platform:: stack walking and symbol lookup used by the heap profiler,
+// shared by Linux and macOS.
+
+#include "pch.h"
+#include "HeapProfiler.h"
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <stdlib.h>
+#include <string.h>
+
+//-------------------------------------------------------------------------
+int platform::capture_backtrace(void **frames, int max_frames, int skip_count)
+{
+    void *all_frames[HEAP_PROFILER_MAX_FRAMES + 8];
+    const int wanted = max_frames + skip_count + 1;
+    const int captured = backtrace(all_frames, wanted < HEAP_PROFILER_MAX_FRAMES + 8 ? wanted : HEAP_PROFILER_MAX_FRAMES + 8);
+
+    // One more for this function
+    const int first = skip_count + 1;
+    int count = 0;
+    for (int i = first; i < captured && count < max_frames; ++i)
+    {
+        frames[count++] = all_frames[i];
+    }
+    return count;
+}
+
+//-------------------------------------------------------------------------
+static const char * file_name_of(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return slash != nullptr ? slash + 1 : path;
+}
+
+//-------------------------------------------------------------------------
+void platform::describe_address(const void *address, char *buffer, size_t buffer_size)
+{
+    Dl_info info;
+    if (dladdr(address, &info) == 0 || info.dli_fname == nullptr)
+    {
+        snprintf(buffer, buffer_size, "0x%" PRIxPTR, reinterpret_cast<uintptr_t>(address));
+        return;
+    }
+
+    const char *module = file_name_of(info.dli_fname);
+    if (info.dli_sname == nullptr)
+    {
+        const uintptr_t offset = reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_fbase);
+        snprintf(buffer, buffer_size, "%s+0x%" PRIxPTR, module, offset);
+        return;
+    }
+
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    snprintf(buffer, buffer_size, "%s!%s", module, status == 0 && demangled != nullptr ? demangled : info.dli_sname);
+    free(demangled);
+}
+
+//-------------------------------------------------------------------------
+void platform::write_mapped_libraries(FILE *file)
+{
+#if PLATFORM_LINUX
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (maps == nullptr)
+    {
+        return;
+    }
+
+    char buffer[4096];
+    size_t read_count = 0;
+    while ((read_count = fread(buffer, 1, sizeof(buffer), maps)) > 0)
+    {
+        fwrite(buffer, 1, read_count, file);
+    }
+    fclose(maps);
+#else
+    (void)file;
+#endif
+}
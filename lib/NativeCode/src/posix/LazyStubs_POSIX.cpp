@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "LazyStubs.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__ELF__)
+#define LAZY_STUBS_X86_64 1
+#endif
+
+#if LAZY_STUBS_X86_64
+
+// Each stub is
+//     jmp *slot(%rip)          ff 25 <rel32>
+//     movabs $record, %r11     49 bb <imm64>
+//     jmp *resolver(%rip)      ff 25 <rel32>
+// padded out with int3. The slot starts out pointing at the movabs.
+#define LAZY_STUB_SIZE 32
+#define LAZY_STUB_RESOLVE_OFFSET 6
+#define LAZY_STUB_RESOLVER_JUMP_OFFSET 16
+
+// A chunk is a page of stubs followed by a page of their slots, with the
+// resolver's address after the last slot. rel32 reaches from one to the
+// other because they're mapped together.
+#define LAZY_STUB_PAGE_SIZE 4096
+#define LAZY_STUBS_PER_CHUNK (LAZY_STUB_PAGE_SIZE / LAZY_STUB_SIZE)
+
+static_assert(sizeof(std::atomic<void*>) == sizeof(void*), "slots are read by a plain jmp");
+static_assert((LAZY_STUBS_PER_CHUNK + 1) * sizeof(void*) <= LAZY_STUB_PAGE_SIZE, "slots have to fit in a page");
+
+namespace
+{
+    struct LazyStubRecord
+    {
+        lazy_stubs::StubArena *arena;
+        std::atomic<void*> *slot;
+        void *resolve_entry;
+        void *library_handle;
+        std::string function_name;
+    };
+
+    // records can't move once a stub has been written with its address
+    struct LazyStubChunk
+    {
+        uint8_t *mapping = nullptr;
+        size_t used = 0;
+        LazyStubRecord records[LAZY_STUBS_PER_CHUNK];
+    };
+}
+
+struct lazy_stubs::StubArena
+{
+    ResolveFunction resolve_function = nullptr;
+    std::vector<std::unique_ptr<LazyStubChunk>> chunks;
+    std::atomic<size_t> resolved_count{0};
+};
+
+extern "C" __attribute__((visibility("hidden"))) void * dllh_resolve_lazy_stub(void *stub_record);
+extern "C" __attribute__((visibility("hidden"))) void dllh_lazy_stub_resolver();
+
+// Entered from a stub with the caller's arguments in place, its return
+// address on top of the stack and the stub's record in r11. Everything the
+// SysV ABI passes arguments in survives the lookup: rdi, rsi, rdx, rcx, r8,
+// r9, xmm0-7, and al for variadic calls. Arguments on the stack aren't
+// touched. The stack is 8 bytes off alignment on entry, so seven pushes
+// and 128 bytes of xmm leave it aligned for the call.
+asm(R"(
+    .text
+    .globl dllh_lazy_stub_resolver
+    .hidden dllh_lazy_stub_resolver
+    .type dllh_lazy_stub_resolver, @function
+dllh_lazy_stub_resolver:
+    pushq %rdi
+    pushq %rsi
+    pushq %rdx
+    pushq %rcx
+    pushq %r8
+    pushq %r9
+    pushq %rax
+    subq $128, %rsp
+    movdqu %xmm0, 0(%rsp)
+    movdqu %xmm1, 16(%rsp)
+    movdqu %xmm2, 32(%rsp)
+    movdqu %xmm3, 48(%rsp)
+    movdqu %xmm4, 64(%rsp)
+    movdqu %xmm5, 80(%rsp)
+    movdqu %xmm6, 96(%rsp)
+    movdqu %xmm7, 112(%rsp)
+    movq %r11, %rdi
+    call dllh_resolve_lazy_stub
+    movq %rax, %r11
+    movdqu 0(%rsp), %xmm0
+    movdqu 16(%rsp), %xmm1
+    movdqu 32(%rsp), %xmm2
+    movdqu 48(%rsp), %xmm3
+    movdqu 64(%rsp), %xmm4
+    movdqu 80(%rsp), %xmm5
+    movdqu 96(%rsp), %xmm6
+    movdqu 112(%rsp), %xmm7
+    addq $128, %rsp
+    popq %rax
+    popq %r9
+    popq %r8
+    popq %rcx
+    popq %rdx
+    popq %rsi
+    popq %rdi
+    jmp *%r11
+    .size dllh_lazy_stub_resolver, .-dllh_lazy_stub_resolver
+)");
+
+//-------------------------------------------------------------------------
+// Two threads calling a new stub at the same time both look the function
+// up and get the same answer; only the one that patches the slot counts it.
+//
+// There's nothing a stub for a missing function could return that would be
+// right for every signature (zero is success for an EOS_EResult, and float
+// and struct results don't come back in rax at all), so calling one is
+// fatal, the way calling a function missing from an import table would be.
+void * dllh_resolve_lazy_stub(void *stub_record)
+{
+    LazyStubRecord *record = static_cast<LazyStubRecord*>(stub_record);
+    void *function = record->arena->resolve_function(record->library_handle, record->function_name.c_str());
+    if (function == nullptr)
+    {
+        fprintf(stderr, "DLLH: %s was called but isn't in the library\n", record->function_name.c_str());
+        abort();
+    }
+
+    void *expected = record->resolve_entry;
+    if (record->slot->compare_exchange_strong(expected, function, std::memory_order_acq_rel))
+    {
+        record->arena->resolved_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return function;
+}
+
+//-------------------------------------------------------------------------
+static void write_rel32(uint8_t *at, const void *target, const uint8_t *next_instruction)
+{
+    const int32_t displacement = static_cast<int32_t>(reinterpret_cast<intptr_t>(target) - reinterpret_cast<intptr_t>(next_instruction));
+    memcpy(at, &displacement, sizeof(displacement));
+}
+
+//-------------------------------------------------------------------------
+// Every stub in the chunk is written up front, pointing at its record, so
+// that the code page can be made executable and never written again
+static LazyStubChunk * create_chunk(lazy_stubs::StubArena *arena)
+{
+    void *mapping = mmap(nullptr, 2 * LAZY_STUB_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    LazyStubChunk *chunk = new LazyStubChunk();
+    chunk->mapping = static_cast<uint8_t*>(mapping);
+
+    uint8_t *code = chunk->mapping;
+    std::atomic<void*> *slots = reinterpret_cast<std::atomic<void*>*>(chunk->mapping + LAZY_STUB_PAGE_SIZE);
+    void **resolver_address = reinterpret_cast<void**>(slots + LAZY_STUBS_PER_CHUNK);
+    *resolver_address = reinterpret_cast<void*>(&dllh_lazy_stub_resolver);
+
+    memset(code, 0xcc, LAZY_STUB_PAGE_SIZE);
+    for (size_t i = 0; i < LAZY_STUBS_PER_CHUNK; ++i)
+    {
+        uint8_t *stub = code + i * LAZY_STUB_SIZE;
+        LazyStubRecord *record = &chunk->records[i];
+
+        record->arena = arena;
+        record->slot = new (&slots[i]) std::atomic<void*>(stub + LAZY_STUB_RESOLVE_OFFSET);
+        record->resolve_entry = stub + LAZY_STUB_RESOLVE_OFFSET;
+
+        stub[0] = 0xff;
+        stub[1] = 0x25;
+        write_rel32(stub + 2, &slots[i], stub + LAZY_STUB_RESOLVE_OFFSET);
+
+        stub[LAZY_STUB_RESOLVE_OFFSET] = 0x49;
+        stub[LAZY_STUB_RESOLVE_OFFSET + 1] = 0xbb;
+        memcpy(stub + LAZY_STUB_RESOLVE_OFFSET + 2, &record, sizeof(record));
+
+        stub[LAZY_STUB_RESOLVER_JUMP_OFFSET] = 0xff;
+        stub[LAZY_STUB_RESOLVER_JUMP_OFFSET + 1] = 0x25;
+        write_rel32(stub + LAZY_STUB_RESOLVER_JUMP_OFFSET + 2, resolver_address, stub + LAZY_STUB_RESOLVER_JUMP_OFFSET + 6);
+    }
+
+    if (mprotect(code, LAZY_STUB_PAGE_SIZE, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(mapping, 2 * LAZY_STUB_PAGE_SIZE);
+        delete chunk;
+        return nullptr;
+    }
+
+    return chunk;
+}
+
+//-------------------------------------------------------------------------
+bool lazy_stubs::is_supported()
+{
+    return sysconf(_SC_PAGESIZE) == LAZY_STUB_PAGE_SIZE;
+}
+
+//-------------------------------------------------------------------------
+lazy_stubs::StubArena * lazy_stubs::create_arena(ResolveFunction resolve_function)
+{
+    if (!is_supported() || resolve_function == nullptr)
+    {
+        return nullptr;
+    }
+
+    StubArena *arena = new StubArena();
+    arena->resolve_function = resolve_function;
+    return arena;
+}
+
+//-------------------------------------------------------------------------
+void lazy_stubs::destroy_arena(StubArena *arena)
+{
+    if (arena == nullptr)
+    {
+        return;
+    }
+
+    for (std::unique_ptr<LazyStubChunk>& chunk : arena->chunks)
+    {
+        munmap(chunk->mapping, 2 * LAZY_STUB_PAGE_SIZE);
+    }
+    delete arena;
+}
+
+//-------------------------------------------------------------------------
+void * lazy_stubs::make_stub(StubArena *arena, void *library_handle, const char *function_name)
+{
+    if (arena == nullptr || function_name == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (arena->chunks.empty() || arena->chunks.back()->used == LAZY_STUBS_PER_CHUNK)
+    {
+        LazyStubChunk *chunk = create_chunk(arena);
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+        arena->chunks.emplace_back(chunk);
+    }
+
+    LazyStubChunk& chunk = *arena->chunks.back();
+    const size_t index = chunk.used++;
+    chunk.records[index].library_handle = library_handle;
+    chunk.records[index].function_name = function_name;
+
+    return chunk.mapping + index * LAZY_STUB_SIZE;
+}
+
+//-------------------------------------------------------------------------
+size_t lazy_stubs::resolved_count(const StubArena *arena)
+{
+    return arena != nullptr ? arena->resolved_count.load(std::memory_order_relaxed) : 0;
+}
+
+#else
+
+//-------------------------------------------------------------------------
+bool lazy_stubs::is_supported()
+{
+    return false;
+}
+
+//-------------------------------------------------------------------------
+lazy_stubs::StubArena * lazy_stubs::create_arena(ResolveFunction resolve_function)
+{
+    std::ignore = resolve_function;
+    return nullptr;
+}
+
+//-------------------------------------------------------------------------
+void lazy_stubs::destroy_arena(StubArena *arena)
+{
+    std::ignore = arena;
+}
+
+//-------------------------------------------------------------------------
+void * lazy_stubs::make_stub(StubArena *arena, void *library_handle, const char *function_name)
+{
+    std::ignore = arena, library_handle, function_name;
+    return nullptr;
+}
+
+//-------------------------------------------------------------------------
+size_t lazy_stubs::resolved_count(const StubArena *arena)
+{
+    std::ignore = arena;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// loader_trace for Linux and macOS, see LoaderTrace.h
+
+#include "pch.h"
+#include "LoaderTrace.h"
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <mutex>
+#if PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+    std::mutex s_ring_lock;
+    DLLHLoaderEvent s_ring[DLLH_LOADER_TRACE_CAPACITY];
+    // Every event ever recorded; the ring holds the last of them
+    uint64_t s_recorded = 0;
+
+    thread_local DLLHLoaderError t_last_error;
+    thread_local bool t_has_error = false;
+
+    //-------------------------------------------------------------------------
+    uint64_t monotonic_ns()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+    }
+
+    const uint64_t s_epoch_ns = monotonic_ns();
+}
+
+std::atomic<bool> loader_trace::detail::recording(false);
+
+//-------------------------------------------------------------------------
+// Looked up once per thread; gettid is a syscall every time
+static uint64_t current_thread_id()
+{
+    thread_local uint64_t t_thread_id = 0;
+    if (t_thread_id == 0)
+    {
+#if PLATFORM_LINUX
+        t_thread_id = static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+        pthread_threadid_np(nullptr, &t_thread_id);
+#endif
+    }
+    return t_thread_id;
+}
+
+//-------------------------------------------------------------------------
+static void copy_truncated(char *destination, size_t destination_size, const char *source)
+{
+    if (source == nullptr)
+    {
+        destination[0] = '\0';
+        return;
+    }
+
+    const size_t length = strnlen(source, destination_size - 1);
+    memcpy(destination, source, length);
+    destination[length] = '\0';
+}
+
+//-------------------------------------------------------------------------
+static void write_json_string(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (const char *character = text; *character != '\0'; ++character)
+    {
+        const unsigned char byte = static_cast<unsigned char>(*character);
+        if (byte == '"' || byte == '\\')
+        {
+            fputc('\\', file);
+            fputc(byte, file);
+        }
+        else if (byte < 0x20)
+        {
+            fprintf(file, "\\u%04x", byte);
+        }
+        else
+        {
+            fputc(byte, file);
+        }
+    }
+    fputc('"', file);
+}
+
+//-------------------------------------------------------------------------
+void loader_trace::set_recording(bool enabled)
+{
+    detail::recording.store(enabled, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------
+uint64_t loader_trace::now_ns()
+{
+    return monotonic_ns() - s_epoch_ns;
+}
+
+//-------------------------------------------------------------------------
+void loader_trace::record(DLLHLoaderOperation operation, const char *name, const void *handle, uint64_t start_ns, uint64_t end_ns, bool succeeded)
+{
+    const uint64_t thread_id = current_thread_id();
+
+    std::lock_guard<std::mutex> scope_lock(s_ring_lock);
+    DLLHLoaderEvent& event = s_ring[s_recorded & (DLLH_LOADER_TRACE_CAPACITY - 1)];
+    s_recorded++;
+
+    event.start_ns = start_ns;
+    event.duration_ns = end_ns - start_ns;
+    event.thread_id = thread_id;
+    event.handle = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+    event.operation = operation;
+    event.succeeded = succeeded ? 1 : 0;
+    copy_truncated(event.name, sizeof(event.name), name);
+}
+
+//-------------------------------------------------------------------------
+size_t loader_trace::events(DLLHLoaderEvent *out_events, size_t capacity)
+{
+    std::lock_guard<std::mutex> scope_lock(s_ring_lock);
+
+    const size_t available = s_recorded < DLLH_LOADER_TRACE_CAPACITY ? static_cast<size_t>(s_recorded) : DLLH_LOADER_TRACE_CAPACITY;
+    const uint64_t first = s_recorded - available;
+    for (size_t i = 0; i < available && i < capacity; ++i)
+    {
+        out_events[i] = s_ring[(first + i) & (DLLH_LOADER_TRACE_CAPACITY - 1)];
+    }
+    return available;
+}
+
+//-------------------------------------------------------------------------
+void loader_trace::set_error(DLLHLoaderOperation operation, const char *name, const void *handle, const char *message)
+{
+    t_last_error.handle = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+    t_last_error.operation = operation;
+    t_last_error.reserved = 0;
+    copy_truncated(t_last_error.name, sizeof(t_last_error.name), name);
+    copy_truncated(t_last_error.message, sizeof(t_last_error.message), message != nullptr ? message : "unknown error");
+    t_has_error = true;
+}
+
+//-------------------------------------------------------------------------
+bool loader_trace::last_error(DLLHLoaderError *out_error)
+{
+    if (!t_has_error)
+    {
+        return false;
+    }
+
+    *out_error = t_last_error;
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Complete ("X") events, one per loader call, in microseconds
+bool loader_trace::write_chrome_trace(FILE *file)
+{
+    static const char *operation_names[] = { "dlopen", "dlsym", "dlclose" };
+
+    DLLHLoaderEvent *snapshot = new DLLHLoaderEvent[DLLH_LOADER_TRACE_CAPACITY];
+    const size_t count = events(snapshot, DLLH_LOADER_TRACE_CAPACITY);
+    const int process_id = static_cast<int>(getpid());
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < count; ++i)
+    {
+        const DLLHLoaderEvent& event = snapshot[i];
+        const char *operation_name = event.operation <= DLLH_LOADER_CLOSE ? operation_names[event.operation] : "unknown";
+
+        fprintf(file, "{\"name\":");
+        write_json_string(file, event.name[0] != '\0' ? event.name : operation_name);
+        fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%" PRIu64 ",\"args\":{\"handle\":\"0x%" PRIx64 "\",\"succeeded\":%s}}%s\n",
+            operation_name, event.start_ns / 1000.0, event.duration_ns / 1000.0, process_id, event.thread_id, event.handle,
+            event.succeeded ? "true" : "false", i + 1 < count ? "," : "");
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    delete[] snapshot;
+    return ferror(file) == 0;
+}
@@ -0,0 +1,501 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// platform:: memory functions shared by Linux and macOS.
+//
+// Every block handed out by alloc_aligned is prefixed with a BlockHeader
+// recording its size, alignment and where the underlying allocation starts.
+// That lets realloc_aligned keep the alignment it was asked for, lets the
+// size of a block be read back in O(1), and lets large blocks live in their
+// own private mappings, which can grow without copying: mremap on Linux,
+// and extending the mapping in place when the pages after it are free on
+// macOS.
+//
+//   small:  [ malloc padding | header | block ............ ]
+//   large:  [ page aligned mapping | header | block ..... | page tail ]
+
+#include "pch.h"
+#include "Memory.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <atomic>
+#include <tuple>
+#if PLATFORM_LINUX
+#include <malloc.h>
+#include <sys/syscall.h>
+#else
+#include <malloc/malloc.h>
+#endif
+
+// Blocks whose allocation would be at least this big get their own mapping
+#define POSIX_MEMORY_MAP_THRESHOLD (256 * 1024)
+
+#define POSIX_MEMORY_BLOCK_MAPPED 1u
+
+namespace
+{
+    struct BlockHeader
+    {
+        uint64_t size_in_bytes;
+        uint32_t alignment_in_bytes;
+
+        // Distance from the start of the underlying allocation to the block.
+        // It is always a multiple of 16, so the low bit says whether the
+        // allocation is a mapping or came from malloc.
+        uint32_t offset_and_kind;
+    };
+
+    static_assert(sizeof(BlockHeader) == 16, "BlockHeader must keep blocks 16 byte aligned");
+
+    // What malloc guarantees without being asked
+    constexpr size_t kMallocAlignment = alignof(max_align_t);
+}
+
+//-------------------------------------------------------------------------
+static size_t page_size()
+{
+    static const size_t s_page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return s_page_size;
+}
+
+//-------------------------------------------------------------------------
+static inline size_t round_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+//-------------------------------------------------------------------------
+// Blocks are at least header aligned, so the header always fits in the
+// alignment padding before the block
+static inline size_t effective_alignment(size_t alignment_in_bytes)
+{
+    assert((alignment_in_bytes & (alignment_in_bytes - 1)) == 0);
+    return alignment_in_bytes < sizeof(BlockHeader) ? sizeof(BlockHeader) : alignment_in_bytes;
+}
+
+//-------------------------------------------------------------------------
+static inline BlockHeader* header_from_pointer(const void *pointer)
+{
+    return reinterpret_cast<BlockHeader*>(const_cast<char*>(static_cast<const char*>(pointer)) - sizeof(BlockHeader));
+}
+
+//-------------------------------------------------------------------------
+static inline size_t block_offset(const BlockHeader *header)
+{
+    return header->offset_and_kind & ~POSIX_MEMORY_BLOCK_MAPPED;
+}
+
+//-------------------------------------------------------------------------
+static inline bool block_is_mapped(const BlockHeader *header)
+{
+    return (header->offset_and_kind & POSIX_MEMORY_BLOCK_MAPPED) != 0;
+}
+
+//-------------------------------------------------------------------------
+static inline char* block_base(void *pointer)
+{
+    return static_cast<char*>(pointer) - block_offset(header_from_pointer(pointer));
+}
+
+//-------------------------------------------------------------------------
+static inline size_t mapping_length(size_t offset, size_t size_in_bytes)
+{
+    return round_up(offset + size_in_bytes, page_size());
+}
+
+//-------------------------------------------------------------------------
+static void * init_block(void *base, size_t offset, size_t size_in_bytes, size_t alignment_in_bytes, bool is_mapped)
+{
+    void *pointer = static_cast<char*>(base) + offset;
+    BlockHeader *header = header_from_pointer(pointer);
+
+    header->size_in_bytes = size_in_bytes;
+    header->alignment_in_bytes = static_cast<uint32_t>(alignment_in_bytes);
+    header->offset_and_kind = static_cast<uint32_t>(offset) | (is_mapped ? POSIX_MEMORY_BLOCK_MAPPED : 0);
+
+    return pointer;
+}
+
+//-------------------------------------------------------------------------
+static void * map_anonymous(void *hint, size_t length)
+{
+    void *mapping = mmap(hint, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return mapping != MAP_FAILED ? mapping : nullptr;
+}
+
+//-------------------------------------------------------------------------
+// Grows or shrinks a mapped block without copying. Returns the (possibly
+// moved) base of the mapping, or nullptr if that isn't possible.
+static char * resize_mapping(char *base, size_t old_length, size_t new_length, bool may_move)
+{
+    if (new_length == old_length)
+    {
+        return base;
+    }
+
+    if (new_length < old_length)
+    {
+        munmap(base + new_length, old_length - new_length);
+        return base;
+    }
+
+#if PLATFORM_LINUX
+    // The kernel moves the page table entries rather than the data
+    void *moved = mremap(base, old_length, new_length, may_move ? MREMAP_MAYMOVE : 0);
+    return moved != MAP_FAILED ? static_cast<char*>(moved) : nullptr;
+#else
+    // No mremap; grab the pages straight after the mapping if nobody
+    // else has them
+    (void)may_move;
+    void *tail = map_anonymous(base + old_length, new_length - old_length);
+    if (tail == base + old_length)
+    {
+        return base;
+    }
+
+    if (tail != nullptr)
+    {
+        munmap(tail, new_length - old_length);
+    }
+    return nullptr;
+#endif
+}
+
+//-------------------------------------------------------------------------
+void * platform::alloc_aligned(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    const size_t alignment = effective_alignment(alignment_in_bytes);
+    const size_t offset = alignment;
+
+    if (size_in_bytes > SIZE_MAX - offset - page_size() || offset > UINT32_MAX)
+    {
+        return nullptr;
+    }
+
+    if (offset + size_in_bytes >= POSIX_MEMORY_MAP_THRESHOLD && alignment <= page_size())
+    {
+        void *base = map_anonymous(nullptr, mapping_length(offset, size_in_bytes));
+        return base != nullptr ? init_block(base, offset, size_in_bytes, alignment, true) : nullptr;
+    }
+
+    void *base = nullptr;
+    if (alignment <= kMallocAlignment)
+    {
+        base = malloc(offset + size_in_bytes);
+    }
+    else if (posix_memalign(&base, alignment, offset + size_in_bytes) != 0)
+    {
+        base = nullptr;
+    }
+
+    return base != nullptr ? init_block(base, offset, size_in_bytes, alignment, false) : nullptr;
+}
+
+//-------------------------------------------------------------------------
+// Fallback for when a block can't be resized where it is
+static void * move_block(void *pointer, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    void *to_return = platform::alloc_aligned(size_in_bytes, alignment_in_bytes);
+    if (to_return == nullptr)
+    {
+        return nullptr;
+    }
+
+    const size_t old_size = static_cast<size_t>(header_from_pointer(pointer)->size_in_bytes);
+    memcpy(to_return, pointer, old_size < size_in_bytes ? old_size : size_in_bytes);
+    platform::free_aligned(pointer);
+
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+// Resizes a block, keeping both its contents and the requested alignment.
+// A size of 0 shrinks the block to nothing but keeps it valid; the EOS SDK
+// treats a null return from realloc as failure, so it is never used to free.
+// Returns nullptr on failure, leaving the block untouched.
+void * platform::realloc_aligned(void *pointer, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    if (pointer == nullptr)
+    {
+        return platform::alloc_aligned(size_in_bytes, alignment_in_bytes);
+    }
+
+    BlockHeader *header = header_from_pointer(pointer);
+    const size_t alignment = effective_alignment(alignment_in_bytes);
+    const size_t offset = block_offset(header);
+
+    if (size_in_bytes > SIZE_MAX - offset - page_size())
+    {
+        return nullptr;
+    }
+
+    // Asking for more alignment than the block happens to have means it
+    // has to move
+    if (reinterpret_cast<uintptr_t>(pointer) & (alignment - 1))
+    {
+        return move_block(pointer, size_in_bytes, alignment);
+    }
+
+    char *base = block_base(pointer);
+
+    if (block_is_mapped(header))
+    {
+        // A moved mapping is only page aligned
+        const bool may_move = alignment <= page_size();
+        char *new_base = resize_mapping(base, mapping_length(offset, static_cast<size_t>(header->size_in_bytes)), mapping_length(offset, size_in_bytes), may_move);
+
+        return new_base != nullptr ? init_block(new_base, offset, size_in_bytes, alignment, true) : move_block(pointer, size_in_bytes, alignment);
+    }
+
+    // Large enough to be worth a mapping of its own, so later growth is cheap
+    if (offset + size_in_bytes >= POSIX_MEMORY_MAP_THRESHOLD && alignment <= page_size())
+    {
+        return move_block(pointer, size_in_bytes, alignment);
+    }
+
+    // With the smallest offset the block sits at malloc's own alignment,
+    // which realloc preserves; it also knows how to grow or shrink in place
+    if (offset == sizeof(BlockHeader) && alignment <= kMallocAlignment)
+    {
+        void *new_base = realloc(base, offset + size_in_bytes);
+        return new_base != nullptr ? init_block(new_base, offset, size_in_bytes, alignment, false) : nullptr;
+    }
+
+    if (size_in_bytes <= platform::mem_usable_size(pointer))
+    {
+        return init_block(base, offset, size_in_bytes, alignment, false);
+    }
+
+    return move_block(pointer, size_in_bytes, alignment);
+}
+
+//-------------------------------------------------------------------------
+void platform::free_aligned(void *pointer)
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+
+    const BlockHeader *header = header_from_pointer(pointer);
+    char *base = block_base(pointer);
+
+    if (block_is_mapped(header))
+    {
+        munmap(base, mapping_length(block_offset(header), static_cast<size_t>(header->size_in_bytes)));
+    }
+    else
+    {
+        free(base);
+    }
+}
+
+//-------------------------------------------------------------------------
+// How far the block could grow without moving
+size_t platform::mem_usable_size(void *pointer)
+{
+    const BlockHeader *header = header_from_pointer(pointer);
+    const size_t offset = block_offset(header);
+
+    if (block_is_mapped(header))
+    {
+        return mapping_length(offset, static_cast<size_t>(header->size_in_bytes)) - offset;
+    }
+
+#if PLATFORM_LINUX
+    return malloc_usable_size(block_base(pointer)) - offset;
+#else
+    return malloc_size(block_base(pointer)) - offset;
+#endif
+}
+
+//-------------------------------------------------------------------------
+void * platform::alloc_pages(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    const size_t length = round_up(size_in_bytes, page_size());
+    if (alignment_in_bytes <= page_size())
+    {
+        return map_anonymous(nullptr, length);
+    }
+
+    // Over map, then trim back to an aligned run of pages
+    const size_t padded_length = length + alignment_in_bytes - page_size();
+    char *mapping = static_cast<char*>(map_anonymous(nullptr, padded_length));
+    if (mapping == nullptr)
+    {
+        return nullptr;
+    }
+
+    char *aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(mapping), alignment_in_bytes));
+    if (aligned != mapping)
+    {
+        munmap(mapping, aligned - mapping);
+    }
+    if (aligned + length != mapping + padded_length)
+    {
+        munmap(aligned + length, (mapping + padded_length) - (aligned + length));
+    }
+
+    return aligned;
+}
+
+//-------------------------------------------------------------------------
+void platform::free_pages(void *pointer, size_t size_in_bytes)
+{
+    if (pointer != nullptr)
+    {
+        munmap(pointer, round_up(size_in_bytes, page_size()));
+    }
+}
+
+//-------------------------------------------------------------------------
+void * platform::reserve_pages(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    const size_t length = round_up(size_in_bytes, page_size());
+    const size_t padded_length = alignment_in_bytes > page_size() ? length + alignment_in_bytes - page_size() : length;
+
+    void *reservation = mmap(nullptr, padded_length, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reservation == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    char *mapping = static_cast<char*>(reservation);
+    char *aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(mapping), alignment_in_bytes > page_size() ? alignment_in_bytes : page_size()));
+    if (aligned != mapping)
+    {
+        munmap(mapping, aligned - mapping);
+    }
+    if (aligned + length != mapping + padded_length)
+    {
+        munmap(aligned + length, (mapping + padded_length) - (aligned + length));
+    }
+
+    return aligned;
+}
+
+//-------------------------------------------------------------------------
+void platform::release_pages(void *pointer, size_t size_in_bytes)
+{
+    if (pointer != nullptr)
+    {
+        munmap(pointer, round_up(size_in_bytes, page_size()));
+    }
+}
+
+//-------------------------------------------------------------------------
+// On Linux, MAP_HUGETLB only succeeds when the administrator has set pages
+// aside in vm.nr_hugepages, which is rare on desktops; after the first
+// failure it isn't tried again. Otherwise MADV_HUGEPAGE asks for
+// transparent huge pages, which the kernel hands out when it has them.
+// Mapping over the reservation with MAP_FIXED is what commits it.
+bool platform::commit_pages(void *pointer, size_t size_in_bytes, bool *out_explicit_huge_pages)
+{
+    *out_explicit_huge_pages = false;
+
+    const bool is_huge_page_range = reinterpret_cast<uintptr_t>(pointer) % PLATFORM_HUGE_PAGE_SIZE == 0 && size_in_bytes % PLATFORM_HUGE_PAGE_SIZE == 0;
+    std::ignore = is_huge_page_range;
+
+#if PLATFORM_LINUX && defined(MAP_HUGETLB)
+    static std::atomic<bool> s_huge_tlb_unavailable(false);
+    if (is_huge_page_range && !s_huge_tlb_unavailable.load(std::memory_order_relaxed))
+    {
+        void *huge = mmap(pointer, size_in_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0);
+        if (huge == pointer)
+        {
+            *out_explicit_huge_pages = true;
+            return true;
+        }
+        s_huge_tlb_unavailable.store(true, std::memory_order_relaxed);
+    }
+#endif
+
+    void *mapping = mmap(pointer, size_in_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if (mapping != pointer)
+    {
+        return false;
+    }
+
+#if PLATFORM_LINUX && defined(MADV_HUGEPAGE)
+    if (is_huge_page_range)
+    {
+        madvise(pointer, size_in_bytes, MADV_HUGEPAGE);
+    }
+#endif
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Mapping fresh inaccessible pages over the range drops whatever was
+// behind it, huge pages included
+void platform::decommit_pages(void *pointer, size_t size_in_bytes)
+{
+    mmap(pointer, round_up(size_in_bytes, page_size()), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+}
+
+//-------------------------------------------------------------------------
+uint64_t platform::current_thread_id()
+{
+#if PLATFORM_LINUX
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+    uint64_t thread_id = 0;
+    pthread_threadid_np(nullptr, &thread_id);
+    return thread_id;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// The coarse clocks are read from the vDSO / commpage without touching the
+// TSC, which is several times cheaper than CLOCK_MONOTONIC on VMs
+uint64_t platform::coarse_milliseconds()
+{
+#if PLATFORM_LINUX
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000 + static_cast<uint64_t>(now.tv_nsec) / 1000000;
+#else
+    return clock_gettime_nsec_np(CLOCK_MONOTONIC_RAW_APPROX) / 1000000;
+#endif
+}
+
+//-------------------------------------------------------------------------
+// Mapped blocks are unmapped as soon as they're freed, so only the C
+// runtime's heap can be holding on to free memory. glibc's malloc_trim
+// also hands back free pages in the middle of its arenas, not just the top.
+size_t platform::trim()
+{
+#if PLATFORM_LINUX
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    return 0;
+#else
+    return malloc_zone_pressure_relief(nullptr, 0);
+#endif
+}
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// bootstrap_platform for Linux and macOS, see PluginBootstrap.h
+
+#include "pch.h"
+#include "PluginBootstrap.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace fs = std::filesystem;
+
+//-------------------------------------------------------------------------
+fs::path bootstrap_platform::module_directory()
+{
+    Dl_info info = {};
+    if (dladdr(reinterpret_cast<const void*>(&bootstrap_platform::module_directory), &info) == 0 || info.dli_fname == nullptr)
+    {
+        return {};
+    }
+
+    std::error_code error_code;
+    fs::path module_path = fs::absolute(info.dli_fname, error_code);
+    if (error_code)
+    {
+        return {};
+    }
+
+    return module_path.remove_filename();
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::load_library(const fs::path& library_path)
+{
+    void *handle = dlopen(library_path.c_str(), RTLD_NOW);
+    if (handle == nullptr)
+    {
+        plugin_bootstrap::log_warn(dlerror());
+    }
+    return handle;
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::find_loaded_library(const char *library_name)
+{
+    return dlopen(library_name, RTLD_NOW | RTLD_NOLOAD);
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::load_function(void *library_handle, const char *function_name)
+{
+    return dlsym(library_handle, function_name);
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::load_dllh_function(void *library_handle, const char *function_name, uint32_t argument_bytes)
+{
+    std::ignore = argument_bytes;
+    return dlsym(library_handle, function_name);
+}
+
+//-------------------------------------------------------------------------
+void bootstrap_platform::unload_library(void *library_handle)
+{
+    if (library_handle != nullptr)
+    {
+        dlclose(library_handle);
+    }
+}
+
+//-------------------------------------------------------------------------
+bool bootstrap_platform::write_file(const fs::path& path, const void *data, size_t size, std::string *out_error)
+{
+    // Beside the file, so that the rename doesn't cross file systems
+    fs::path temporary_path = path;
+    temporary_path += ".tmp" + std::to_string(getpid());
+
+    // The directory may be shared, so anything already at the temporary
+    // path, a link planted there included, is left alone
+    int fd = open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0)
+    {
+        *out_error = strerror(errno);
+        return false;
+    }
+
+    const char *bytes = static_cast<const char*>(data);
+    size_t total_written = 0;
+    while (total_written < size)
+    {
+        ssize_t bytes_written = write(fd, bytes + total_written, size - total_written);
+        if (bytes_written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytes_written < 0)
+        {
+            *out_error = strerror(errno);
+            close(fd);
+            unlink(temporary_path.c_str());
+            return false;
+        }
+        total_written += static_cast<size_t>(bytes_written);
+    }
+
+    if (close(fd) != 0 || rename(temporary_path.c_str(), path.c_str()) != 0)
+    {
+        *out_error = strerror(errno);
+        unlink(temporary_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+bool bootstrap_platform::map_file(const fs::path& path, MappedFile *out_mapped_file, std::string *out_error)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        *out_error = strerror(errno);
+        return false;
+    }
+
+    struct stat file_stat = {};
+    if (fstat(fd, &file_stat) != 0)
+    {
+        *out_error = strerror(errno);
+        close(fd);
+        return false;
+    }
+    if (file_stat.st_size <= 0)
+    {
+        *out_error = "file is empty";
+        close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(file_stat.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int map_error = errno;
+    // The mapping holds its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        *out_error = strerror(map_error);
+        return false;
+    }
+
+    out_mapped_file->data = data;
+    out_mapped_file->size = size;
+    out_mapped_file->mapping = nullptr;
+    out_mapped_file->private_to_user = file_stat.st_uid == geteuid() && (file_stat.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+    return true;
+}
+
+//-------------------------------------------------------------------------
+void bootstrap_platform::unmap_file(MappedFile *mapped_file)
+{
+    if (mapped_file->data != nullptr)
+    {
+        munmap(const_cast<void*>(mapped_file->data), mapped_file->size);
+    }
+    *mapped_file = MappedFile();
+}
+
+//-------------------------------------------------------------------------
+static bool is_directory(const char *path)
+{
+    struct stat path_stat = {};
+    return path != nullptr && path[0] != '\0' && stat(path, &path_stat) == 0 && S_ISDIR(path_stat.st_mode);
+}
+
+//-------------------------------------------------------------------------
+// The XDG cache directory, as the SDK's cache is safe to lose, then the
+// temporary directory
+static std::string find_cache_directory()
+{
+    const char *xdg_cache_home = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    const char *tmpdir = getenv("TMPDIR");
+
+    std::string cache_directory;
+    if (is_directory(xdg_cache_home))
+    {
+        cache_directory = xdg_cache_home;
+    }
+    else if (home != nullptr && is_directory((std::string(home) + "/.cache").c_str()))
+    {
+        cache_directory = std::string(home) + "/.cache";
+    }
+    else if (is_directory(tmpdir))
+    {
+        cache_directory = tmpdir;
+    }
+    else
+    {
+        cache_directory = "/tmp";
+    }
+
+    if (cache_directory.back() != '/')
+    {
+        cache_directory += '/';
+    }
+    return cache_directory;
+}
+
+//-------------------------------------------------------------------------
+// Looked up once, by whichever thread asks first
+const char * bootstrap_platform::cache_directory()
+{
+    static const std::string s_cache_directory = find_cache_directory();
+    return s_cache_directory.c_str();
+}
+
+//-------------------------------------------------------------------------
+std::vector<std::string> bootstrap_platform::command_line_arguments()
+{
+    std::vector<std::string> arguments;
+#if PLATFORM_LINUX
+    std::string contents;
+    // /proc reports a size of 0, so the file can't be mapped
+    FILE *cmdline = fopen("/proc/self/cmdline", "rb");
+    if (cmdline == nullptr)
+    {
+        return arguments;
+    }
+
+    char buffer[4096];
+    size_t bytes_read = 0;
+    while ((bytes_read = fread(buffer, 1, sizeof(buffer), cmdline)) > 0)
+    {
+        contents.append(buffer, bytes_read);
+    }
+    fclose(cmdline);
+
+    // Each argument is terminated by a null
+    size_t start = 0;
+    while (start < contents.size())
+    {
+        size_t end = contents.find('\0', start);
+        if (end == std::string::npos)
+        {
+            end = contents.size();
+        }
+        arguments.emplace_back(contents, start, end - start);
+        start = end + 1;
+    }
+#endif
+    return arguments;
+}
+
+//-------------------------------------------------------------------------
+bool bootstrap_platform::local_time(time_t raw_time, tm *out_time_info)
+{
+    return localtime_r(&raw_time, out_time_info) != nullptr;
+}
+
+//-------------------------------------------------------------------------
+// There's no dialog to show without a toolkit; the terminal, if any, will do
+void bootstrap_platform::show_dialog(const char *message)
+{
+    fprintf(stderr, "NativePlugin: %s\n", message);
+}
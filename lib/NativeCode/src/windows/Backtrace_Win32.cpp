@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pch.h"
+#include "HeapProfiler.h"
+
+#if _WIN64 || _WIN32
+#define WINDOWS_BACKTRACE_PLATFORM 1
+#endif
+
+#if WINDOWS_BACKTRACE_PLATFORM
+#include <inttypes.h>
+#include <string.h>
+#include <psapi.h>
+#include <vector>
+
+int platform::capture_backtrace(void **frames, int max_frames, int skip_count)
+{
+    // One more for this function
+    return CaptureStackBackTrace(static_cast<DWORD>(skip_count + 1), static_cast<DWORD>(max_frames), frames, nullptr);
+}
+
+// Symbols would need dbghelp; module+offset is enough to resolve offline
+void platform::describe_address(const void *address, char *buffer, size_t buffer_size)
+{
+    HMODULE module = nullptr;
+    char module_path[MAX_PATH];
+
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, static_cast<LPCSTR>(address), &module)
+        || GetModuleFileNameA(module, module_path, MAX_PATH) == 0)
+    {
+        snprintf(buffer, buffer_size, "0x%p", address);
+        return;
+    }
+
+    const char *module_name = strrchr(module_path, '\\');
+    module_name = module_name != nullptr ? module_name + 1 : module_path;
+
+    const uintptr_t offset = reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(module);
+    snprintf(buffer, buffer_size, "%s+0x%llx", module_name, static_cast<unsigned long long>(offset));
+}
+
+// One line per loaded module, laid out like /proc/self/maps so that pprof
+// can match frames to modules
+void platform::write_mapped_libraries(FILE *file)
+{
+    HANDLE process = GetCurrentProcess();
+    std::vector<HMODULE> modules(256);
+    DWORD bytes_needed = 0;
+    for (;;)
+    {
+        const DWORD bytes_available = static_cast<DWORD>(modules.size() * sizeof(HMODULE));
+        if (!EnumProcessModules(process, modules.data(), bytes_available, &bytes_needed))
+        {
+            return;
+        }
+        if (bytes_needed <= bytes_available)
+        {
+            break;
+        }
+        modules.resize(bytes_needed / sizeof(HMODULE));
+    }
+    modules.resize(bytes_needed / sizeof(HMODULE));
+
+    char module_path[MAX_PATH];
+    for (HMODULE module : modules)
+    {
+        MODULEINFO module_info;
+        if (!GetModuleInformation(process, module, &module_info, sizeof(module_info))
+            || GetModuleFileNameA(module, module_path, MAX_PATH) == 0)
+        {
+            continue;
+        }
+
+        const uintptr_t start = reinterpret_cast<uintptr_t>(module_info.lpBaseOfDll);
+        fprintf(file, "%" PRIxPTR "-%" PRIxPTR " r-xp 00000000 00:00 0 %s\n", start, start + module_info.SizeOfImage, module_path);
+    }
+}
+
+#endif
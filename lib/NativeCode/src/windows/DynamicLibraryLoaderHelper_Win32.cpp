@@ -44,42 +44,37 @@ static void show_log_as_dialog(const char* log_string)
 }
 
 //-------------------------------------------------------------------------
-//
+// Libraries can be loaded from several threads at once through
+// DLLH_load_library_async, so the answer is worked out in a static
+// initializer, which only ever runs once
 static bool is_uwp()
 {
-    static int has_package_family_name = -1;
     typedef LONG (__stdcall *GetPackageFamilyName_t)(HANDLE, UINT32*, PWSTR);
-    static GetPackageFamilyName_t GetPackageFamilyName_ptr = NULL;
 
     show_log_as_dialog("checking if is_uwp");
-    // hasn't run before
-    if (has_package_family_name == -1)
+    static const bool has_package_family_name = []()
     {
-        GetPackageFamilyName_ptr = (GetPackageFamilyName_t)GetProcAddress(GetModuleHandle(TEXT("kernel32")), "GetPackageFamilyName");
-        if (GetPackageFamilyName_ptr != NULL)
+        GetPackageFamilyName_t GetPackageFamilyName_ptr = (GetPackageFamilyName_t)GetProcAddress(GetModuleHandle(TEXT("kernel32")), "GetPackageFamilyName");
+        if (GetPackageFamilyName_ptr == NULL)
         {
-            show_log_as_dialog("looking for package name");
-            UINT32 size = 0;
-            auto result = GetPackageFamilyName_ptr(GetCurrentProcess(), &size, NULL);
-            if(result == ERROR_INSUFFICIENT_BUFFER)
-            {
-                show_log_as_dialog("has package name");
-                has_package_family_name = 1;
-            }
-            else
-            {
-                show_log_as_dialog("Doesn't have package name?");
-                has_package_family_name = 0;
-            }
+            show_log_as_dialog("Couldn't find GetPackageFamilyName");
+            return false;
         }
-        else
+
+        show_log_as_dialog("looking for package name");
+        UINT32 size = 0;
+        auto result = GetPackageFamilyName_ptr(GetCurrentProcess(), &size, NULL);
+        if(result == ERROR_INSUFFICIENT_BUFFER)
         {
-            show_log_as_dialog("Couldn't find GetPackageFamilyName");
-            has_package_family_name = 0;
+            show_log_as_dialog("has package name");
+            return true;
         }
-    }
 
-    return has_package_family_name == 1;
+        show_log_as_dialog("Doesn't have package name?");
+        return false;
+    }();
+
+    return has_package_family_name;
 }
 
 //-------------------------------------------------------------------------
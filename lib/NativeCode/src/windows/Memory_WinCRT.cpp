@@ -16,9 +16,11 @@ void * platform::alloc_aligned(size_t size_in_bytes, size_t alignment_in_bytes)
     return _aligned_malloc(size_in_bytes, alignment_in_bytes);
 }
 
+// _aligned_realloc frees the block when asked for 0 bytes, but the EOS SDK
+// treats a null return as failure; keep a minimal block instead
 void * platform::realloc_aligned(void *pointer, size_t size_in_bytes, size_t alignment_in_bytes)
 {
-    return _aligned_realloc(pointer, size_in_bytes, alignment_in_bytes);
+    return _aligned_realloc(pointer, size_in_bytes != 0 ? size_in_bytes : 1, alignment_in_bytes);
 }
 
 void platform::free_aligned(void *ptr)
@@ -31,5 +33,89 @@ size_t platform::mem_usable_size(void* pointer)
     return _msize(pointer);
 }
 
+// VirtualAlloc hands out whole allocation granularity (64KiB) regions,
+// which covers every alignment the allocator internals ask for
+void * platform::alloc_pages(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    if (alignment_in_bytes > system_info.dwAllocationGranularity)
+    {
+        return nullptr;
+    }
+
+    return VirtualAlloc(nullptr, size_in_bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void platform::free_pages(void *pointer, size_t size_in_bytes)
+{
+    if (pointer != nullptr)
+    {
+        VirtualFree(pointer, 0, MEM_RELEASE);
+    }
+}
+
+// Reserves extra to find an aligned address, then reserves exactly that;
+// another thread can take the address in between, hence the retries
+void * platform::reserve_pages(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    for (int attempt = 0; attempt < 8; ++attempt)
+    {
+        void *padded = VirtualAlloc(nullptr, size_in_bytes + alignment_in_bytes, MEM_RESERVE, PAGE_NOACCESS);
+        if (padded == nullptr)
+        {
+            return nullptr;
+        }
+
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(padded) + alignment_in_bytes - 1) & ~(static_cast<uintptr_t>(alignment_in_bytes) - 1);
+        VirtualFree(padded, 0, MEM_RELEASE);
+
+        void *reservation = VirtualAlloc(reinterpret_cast<void*>(aligned), size_in_bytes, MEM_RESERVE, PAGE_NOACCESS);
+        if (reservation != nullptr)
+        {
+            return reservation;
+        }
+    }
+    return nullptr;
+}
+
+void platform::release_pages(void *pointer, size_t size_in_bytes)
+{
+    if (pointer != nullptr)
+    {
+        VirtualFree(pointer, 0, MEM_RELEASE);
+    }
+}
+
+// Large pages need SeLockMemoryPrivilege and have to be committed along
+// with the reservation, so the pages here are always regular ones
+bool platform::commit_pages(void *pointer, size_t size_in_bytes, bool *out_explicit_huge_pages)
+{
+    *out_explicit_huge_pages = false;
+    return VirtualAlloc(pointer, size_in_bytes, MEM_COMMIT, PAGE_READWRITE) == pointer;
+}
+
+void platform::decommit_pages(void *pointer, size_t size_in_bytes)
+{
+    VirtualFree(pointer, size_in_bytes, MEM_DECOMMIT);
+}
+
+uint64_t platform::current_thread_id()
+{
+    return GetCurrentThreadId();
+}
+
+uint64_t platform::coarse_milliseconds()
+{
+    return GetTickCount64();
+}
+
+// The CRT heap doesn't say how much it handed back
+size_t platform::trim()
+{
+    _heapmin();
+    return 0;
+}
+
 
 #endif
@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// bootstrap_platform for Windows, see PluginBootstrap.h
+
+#include "pch.h"
+#include "PluginBootstrap.h"
+
+#if PLATFORM_WINDOWS
+#include <aclapi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+//-------------------------------------------------------------------------
+static std::string utf8_str_from_wide_str(const wchar_t *wide_str)
+{
+    int bytes_required = WideCharToMultiByte(CP_UTF8, 0, wide_str, -1, NULL, 0, NULL, NULL);
+    if (bytes_required <= 0)
+    {
+        return {};
+    }
+
+    std::string utf8_str(static_cast<size_t>(bytes_required), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, wide_str, -1, utf8_str.data(), bytes_required, NULL, NULL);
+    // Drop the terminator WideCharToMultiByte counted
+    utf8_str.pop_back();
+
+    return utf8_str;
+}
+
+//-------------------------------------------------------------------------
+// What GetLastError's code means, such as that another process has the file
+// locked
+static std::string error_message(DWORD error)
+{
+    char *message = nullptr;
+    const DWORD length = FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+        NULL, error, 0, (LPSTR)&message, 0, NULL);
+    std::string message_str = length > 0 ? std::string(message, length) : "error " + std::to_string(error);
+    LocalFree(message);
+
+    // FormatMessage ends the message with a full stop and a line break
+    while (!message_str.empty() && (message_str.back() == '\n' || message_str.back() == '\r' || message_str.back() == '.'))
+    {
+        message_str.pop_back();
+    }
+    return message_str;
+}
+
+//-------------------------------------------------------------------------
+fs::path bootstrap_platform::module_directory()
+{
+    HMODULE this_module = nullptr;
+    if (!GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCWSTR)&bootstrap_platform::module_directory, &this_module) || !this_module)
+    {
+        return {};
+    }
+
+    std::wstring module_path(128, L'\0');
+    for (;;)
+    {
+        DWORD length = GetModuleFileNameW(this_module, module_path.data(), static_cast<DWORD>(module_path.size()));
+        if (length == 0)
+        {
+            return {};
+        }
+        if (length < module_path.size())
+        {
+            module_path.resize(length);
+            break;
+        }
+        module_path.resize(module_path.size() * 2);
+    }
+
+    return fs::path(module_path).remove_filename();
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::load_library(const fs::path& library_path)
+{
+    return (void*)LoadLibraryW(library_path.c_str());
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::find_loaded_library(const char *library_name)
+{
+    return (void*)GetModuleHandleA(library_name);
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::load_function(void *library_handle, const char *function_name)
+{
+    return (void*)GetProcAddress((HMODULE)library_handle, function_name);
+}
+
+//-------------------------------------------------------------------------
+void * bootstrap_platform::load_dllh_function(void *library_handle, const char *function_name, uint32_t argument_bytes)
+{
+#if PLATFORM_32BITS
+    char decorated_name[128];
+    snprintf(decorated_name, sizeof(decorated_name), "_%s@%u", function_name, argument_bytes);
+    return load_function(library_handle, decorated_name);
+#else
+    std::ignore = argument_bytes;
+    return load_function(library_handle, function_name);
+#endif
+}
+
+//-------------------------------------------------------------------------
+void bootstrap_platform::unload_library(void *library_handle)
+{
+    if (library_handle != nullptr)
+    {
+        FreeLibrary((HMODULE)library_handle);
+    }
+}
+
+//-------------------------------------------------------------------------
+bool bootstrap_platform::write_file(const fs::path& path, const void *data, size_t size, std::string *out_error)
+{
+    // Beside the file, so that the move doesn't cross volumes
+    fs::path temporary_path = path;
+    temporary_path += L".tmp" + std::to_wstring(GetCurrentProcessId());
+
+    FILE *file = nullptr;
+    errno_t open_error = _wfopen_s(&file, temporary_path.c_str(), L"wb");
+    if (open_error != 0 || file == nullptr)
+    {
+        char message[128] = {};
+        strerror_s(message, sizeof(message), open_error);
+        *out_error = message;
+        return false;
+    }
+
+    const bool written = fwrite(data, 1, size, file) == size;
+    if (fclose(file) != 0 || !written)
+    {
+        *out_error = "write failed";
+        DeleteFileW(temporary_path.c_str());
+        return false;
+    }
+
+    if (!MoveFileExW(temporary_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        *out_error = error_message(GetLastError());
+        DeleteFileW(temporary_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Whether the file is owned by the user the process runs as. Files made by
+// an elevated process are owned by Administrators, so they don't count.
+static bool is_owned_by_current_user(HANDLE file)
+{
+    PSID owner = NULL;
+    PSECURITY_DESCRIPTOR security_descriptor = NULL;
+    if (GetSecurityInfo(file, SE_FILE_OBJECT, OWNER_SECURITY_INFORMATION, &owner, NULL, NULL, NULL, &security_descriptor) != ERROR_SUCCESS)
+    {
+        return false;
+    }
+
+    bool is_owned = false;
+    HANDLE token = NULL;
+    if (OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token))
+    {
+        DWORD token_user_size = 0;
+        GetTokenInformation(token, TokenUser, NULL, 0, &token_user_size);
+        std::vector<BYTE> token_user(token_user_size);
+        if (token_user_size != 0 && GetTokenInformation(token, TokenUser, token_user.data(), token_user_size, &token_user_size))
+        {
+            is_owned = EqualSid(owner, reinterpret_cast<TOKEN_USER*>(token_user.data())->User.Sid) != FALSE;
+        }
+        CloseHandle(token);
+    }
+
+    LocalFree(security_descriptor);
+    return is_owned;
+}
+
+//-------------------------------------------------------------------------
+bool bootstrap_platform::map_file(const fs::path& path, MappedFile *out_mapped_file, std::string *out_error)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        *out_error = error_message(GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        *out_error = error_message(GetLastError());
+        CloseHandle(file);
+        return false;
+    }
+    if (file_size.QuadPart <= 0 || static_cast<unsigned long long>(file_size.QuadPart) > SIZE_MAX)
+    {
+        *out_error = file_size.QuadPart <= 0 ? "file is empty" : "file is too large to map";
+        CloseHandle(file);
+        return false;
+    }
+
+    const bool private_to_user = is_owned_by_current_user(file);
+
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const DWORD mapping_error = GetLastError();
+    // The mapping holds its own reference to the file
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        *out_error = error_message(mapping_error);
+        return false;
+    }
+
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        *out_error = error_message(GetLastError());
+        CloseHandle(mapping);
+        return false;
+    }
+
+    out_mapped_file->data = data;
+    out_mapped_file->size = static_cast<size_t>(file_size.QuadPart);
+    out_mapped_file->mapping = mapping;
+    out_mapped_file->private_to_user = private_to_user;
+    return true;
+}
+
+//-------------------------------------------------------------------------
+void bootstrap_platform::unmap_file(MappedFile *mapped_file)
+{
+    if (mapped_file->data != nullptr)
+    {
+        UnmapViewOfFile(mapped_file->data);
+    }
+    if (mapped_file->mapping != nullptr)
+    {
+        CloseHandle((HANDLE)mapped_file->mapping);
+    }
+    *mapped_file = MappedFile();
+}
+
+//-------------------------------------------------------------------------
+static std::string find_temp_path()
+{
+    WCHAR tmp_buffer = 0;
+    DWORD buffer_size = GetTempPathW(1, &tmp_buffer) + 1;
+    std::wstring temp_path(buffer_size, L'\0');
+    GetTempPathW(buffer_size, temp_path.data());
+
+    return utf8_str_from_wide_str(temp_path.c_str());
+}
+
+//-------------------------------------------------------------------------
+// Looked up once, by whichever thread asks first
+const char * bootstrap_platform::cache_directory()
+{
+    static const std::string s_temp_path = find_temp_path();
+    return s_temp_path.c_str();
+}
+
+//-------------------------------------------------------------------------
+std::vector<std::string> bootstrap_platform::command_line_arguments()
+{
+    std::stringstream arg_stream = std::stringstream(GetCommandLineA());
+    std::istream_iterator<std::string> args_begin(arg_stream);
+    std::istream_iterator<std::string> args_end;
+
+    return std::vector<std::string>(args_begin, args_end);
+}
+
+//-------------------------------------------------------------------------
+bool bootstrap_platform::local_time(time_t raw_time, tm *out_time_info)
+{
+    return localtime_s(out_time_info, &raw_time) == 0;
+}
+
+//-------------------------------------------------------------------------
+void bootstrap_platform::show_dialog(const char *message)
+{
+    MessageBoxA(NULL, message, "Warning", MB_ICONWARNING);
+}
+
+#endif
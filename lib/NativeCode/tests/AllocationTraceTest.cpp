@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that Mem_StartAllocationTrace records every Mem_generic_* call
+// with the right pointers, sizes and alignments, that events dropped from a
+// full ring are accounted for, that a thread which lets the drain thread
+// run when it asks for a drain loses nothing, that a second recording
+// doesn't pick up anything from the first, and that exiting part way
+// through a recording is clean.
+
+#include "BenchmarkCommon.h"
+#include "AllocationTrace.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_StartAllocationTrace(const char *path);
+extern "C" bool Mem_StopAllocationTrace();
+
+// The Makefile replays the first one as a smoke test of the replay tool
+static const char *kTracePath = "build/tests/allocation_trace.bin";
+static const char *kRestartedTracePath = "build/tests/allocation_trace_restarted.bin";
+static const char *kPacedTracePath = "build/tests/allocation_trace_paced.bin";
+static const char *kUnstoppedTracePath = "build/tests/allocation_trace_unstopped.bin";
+
+#define WORKER_COUNT 3
+#define WORKER_ITERATIONS 20000
+
+//-------------------------------------------------------------------------
+static std::vector<AllocationTraceEvent> read_trace(const char *path)
+{
+    std::vector<AllocationTraceEvent> events;
+    FILE *file = fopen(path, "rb");
+    BENCH_CHECK(file != nullptr);
+
+    AllocationTraceHeader header = {};
+    BENCH_CHECK(fread(&header, sizeof(header), 1, file) == 1);
+    BENCH_CHECK(memcmp(header.magic, ALLOCATION_TRACE_MAGIC, sizeof(ALLOCATION_TRACE_MAGIC)) == 0);
+    BENCH_CHECK(header.version == ALLOCATION_TRACE_VERSION);
+    BENCH_CHECK(header.event_size == sizeof(AllocationTraceEvent));
+
+    AllocationTraceEvent event;
+    while (fread(&event, sizeof(event), 1, file) == 1)
+    {
+        events.push_back(event);
+    }
+    fclose(file);
+
+    return events;
+}
+
+//-------------------------------------------------------------------------
+static const AllocationTraceEvent* find_event(const std::vector<AllocationTraceEvent>& events, AllocationTraceEventType type, void *pointer)
+{
+    for (const AllocationTraceEvent& event : events)
+    {
+        if (event.type == type && event.pointer == reinterpret_cast<uintptr_t>(pointer))
+        {
+            return &event;
+        }
+    }
+    return nullptr;
+}
+
+//-------------------------------------------------------------------------
+static void worker(void *handed_over)
+{
+    // Freed on a thread other than the one that allocated it. First, while
+    // this thread's ring is empty, as later the free could be dropped.
+    if (handed_over != nullptr)
+    {
+        Mem_generic_free(handed_over);
+    }
+
+    for (int i = 0; i < WORKER_ITERATIONS; ++i)
+    {
+        Mem_generic_free(Mem_generic_align_alloc(64, 16));
+    }
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    BENCH_CHECK(!Mem_StopAllocationTrace());
+    BENCH_CHECK(Mem_StartAllocationTrace(kTracePath));
+    BENCH_CHECK(!Mem_StartAllocationTrace(kTracePath));
+
+    void *small = Mem_generic_align_alloc(100, 16);
+    void *grown = Mem_generic_align_realloc(small, 5000, 64);
+    void *handed_over = Mem_generic_align_alloc(300, 8);
+    Mem_generic_free(grown);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < WORKER_COUNT; ++i)
+    {
+        workers.emplace_back(worker, i == 0 ? handed_over : nullptr);
+    }
+    for (std::thread& thread : workers)
+    {
+        thread.join();
+    }
+
+    BENCH_CHECK(Mem_StopAllocationTrace());
+    BENCH_CHECK(!Mem_StopAllocationTrace());
+
+    // Not recorded
+    Mem_generic_free(Mem_generic_align_alloc(32, 16));
+
+    std::vector<AllocationTraceEvent> events = read_trace(kTracePath);
+
+    const AllocationTraceEvent *alloc = find_event(events, AllocationTraceEventType::Alloc, small);
+    BENCH_CHECK(alloc != nullptr && alloc->size_in_bytes == 100 && alloc->alignment_log2 == 4);
+
+    const AllocationTraceEvent *realloc = find_event(events, AllocationTraceEventType::Realloc, grown);
+    BENCH_CHECK(realloc != nullptr && realloc->old_pointer == reinterpret_cast<uintptr_t>(small));
+    BENCH_CHECK(realloc->size_in_bytes == 5000 && realloc->alignment_log2 == 6);
+    BENCH_CHECK(realloc->timestamp_ns >= alloc->timestamp_ns);
+
+    const AllocationTraceEvent *handed_over_alloc = find_event(events, AllocationTraceEventType::Alloc, handed_over);
+    const AllocationTraceEvent *handed_over_free = find_event(events, AllocationTraceEventType::Free, handed_over);
+    BENCH_CHECK(handed_over_alloc != nullptr && handed_over_free != nullptr);
+    BENCH_CHECK(handed_over_alloc->thread_index != handed_over_free->thread_index);
+    BENCH_CHECK(handed_over_free->timestamp_ns >= handed_over_alloc->timestamp_ns);
+
+    // Every operation is either in the file or counted as dropped, and each
+    // thread's events are in order
+    std::map<uint16_t, uint64_t> operations;
+    std::map<uint16_t, uint64_t> last_timestamp;
+    std::map<uint16_t, int> announcements;
+    uint64_t dropped = 0;
+    for (const AllocationTraceEvent& event : events)
+    {
+        switch (event.type)
+        {
+        case AllocationTraceEventType::Thread:
+            BENCH_CHECK(operations[event.thread_index] == 0);
+            announcements[event.thread_index]++;
+            break;
+        case AllocationTraceEventType::Dropped:
+            operations[event.thread_index] += event.size_in_bytes;
+            dropped += event.size_in_bytes;
+            break;
+        default:
+            BENCH_CHECK(event.timestamp_ns >= last_timestamp[event.thread_index]);
+            last_timestamp[event.thread_index] = event.timestamp_ns;
+            operations[event.thread_index]++;
+            break;
+        }
+    }
+
+    BENCH_CHECK(operations.size() == WORKER_COUNT + 1);
+    uint64_t total = 0;
+    for (const auto& thread : operations)
+    {
+        BENCH_CHECK(announcements[thread.first] == 1);
+        total += thread.second;
+    }
+    BENCH_CHECK(total == 4 + WORKER_COUNT * WORKER_ITERATIONS * 2 + 1);
+
+    // A second recording reuses this thread's ring and starts empty
+    BENCH_CHECK(Mem_StartAllocationTrace(kRestartedTracePath));
+    void *block = Mem_generic_align_alloc(48, 16);
+    Mem_generic_free(block);
+    BENCH_CHECK(Mem_StopAllocationTrace());
+
+    events = read_trace(kRestartedTracePath);
+    BENCH_CHECK(events.size() == 3);
+    BENCH_CHECK(events[0].type == AllocationTraceEventType::Thread);
+    BENCH_CHECK(events[1].type == AllocationTraceEventType::Alloc && events[1].pointer == reinterpret_cast<uintptr_t>(block));
+    BENCH_CHECK(events[2].type == AllocationTraceEventType::Free && events[2].pointer == reinterpret_cast<uintptr_t>(block));
+
+    // Several rings' worth from one thread, pausing well short of the drain
+    // interval each quarter ring. Only a drain woken at half full keeps up.
+    BENCH_CHECK(Mem_StartAllocationTrace(kPacedTracePath));
+    const int paced_pairs = ALLOCATION_TRACE_RING_SIZE * 4;
+    for (int i = 0; i < paced_pairs; ++i)
+    {
+        Mem_generic_free(Mem_generic_align_alloc(64, 16));
+        if (i % (ALLOCATION_TRACE_RING_SIZE / 8) == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    BENCH_CHECK(Mem_StopAllocationTrace());
+
+    events = read_trace(kPacedTracePath);
+    BENCH_CHECK(events.size() == 1 + paced_pairs * 2);
+    for (const AllocationTraceEvent& event : events)
+    {
+        BENCH_CHECK(event.type != AllocationTraceEventType::Dropped);
+    }
+
+    // Left running; exiting has to stop it rather than terminate
+    BENCH_CHECK(Mem_StartAllocationTrace(kUnstoppedTracePath));
+    Mem_generic_free(Mem_generic_align_alloc(64, 16));
+
+    printf("AllocationTraceTest: ok (%llu events dropped)\n", static_cast<unsigned long long>(dropped));
+    return 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <chrono>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//-------------------------------------------------------------------------
+// Small helpers shared by the native benchmarks and tests. These are plain
+// executables so that they can run anywhere the Makefile can build them.
+
+// Unlike assert, this survives NDEBUG builds
+#define BENCH_CHECK(condition)                                                      \
+    do                                                                              \
+    {                                                                               \
+        if (!(condition))                                                           \
+        {                                                                           \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1);                                                                \
+        }                                                                           \
+    } while (0)
+
+namespace bench
+{
+    using clock = std::chrono::steady_clock;
+
+    //-------------------------------------------------------------------------
+    inline double elapsed_ns(clock::time_point start, clock::time_point end)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    //-------------------------------------------------------------------------
+    inline double elapsed_ms(clock::time_point start, clock::time_point end)
+    {
+        return elapsed_ns(start, end) / 1.0e6;
+    }
+
+    //-------------------------------------------------------------------------
+    // xorshift64*; deterministic so runs are comparable
+    struct Random
+    {
+        uint64_t state;
+
+        explicit Random(uint64_t seed = 0x9E3779B97F4A7C15ULL) : state(seed) { }
+
+        uint64_t next()
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 0x2545F4914F6CDD1DULL;
+        }
+
+        // Uniform in [low, high]
+        size_t range(size_t low, size_t high)
+        {
+            return low + static_cast<size_t>(next() % (high - low + 1));
+        }
+    };
+}
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks the schema-driven config binding in ConfigBinding.h: that a
+// schema's perfect hash finds every field and nothing else, and that every
+// field of EOSConfig, SandboxDeploymentOverride, LogLevelConfig and
+// EOSSteamConfig is filled from its JSON key, including the two the strcmp
+// chain used to miss, whether or not the strings were left in the source.
+// Values of the wrong type are skipped rather than crashed on.
+
+#include "BenchmarkCommon.h"
+#include "ConfigBinding.h"
+#include "PluginBootstrap.h"
+#include "json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+struct Point
+{
+    int x = 0;
+    int y = 0;
+};
+
+static void bind_x(json_value_s *, Point *out_point) { out_point->x = 1; }
+static void bind_y(json_value_s *, Point *out_point) { out_point->y = 1; }
+
+static constexpr config_binding::FieldDescriptor<Point> kPointFields[] =
+{
+    { "x", &bind_x },
+    { "y", &bind_y },
+};
+static constexpr auto kPointSchema = config_binding::make_schema(kPointFields);
+static_assert(kPointSchema.field_count() == 2, "");
+static_assert(kPointSchema.slot_count >= 4, "");
+
+// Names alike enough to collide in a naive hash
+#define FIELD(name) { #name, &bind_x }
+static constexpr config_binding::FieldDescriptor<Point> kManyFields[] =
+{
+    FIELD(a0), FIELD(a1), FIELD(a2), FIELD(a3), FIELD(a4), FIELD(a5), FIELD(a6), FIELD(a7), FIELD(a8), FIELD(a9),
+    FIELD(b0), FIELD(b1), FIELD(b2), FIELD(b3), FIELD(b4), FIELD(b5), FIELD(b6), FIELD(b7), FIELD(b8), FIELD(b9),
+    FIELD(ThreadAffinity_a), FIELD(ThreadAffinity_b), FIELD(ThreadAffinity_c), FIELD(ThreadAffinity_d),
+    FIELD(ThreadAffinity_e), FIELD(ThreadAffinity_f), FIELD(ThreadAffinity_g), FIELD(ThreadAffinity_h),
+    FIELD(ThreadAffinity_i), FIELD(ThreadAffinity_j), FIELD(ThreadAffinity_k), FIELD(ThreadAffinity_l),
+    FIELD(ThreadAffinity_m), FIELD(ThreadAffinity_n), FIELD(ThreadAffinity_o), FIELD(ThreadAffinity_p),
+    FIELD(ThreadAffinity_q), FIELD(ThreadAffinity_r), FIELD(ThreadAffinity_s), FIELD(ThreadAffinity_t),
+};
+#undef FIELD
+static constexpr auto kManySchema = config_binding::make_schema(kManyFields);
+
+//-------------------------------------------------------------------------
+template<typename Schema>
+static void check_schema_finds_only_its_fields(const Schema& schema)
+{
+    for (size_t i = 0; i < schema.field_count(); ++i)
+    {
+        const char *name = schema.field(i).name;
+        const size_t length = strlen(name);
+        BENCH_CHECK(schema.find(name, length) == &schema.field(i));
+
+        // Not null terminated where the key ends
+        std::string longer = std::string(name) + " ";
+        BENCH_CHECK(schema.find(longer.data(), length) == &schema.field(i));
+        BENCH_CHECK(schema.find(longer.data(), longer.size()) == nullptr);
+        BENCH_CHECK(schema.find(name, length - 1) == nullptr || length == 1);
+
+        std::string other_case = name;
+        other_case[0] ^= 0x20;
+        BENCH_CHECK(schema.find(other_case.data(), other_case.size()) == nullptr);
+    }
+    BENCH_CHECK(schema.find("", 0) == nullptr);
+    BENCH_CHECK(schema.find("missing", 7) == nullptr);
+}
+
+// Each config is checked both ways the bootstrap parses
+static size_t s_parse_flags = json_parse_flags_default;
+
+//-------------------------------------------------------------------------
+static json_value_s * parse(const char *json)
+{
+    json_value_s *value = json_parse_ex(json, strlen(json), s_parse_flags, nullptr, nullptr, nullptr);
+    BENCH_CHECK(value != nullptr);
+    return value;
+}
+
+//-------------------------------------------------------------------------
+static bool points_into(const json_string_s *string, const char *source)
+{
+    return string->string >= source && string->string + string->string_size <= source + strlen(source);
+}
+
+//-------------------------------------------------------------------------
+// Strings without escapes are left where they are in the source, keys
+// included; strings with them are decoded as usual
+static void check_strings_in_source()
+{
+    const char *source = R"({ "plain": "value", "escaped": "tab\t\u00e9\"", "empty": "", "multi": [ "a", "b\/c" ], "number": 12 })";
+
+    json_value_s *copied = json_parse(source, strlen(source));
+    json_value_s *in_source = json_parse_ex(source, strlen(source), json_parse_flags_strings_in_source, nullptr, nullptr, nullptr);
+    BENCH_CHECK(copied != nullptr && in_source != nullptr);
+
+    json_object_element_s *element = json_value_as_object(in_source)->start;
+    BENCH_CHECK(points_into(element->name, source) && element->name->string_size == 5);
+    json_string_s *string = json_value_as_string(element->value);
+    BENCH_CHECK(points_into(string, source) && string->string_size == 5 && memcmp(string->string, "value", 5) == 0);
+
+    element = element->next;
+    string = json_value_as_string(element->value);
+    BENCH_CHECK(!points_into(string, source));
+    BENCH_CHECK(string->string_size == 7 && strcmp(string->string, "tab\t\xc3\xa9\"") == 0);
+
+    element = element->next;
+    string = json_value_as_string(element->value);
+    BENCH_CHECK(points_into(string, source) && string->string_size == 0);
+
+    element = element->next;
+    json_array_element_s *item = json_value_as_array(element->value)->start;
+    BENCH_CHECK(points_into(json_value_as_string(item->value), source));
+    string = json_value_as_string(item->next->value);
+    BENCH_CHECK(!points_into(string, source) && strcmp(string->string, "b/c") == 0);
+
+    element = element->next;
+    BENCH_CHECK(strcmp(json_value_as_number(element->value)->number, "12") == 0);
+
+    free(copied);
+    free(in_source);
+
+    // And the allocation only holds the strings that had to be decoded
+    size_t copied_size = 0;
+    size_t in_source_size = 0;
+    auto record_size = [](void *user_data, size_t size) -> void * {
+        *static_cast<size_t*>(user_data) = size;
+        return malloc(size);
+    };
+    free(json_parse_ex(source, strlen(source), json_parse_flags_default, record_size, &copied_size, nullptr));
+    free(json_parse_ex(source, strlen(source), json_parse_flags_strings_in_source, record_size, &in_source_size, nullptr));
+    // Eight strings, keys included, had no escapes to decode
+    const size_t left_in_source = strlen("plain" "value" "escaped" "empty" "" "multi" "a" "number") + 8;
+    BENCH_CHECK(in_source_size + left_in_source == copied_size);
+
+    // Errors are still found
+    const char *broken = R"({ "unterminated": "value })";
+    BENCH_CHECK(json_parse_ex(broken, strlen(broken), json_parse_flags_strings_in_source, nullptr, nullptr, nullptr) == nullptr);
+}
+
+//-------------------------------------------------------------------------
+static void check_eos_config()
+{
+    json_value_s *json = parse(R"({
+        "productName": "Name",
+        "productVersion": "1.2",
+        "productID": "product",
+        "sandboxID": "sandbox",
+        "deploymentID": "deployment",
+        "sandboxDeploymentOverrides": [
+            { "sandboxID": "sandbox_a", "deploymentID": "deployment_a" },
+            { "deploymentID": "deployment_b", "unknown": 1 },
+            { "sandboxID": "sandbox_c" }
+        ],
+        "clientID": "client",
+        "clientSecret": "secret",
+        "encryptionKey": "key",
+        "overrideCountryCode": "GB",
+        "overrideLocaleCode": "en",
+        "platformOptionsFlags": [ "LoadingInEditor", "EOS_PF_DISABLE_OVERLAY", "DisableSocialOverlay", "Reserved1",
+            "WindowsEnableOverlayD3D9", "EOS_PF_WINDOWS_ENABLE_OVERLAY_D3D10", "WindowsEnableOverlayOpengl", "NotAFlag", 7 ],
+        "tickBudgetInMilliseconds": 16,
+        "taskNetworkTimeoutSeconds": 1.5,
+        "ThreadAffinity_networkWork": 1,
+        "ThreadAffinity_storageIO": "2",
+        "ThreadAffinity_webSocketIO": 3,
+        "ThreadAffinity_P2PIO": 4,
+        "ThreadAffinity_HTTPRequestIO": 5,
+        "ThreadAffinity_RTCIO": 18446744073709551615,
+        "isServer": true,
+        "memoryAllocatorBackend": "Pooled",
+        "notAField": "ignored"
+    })");
+    EOSConfig config = plugin_bootstrap::eos_config_from_json_value(json);
+    free(json);
+
+    BENCH_CHECK(config.productName == "Name");
+    BENCH_CHECK(config.productVersion == "1.2");
+    BENCH_CHECK(config.productID == "product");
+    BENCH_CHECK(config.sandboxID == "sandbox");
+    BENCH_CHECK(config.deploymentID == "deployment");
+    BENCH_CHECK(config.sandboxDeploymentOverrides.size() == 3);
+    BENCH_CHECK(config.sandboxDeploymentOverrides[0].sandboxID == "sandbox_a");
+    BENCH_CHECK(config.sandboxDeploymentOverrides[0].deploymentID == "deployment_a");
+    BENCH_CHECK(config.sandboxDeploymentOverrides[1].sandboxID.empty());
+    BENCH_CHECK(config.sandboxDeploymentOverrides[1].deploymentID == "deployment_b");
+    BENCH_CHECK(config.sandboxDeploymentOverrides[2].sandboxID == "sandbox_c");
+    BENCH_CHECK(config.sandboxDeploymentOverrides[2].deploymentID.empty());
+    BENCH_CHECK(config.clientID == "client");
+    BENCH_CHECK(config.clientSecret == "secret");
+    BENCH_CHECK(config.encryptionKey == "key");
+    BENCH_CHECK(config.overrideCountryCode == "GB");
+    BENCH_CHECK(config.overrideLocaleCode == "en");
+    BENCH_CHECK(config.flags == (EOS_PF_LOADING_IN_EDITOR | EOS_PF_DISABLE_OVERLAY | EOS_PF_DISABLE_SOCIAL_OVERLAY | EOS_PF_RESERVED1
+        | EOS_PF_WINDOWS_ENABLE_OVERLAY_D3D9 | EOS_PF_WINDOWS_ENABLE_OVERLAY_D3D10 | EOS_PF_WINDOWS_ENABLE_OVERLAY_OPENGL));
+    BENCH_CHECK(config.tickBudgetInMilliseconds == 16);
+    BENCH_CHECK(config.taskNetworkTimeoutSeconds == 1.5);
+    BENCH_CHECK(config.ThreadAffinity_networkWork == 1);
+    BENCH_CHECK(config.ThreadAffinity_storageIO == 2);
+    BENCH_CHECK(config.ThreadAffinity_webSocketIO == 3);
+    BENCH_CHECK(config.ThreadAffinity_P2PIO == 4);
+    BENCH_CHECK(config.ThreadAffinity_HTTPRequestIO == 5);
+    BENCH_CHECK(config.ThreadAffinity_RTCIO == UINT64_MAX);
+    BENCH_CHECK(config.isServer);
+    BENCH_CHECK(config.memoryAllocatorBackend == "Pooled");
+
+    // The key as the strcmp chain spelt it isn't one, and a later key wins
+    json = parse(R"({ "overrideCountryCode ": "GB", "isServer": true, "isServer": false, "productName": "A", "productName": "B" })");
+    config = plugin_bootstrap::eos_config_from_json_value(json);
+    free(json);
+    BENCH_CHECK(config.overrideCountryCode.empty());
+    BENCH_CHECK(!config.isServer);
+    BENCH_CHECK(config.productName == "B");
+
+    // Values of the wrong type leave the field as it was
+    json = parse(R"({
+        "productName": 1,
+        "encryptionKey": null,
+        "sandboxDeploymentOverrides": { "sandboxID": "not a list" },
+        "platformOptionsFlags": "DisableOverlay",
+        "isServer": "true",
+        "tickBudgetInMilliseconds": [ 1 ],
+        "memoryAllocatorBackend": false
+    })");
+    config = plugin_bootstrap::eos_config_from_json_value(json);
+    free(json);
+    BENCH_CHECK(config.productName.empty() && config.encryptionKey.empty() && config.memoryAllocatorBackend.empty());
+    BENCH_CHECK(config.sandboxDeploymentOverrides.empty());
+    BENCH_CHECK(config.flags == 0 && !config.isServer && config.tickBudgetInMilliseconds == 0);
+
+    // Nor is anything but an object a config
+    json = parse(R"([ { "productName": "Name" } ])");
+    config = plugin_bootstrap::eos_config_from_json_value(json);
+    free(json);
+    BENCH_CHECK(config.productName.empty());
+}
+
+//-------------------------------------------------------------------------
+static void check_log_level_config()
+{
+    json_value_s *json = parse(R"({
+        "LogCategoryLevelPairs": [
+            { "Category": "Core", "Level": "Warning" },
+            { "Level": "Info", "Category": "Auth" },
+            "not a pair",
+            { "Category": "AllCategories", "Level": "Verbose", "Other": 1 }
+        ]
+    })");
+    LogLevelConfig config = plugin_bootstrap::log_config_from_json_value(json);
+    free(json);
+
+    BENCH_CHECK(config.category.size() == 3 && config.level.size() == 3);
+    BENCH_CHECK(config.category[0] == "Core" && config.level[0] == "Warning");
+    BENCH_CHECK(config.category[1] == "Auth" && config.level[1] == "Info");
+    BENCH_CHECK(config.category[2] == "AllCategories" && config.level[2] == "Verbose");
+
+    // Category and Level belong in the pairs, not at the top
+    json = parse(R"({ "Category": "Core", "Level": "Warning" })");
+    config = plugin_bootstrap::log_config_from_json_value(json);
+    free(json);
+    BENCH_CHECK(config.category.empty() && config.level.empty());
+}
+
+//-------------------------------------------------------------------------
+static void check_steam_config()
+{
+    json_value_s *json = parse(R"({
+        "flags": [ "LibraryManagedByApplication", "EOS_IPMF_DisableSessions", "DisablePresenceMirroring", "PreferEOS", 3 ],
+        "overrideLibraryPath": "steam/libsteam_api.so",
+        "steamSDKMajorVersion": 1,
+        "steamSDKMinorVersion": "57",
+        "steamApiInterfaceVersionsArray": [ "SteamUser023", 5, "SteamFriends017" ]
+    })");
+    EOSSteamConfig config = plugin_bootstrap::eos_steam_config_from_json_value(json);
+    free(json);
+
+    BENCH_CHECK(config.flags == (EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_LibraryManagedByApplication
+        | EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_DisableSDKManagedSessions
+        | EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_DisablePresenceMirroring
+        | EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_PreferEOSIdentity));
+    BENCH_CHECK(config.isManagedByApplication() && !config.isManagedBySDK());
+    BENCH_CHECK(config.OverrideLibraryPath == std::string("steam/libsteam_api.so"));
+    BENCH_CHECK(config.steamSDKMajorVersion == 1);
+    BENCH_CHECK(config.steamSDKMinorVersion == 57);
+    BENCH_CHECK(config.steamApiInterfaceVersionsArray.size() == 2);
+    BENCH_CHECK(config.steamApiInterfaceVersionsArray[0] == "SteamUser023");
+    BENCH_CHECK(config.steamApiInterfaceVersionsArray[1] == "SteamFriends017");
+
+    // No flags that mean anything is Disabled, and "null" is no path
+    json = parse(R"({ "flags": [ "Unknown" ], "overrideLibraryPath": "null" })");
+    config = plugin_bootstrap::eos_steam_config_from_json_value(json);
+    free(json);
+    BENCH_CHECK(config.flags == EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_Disabled);
+    BENCH_CHECK(!config.OverrideLibraryPath.has_value());
+
+    json = parse(R"({ "overrideLibraryPath": "NULL" })");
+    config = plugin_bootstrap::eos_steam_config_from_json_value(json);
+    free(json);
+    BENCH_CHECK(!config.OverrideLibraryPath.has_value());
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    check_schema_finds_only_its_fields(kPointSchema);
+    check_schema_finds_only_its_fields(kManySchema);
+
+    json_value_s *json = parse(R"({ "y": 0, "z": 0 })");
+    Point point;
+    for (json_object_element_s *iter = json_value_as_object(json)->start; iter != nullptr; iter = iter->next)
+    {
+        if (const config_binding::FieldDescriptor<Point> *field = kPointSchema.find(iter->name->string, iter->name->string_size))
+        {
+            field->bind(iter->value, &point);
+        }
+    }
+    free(json);
+    BENCH_CHECK(point.x == 0 && point.y == 1);
+
+    check_strings_in_source();
+
+    const size_t parse_flags[] = { json_parse_flags_default, json_parse_flags_strings_in_source };
+    for (size_t flags : parse_flags)
+    {
+        s_parse_flags = flags;
+        check_eos_config();
+        check_log_level_config();
+        check_steam_config();
+    }
+
+    printf("ConfigBindingTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Times reading the EOS config three ways: parsing the JSON with nothing
+// cached, as before there was a cache; a cold start, which parses and
+// writes the cache; and a warm start, which reads the JSON only to hash it
+// and takes the config from the mapped cache. Once for a config as most
+// projects ship it, and once for one with many sandbox deployment
+// overrides.
+
+#include "BenchmarkCommon.h"
+#include "ConfigCache.h"
+#include "PluginBootstrap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static const int kRounds = 200;
+
+//-------------------------------------------------------------------------
+static std::string make_config(int override_count)
+{
+    std::string config =
+        "{\n"
+        "    \"productName\": \"ConfigCacheBenchmark\",\n"
+        "    \"productVersion\": \"1.0\",\n"
+        "    \"productID\": \"0123456789abcdef0123456789abcdef\",\n"
+        "    \"sandboxID\": \"0123456789abcdef0123456789abcdef\",\n"
+        "    \"deploymentID\": \"0123456789abcdef0123456789abcdef\",\n"
+        "    \"sandboxDeploymentOverrides\": [";
+    for (int i = 0; i < override_count; ++i)
+    {
+        char entry[160];
+        snprintf(entry, sizeof(entry), "%s\n        { \"sandboxID\": \"sandbox_%08d\", \"deploymentID\": \"deployment_%08d\" }", i ? "," : "", i, i);
+        config += entry;
+    }
+    config +=
+        "\n    ],\n"
+        "    \"clientID\": \"xyza7891AbCdEfGhIjKlMnOpQrStUvWx\",\n"
+        "    \"clientSecret\": \"AbCdEfGhIjKlMnOpQrStUvWxYz0123456789AbCdEfGh\",\n"
+        "    \"encryptionKey\": \"1111111111111111111111111111111111111111111111111111111111111111\",\n"
+        "    \"platformOptionsFlags\": [ \"DisableOverlay\", \"DisableSocialOverlay\" ],\n"
+        "    \"tickBudgetInMilliseconds\": 0,\n"
+        "    \"taskNetworkTimeoutSeconds\": 0.0,\n"
+        "    \"ThreadAffinity_networkWork\": 0,\n"
+        "    \"ThreadAffinity_storageIO\": 0,\n"
+        "    \"ThreadAffinity_webSocketIO\": 0,\n"
+        "    \"ThreadAffinity_P2PIO\": 0,\n"
+        "    \"ThreadAffinity_HTTPRequestIO\": 0,\n"
+        "    \"ThreadAffinity_RTCIO\": 0,\n"
+        "    \"isServer\": false\n"
+        "}\n";
+    return config;
+}
+
+//-------------------------------------------------------------------------
+static double json_round(const fs::path& config_path)
+{
+    const auto start = bench::clock::now();
+    json_value_s *config_json = plugin_bootstrap::read_config_json_from_path(config_path);
+    BENCH_CHECK(config_json != nullptr);
+    EOSConfig config = plugin_bootstrap::eos_config_from_json_value(config_json);
+    free(config_json);
+    const double elapsed = bench::elapsed_ns(start, bench::clock::now());
+
+    BENCH_CHECK(config.productName == "ConfigCacheBenchmark");
+    return elapsed;
+}
+
+//-------------------------------------------------------------------------
+static double cached_round(const fs::path& config_path, bool cold)
+{
+    fs::path cache_path = config_path;
+    cache_path += CONFIG_CACHE_EXTENSION;
+    if (cold)
+    {
+        fs::remove(cache_path);
+    }
+
+    const auto start = bench::clock::now();
+    std::optional<EOSConfig> config = plugin_bootstrap::read_eos_config_from_path(config_path);
+    const double elapsed = bench::elapsed_ns(start, bench::clock::now());
+
+    BENCH_CHECK(config.has_value() && config->productName == "ConfigCacheBenchmark");
+    BENCH_CHECK(fs::exists(cache_path));
+    return elapsed;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    char root_template[] = "/tmp/ConfigCacheBenchmark.XXXXXX";
+    BENCH_CHECK(mkdtemp(root_template) != nullptr);
+    const fs::path root = root_template;
+    setenv("XDG_CACHE_HOME", root.c_str(), 1);
+
+    printf("Reading EpicOnlineServicesConfig.json, best of %d rounds (us, lower is better)\n", kRounds);
+    printf("%-12s %8s %10s %10s %10s %8s\n", "overrides", "bytes", "json", "cold", "warm", "speedup");
+
+    const int override_counts[] = { 0, 500 };
+    for (int override_count : override_counts)
+    {
+        const fs::path config_path = root / "EpicOnlineServicesConfig.json";
+        const std::string contents = make_config(override_count);
+        {
+            std::ofstream file(config_path, std::ios::binary | std::ios::trunc);
+            file << contents;
+            BENCH_CHECK(file.good());
+        }
+
+        double json_ns = 1.0e30;
+        double cold_ns = 1.0e30;
+        double warm_ns = 1.0e30;
+        for (int round = 0; round < kRounds; ++round)
+        {
+            json_ns = std::min(json_ns, json_round(config_path));
+            cold_ns = std::min(cold_ns, cached_round(config_path, true));
+            warm_ns = std::min(warm_ns, cached_round(config_path, false));
+        }
+
+        // The lines the reads logged aren't wanted
+        plugin_bootstrap::flush_log_with_function([](const char *) { });
+
+        printf("%-12d %8zu %10.1f %10.1f %10.1f %7.2fx\n", override_count, contents.size(),
+            json_ns / 1000.0, cold_ns / 1000.0, warm_ns / 1000.0, json_ns / warm_ns);
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
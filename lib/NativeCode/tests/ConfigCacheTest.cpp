@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks the binary config cache in ConfigCache.h: every field of each
+// config survives a round trip, a config is read from its cache once one
+// has been written, and a cache that's stale, damaged, from another
+// version or of another kind is passed over for the JSON and rewritten.
+// A cache that can't be written beside its config goes to the cache
+// directory instead, and a config that can't be read says why.
+
+#include "BenchmarkCommon.h"
+#include "ConfigCache.h"
+#include "PluginBootstrap.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static const char *kConfig = R"({
+    "productName": "ConfigCacheTest",
+    "productVersion": "2.0",
+    "productID": "product",
+    "sandboxID": "sandbox",
+    "deploymentID": "deployment",
+    "sandboxDeploymentOverrides": [
+        { "sandboxID": "sandbox_a", "deploymentID": "deployment_a" },
+        { "sandboxID": "sandbox_b", "deploymentID": "deployment_b" }
+    ],
+    "clientID": "client",
+    "clientSecret": "secret",
+    "encryptionKey": "1111111111111111111111111111111111111111111111111111111111111111",
+    "overrideLocaleCode": "fr",
+    "platformOptionsFlags": [ "DisableOverlay", "DisableSocialOverlay" ],
+    "tickBudgetInMilliseconds": 7,
+    "taskNetworkTimeoutSeconds": 2.5,
+    "ThreadAffinity_networkWork": 1,
+    "ThreadAffinity_storageIO": 2,
+    "ThreadAffinity_webSocketIO": 3,
+    "ThreadAffinity_P2PIO": 4,
+    "ThreadAffinity_HTTPRequestIO": 5,
+    "ThreadAffinity_RTCIO": 6,
+    "isServer": true,
+    "memoryAllocatorBackend": "Pooled"
+})";
+
+static const char *kLogLevelConfig = R"({
+    "LogCategoryLevelPairs": [
+        { "Category": "Core", "Level": "Warning" },
+        { "Category": "AllCategories", "Level": "Info" }
+    ]
+})";
+
+static const char *kSteamConfig = R"({
+    "flags": [ "ManagedByApplication", "DisableSessions" ],
+    "overrideLibraryPath": "steam/libsteam_api.so",
+    "steamSDKMajorVersion": 1,
+    "steamSDKMinorVersion": 57,
+    "steamApiInterfaceVersionsArray": [ "SteamUser023", "SteamFriends017" ]
+})";
+
+//-------------------------------------------------------------------------
+static void write_file(const fs::path& path, const std::string& contents)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+    BENCH_CHECK(file.good());
+}
+
+//-------------------------------------------------------------------------
+static std::string read_file(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static std::string s_log;
+
+//-------------------------------------------------------------------------
+static void append_to_log(const char *line)
+{
+    s_log += line;
+    s_log += '\n';
+}
+
+//-------------------------------------------------------------------------
+// contents is what to write first, if anything
+static void check_read_fails(const fs::path& path, const char *contents, const char *reason)
+{
+    if (contents != nullptr)
+    {
+        write_file(path, contents);
+    }
+
+    s_log.clear();
+    plugin_bootstrap::flush_log_with_function(&append_to_log);
+    BENCH_CHECK(!plugin_bootstrap::read_log_level_config_from_path(path).has_value());
+    plugin_bootstrap::flush_log_with_function(&append_to_log);
+    BENCH_CHECK(s_log.find(path.filename().string()) != std::string::npos);
+    BENCH_CHECK(s_log.find(reason) != std::string::npos);
+}
+
+//-------------------------------------------------------------------------
+static fs::path cache_beside(const fs::path& path)
+{
+    fs::path cache_path = path;
+    cache_path += CONFIG_CACHE_EXTENSION;
+    return cache_path;
+}
+
+//-------------------------------------------------------------------------
+static bool same_config(const EOSConfig& a, const EOSConfig& b)
+{
+    if (a.sandboxDeploymentOverrides.size() != b.sandboxDeploymentOverrides.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.sandboxDeploymentOverrides.size(); ++i)
+    {
+        if (a.sandboxDeploymentOverrides[i].sandboxID != b.sandboxDeploymentOverrides[i].sandboxID
+            || a.sandboxDeploymentOverrides[i].deploymentID != b.sandboxDeploymentOverrides[i].deploymentID)
+        {
+            return false;
+        }
+    }
+
+    return a.productName == b.productName && a.productVersion == b.productVersion
+        && a.productID == b.productID && a.sandboxID == b.sandboxID && a.deploymentID == b.deploymentID
+        && a.clientSecret == b.clientSecret && a.clientID == b.clientID && a.encryptionKey == b.encryptionKey
+        && a.overrideCountryCode == b.overrideCountryCode && a.overrideLocaleCode == b.overrideLocaleCode
+        && a.flags == b.flags && a.tickBudgetInMilliseconds == b.tickBudgetInMilliseconds
+        && a.taskNetworkTimeoutSeconds == b.taskNetworkTimeoutSeconds
+        && a.ThreadAffinity_networkWork == b.ThreadAffinity_networkWork
+        && a.ThreadAffinity_storageIO == b.ThreadAffinity_storageIO
+        && a.ThreadAffinity_webSocketIO == b.ThreadAffinity_webSocketIO
+        && a.ThreadAffinity_P2PIO == b.ThreadAffinity_P2PIO
+        && a.ThreadAffinity_HTTPRequestIO == b.ThreadAffinity_HTTPRequestIO
+        && a.ThreadAffinity_RTCIO == b.ThreadAffinity_RTCIO
+        && a.isServer == b.isServer && a.memoryAllocatorBackend == b.memoryAllocatorBackend;
+}
+
+//-------------------------------------------------------------------------
+static bool same_config(const EOSSteamConfig& a, const EOSSteamConfig& b)
+{
+    return a.flags == b.flags && a.steamSDKMajorVersion == b.steamSDKMajorVersion
+        && a.steamSDKMinorVersion == b.steamSDKMinorVersion && a.OverrideLibraryPath == b.OverrideLibraryPath
+        && a.steamApiInterfaceVersionsArray == b.steamApiInterfaceVersionsArray;
+}
+
+//-------------------------------------------------------------------------
+// Every field, set to something other than its default, survives
+static void check_round_trips()
+{
+    EOSConfig config;
+    config.productName = "name";
+    config.productVersion = "version";
+    config.productID = "product";
+    config.sandboxID = "sandbox";
+    config.deploymentID = "deployment";
+    config.sandboxDeploymentOverrides = { { "a", "b" }, { "", "d" } };
+    config.clientSecret = "secret";
+    config.clientID = "client";
+    config.encryptionKey = "key";
+    config.overrideCountryCode = "GB";
+    config.overrideLocaleCode = "en";
+    config.flags = 0x8000000000000001ULL;
+    config.tickBudgetInMilliseconds = 9;
+    config.taskNetworkTimeoutSeconds = 0.125;
+    config.ThreadAffinity_networkWork = 1;
+    config.ThreadAffinity_storageIO = 2;
+    config.ThreadAffinity_webSocketIO = 3;
+    config.ThreadAffinity_P2PIO = 4;
+    config.ThreadAffinity_HTTPRequestIO = 5;
+    config.ThreadAffinity_RTCIO = UINT64_MAX;
+    config.isServer = true;
+    config.memoryAllocatorBackend = "System";
+
+    const std::string source = "any bytes at all";
+    std::string encoded = config_cache::encode(config, source.data(), source.size());
+    EOSConfig decoded;
+    BENCH_CHECK(config_cache::decode(encoded.data(), encoded.size(), source.data(), source.size(), &decoded));
+    BENCH_CHECK(same_config(config, decoded));
+
+    // Nor is it anything else
+    LogLevelConfig wrong_kind;
+    BENCH_CHECK(!config_cache::decode(encoded.data(), encoded.size(), source.data(), source.size(), &wrong_kind));
+
+    LogLevelConfig log_config;
+    log_config.category = { "Core", "Auth", "" };
+    log_config.level = { "Warning", "Error", "Info" };
+    encoded = config_cache::encode(log_config, source.data(), source.size());
+    LogLevelConfig decoded_log_config;
+    BENCH_CHECK(config_cache::decode(encoded.data(), encoded.size(), source.data(), source.size(), &decoded_log_config));
+    BENCH_CHECK(decoded_log_config.category == log_config.category && decoded_log_config.level == log_config.level);
+
+    // With and without an override path; an empty one is still one
+    EOSSteamConfig steam_config;
+    steam_config.flags = EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_LibraryManagedBySDK | EOS_EIntegratedPlatformManagementFlags::EOS_IPMF_PreferEOSIdentity;
+    steam_config.steamSDKMajorVersion = 1;
+    steam_config.steamSDKMinorVersion = 60;
+    steam_config.steamApiInterfaceVersionsArray = { "SteamUser023" };
+    for (int has_path = 0; has_path < 2; ++has_path)
+    {
+        if (has_path)
+        {
+            steam_config.OverrideLibraryPath = std::string();
+        }
+        encoded = config_cache::encode(steam_config, source.data(), source.size());
+        EOSSteamConfig decoded_steam_config;
+        BENCH_CHECK(config_cache::decode(encoded.data(), encoded.size(), source.data(), source.size(), &decoded_steam_config));
+        BENCH_CHECK(same_config(steam_config, decoded_steam_config));
+    }
+}
+
+//-------------------------------------------------------------------------
+// Anything wrong with the cache sends the read back to the JSON, which
+// writes a good cache again
+static void check_rejected(const fs::path& config_path, const std::string& damaged_cache, const char *what)
+{
+    write_file(cache_beside(config_path), damaged_cache);
+
+    std::optional<EOSConfig> config = plugin_bootstrap::read_eos_config_from_path(config_path);
+    BENCH_CHECK(config.has_value());
+    BENCH_CHECK(config->productName == "ConfigCacheTest");
+
+    const std::string rewritten = read_file(cache_beside(config_path));
+    const std::string source = read_file(config_path);
+    EOSConfig decoded;
+    BENCH_CHECK(config_cache::decode(rewritten.data(), rewritten.size(), source.data(), source.size(), &decoded));
+    printf("%s: rejected\n", what);
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    char root_template[] = "/tmp/ConfigCacheTest.XXXXXX";
+    BENCH_CHECK(mkdtemp(root_template) != nullptr);
+    const fs::path root = root_template;
+    fs::create_directories(root / "cache");
+    // Before anything asks for the cache directory, as it's looked up once
+    setenv("XDG_CACHE_HOME", (root / "cache").c_str(), 1);
+
+    check_round_trips();
+
+    const fs::path config_path = root / "EpicOnlineServicesConfig.json";
+    const fs::path log_level_config_path = root / "log_level_config.json";
+    const fs::path steam_config_path = root / "eos_steam_config.json";
+    write_file(config_path, kConfig);
+    write_file(log_level_config_path, kLogLevelConfig);
+    write_file(steam_config_path, kSteamConfig);
+
+    // The first read parses and leaves a cache behind that reads the same
+    std::optional<EOSConfig> parsed = plugin_bootstrap::read_eos_config_from_path(config_path);
+    BENCH_CHECK(parsed.has_value());
+    BENCH_CHECK(fs::exists(cache_beside(config_path)));
+    BENCH_CHECK(parsed->sandboxDeploymentOverrides.size() == 2 && parsed->memoryAllocatorBackend == "Pooled");
+    std::optional<EOSConfig> cached = plugin_bootstrap::read_eos_config_from_path(config_path);
+    BENCH_CHECK(cached.has_value() && same_config(parsed.value(), cached.value()));
+
+    std::optional<LogLevelConfig> parsed_log_level = plugin_bootstrap::read_log_level_config_from_path(log_level_config_path);
+    BENCH_CHECK(parsed_log_level.has_value() && parsed_log_level->level.size() == 2);
+    std::optional<LogLevelConfig> cached_log_level = plugin_bootstrap::read_log_level_config_from_path(log_level_config_path);
+    BENCH_CHECK(cached_log_level.has_value());
+    BENCH_CHECK(cached_log_level->category == parsed_log_level->category && cached_log_level->level == parsed_log_level->level);
+
+    std::optional<EOSSteamConfig> parsed_steam = plugin_bootstrap::read_steam_config_from_path(steam_config_path);
+    BENCH_CHECK(parsed_steam.has_value() && parsed_steam->isManagedByApplication());
+    std::optional<EOSSteamConfig> cached_steam = plugin_bootstrap::read_steam_config_from_path(steam_config_path);
+    BENCH_CHECK(cached_steam.has_value() && same_config(parsed_steam.value(), cached_steam.value()));
+
+    // A read really is from the cache: one made from the same JSON, but
+    // saying something else, is believed
+    const std::string source = read_file(config_path);
+    EOSConfig planted = parsed.value();
+    planted.productName = "FromTheCache";
+    write_file(cache_beside(config_path), config_cache::encode(planted, source.data(), source.size()));
+    cached = plugin_bootstrap::read_eos_config_from_path(config_path);
+    BENCH_CHECK(cached.has_value() && cached->productName == "FromTheCache");
+
+    // Stale: the JSON changed since
+    std::string changed_config = kConfig;
+    changed_config.replace(changed_config.find("\"2.0\""), 5, "\"2.1\"");
+    write_file(config_path, changed_config);
+    cached = plugin_bootstrap::read_eos_config_from_path(config_path);
+    BENCH_CHECK(cached.has_value() && cached->productVersion == "2.1" && cached->productName == "ConfigCacheTest");
+    printf("stale: rejected\n");
+
+    const std::string good_cache = read_file(cache_beside(config_path));
+
+    std::string damaged = good_cache;
+    damaged[damaged.size() - 3] ^= 0x20;
+    check_rejected(config_path, damaged, "damaged");
+
+    check_rejected(config_path, good_cache.substr(0, good_cache.size() - 1), "truncated");
+    check_rejected(config_path, good_cache.substr(0, sizeof(ConfigCacheHeader) / 2), "short header");
+
+    std::string other_version = good_cache;
+    ConfigCacheHeader header = {};
+    memcpy(&header, other_version.data(), sizeof(header));
+    header.version = CONFIG_CACHE_VERSION + 1;
+    memcpy(&other_version[0], &header, sizeof(header));
+    check_rejected(config_path, other_version, "other version");
+
+    check_rejected(config_path, config_cache::encode(parsed_log_level.value(), source.data(), source.size()), "other kind");
+
+    // A cache others could have written is passed over however good it is
+    const std::string changed_source = read_file(config_path);
+    write_file(cache_beside(config_path), config_cache::encode(planted, changed_source.data(), changed_source.size()));
+    fs::permissions(cache_beside(config_path), fs::perms::group_write | fs::perms::others_write, fs::perm_options::add);
+    cached = plugin_bootstrap::read_eos_config_from_path(config_path);
+    BENCH_CHECK(cached.has_value() && cached->productName == "ConfigCacheTest");
+    BENCH_CHECK((fs::status(cache_beside(config_path)).permissions() & fs::perms::others_write) == fs::perms::none);
+    printf("writable by others: rejected\n");
+
+    // Where the cache can't go beside the config, it goes to the cache
+    // directory, and is found there next time
+    fs::remove(cache_beside(steam_config_path));
+    fs::create_directory(cache_beside(steam_config_path));
+    parsed_steam = plugin_bootstrap::read_steam_config_from_path(steam_config_path);
+    BENCH_CHECK(parsed_steam.has_value());
+    size_t cache_directory_files = 0;
+    for (const fs::directory_entry& entry : fs::directory_iterator(root / "cache"))
+    {
+        const std::string name = entry.path().filename().string();
+        BENCH_CHECK(name.find("eos_steam_config.json" CONFIG_CACHE_EXTENSION) != std::string::npos);
+        cache_directory_files++;
+    }
+    BENCH_CHECK(cache_directory_files == 1);
+    cached_steam = plugin_bootstrap::read_steam_config_from_path(steam_config_path);
+    BENCH_CHECK(cached_steam.has_value() && same_config(parsed_steam.value(), cached_steam.value()));
+
+    // A file that isn't JSON is still turned away, and what was wrong with
+    // a file that couldn't be read is logged
+    check_read_fails(log_level_config_path, "not json", "Couldn't parse");
+    check_read_fails(log_level_config_path, "{ \"LogCategoryLevelPairs\": [ ", "Couldn't parse");
+    check_read_fails(log_level_config_path, "", "file is empty");
+    fs::remove(log_level_config_path);
+    check_read_fails(log_level_config_path, nullptr, strerror(ENOENT));
+
+    fs::remove_all(root);
+
+    printf("ConfigCacheTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Times filling an EOSConfig from parsed JSON through the schema in
+// PluginBootstrap.cpp against the chain of strcmp calls it replaced, with
+// the time json_parse takes alongside for scale. The chain is kept here as
+// it was, including its missing else, so that it does the same work.
+//
+// Also times parsing with json_parse_flags_strings_in_source, as the
+// bootstrap does from a mapped file, and how much it allocates to load a
+// config either way: reading the file into a buffer and parsing a copy of
+// every string, as before, against parsing the mapping in place.
+
+#include "BenchmarkCommon.h"
+#include "PluginBootstrap.h"
+#include "json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+static const int kRounds = 20;
+static const int kIterations = 2000;
+
+static const char *kConfig = R"({
+    "productName": "ConfigParseBenchmark",
+    "productVersion": "1.0",
+    "productID": "0123456789abcdef0123456789abcdef",
+    "sandboxID": "0123456789abcdef0123456789abcdef",
+    "deploymentID": "0123456789abcdef0123456789abcdef",
+    "sandboxDeploymentOverrides": [
+        { "sandboxID": "sandbox_a", "deploymentID": "deployment_a" },
+        { "sandboxID": "sandbox_b", "deploymentID": "deployment_b" }
+    ],
+    "clientID": "xyza7891AbCdEfGhIjKlMnOpQrStUvWx",
+    "clientSecret": "AbCdEfGhIjKlMnOpQrStUvWxYz0123456789AbCdEfGh",
+    "encryptionKey": "1111111111111111111111111111111111111111111111111111111111111111",
+    "overrideCountryCode": "GB",
+    "overrideLocaleCode": "en",
+    "platformOptionsFlags": [ "DisableOverlay", "DisableSocialOverlay" ],
+    "tickBudgetInMilliseconds": 0,
+    "taskNetworkTimeoutSeconds": 0.0,
+    "ThreadAffinity_networkWork": 0,
+    "ThreadAffinity_storageIO": 0,
+    "ThreadAffinity_webSocketIO": 0,
+    "ThreadAffinity_P2PIO": 0,
+    "ThreadAffinity_HTTPRequestIO": 0,
+    "ThreadAffinity_RTCIO": 0,
+    "isServer": false,
+    "memoryAllocatorBackend": "Pooled"
+})";
+
+//-------------------------------------------------------------------------
+static uint64_t as_uint64(json_value_s *value)
+{
+    json_number_s *n = json_value_as_number(value);
+    return n != nullptr ? strtoull(n->number, nullptr, 10) : 0;
+}
+
+//-------------------------------------------------------------------------
+static EOSConfig strcmp_chain_from_json_value(json_value_s *config_json)
+{
+    struct json_object_s* config_json_object = json_value_as_object(config_json);
+    struct json_object_element_s* iter = config_json_object->start;
+    EOSConfig eos_config;
+
+    while (iter != nullptr)
+    {
+        if (!strcmp("productName", iter->name->string))
+        {
+            eos_config.productName = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("productVersion", iter->name->string))
+        {
+            eos_config.productVersion = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("productID", iter->name->string))
+        {
+            eos_config.productID = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("sandboxID", iter->name->string))
+        {
+            eos_config.sandboxID = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("deploymentID", iter->name->string))
+        {
+            eos_config.deploymentID = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("sandboxDeploymentOverrides", iter->name->string))
+        {
+            json_array_s* overrides = json_value_as_array(iter->value);
+            for (auto e = overrides->start; e != nullptr; e = e->next)
+            {
+                struct json_object_element_s* ov_iter = json_value_as_object(e->value)->start;
+                SandboxDeploymentOverride override_item;
+                while (ov_iter != nullptr)
+                {
+                    if (!strcmp("sandboxID", ov_iter->name->string))
+                    {
+                        override_item.sandboxID = json_value_as_string(ov_iter->value)->string;
+                    }
+                    else if (!strcmp("deploymentID", ov_iter->name->string))
+                    {
+                        override_item.deploymentID = json_value_as_string(ov_iter->value)->string;
+                    }
+                    ov_iter = ov_iter->next;
+                }
+                eos_config.sandboxDeploymentOverrides.push_back(override_item);
+            }
+        }
+        else if (!strcmp("clientID", iter->name->string))
+        {
+            eos_config.clientID = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("clientSecret", iter->name->string))
+        {
+            eos_config.clientSecret = json_value_as_string(iter->value)->string;
+        }
+        if (!strcmp("encryptionKey", iter->name->string))
+        {
+            eos_config.encryptionKey = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("overrideCountryCode ", iter->name->string))
+        {
+            eos_config.overrideCountryCode = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("overrideLocaleCode", iter->name->string))
+        {
+            eos_config.overrideLocaleCode = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("platformOptionsFlags", iter->name->string))
+        {
+            for (auto e = json_value_as_array(iter->value)->start; e != nullptr; e = e->next)
+            {
+                const char* flag_as_cstr = json_value_as_string(e->value)->string;
+                if (!strcmp("EOS_PF_DISABLE_OVERLAY", flag_as_cstr) || !strcmp("DisableOverlay", flag_as_cstr))
+                {
+                    eos_config.flags |= EOS_PF_DISABLE_OVERLAY;
+                }
+                if (!strcmp("EOS_PF_DISABLE_SOCIAL_OVERLAY", flag_as_cstr) || !strcmp("DisableSocialOverlay", flag_as_cstr))
+                {
+                    eos_config.flags |= EOS_PF_DISABLE_SOCIAL_OVERLAY;
+                }
+            }
+        }
+        else if (!strcmp("tickBudgetInMilliseconds", iter->name->string))
+        {
+            eos_config.tickBudgetInMilliseconds = static_cast<uint32_t>(as_uint64(iter->value));
+        }
+        else if (!strcmp("taskNetworkTimeoutSeconds", iter->name->string))
+        {
+            json_number_s *n = json_value_as_number(iter->value);
+            eos_config.taskNetworkTimeoutSeconds = n != nullptr ? strtod(n->number, nullptr) : 0.0;
+        }
+        else if (!strcmp("ThreadAffinity_networkWork", iter->name->string))
+        {
+            eos_config.ThreadAffinity_networkWork = as_uint64(iter->value);
+        }
+        else if (!strcmp("ThreadAffinity_storageIO", iter->name->string))
+        {
+            eos_config.ThreadAffinity_storageIO = as_uint64(iter->value);
+        }
+        else if (!strcmp("ThreadAffinity_webSocketIO", iter->name->string))
+        {
+            eos_config.ThreadAffinity_webSocketIO = as_uint64(iter->value);
+        }
+        else if (!strcmp("ThreadAffinity_P2PIO", iter->name->string))
+        {
+            eos_config.ThreadAffinity_P2PIO = as_uint64(iter->value);
+        }
+        else if (!strcmp("ThreadAffinity_HTTPRequestIO", iter->name->string))
+        {
+            eos_config.ThreadAffinity_HTTPRequestIO = as_uint64(iter->value);
+        }
+        else if (!strcmp("ThreadAffinity_RTCIO", iter->name->string))
+        {
+            eos_config.ThreadAffinity_RTCIO = as_uint64(iter->value);
+        }
+        else if (!strcmp("memoryAllocatorBackend", iter->name->string))
+        {
+            eos_config.memoryAllocatorBackend = json_value_as_string(iter->value)->string;
+        }
+        else if (!strcmp("isServer", iter->name->string))
+        {
+            eos_config.isServer = json_value_is_true(iter->value);
+        }
+
+        iter = iter->next;
+    }
+
+    return eos_config;
+}
+
+//-------------------------------------------------------------------------
+template<typename Function>
+static double best_ns_per_iteration(Function function)
+{
+    double best_ns = 1.0e30;
+    for (int round = 0; round < kRounds; ++round)
+    {
+        const auto start = bench::clock::now();
+        for (int i = 0; i < kIterations; ++i)
+        {
+            function();
+        }
+        best_ns = std::min(best_ns, bench::elapsed_ns(start, bench::clock::now()) / kIterations);
+    }
+    return best_ns;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    const size_t config_size = strlen(kConfig);
+    json_value_s *config_json = json_parse(kConfig, config_size);
+    BENCH_CHECK(config_json != nullptr);
+
+    // Both read the same, bar the key the chain misspelt
+    EOSConfig from_schema = plugin_bootstrap::eos_config_from_json_value(config_json);
+    EOSConfig from_chain = strcmp_chain_from_json_value(config_json);
+    BENCH_CHECK(from_schema.productName == from_chain.productName && from_schema.encryptionKey == from_chain.encryptionKey);
+    BENCH_CHECK(from_schema.flags == from_chain.flags && from_schema.memoryAllocatorBackend == from_chain.memoryAllocatorBackend);
+    BENCH_CHECK(from_schema.sandboxDeploymentOverrides.size() == 2 && from_chain.sandboxDeploymentOverrides.size() == 2);
+    BENCH_CHECK(from_schema.overrideCountryCode == "GB" && from_chain.overrideCountryCode.empty());
+
+    size_t sink = 0;
+    const double parse_ns = best_ns_per_iteration([&] {
+        json_value_s *json = json_parse(kConfig, config_size);
+        sink += reinterpret_cast<uintptr_t>(json) & 1;
+        free(json);
+    });
+    const double in_source_parse_ns = best_ns_per_iteration([&] {
+        json_value_s *json = json_parse_ex(kConfig, config_size, json_parse_flags_strings_in_source, nullptr, nullptr, nullptr);
+        sink += reinterpret_cast<uintptr_t>(json) & 1;
+        free(json);
+    });
+    const double chain_ns = best_ns_per_iteration([&] {
+        sink += strcmp_chain_from_json_value(config_json).productName.size();
+    });
+    const double schema_ns = best_ns_per_iteration([&] {
+        sink += plugin_bootstrap::eos_config_from_json_value(config_json).productName.size();
+    });
+    free(config_json);
+    BENCH_CHECK(sink != 0);
+
+    size_t copied_dom_size = 0;
+    size_t in_source_dom_size = 0;
+    auto record_size = [](void *user_data, size_t size) -> void * {
+        *static_cast<size_t*>(user_data) = size;
+        return malloc(size);
+    };
+    free(json_parse_ex(kConfig, config_size, json_parse_flags_default, record_size, &copied_dom_size, nullptr));
+    free(json_parse_ex(kConfig, config_size, json_parse_flags_strings_in_source, record_size, &in_source_dom_size, nullptr));
+    const size_t read_peak = config_size + copied_dom_size;
+
+    printf("Filling an EOSConfig from %zu bytes of JSON, best of %d rounds of %d (ns, lower is better)\n", config_size, kRounds, kIterations);
+    printf("  json_parse                          %10.1f\n", parse_ns);
+    printf("  json_parse, strings in source       %10.1f  (%.2fx)\n", in_source_parse_ns, parse_ns / in_source_parse_ns);
+    printf("  bind, strcmp chain                  %10.1f\n", chain_ns);
+    printf("  bind, schema                        %10.1f  (%.2fx)\n", schema_ns, chain_ns / schema_ns);
+    printf("Heap used to load it (bytes, lower is better)\n");
+    printf("  read into a buffer, then parse      %10zu\n", read_peak);
+    printf("  map, then parse in place            %10zu  (%.0f%%)\n", in_source_dom_size, 100.0 * in_source_dom_size / read_peak);
+    return 0;
+}
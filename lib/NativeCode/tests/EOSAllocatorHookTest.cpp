@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Hands the functions from Mem_GetAllocatorFunctions to a stand-in EOS SDK
+// the same way NativeRender's eos_init and EOSManager do, and checks that
+// everything the SDK allocates through them shows up in the counters, for
+// each backend, and is gone again after EOS_Shutdown.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include "StandInEOSSDK.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string>
+
+extern "C" void Mem_GetAllocatorFunctions(void** alloc, void** realloc, void** free);
+extern "C" bool Mem_SetAllocatorBackend(int32_t backend);
+extern "C" bool Mem_GetAllocationCountersEx(void *data);
+
+//-------------------------------------------------------------------------
+static MemCountersEx read_counters()
+{
+    MemCountersEx counters = {};
+    counters.apiVersion = MEM_COUNTERSEX_API_LATEST;
+    BENCH_CHECK(Mem_GetAllocationCountersEx(&counters));
+    return counters;
+}
+
+//-------------------------------------------------------------------------
+// The stand-in is built next to the test
+static std::string stand_in_sdk_path(const char *test_path)
+{
+    std::string path = test_path;
+    const size_t slash = path.rfind('/');
+    path = slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+    return path + "/libStandInEOSSDK.so";
+}
+
+//-------------------------------------------------------------------------
+int main(int, char **argv)
+{
+    void *sdk_handle = dlopen(stand_in_sdk_path(argv[0]).c_str(), RTLD_NOW | RTLD_LOCAL);
+    BENCH_CHECK(sdk_handle != nullptr);
+
+    auto EOS_Initialize_ptr = reinterpret_cast<EOS_Initialize_t>(dlsym(sdk_handle, "EOS_Initialize"));
+    auto EOS_Shutdown_ptr = reinterpret_cast<EOS_Shutdown_t>(dlsym(sdk_handle, "EOS_Shutdown"));
+    auto StandIn_Tick_ptr = reinterpret_cast<StandIn_Tick_t>(dlsym(sdk_handle, "StandIn_Tick"));
+    auto StandIn_GetStats_ptr = reinterpret_cast<StandIn_GetStats_t>(dlsym(sdk_handle, "StandIn_GetStats"));
+    BENCH_CHECK(EOS_Initialize_ptr != nullptr && EOS_Shutdown_ptr != nullptr);
+    BENCH_CHECK(StandIn_Tick_ptr != nullptr && StandIn_GetStats_ptr != nullptr);
+
+    void *alloc_function = nullptr;
+    void *realloc_function = nullptr;
+    void *free_function = nullptr;
+    Mem_GetAllocatorFunctions(&alloc_function, &realloc_function, &free_function);
+    BENCH_CHECK(alloc_function != nullptr && realloc_function != nullptr && free_function != nullptr);
+
+    StandInInitializeOptions options = {};
+    options.ApiVersion = STANDIN_EOS_INITIALIZE_API_LATEST;
+    options.AllocateMemoryFunction = reinterpret_cast<StandInAllocateMemoryFunc>(alloc_function);
+    options.ReallocateMemoryFunction = reinterpret_cast<StandInReallocateMemoryFunc>(realloc_function);
+    options.ReleaseMemoryFunction = reinterpret_cast<StandInReleaseMemoryFunc>(free_function);
+    options.ProductName = "EOSAllocatorHookTest";
+    options.ProductVersion = "1.0";
+
+    const MemAllocatorBackend backends[] = { MemAllocatorBackend::System, MemAllocatorBackend::Pooled };
+    for (MemAllocatorBackend backend : backends)
+    {
+        BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(backend)));
+
+        const MemCountersEx before = read_counters();
+        StandInStats sdk_before = {};
+        StandIn_GetStats_ptr(&sdk_before);
+
+        // What the SDK keeps for as long as it's initialized is live in the
+        // counters, to the byte
+        BENCH_CHECK(EOS_Initialize_ptr(&options) == STANDIN_EOS_SUCCESS);
+        BENCH_CHECK(EOS_Initialize_ptr(&options) == STANDIN_EOS_ALREADY_CONFIGURED);
+
+        MemCountersEx after = read_counters();
+        StandInStats sdk_after = {};
+        StandIn_GetStats_ptr(&sdk_after);
+
+        BENCH_CHECK(sdk_after.liveBytes > sdk_before.liveBytes);
+        BENCH_CHECK(after.currentMemoryAllocatedInBytes - before.currentMemoryAllocatedInBytes == sdk_after.liveBytes - sdk_before.liveBytes);
+        BENCH_CHECK(after.allocCount - before.allocCount == sdk_after.allocCount - sdk_before.allocCount);
+
+        // Short lived blocks come and go without leaving anything behind
+        StandIn_Tick_ptr(20000);
+
+        after = read_counters();
+        StandIn_GetStats_ptr(&sdk_after);
+
+        BENCH_CHECK(sdk_after.reallocCount > sdk_before.reallocCount);
+        BENCH_CHECK(after.allocCount - before.allocCount == sdk_after.allocCount - sdk_before.allocCount);
+        BENCH_CHECK(after.reallocCount - before.reallocCount == sdk_after.reallocCount - sdk_before.reallocCount);
+        BENCH_CHECK(after.freeCount - before.freeCount == sdk_after.freeCount - sdk_before.freeCount);
+        BENCH_CHECK(after.currentMemoryAllocatedInBytes - before.currentMemoryAllocatedInBytes == sdk_after.liveBytes - sdk_before.liveBytes);
+        BENCH_CHECK(after.peakMemoryAllocatedInBytes >= after.currentMemoryAllocatedInBytes);
+
+        // Every alignment the SDK asked for, up to a page, was honoured
+        BENCH_CHECK(sdk_after.misalignedCount == 0);
+
+        BENCH_CHECK(EOS_Shutdown_ptr() == STANDIN_EOS_SUCCESS);
+
+        after = read_counters();
+        StandIn_GetStats_ptr(&sdk_after);
+
+        BENCH_CHECK(sdk_after.liveBytes == sdk_before.liveBytes);
+        BENCH_CHECK(after.currentMemoryAllocatedInBytes == before.currentMemoryAllocatedInBytes);
+
+        printf("%s: %llu allocs, %llu reallocs, %llu frees through the hooks\n",
+            backend == MemAllocatorBackend::Pooled ? "pooled" : "system",
+            static_cast<unsigned long long>(after.allocCount - before.allocCount),
+            static_cast<unsigned long long>(after.reallocCount - before.reallocCount),
+            static_cast<unsigned long long>(after.freeCount - before.freeCount));
+    }
+
+    // The SDK rejects a partial set of hooks, so it's all or nothing
+    StandInInitializeOptions partial_options = options;
+    partial_options.ReallocateMemoryFunction = nullptr;
+    BENCH_CHECK(EOS_Initialize_ptr(&partial_options) == STANDIN_EOS_INVALID_PARAMETERS);
+
+    dlclose(sdk_handle);
+
+    printf("EOSAllocatorHookTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks the EOS dispatch table against a stand-in that exports every
+// function in it: required functions are looked up when the table is
+// resolved and lazy ones only when first called, a library missing a
+// required function is turned away, a missing lazy function returns
+// something harmless, and resolving up front gives the same pointers as
+// dlsym.
+
+#include "BenchmarkCommon.h"
+#include "EOSFunctions.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string.h>
+#include <set>
+#include <string>
+
+typedef const char *(*StandIn_LastCalled_t)();
+
+static const char *kStandInPath = "build/tests/libStandInEOSFunctionTable.so";
+
+namespace
+{
+    size_t s_load_count = 0;
+    const char *s_hidden_name = nullptr;
+}
+
+//-------------------------------------------------------------------------
+// dlsym, counting the lookups and pretending not to have s_hidden_name
+static void * counting_load_function(void *library_handle, const char *function_name)
+{
+    s_load_count++;
+    if (s_hidden_name != nullptr && strcmp(function_name, s_hidden_name) == 0)
+    {
+        return nullptr;
+    }
+    return dlsym(library_handle, function_name);
+}
+
+static_assert(eos_functions::descriptor(EOSFunctionId::EOS_Shutdown).stdcall_argument_bytes == 0, "EOS_Shutdown takes nothing");
+static_assert(eos_functions::descriptor(EOSFunctionId::EOS_Logging_SetLogLevel).stdcall_argument_bytes == 8, "two enums");
+static_assert(eos_functions::descriptor(EOSFunctionId::EOS_Initialize).stdcall_argument_bytes == sizeof(void*), "one pointer");
+static_assert(eos_functions::descriptor(EOSFunctionId::EOS_Platform_Create).binding == EOS_FUNCTION_REQUIRED, "needed to start");
+static_assert(eos_functions::descriptor(EOSFunctionId::EOS_Platform_Tick).binding == EOS_FUNCTION_LAZY, "not needed to start");
+
+//-------------------------------------------------------------------------
+int main()
+{
+    std::set<std::string> names;
+    size_t required_count = 0;
+    for (const EOSFunctionDescriptor& descriptor : eos_functions::descriptors)
+    {
+        BENCH_CHECK(strncmp(descriptor.name, "EOS_", 4) == 0);
+        BENCH_CHECK(names.insert(descriptor.name).second);
+        required_count += descriptor.binding == EOS_FUNCTION_REQUIRED ? 1 : 0;
+    }
+    BENCH_CHECK(strcmp(eos_functions::descriptor(EOSFunctionId::EOS_Platform_GetAuthInterface).name, "EOS_Platform_GetAuthInterface") == 0);
+
+    void *handle = dlopen(kStandInPath, RTLD_NOW | RTLD_LOCAL);
+    BENCH_CHECK(handle != nullptr);
+    auto StandIn_LastCalled = reinterpret_cast<StandIn_LastCalled_t>(dlsym(handle, "StandIn_LastCalled"));
+    BENCH_CHECK(StandIn_LastCalled != nullptr);
+
+    // Only the required functions are looked up to begin with
+    EOSFunctions eos = {};
+    BENCH_CHECK(eos_functions::resolve(handle, &counting_load_function, EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL, &eos));
+    BENCH_CHECK(s_load_count == required_count);
+    BENCH_CHECK(reinterpret_cast<void*>(eos.EOS_Initialize) == dlsym(handle, "EOS_Initialize"));
+    BENCH_CHECK(reinterpret_cast<void*>(eos.EOS_Platform_Tick) != dlsym(handle, "EOS_Platform_Tick"));
+
+    EOS_InitializeOptions initialize_options = {};
+    BENCH_CHECK(eos.EOS_Initialize(&initialize_options) == EOS_EResult::EOS_Success);
+    BENCH_CHECK(strcmp(StandIn_LastCalled(), "EOS_Initialize") == 0);
+
+    // A lazy function is looked up on its first call and not again
+    eos.EOS_Platform_Tick(nullptr);
+    BENCH_CHECK(strcmp(StandIn_LastCalled(), "EOS_Platform_Tick") == 0);
+    BENCH_CHECK(s_load_count == required_count + 1);
+    eos.EOS_Platform_Tick(nullptr);
+    BENCH_CHECK(eos_functions::is_available(EOSFunctionId::EOS_Platform_Tick));
+    BENCH_CHECK(s_load_count == required_count + 1);
+
+    // Missing lazy functions say so rather than crash, and aren't asked for
+    // again
+    EOSFunctions partial = {};
+    s_hidden_name = "EOS_Logging_SetCallback";
+    s_load_count = 0;
+    BENCH_CHECK(eos_functions::resolve(handle, &counting_load_function, EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL, &partial));
+    BENCH_CHECK(partial.EOS_Logging_SetCallback(nullptr) == EOS_EResult::EOS_NotImplemented);
+    BENCH_CHECK(partial.EOS_Logging_SetCallback(nullptr) == EOS_EResult::EOS_NotImplemented);
+    BENCH_CHECK(!eos_functions::is_available(EOSFunctionId::EOS_Logging_SetCallback));
+    BENCH_CHECK(s_load_count == required_count + 1);
+    BENCH_CHECK(strcmp(StandIn_LastCalled(), "EOS_Platform_Tick") == 0);
+
+    s_hidden_name = "EOS_Platform_GetAuthInterface";
+    BENCH_CHECK(eos_functions::resolve(handle, &counting_load_function, EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL, &partial));
+    BENCH_CHECK(partial.EOS_Platform_GetAuthInterface(nullptr) == nullptr);
+    s_hidden_name = "EOS_Platform_Tick";
+    BENCH_CHECK(eos_functions::resolve(handle, &counting_load_function, EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL, &partial));
+    partial.EOS_Platform_Tick(nullptr);
+    BENCH_CHECK(strcmp(StandIn_LastCalled(), "EOS_Platform_Tick") == 0);
+
+    // A library without a required function is turned away, with nothing
+    // left behind for lazy functions to find
+    s_hidden_name = "EOS_Platform_Create";
+    const char *missing_name = nullptr;
+    EOSFunctions rejected = {};
+    BENCH_CHECK(!eos_functions::resolve(handle, &counting_load_function, EOS_FUNCTIONS_RESOLVE_ON_FIRST_CALL, &rejected, &missing_name));
+    BENCH_CHECK(missing_name != nullptr && strcmp(missing_name, "EOS_Platform_Create") == 0);
+    BENCH_CHECK(rejected.EOS_Initialize == nullptr);
+    BENCH_CHECK(!eos_functions::is_available(EOSFunctionId::EOS_Initialize));
+    BENCH_CHECK(eos.EOS_Logging_SetLogLevel(EOS_ELogCategory::EOS_LC_ALL_CATEGORIES, EOS_ELogLevel::EOS_LOG_Error) == EOS_EResult::EOS_NotImplemented);
+
+    // Up front, everything is looked up and called directly
+    s_hidden_name = nullptr;
+    s_load_count = 0;
+    BENCH_CHECK(eos_functions::resolve(handle, &counting_load_function, EOS_FUNCTIONS_RESOLVE_UP_FRONT, &eos));
+    BENCH_CHECK(s_load_count == eos_functions::function_count);
+#define EOS_FUNCTION(name, binding) BENCH_CHECK(reinterpret_cast<void*>(eos.name) == dlsym(handle, #name));
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+    BENCH_CHECK(eos.EOS_Logging_SetLogLevel(EOS_ELogCategory::EOS_LC_ALL_CATEGORIES, EOS_ELogLevel::EOS_LOG_Error) == EOS_EResult::EOS_Success);
+    BENCH_CHECK(strcmp(StandIn_LastCalled(), "EOS_Logging_SetLogLevel") == 0);
+    BENCH_CHECK(s_load_count == eos_functions::function_count);
+
+    eos_functions::reset();
+    dlclose(handle);
+
+    printf("EOSFunctionsTest: ok (%zu functions, %zu required)\n", eos_functions::function_count, required_count);
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that the sampling heap profiler's estimates land close to the
+// real live bytes per call site, and measures what it costs per allocation
+// when it's off and at a couple of sampling intervals.
+
+#include "BenchmarkCommon.h"
+#include "HeapProfiler.h"
+#include "Memory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" void Mem_SetHeapProfileSampleInterval(uint64_t interval_in_bytes);
+extern "C" bool Mem_WriteHeapProfile(const char *path, int32_t format);
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+static const char *kProfilePath = "build/tests/heap_profile.txt";
+
+//-------------------------------------------------------------------------
+extern "C" BENCH_NOINLINE void *allocate_small_blocks_site(size_t size)
+{
+    // Touching the block keeps this from becoming a tail call, which would
+    // leave the function out of the backtrace
+    void *block = Mem_generic_align_alloc(size, 16);
+    memset(block, 0, size < 64 ? size : 64);
+    return block;
+}
+
+//-------------------------------------------------------------------------
+extern "C" BENCH_NOINLINE void *allocate_large_blocks_site(size_t size)
+{
+    // Touching the block keeps this from becoming a tail call, which would
+    // leave the function out of the backtrace
+    void *block = Mem_generic_align_alloc(size, 16);
+    memset(block, 0, size < 64 ? size : 64);
+    return block;
+}
+
+//-------------------------------------------------------------------------
+static std::string read_file(const char *path)
+{
+    std::string contents;
+    FILE *file = fopen(path, "r");
+    BENCH_CHECK(file != nullptr);
+
+    char buffer[4096];
+    size_t read_count = 0;
+    while ((read_count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        contents.append(buffer, read_count);
+    }
+    fclose(file);
+    return contents;
+}
+
+//-------------------------------------------------------------------------
+// Sum of the bytes on collapsed stack lines that mention site
+static double collapsed_bytes_for(const std::string& profile, const char *site)
+{
+    double total = 0;
+    size_t line_start = 0;
+    while (line_start < profile.size())
+    {
+        size_t line_end = profile.find('\n', line_start);
+        if (line_end == std::string::npos)
+        {
+            line_end = profile.size();
+        }
+
+        const std::string line = profile.substr(line_start, line_end - line_start);
+        if (line.find(site) != std::string::npos)
+        {
+            total += atof(line.c_str() + line.rfind(' ') + 1);
+        }
+        line_start = line_end + 1;
+    }
+    return total;
+}
+
+//-------------------------------------------------------------------------
+static void check_estimates()
+{
+    const size_t small_count = 40000;
+    const size_t small_size = 256;
+    const size_t large_count = 1000;
+    const size_t large_size = 16 * 1024;
+
+    Mem_SetHeapProfileSampleInterval(4096);
+
+    std::vector<void*> small_blocks;
+    std::vector<void*> large_blocks;
+    for (size_t i = 0; i < small_count; ++i)
+    {
+        small_blocks.push_back(allocate_small_blocks_site(small_size));
+    }
+    for (size_t i = 0; i < large_count; ++i)
+    {
+        large_blocks.push_back(allocate_large_blocks_site(large_size));
+    }
+
+    BENCH_CHECK(Mem_WriteHeapProfile(kProfilePath, static_cast<int32_t>(HeapProfileFormat::CollapsedStacks)));
+    std::string profile = read_file(kProfilePath);
+
+    const double small_estimate = collapsed_bytes_for(profile, "allocate_small_blocks_site");
+    const double large_estimate = collapsed_bytes_for(profile, "allocate_large_blocks_site");
+    const double small_actual = static_cast<double>(small_count * small_size);
+    const double large_actual = static_cast<double>(large_count * large_size);
+    printf("collapsed stack estimates: small site %.0f of %.0f bytes, large site %.0f of %.0f bytes\n",
+        small_estimate, small_actual, large_estimate, large_actual);
+    BENCH_CHECK(small_estimate > small_actual * 0.85 && small_estimate < small_actual * 1.15);
+    BENCH_CHECK(large_estimate > large_actual * 0.85 && large_estimate < large_actual * 1.15);
+
+    BENCH_CHECK(Mem_WriteHeapProfile(kProfilePath, static_cast<int32_t>(HeapProfileFormat::Pprof)));
+    profile = read_file(kProfilePath);
+    BENCH_CHECK(profile.compare(0, 14, "heap profile: ") == 0);
+    BENCH_CHECK(profile.find("@ heap_v2/1\n") != std::string::npos);
+    BENCH_CHECK(profile.find("MAPPED_LIBRARIES:") != std::string::npos);
+
+    // Freed blocks drop out of the live profile, and turning sampling off
+    // stops new samples
+    for (void *block : small_blocks)
+    {
+        Mem_generic_free(block);
+    }
+    Mem_SetHeapProfileSampleInterval(0);
+    const size_t samples_left = heap_profiler::live_sample_count();
+    void *unsampled = allocate_small_blocks_site(1024 * 1024);
+    BENCH_CHECK(heap_profiler::live_sample_count() == samples_left);
+    Mem_generic_free(unsampled);
+
+    BENCH_CHECK(Mem_WriteHeapProfile(kProfilePath, static_cast<int32_t>(HeapProfileFormat::CollapsedStacks)));
+    profile = read_file(kProfilePath);
+    BENCH_CHECK(collapsed_bytes_for(profile, "allocate_small_blocks_site") == 0);
+    BENCH_CHECK(collapsed_bytes_for(profile, "allocate_large_blocks_site") > 0);
+
+    for (void *block : large_blocks)
+    {
+        Mem_generic_free(block);
+    }
+    BENCH_CHECK(heap_profiler::live_sample_count() == 0);
+    remove(kProfilePath);
+}
+
+//-------------------------------------------------------------------------
+// ns per alloc/free pair through Mem_generic_*
+static double time_alloc_free(uint64_t interval_in_bytes)
+{
+    const size_t iterations = 2000000;
+    bench::Random random;
+    void *blocks[16] = {};
+
+    Mem_SetHeapProfileSampleInterval(interval_in_bytes);
+    auto start = bench::clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        void*& block = blocks[i & 15];
+        Mem_generic_free(block);
+        block = Mem_generic_align_alloc(random.range(16, 512), 16);
+    }
+    const double elapsed = bench::elapsed_ns(start, bench::clock::now());
+
+    for (void*& block : blocks)
+    {
+        Mem_generic_free(block);
+    }
+    Mem_SetHeapProfileSampleInterval(0);
+
+    return elapsed / iterations;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    check_estimates();
+
+    printf("Heap profiler cost (ns per Mem_generic_* alloc/free pair)\n");
+    printf("%-24s %10s\n", "sampling", "ns");
+    printf("%-24s %10.1f\n", "off", time_alloc_free(0));
+    printf("%-24s %10.1f\n", "every 512KiB", time_alloc_free(512 * 1024));
+    printf("%-24s %10.1f\n", "every 4KiB", time_alloc_free(4 * 1024));
+    printf("%-24s %10.1f\n", "off again", time_alloc_free(0));
+
+    return 0;
+}
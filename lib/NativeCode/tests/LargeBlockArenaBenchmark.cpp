@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compares the large block arena with the regular allocator on the two
+// things it's for:
+//
+//   churn         allocate a buffer of 256KiB-2MiB, fill it, free it, the
+//                 way transfer and audio buffers come and go. Each fresh
+//                 mapping page faults on every 4KiB page; the arena hands
+//                 back pages it already has.
+//   packet path   random 64 byte reads over 64MiB of live buffers, which
+//                 is mostly TLB misses on 4KiB pages. On Linux the arena
+//                 asks for transparent huge pages.
+//
+// Page faults come from getrusage, huge pages from /proc/self/smaps_rollup.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_GetAllocationCountersEx(void *data);
+extern "C" bool Mem_SetLargeBlockArena(uint64_t threshold_in_bytes, uint64_t capacity_in_bytes);
+
+#define KIB 1024
+#define MIB (1024 * 1024)
+
+static const int kChurnIterations = 4000;
+static const size_t kPacketBufferCount = 32;
+static const size_t kPacketBufferSize = 2 * MIB;
+static const int kPacketReads = 20 * 1000 * 1000;
+
+struct RunResult
+{
+    double churn_ns_per_buffer;
+    double churn_faults_per_buffer;
+    double packet_ns_per_read;
+    long long huge_page_kib;
+};
+
+//-------------------------------------------------------------------------
+static long long minor_faults()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+//-------------------------------------------------------------------------
+// -1 where the kernel doesn't say
+static long long anon_huge_page_kib()
+{
+    FILE *rollup = fopen("/proc/self/smaps_rollup", "r");
+    if (rollup == nullptr)
+    {
+        return -1;
+    }
+
+    char line[256];
+    long long kib = -1;
+    while (fgets(line, sizeof(line), rollup) != nullptr)
+    {
+        if (sscanf(line, "AnonHugePages: %lld kB", &kib) == 1)
+        {
+            break;
+        }
+    }
+    fclose(rollup);
+    return kib;
+}
+
+//-------------------------------------------------------------------------
+static RunResult run()
+{
+    RunResult result = {};
+    bench::Random random;
+
+    const long long faults_before = minor_faults();
+    auto start = bench::clock::now();
+    for (int i = 0; i < kChurnIterations; ++i)
+    {
+        const size_t size = random.range(256 * KIB, 2 * MIB);
+        char *buffer = static_cast<char*>(Mem_generic_align_alloc(size, 16));
+        BENCH_CHECK(buffer != nullptr);
+        for (size_t offset = 0; offset < size; offset += 4096)
+        {
+            buffer[offset] = static_cast<char>(i);
+        }
+        Mem_generic_free(buffer);
+    }
+    result.churn_ns_per_buffer = bench::elapsed_ns(start, bench::clock::now()) / kChurnIterations;
+    result.churn_faults_per_buffer = static_cast<double>(minor_faults() - faults_before) / kChurnIterations;
+
+    std::vector<char*> buffers;
+    for (size_t i = 0; i < kPacketBufferCount; ++i)
+    {
+        char *buffer = static_cast<char*>(Mem_generic_align_alloc(kPacketBufferSize, 16));
+        BENCH_CHECK(buffer != nullptr);
+        memset(buffer, static_cast<int>(i), kPacketBufferSize);
+        buffers.push_back(buffer);
+    }
+    result.huge_page_kib = anon_huge_page_kib();
+
+    uint64_t checksum = 0;
+    start = bench::clock::now();
+    for (int i = 0; i < kPacketReads; ++i)
+    {
+        const uint64_t bits = random.next();
+        const char *buffer = buffers[bits % kPacketBufferCount];
+        checksum += static_cast<unsigned char>(buffer[(bits >> 8) % (kPacketBufferSize / 64) * 64]);
+    }
+    result.packet_ns_per_read = bench::elapsed_ns(start, bench::clock::now()) / kPacketReads;
+    BENCH_CHECK(checksum != 0);
+
+    for (char *buffer : buffers)
+    {
+        Mem_generic_free(buffer);
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    const RunResult system = run();
+
+    BENCH_CHECK(Mem_SetLargeBlockArena(256 * KIB, 256 * MIB));
+    const RunResult arena = run();
+
+    MemCountersEx counters = {};
+    counters.apiVersion = MEM_COUNTERSEX_API_LATEST;
+    BENCH_CHECK(Mem_GetAllocationCountersEx(&counters));
+    BENCH_CHECK(Mem_SetLargeBlockArena(0, 0));
+
+    printf("%-8s %14s %16s %15s %16s\n", "", "churn ns/buf", "churn faults/buf", "packet ns/read", "AnonHugePages");
+    printf("%-8s %14.0f %16.1f %15.2f %13lld KiB\n", "system", system.churn_ns_per_buffer, system.churn_faults_per_buffer, system.packet_ns_per_read, system.huge_page_kib);
+    printf("%-8s %14.0f %16.1f %15.2f %13lld KiB\n", "arena", arena.churn_ns_per_buffer, arena.churn_faults_per_buffer, arena.packet_ns_per_read, arena.huge_page_kib);
+    printf("arena peak %.1f MiB used, %.1f MiB committed at the end, %.1f MiB explicitly huge\n",
+        counters.largeBlockPeakUsedInBytes / double(MIB), counters.largeBlockCommittedInBytes / double(MIB), counters.largeBlockExplicitHugePageInBytes / double(MIB));
+
+    // Reusing committed pages is the point, whatever the OS does about
+    // huge pages
+    BENCH_CHECK(arena.churn_faults_per_buffer < system.churn_faults_per_buffer);
+
+    return 0;
+}
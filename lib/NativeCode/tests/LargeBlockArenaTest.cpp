@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that Mem_SetLargeBlockArena routes allocations at or over the
+// threshold into the arena, that its runs are reused, coalesced and
+// resized in place, that blocks move in and out of it on realloc with their
+// contents, that a full arena falls back to the regular backends, and that
+// the counters report it separately.
+
+#include "BenchmarkCommon.h"
+#include "LargeBlockArena.h"
+#include "Memory.h"
+#include <stdio.h>
+#include <string.h>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_GetAllocationCountersEx(void *data);
+extern "C" bool Mem_SetLargeBlockArena(uint64_t threshold_in_bytes, uint64_t capacity_in_bytes);
+extern "C" uint64_t Mem_Trim();
+
+#define KIB 1024
+#define MIB (1024 * 1024)
+#define PAGE LARGE_BLOCK_ARENA_PAGE_SIZE
+
+//-------------------------------------------------------------------------
+static MemCountersEx read_counters()
+{
+    MemCountersEx counters = {};
+    counters.apiVersion = MEM_COUNTERSEX_API_LATEST;
+    BENCH_CHECK(Mem_GetAllocationCountersEx(&counters));
+    return counters;
+}
+
+//-------------------------------------------------------------------------
+static void fill(void *block, size_t size_in_bytes, unsigned char seed)
+{
+    unsigned char *bytes = static_cast<unsigned char*>(block);
+    for (size_t i = 0; i < size_in_bytes; ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(seed + i * 31);
+    }
+}
+
+//-------------------------------------------------------------------------
+static bool holds(const void *block, size_t size_in_bytes, unsigned char seed)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(block);
+    for (size_t i = 0; i < size_in_bytes; ++i)
+    {
+        if (bytes[i] != static_cast<unsigned char>(seed + i * 31))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    // Off until asked for
+    void *before = Mem_generic_align_alloc(1 * MIB, 16);
+    BENCH_CHECK(before != nullptr && !large_block_arena::owns(before));
+    Mem_generic_free(before);
+
+    BENCH_CHECK(Mem_SetLargeBlockArena(256 * KIB, 32 * MIB));
+
+    // Only the threshold and up goes to the arena, page aligned
+    void *small = Mem_generic_align_alloc(256 * KIB - 1, 16);
+    void *a = Mem_generic_align_alloc(256 * KIB, 16);
+    void *b = Mem_generic_align_alloc(300 * KIB, 4096);
+    void *c = Mem_generic_align_alloc(256 * KIB, 16);
+    BENCH_CHECK(small != nullptr && !large_block_arena::owns(small));
+    BENCH_CHECK(large_block_arena::owns(a) && large_block_arena::owns(b) && large_block_arena::owns(c));
+    BENCH_CHECK(reinterpret_cast<uintptr_t>(a) % PAGE == 0 && reinterpret_cast<uintptr_t>(b) % PAGE == 0);
+    BENCH_CHECK(static_cast<char*>(b) == static_cast<char*>(a) + 4 * PAGE);
+    BENCH_CHECK(static_cast<char*>(c) == static_cast<char*>(b) + 5 * PAGE);
+
+    // More alignment than a page isn't the arena's business
+    void *over_aligned = Mem_generic_align_alloc(512 * KIB, 2 * MIB);
+    BENCH_CHECK(over_aligned != nullptr && !large_block_arena::owns(over_aligned));
+    BENCH_CHECK(reinterpret_cast<uintptr_t>(over_aligned) % (2 * MIB) == 0);
+    Mem_generic_free(over_aligned);
+
+    MemCountersEx counters = read_counters();
+    BENCH_CHECK(counters.largeBlockUsedInBytes == 13 * PAGE);
+    BENCH_CHECK(counters.largeBlockCommittedInBytes == PLATFORM_HUGE_PAGE_SIZE);
+    BENCH_CHECK(counters.largeBlockAllocCount == 3);
+    BENCH_CHECK(counters.largeBlockExplicitHugePageInBytes <= counters.largeBlockCommittedInBytes);
+
+    // Callers built against version 2 get everything up to the threads,
+    // and nothing is written past them
+    {
+        unsigned char buffer[sizeof(MemCountersEx)];
+        memset(buffer, 0xab, sizeof(buffer));
+        reinterpret_cast<MemCountersEx*>(buffer)->apiVersion = 2;
+        BENCH_CHECK(Mem_GetAllocationCountersEx(buffer));
+        BENCH_CHECK(reinterpret_cast<MemCountersEx*>(buffer)->currentMemoryAllocatedInBytes == counters.currentMemoryAllocatedInBytes);
+        for (size_t i = offsetof(MemCountersEx, largeBlockCommittedInBytes); i < sizeof(buffer); ++i)
+        {
+            BENCH_CHECK(buffer[i] == 0xab);
+        }
+    }
+
+    // Neighbouring free runs coalesce, and the merged run is reused
+    Mem_generic_free(a);
+    Mem_generic_free(b);
+    void *merged = Mem_generic_align_alloc(9 * PAGE, 16);
+    BENCH_CHECK(merged == a);
+    Mem_generic_free(merged);
+
+    // A block before a free run grows into it without moving; one at the
+    // end of what's been handed out grows into fresh pages
+    void *d = Mem_generic_align_alloc(4 * PAGE, 16);
+    BENCH_CHECK(d == a);
+    fill(d, 4 * PAGE, 1);
+    void *grown = Mem_generic_align_realloc(d, 9 * PAGE, 16);
+    BENCH_CHECK(grown == d && holds(grown, 4 * PAGE, 1));
+
+    fill(c, 256 * KIB, 2);
+    void *grown_at_end = Mem_generic_align_realloc(c, 3 * MIB, 16);
+    BENCH_CHECK(grown_at_end == c && holds(grown_at_end, 256 * KIB, 2));
+    BENCH_CHECK(read_counters().largeBlockCommittedInBytes == 2 * PLATFORM_HUGE_PAGE_SIZE);
+
+    // Shrinking gives the tail back, even below the threshold
+    const int64_t used_before_shrink = read_counters().largeBlockUsedInBytes;
+    void *shrunk = Mem_generic_align_realloc(grown, 100 * KIB, 16);
+    BENCH_CHECK(shrunk == grown && holds(shrunk, 100 * KIB, 1));
+    BENCH_CHECK(read_counters().largeBlockUsedInBytes == used_before_shrink - 7 * PAGE);
+
+    // Blocks that grow past the threshold move in, contents and all
+    fill(small, 256 * KIB - 1, 3);
+    void *moved_in = Mem_generic_align_realloc(small, 512 * KIB, 16);
+    BENCH_CHECK(large_block_arena::owns(moved_in) && holds(moved_in, 256 * KIB - 1, 3));
+
+    // A block blocked in by its neighbour moves within the arena
+    void *blocked = Mem_generic_align_realloc(shrunk, 8 * MIB, 16);
+    BENCH_CHECK(blocked != shrunk && large_block_arena::owns(blocked) && holds(blocked, 100 * KIB, 1));
+
+    // Reconfiguring under live blocks isn't allowed
+    BENCH_CHECK(!Mem_SetLargeBlockArena(128 * KIB, 64 * MIB));
+
+    // Once the arena is full, large blocks come from the regular backends
+    void *too_big = Mem_generic_align_alloc(32 * MIB, 16);
+    BENCH_CHECK(too_big != nullptr && !large_block_arena::owns(too_big));
+    fill(too_big, 1 * MIB, 4);
+    Mem_generic_free(too_big);
+
+    Mem_generic_free(blocked);
+    Mem_generic_free(moved_in);
+    Mem_generic_free(grown_at_end);
+
+    counters = read_counters();
+    BENCH_CHECK(counters.largeBlockUsedInBytes == 0);
+    BENCH_CHECK(counters.largeBlockPeakUsedInBytes >= 8 * MIB);
+
+    // Freed memory stays committed for the next block until trimmed
+    BENCH_CHECK(counters.largeBlockCommittedInBytes > 0);
+    Mem_Trim();
+    BENCH_CHECK(read_counters().largeBlockCommittedInBytes == 0);
+
+    // Committed again on demand, and zeroed
+    void *again = Mem_generic_align_alloc(1 * MIB, 16);
+    BENCH_CHECK(large_block_arena::owns(again));
+    BENCH_CHECK(static_cast<unsigned char*>(again)[123] == 0);
+    Mem_generic_free(again);
+
+    BENCH_CHECK(Mem_SetLargeBlockArena(0, 0));
+    void *after = Mem_generic_align_alloc(1 * MIB, 16);
+    BENCH_CHECK(after != nullptr && !large_block_arena::owns(after));
+    Mem_generic_free(after);
+    BENCH_CHECK(read_counters().largeBlockCommittedInBytes == 0);
+
+    printf("LargeBlockArenaTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Times growing a single 64 byte aligned buffer up to 128MiB, the way a
+// receive or file buffer grows, with three realloc strategies:
+//
+//   copy           allocate, copy, free: the only way to keep alignment
+//                  with the C library alone
+//   libc realloc   what the allocator used to do; fast, but the result is
+//                  only malloc aligned
+//   platform::     header prefixed blocks, mremap for mapped blocks
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const size_t kAlignment = 64;
+static const size_t kStartSize = 64 * 1024;
+static const size_t kFinalSize = 128 * 1024 * 1024;
+
+struct Strategy
+{
+    const char *name;
+    void *(*alloc)(size_t, size_t);
+    void *(*realloc)(void*, size_t, size_t, size_t);
+    void (*free)(void*);
+};
+
+struct GrowthResult
+{
+    double elapsed_ms;
+    size_t moves;
+    size_t misaligned;
+};
+
+//-------------------------------------------------------------------------
+static void *libc_alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    void *pointer = nullptr;
+    return posix_memalign(&pointer, alignment_in_bytes, size_in_bytes) == 0 ? pointer : nullptr;
+}
+
+//-------------------------------------------------------------------------
+static void *copy_realloc(void *pointer, size_t old_size, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    void *to_return = libc_alloc(size_in_bytes, alignment_in_bytes);
+    memcpy(to_return, pointer, old_size < size_in_bytes ? old_size : size_in_bytes);
+    free(pointer);
+    return to_return;
+}
+
+//-------------------------------------------------------------------------
+static void *libc_realloc(void *pointer, size_t, size_t size_in_bytes, size_t)
+{
+    return realloc(pointer, size_in_bytes);
+}
+
+//-------------------------------------------------------------------------
+static void *platform_realloc(void *pointer, size_t, size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    return platform::realloc_aligned(pointer, size_in_bytes, alignment_in_bytes);
+}
+
+//-------------------------------------------------------------------------
+// Touch every page that's been added so the work isn't deferred to later
+static void touch(void *pointer, size_t from, size_t to)
+{
+    for (size_t offset = from; offset < to; offset += 4096)
+    {
+        static_cast<char*>(pointer)[offset] = 1;
+    }
+}
+
+//-------------------------------------------------------------------------
+static GrowthResult grow(const Strategy& strategy, size_t (*next_size)(size_t))
+{
+    GrowthResult result = {};
+
+    auto start = bench::clock::now();
+    size_t size = kStartSize;
+    void *buffer = strategy.alloc(size, kAlignment);
+    touch(buffer, 0, size);
+
+    while (size < kFinalSize)
+    {
+        const size_t new_size = next_size(size);
+        void *grown = strategy.realloc(buffer, size, new_size, kAlignment);
+        BENCH_CHECK(grown != nullptr);
+
+        result.moves += grown != buffer ? 1 : 0;
+        result.misaligned += (reinterpret_cast<uintptr_t>(grown) % kAlignment) != 0 ? 1 : 0;
+        touch(grown, size, new_size);
+
+        buffer = grown;
+        size = new_size;
+    }
+    strategy.free(buffer);
+    result.elapsed_ms = bench::elapsed_ms(start, bench::clock::now());
+
+    return result;
+}
+
+//-------------------------------------------------------------------------
+static size_t grow_linear(size_t size)
+{
+    return size + 1024 * 1024;
+}
+
+//-------------------------------------------------------------------------
+static size_t grow_geometric(size_t size)
+{
+    return size + size / 2;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    const Strategy strategies[] =
+    {
+        { "copy", &libc_alloc, &copy_realloc, &free },
+        { "libc realloc", &libc_alloc, &libc_realloc, &free },
+        { "platform::", &platform::alloc_aligned, &platform_realloc, &platform::free_aligned },
+    };
+    struct Growth
+    {
+        const char *name;
+        size_t (*next_size)(size_t);
+    };
+    const Growth growths[] =
+    {
+        { "+1MiB steps", &grow_linear },
+        { "x1.5 steps", &grow_geometric },
+    };
+
+    printf("Growing a %zu byte aligned buffer from 64KiB to 128MiB (ms, lower is better)\n", kAlignment);
+    printf("%-14s %-14s %10s %8s %11s\n", "growth", "strategy", "ms", "moves", "misaligned");
+    for (const Growth& growth : growths)
+    {
+        for (const Strategy& strategy : strategies)
+        {
+            const GrowthResult result = grow(strategy, growth.next_size);
+            printf("%-14s %-14s %10.2f %8zu %11zu\n", growth.name, strategy.name, result.elapsed_ms, result.moves, result.misaligned);
+        }
+    }
+
+    return 0;
+}
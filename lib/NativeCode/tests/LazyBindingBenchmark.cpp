@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Times binding every function in EOSFunctionTable.inl against a stand-in
+// that exports the same names, the way managed code binds the SDK at
+// startup: eagerly, where every name is looked up before the first call,
+// and through lazy stubs, where only the functions that get called are.
+// Each round binds into a new DLLHContext, so nothing is cached from the
+// last one. Also times a call through a stub that has resolved against a
+// call straight to the function.
+
+#include "BenchmarkCommon.h"
+#include "LazyStubs.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+extern "C" void *DLLH_create_context();
+extern "C" void DLLH_destroy_context(void *context);
+extern "C" void *DLLH_load_library_at_path(void *ctx, const char *library_path);
+extern "C" size_t DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count);
+extern "C" size_t DLLH_load_functions_lazily(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count);
+extern "C" size_t DLLH_release_functions(void *ctx, void *library_handle);
+extern "C" bool DLLH_unload_library_at_path(void *ctx, void *library_handle);
+
+typedef uintptr_t (*NoArguments_t)();
+typedef size_t (*LoadFunctions_t)(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count);
+
+static const char *kStandInPath = "build/tests/libStandInEOSFunctionTable.so";
+static const int kRounds = 50;
+static const int kCalls = 10000000;
+
+// About what a session calls before it's logged in: one in every 25
+static const size_t kStartupStride = 25;
+
+static const char *s_names[] =
+{
+#define EOS_FUNCTION(name, binding) #name,
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+};
+
+static const size_t kFunctionCount = sizeof(s_names) / sizeof(s_names[0]);
+
+//-------------------------------------------------------------------------
+// Median of kRounds, in microseconds, of binding every function and then
+// calling every kStartupStride'th one, or none if call_stride is 0
+static double time_binding(LoadFunctions_t load_functions, size_t call_stride)
+{
+    std::vector<void*> functions(kFunctionCount);
+    std::vector<double> samples;
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        void *ctx = DLLH_create_context();
+        void *handle = DLLH_load_library_at_path(ctx, kStandInPath);
+        BENCH_CHECK(handle != nullptr);
+
+        const bench::clock::time_point start = bench::clock::now();
+        BENCH_CHECK(load_functions(ctx, handle, s_names, functions.data(), kFunctionCount) == kFunctionCount);
+        for (size_t i = 0; call_stride != 0 && i < kFunctionCount; i += call_stride)
+        {
+            BENCH_CHECK(reinterpret_cast<NoArguments_t>(functions[i])() == 0);
+        }
+        const bench::clock::time_point end = bench::clock::now();
+        samples.push_back(bench::elapsed_ns(start, end) / 1.0e3);
+
+        DLLH_release_functions(ctx, handle);
+        BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+        DLLH_destroy_context(ctx);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+//-------------------------------------------------------------------------
+static double time_calls(NoArguments_t function)
+{
+    uintptr_t total = 0;
+    const bench::clock::time_point start = bench::clock::now();
+    for (int i = 0; i < kCalls; ++i)
+    {
+        total += function();
+    }
+    const bench::clock::time_point end = bench::clock::now();
+    BENCH_CHECK(total == 0);
+    return bench::elapsed_ns(start, end) / kCalls;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    if (!lazy_stubs::is_supported())
+    {
+        printf("LazyBindingBenchmark: skipped, no lazy stubs on this platform\n");
+        return 0;
+    }
+
+    // Held open for the whole run, so that the rounds time binding rather
+    // than mapping the library in again
+    void *pinned = dlopen(kStandInPath, RTLD_NOW);
+    BENCH_CHECK(pinned != nullptr);
+
+    const size_t startup_calls = (kFunctionCount + kStartupStride - 1) / kStartupStride;
+    printf("LazyBindingBenchmark: %zu functions, %d rounds, median of each\n", kFunctionCount, kRounds);
+
+    const double eager = time_binding(&DLLH_load_functions_with_names, 0);
+    const double lazy = time_binding(&DLLH_load_functions_lazily, 0);
+    printf("  %-40s %9.1f us\n", "eager, bind all", eager);
+    printf("  %-40s %9.1f us  (%.1fx)\n", "lazy, bind all", lazy, eager / lazy);
+
+    const double eager_startup = time_binding(&DLLH_load_functions_with_names, kStartupStride);
+    const double lazy_startup = time_binding(&DLLH_load_functions_lazily, kStartupStride);
+    char label[64];
+    snprintf(label, sizeof(label), "eager, bind all, call %zu", startup_calls);
+    printf("  %-40s %9.1f us\n", label, eager_startup);
+    snprintf(label, sizeof(label), "lazy, bind all, call %zu", startup_calls);
+    printf("  %-40s %9.1f us  (%.1fx)\n", label, lazy_startup, eager_startup / lazy_startup);
+
+    // A stub that has resolved costs one more indirect jump per call
+    void *ctx = DLLH_create_context();
+    void *handle = DLLH_load_library_at_path(ctx, kStandInPath);
+    const char *tick_name = "EOS_Platform_Tick";
+    void *tick_stub = nullptr;
+    BENCH_CHECK(DLLH_load_functions_lazily(ctx, handle, &tick_name, &tick_stub, 1) == 1);
+    NoArguments_t tick = reinterpret_cast<NoArguments_t>(dlsym(handle, tick_name));
+    BENCH_CHECK(tick != nullptr && tick_stub != reinterpret_cast<void*>(tick));
+    printf("  %-40s %9.2f ns\n", "call, direct", time_calls(tick));
+    printf("  %-40s %9.2f ns\n", "call, through resolved stub", time_calls(reinterpret_cast<NoArguments_t>(tick_stub)));
+
+    DLLH_release_functions(ctx, handle);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+    DLLH_destroy_context(ctx);
+    dlclose(pinned);
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks the lazy stubs the Linux DLLH hands out: nothing is looked up
+// until a stub is first called and then only once, arguments in registers
+// and on the stack arrive intact, a function the library doesn't export
+// gets no stub, calling a stub whose function has gone aborts, first calls
+// can race, and stubs keep the library loaded like any other function
+// pointer until they're released.
+
+#include "BenchmarkCommon.h"
+#include "LazyStubs.h"
+#include "LoaderTrace.h"
+#include <dlfcn.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+extern "C" void *DLLH_create_context();
+extern "C" void DLLH_destroy_context(void *context);
+extern "C" void *DLLH_load_library_at_path(void *ctx, const char *library_path);
+extern "C" void *DLLH_load_function_with_name(void *ctx, void *library_handle, const char *function);
+extern "C" void *DLLH_load_function_lazily(void *ctx, void *library_handle, const char *function);
+extern "C" size_t DLLH_load_functions_lazily(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count);
+extern "C" size_t DLLH_release_functions(void *ctx, void *library_handle);
+extern "C" bool DLLH_unload_library_at_path(void *ctx, void *library_handle);
+extern "C" void DLLH_set_loader_trace(bool enabled);
+extern "C" int64_t DLLH_query_loader_info(int32_t api_version, int32_t query, void *buffer, uint64_t capacity);
+
+typedef uintptr_t (*NoArguments_t)();
+typedef const char *(*LastCalled_t)();
+typedef double (*SumArguments_t)(int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t,
+    double, double, double, double, double, double, double, double, double, double);
+
+static const char *kStandInPath = "build/tests/libStandInEOSFunctionTable.so";
+static const int kThreadCount = 8;
+
+//-------------------------------------------------------------------------
+static size_t symbol_lookups(const char *function)
+{
+    const int64_t count = DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_EVENTS, nullptr, 0);
+    BENCH_CHECK(count >= 0);
+
+    std::vector<DLLHLoaderEvent> events(static_cast<size_t>(count));
+    BENCH_CHECK(DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_EVENTS, events.data(), events.size()) == count);
+
+    size_t lookups = 0;
+    for (const DLLHLoaderEvent& event : events)
+    {
+        if (event.operation == DLLH_LOADER_SYMBOL && strcmp(event.name, function) == 0)
+        {
+            ++lookups;
+        }
+    }
+    return lookups;
+}
+
+//-------------------------------------------------------------------------
+static double sum_arguments(SumArguments_t function, int64_t seed)
+{
+    return function(seed, -2, 3, seed * 4, -5, 6, 7, seed - 8,
+        0.5, -1.5, 2.25, 3.0 * seed, -4.75, 5.5, 6.125, 7.0, -8.5, 9.25 * seed);
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    if (!lazy_stubs::is_supported())
+    {
+        printf("LazyStubTest: skipped, no lazy stubs on this platform\n");
+        return 0;
+    }
+
+    void *ctx = DLLH_create_context();
+    void *handle = DLLH_load_library_at_path(ctx, kStandInPath);
+    BENCH_CHECK(handle != nullptr);
+    LastCalled_t last_called = reinterpret_cast<LastCalled_t>(dlsym(handle, "StandIn_LastCalled"));
+    BENCH_CHECK(last_called != nullptr);
+
+    DLLH_set_loader_trace(true);
+
+    // Handing the stub out doesn't look anything up
+    void *tick = DLLH_load_function_lazily(ctx, handle, "EOS_Platform_Tick");
+    BENCH_CHECK(tick != nullptr);
+    BENCH_CHECK(tick != dlsym(handle, "EOS_Platform_Tick"));
+    BENCH_CHECK(symbol_lookups("EOS_Platform_Tick") == 0);
+
+    // The first call does, and later calls go straight through
+    BENCH_CHECK(reinterpret_cast<NoArguments_t>(tick)() == 0);
+    BENCH_CHECK(strcmp(last_called(), "EOS_Platform_Tick") == 0);
+    BENCH_CHECK(symbol_lookups("EOS_Platform_Tick") == 1);
+    BENCH_CHECK(reinterpret_cast<NoArguments_t>(tick)() == 0);
+    BENCH_CHECK(symbol_lookups("EOS_Platform_Tick") == 1);
+
+    // The first call arrives with every register and stack argument intact
+    SumArguments_t direct_sum = reinterpret_cast<SumArguments_t>(dlsym(handle, "StandIn_SumArguments"));
+    SumArguments_t lazy_sum = reinterpret_cast<SumArguments_t>(DLLH_load_function_lazily(ctx, handle, "StandIn_SumArguments"));
+    BENCH_CHECK(direct_sum != nullptr && lazy_sum != nullptr);
+    BENCH_CHECK(sum_arguments(lazy_sum, 3) == sum_arguments(direct_sum, 3));
+    BENCH_CHECK(sum_arguments(lazy_sum, -7) == sum_arguments(direct_sum, -7));
+
+    // A function the library doesn't export is null, as it would be from
+    // DLLH_load_function_with_name, so managed bindings still fail up front
+    BENCH_CHECK(DLLH_load_function_lazily(ctx, handle, "EOS_StandIn_Missing") == nullptr);
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, handle, "EOS_StandIn_Missing") == nullptr);
+
+    // A stub whose function can't be found when it's called aborts rather
+    // than return something the caller would take for a result
+    std::unique_ptr<lazy_stubs::StubArena, lazy_stubs::ArenaDeleter> arena(lazy_stubs::create_arena(&dlsym));
+    BENCH_CHECK(arena != nullptr);
+    void *missing = lazy_stubs::make_stub(arena.get(), handle, "EOS_StandIn_Missing");
+    BENCH_CHECK(missing != nullptr);
+    fflush(stdout);
+    const pid_t child = fork();
+    BENCH_CHECK(child >= 0);
+    if (child == 0)
+    {
+        freopen("/dev/null", "w", stderr);
+        reinterpret_cast<NoArguments_t>(missing)();
+        _exit(0);
+    }
+    int status = 0;
+    BENCH_CHECK(waitpid(child, &status, 0) == child);
+    BENCH_CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+
+    // Threads racing on the first call all get through to the function
+    SumArguments_t raced_sum = reinterpret_cast<SumArguments_t>(DLLH_load_function_lazily(ctx, handle, "StandIn_SumArguments"));
+    BENCH_CHECK(raced_sum != nullptr && raced_sum != lazy_sum);
+    std::vector<std::thread> threads;
+    std::vector<int> correct(kThreadCount, 0);
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        threads.emplace_back([&, i]() { correct[i] = sum_arguments(raced_sum, i) == sum_arguments(direct_sum, i); });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        BENCH_CHECK(correct[i]);
+    }
+
+    DLLH_set_loader_trace(false);
+
+    // A function that has already been looked up is handed out as itself
+    void *initialize = DLLH_load_function_with_name(ctx, handle, "EOS_Initialize");
+    BENCH_CHECK(initialize != nullptr);
+    BENCH_CHECK(DLLH_load_function_lazily(ctx, handle, "EOS_Initialize") == initialize);
+
+    const char *names[] = { "EOS_Shutdown", nullptr, "EOS_Platform_Create" };
+    void *functions[3];
+    BENCH_CHECK(DLLH_load_functions_lazily(ctx, handle, names, functions, 3) == 2);
+    BENCH_CHECK(functions[0] != nullptr && functions[1] == nullptr && functions[2] != nullptr);
+    BENCH_CHECK(reinterpret_cast<NoArguments_t>(functions[2])() == 0);
+    BENCH_CHECK(strcmp(last_called(), "EOS_Platform_Create") == 0);
+
+    // Stubs are outstanding function pointers, so the library stays until
+    // they're released
+    BENCH_CHECK(!DLLH_unload_library_at_path(ctx, handle));
+    BENCH_CHECK(DLLH_release_functions(ctx, handle) == 7);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+
+    // Without a context there's nothing to keep the stubs in
+    handle = dlopen(kStandInPath, RTLD_NOW);
+    BENCH_CHECK(handle != nullptr);
+    BENCH_CHECK(DLLH_load_function_lazily(nullptr, handle, "EOS_Platform_Tick") == dlsym(handle, "EOS_Platform_Tick"));
+    dlclose(handle);
+
+    DLLH_destroy_context(ctx);
+
+    printf("LazyStubTest: ok\n");
+    return 0;
+}
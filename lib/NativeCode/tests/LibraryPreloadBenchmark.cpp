@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Times loading a stand-in for the EOS SDK and one for the Steam API
+// around a stand-in for the rest of startup, one after the other against
+// starting both loads with DLLH_load_library_async and waiting on them
+// afterwards. The rest of startup is either busy on the CPU or waiting,
+// as it would be on disk or on the GPU. Loads can only hide behind busy
+// work when there is a core free to run them on.
+
+#include "BenchmarkCommon.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <algorithm>
+#include <thread>
+
+extern "C" void *DLLH_create_context();
+extern "C" void DLLH_destroy_context(void *context);
+extern "C" void *DLLH_load_library_at_path(void *ctx, const char *library_path);
+extern "C" void *DLLH_load_library_async(void *ctx, const char *library_path);
+extern "C" bool DLLH_poll_library(void *ctx, void *ticket);
+extern "C" void *DLLH_wait_library(void *ctx, void *ticket);
+extern "C" bool DLLH_unload_library_at_path(void *ctx, void *library_handle);
+
+static const char *kLibraryPaths[] = { "build/tests/libStandInLoadCostSDK.so", "build/tests/libStandInLoadCostSteam.so" };
+static const int kLibraryCount = 2;
+static const int kRounds = 30;
+
+static volatile uint64_t s_work_sink;
+
+//-------------------------------------------------------------------------
+static void busy_work(uint64_t iterations)
+{
+    bench::Random random;
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        sum += random.next();
+    }
+    s_work_sink = sum;
+}
+
+//-------------------------------------------------------------------------
+static void waiting_work(double milliseconds)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(milliseconds * 1000.0)));
+}
+
+//-------------------------------------------------------------------------
+// Every library has to be gone before the next round, or the next load
+// only bumps a reference count
+static void unload_all(void *ctx, void **handles)
+{
+    for (int i = 0; i < kLibraryCount; ++i)
+    {
+        BENCH_CHECK(handles[i] != nullptr);
+        BENCH_CHECK(DLLH_unload_library_at_path(ctx, handles[i]));
+        BENCH_CHECK(dlopen(kLibraryPaths[i], RTLD_NOW | RTLD_NOLOAD) == nullptr);
+        handles[i] = nullptr;
+    }
+}
+
+//-------------------------------------------------------------------------
+static double sequential_round(void *ctx, bool busy, uint64_t work_iterations, double work_ms)
+{
+    void *handles[kLibraryCount];
+    const auto start = bench::clock::now();
+    for (int i = 0; i < kLibraryCount; ++i)
+    {
+        handles[i] = DLLH_load_library_at_path(ctx, kLibraryPaths[i]);
+    }
+    if (busy)
+    {
+        busy_work(work_iterations);
+    }
+    else
+    {
+        waiting_work(work_ms);
+    }
+    const double elapsed = bench::elapsed_ms(start, bench::clock::now());
+
+    unload_all(ctx, handles);
+    return elapsed;
+}
+
+//-------------------------------------------------------------------------
+static double async_round(void *ctx, bool busy, uint64_t work_iterations, double work_ms)
+{
+    void *tickets[kLibraryCount];
+    void *handles[kLibraryCount];
+    const auto start = bench::clock::now();
+    for (int i = 0; i < kLibraryCount; ++i)
+    {
+        tickets[i] = DLLH_load_library_async(ctx, kLibraryPaths[i]);
+    }
+    if (busy)
+    {
+        busy_work(work_iterations);
+    }
+    else
+    {
+        waiting_work(work_ms);
+    }
+    for (int i = 0; i < kLibraryCount; ++i)
+    {
+        handles[i] = DLLH_wait_library(ctx, tickets[i]);
+    }
+    const double elapsed = bench::elapsed_ms(start, bench::clock::now());
+
+    unload_all(ctx, handles);
+    return elapsed;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    void *ctx = DLLH_create_context();
+
+    // The asynchronous load gives back what the synchronous one does
+    void *handle = DLLH_load_library_at_path(ctx, kLibraryPaths[0]);
+    void *ticket = DLLH_load_library_async(ctx, kLibraryPaths[0]);
+    BENCH_CHECK(ticket != nullptr);
+    while (!DLLH_poll_library(ctx, ticket))
+    {
+        std::this_thread::yield();
+    }
+    BENCH_CHECK(DLLH_wait_library(ctx, ticket) == handle);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+
+    ticket = DLLH_load_library_async(ctx, "build/tests/libStandInMissing.so");
+    BENCH_CHECK(ticket != nullptr);
+    BENCH_CHECK(DLLH_wait_library(ctx, ticket) == nullptr);
+    BENCH_CHECK(DLLH_load_library_async(nullptr, kLibraryPaths[0]) == nullptr);
+    BENCH_CHECK(!DLLH_poll_library(ctx, nullptr));
+    BENCH_CHECK(DLLH_wait_library(ctx, nullptr) == nullptr);
+
+    // Size the rest of startup to take as long as the loads do, which is
+    // where overlapping them can save the most
+    double load_ms = 1.0e30;
+    for (int round = 0; round < kRounds; ++round)
+    {
+        void *handles[kLibraryCount];
+        const auto start = bench::clock::now();
+        for (int i = 0; i < kLibraryCount; ++i)
+        {
+            handles[i] = DLLH_load_library_at_path(ctx, kLibraryPaths[i]);
+        }
+        load_ms = std::min(load_ms, bench::elapsed_ms(start, bench::clock::now()));
+        unload_all(ctx, handles);
+    }
+
+    const uint64_t calibration_iterations = 1000000;
+    double calibration_ms = 1.0e30;
+    for (int round = 0; round < 5; ++round)
+    {
+        const auto start = bench::clock::now();
+        busy_work(calibration_iterations);
+        calibration_ms = std::min(calibration_ms, bench::elapsed_ms(start, bench::clock::now()));
+    }
+    const uint64_t work_iterations = static_cast<uint64_t>(calibration_iterations * load_ms / calibration_ms);
+
+    enum Case { SequentialBusy, AsyncBusy, SequentialWaiting, AsyncWaiting, CaseCount };
+    const char *case_names[CaseCount] = { "sequential, busy", "async, busy", "sequential, waiting", "async, waiting" };
+    double best_ms[CaseCount];
+    std::fill(best_ms, best_ms + CaseCount, 1.0e30);
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        best_ms[SequentialBusy] = std::min(best_ms[SequentialBusy], sequential_round(ctx, true, work_iterations, load_ms));
+        best_ms[AsyncBusy] = std::min(best_ms[AsyncBusy], async_round(ctx, true, work_iterations, load_ms));
+        best_ms[SequentialWaiting] = std::min(best_ms[SequentialWaiting], sequential_round(ctx, false, work_iterations, load_ms));
+        best_ms[AsyncWaiting] = std::min(best_ms[AsyncWaiting], async_round(ctx, false, work_iterations, load_ms));
+    }
+
+    printf("Loading %d libraries alongside %.2f ms of other startup work, best of %d rounds on %u hardware threads (ms, lower is better)\n",
+        kLibraryCount, load_ms, kRounds, std::thread::hardware_concurrency());
+    printf("%-24s %10s %10s\n", "", "wall", "saved");
+    for (int i = 0; i < CaseCount; ++i)
+    {
+        const double sequential_ms = best_ms[i & ~1];
+        printf("%-24s %10.3f %9.1f%%\n", case_names[i], best_ms[i], 100.0 * (sequential_ms - best_ms[i]) / sequential_ms);
+    }
+
+    DLLH_destroy_context(ctx);
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that the Linux DLLHContext only unloads a library once every
+// load through it has been matched by an unload and its function pointers
+// have been released, and that repeated load and unload cycles, as in
+// editor play mode or a server hosting one match after another, leave
+// nothing mapped and don't grow the process.
+
+#include "BenchmarkCommon.h"
+#include "StandInEOSExports.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" void *DLLH_create_context();
+extern "C" void DLLH_destroy_context(void *context);
+extern "C" void *DLLH_load_library_at_path(void *ctx, const char *library_path);
+extern "C" void *DLLH_load_function_with_name(void *ctx, void *library_handle, const char *function);
+extern "C" size_t DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count);
+extern "C" size_t DLLH_release_functions(void *ctx, void *library_handle);
+extern "C" bool DLLH_unload_library_at_path(void *ctx, void *library_handle);
+
+static const char *kStandInExportsPath = "build/tests/libStandInEOSExports.so";
+static const char *kStandInSDKPath = "build/tests/libStandInEOSSDK.so";
+static const int kCycles = 200;
+
+//-------------------------------------------------------------------------
+// Counts the mappings of the stand-in in /proc/self/maps
+static int stand_in_mapping_count()
+{
+    FILE *maps = fopen("/proc/self/maps", "r");
+    BENCH_CHECK(maps != nullptr);
+
+    int count = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), maps) != nullptr)
+    {
+        if (strstr(line, "libStandInEOSExports.so") != nullptr)
+        {
+            ++count;
+        }
+    }
+    fclose(maps);
+    return count;
+}
+
+//-------------------------------------------------------------------------
+static bool is_loaded(const char *library_path)
+{
+    void *handle = dlopen(library_path, RTLD_NOW | RTLD_NOLOAD);
+    if (handle != nullptr)
+    {
+        dlclose(handle);
+    }
+    return handle != nullptr;
+}
+
+//-------------------------------------------------------------------------
+static size_t resident_kib()
+{
+    FILE *status = fopen("/proc/self/status", "r");
+    BENCH_CHECK(status != nullptr);
+
+    size_t resident = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), status) != nullptr)
+    {
+        if (sscanf(line, "VmRSS: %zu kB", &resident) == 1)
+        {
+            break;
+        }
+    }
+    fclose(status);
+    return resident;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    void *ctx = DLLH_create_context();
+
+    // Two loads take two references
+    void *handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(handle != nullptr);
+    BENCH_CHECK(DLLH_load_library_at_path(ctx, kStandInExportsPath) == handle);
+    void *function = DLLH_load_function_with_name(ctx, handle, "EOS_StandInExport_007");
+    BENCH_CHECK(function != nullptr && reinterpret_cast<StandInExport_t>(function)() == 7);
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, handle, "EOS_StandInExport_Missing") == nullptr);
+
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+    BENCH_CHECK(is_loaded(kStandInExportsPath));
+
+    // The last reference stays while the function is outstanding
+    BENCH_CHECK(!DLLH_unload_library_at_path(ctx, handle));
+    BENCH_CHECK(is_loaded(kStandInExportsPath));
+    BENCH_CHECK(reinterpret_cast<StandInExport_t>(function)() == 7);
+
+    // Missing functions weren't counted
+    BENCH_CHECK(DLLH_release_functions(ctx, handle) == 1);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+    BENCH_CHECK(!is_loaded(kStandInExportsPath));
+    BENCH_CHECK(stand_in_mapping_count() == 0);
+    BENCH_CHECK(!DLLH_unload_library_at_path(ctx, handle));
+
+    // Libraries the context didn't load are left alone
+    void *sdk_handle = dlopen(kStandInSDKPath, RTLD_NOW);
+    BENCH_CHECK(sdk_handle != nullptr);
+    BENCH_CHECK(!DLLH_unload_library_at_path(ctx, sdk_handle));
+    BENCH_CHECK(is_loaded(kStandInSDKPath));
+    dlclose(sdk_handle);
+
+    // An unload behind the context's back forgets the references it held
+    handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(handle != nullptr);
+    BENCH_CHECK(dlclose(handle) == 0);
+    BENCH_CHECK(!is_loaded(kStandInExportsPath));
+    handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(handle != nullptr);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+    BENCH_CHECK(!is_loaded(kStandInExportsPath));
+
+    std::vector<std::string> names(STANDIN_EXPORT_COUNT);
+    std::vector<const char*> name_pointers(STANDIN_EXPORT_COUNT);
+    for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+    {
+        char name[64];
+        standin_export_name(i, name, sizeof(name));
+        names[i] = name;
+        name_pointers[i] = names[i].c_str();
+    }
+    std::vector<void*> functions(STANDIN_EXPORT_COUNT);
+
+    // Load, bind everything, release and unload, over and over. The first
+    // cycles warm up the allocator, after that the process shouldn't grow.
+    size_t warm_resident_kib = 0;
+    for (int cycle = 0; cycle < kCycles; ++cycle)
+    {
+        if (cycle == kCycles / 4)
+        {
+            warm_resident_kib = resident_kib();
+        }
+
+        handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+        BENCH_CHECK(handle != nullptr);
+        BENCH_CHECK(DLLH_load_functions_with_names(ctx, handle, name_pointers.data(), functions.data(), STANDIN_EXPORT_COUNT) == STANDIN_EXPORT_COUNT);
+        BENCH_CHECK(reinterpret_cast<StandInExport_t>(functions[cycle % STANDIN_EXPORT_COUNT])() == cycle % STANDIN_EXPORT_COUNT);
+
+        BENCH_CHECK(!DLLH_unload_library_at_path(ctx, handle));
+        BENCH_CHECK(DLLH_release_functions(ctx, handle) == STANDIN_EXPORT_COUNT);
+        BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+        BENCH_CHECK(stand_in_mapping_count() == 0);
+    }
+
+    const size_t final_resident_kib = resident_kib();
+    BENCH_CHECK(final_resident_kib <= warm_resident_kib + 256);
+
+    DLLH_destroy_context(ctx);
+
+    printf("LibraryUnloadTest: ok (%zu KiB resident after %d cycles, %zu KiB after %d)\n", warm_resident_kib, kCycles / 4, final_resident_kib, kCycles);
+    return 0;
+}
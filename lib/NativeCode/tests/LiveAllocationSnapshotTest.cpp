@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that Mem_SnapshotLiveAllocations reports every live block with its
+// size, alignment, age and allocating thread, copes with a buffer that is
+// too small, and that the leak report totals what is still live in the
+// size classes of MemCountersEx.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_SetAllocationAgeTracking(bool enabled);
+extern "C" int64_t Mem_SnapshotLiveAllocations(int32_t api_version, void *buffer, uint64_t capacity);
+extern "C" bool Mem_WriteLeakReport(const char *path);
+
+//-------------------------------------------------------------------------
+static std::vector<MemLiveAllocation> snapshot()
+{
+    std::vector<MemLiveAllocation> allocations(1024);
+    const int64_t count = Mem_SnapshotLiveAllocations(MEM_LIVE_ALLOCATION_API_LATEST, allocations.data(), allocations.size());
+    BENCH_CHECK(count >= 0 && count <= static_cast<int64_t>(allocations.size()));
+    allocations.resize(static_cast<size_t>(count));
+    return allocations;
+}
+
+//-------------------------------------------------------------------------
+static std::string read_leak_report()
+{
+    const char *report_path = "build/tests/LiveAllocationSnapshotTest_leaks.txt";
+    BENCH_CHECK(Mem_WriteLeakReport(report_path));
+
+    FILE *report = fopen(report_path, "r");
+    BENCH_CHECK(report != nullptr);
+    std::string text;
+    char line[512];
+    while (fgets(line, sizeof(line), report) != nullptr)
+    {
+        text += line;
+    }
+    fclose(report);
+    remove(report_path);
+    return text;
+}
+
+//-------------------------------------------------------------------------
+static const MemLiveAllocation *find(const std::vector<MemLiveAllocation>& allocations, const void *pointer)
+{
+    for (const MemLiveAllocation& allocation : allocations)
+    {
+        if (allocation.address == reinterpret_cast<uintptr_t>(pointer))
+        {
+            return &allocation;
+        }
+    }
+    return nullptr;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    BENCH_CHECK(Mem_SnapshotLiveAllocations(MEM_LIVE_ALLOCATION_API_LATEST + 1, nullptr, 0) == -1);
+    const int64_t baseline = Mem_SnapshotLiveAllocations(MEM_LIVE_ALLOCATION_API_LATEST, nullptr, 0);
+    BENCH_CHECK(baseline >= 0);
+
+    // Blocks from before ages were tracked say so
+    void *unaged_block = Mem_generic_align_alloc(24, 8);
+    BENCH_CHECK(Mem_SetAllocationAgeTracking(true));
+
+    void *old_block = Mem_generic_align_alloc(100, 8);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    void *aligned_block = Mem_generic_align_alloc(3000, 64);
+
+    void *other_thread_block = nullptr;
+    std::thread([&] { other_thread_block = Mem_generic_align_alloc(40, 16); }).join();
+
+    std::vector<MemLiveAllocation> allocations = snapshot();
+    BENCH_CHECK(static_cast<int64_t>(allocations.size()) == baseline + 4);
+
+    const MemLiveAllocation *old_entry = find(allocations, old_block);
+    const MemLiveAllocation *aligned_entry = find(allocations, aligned_block);
+    const MemLiveAllocation *other_entry = find(allocations, other_thread_block);
+    const MemLiveAllocation *unaged_entry = find(allocations, unaged_block);
+    BENCH_CHECK(old_entry != nullptr && aligned_entry != nullptr && other_entry != nullptr && unaged_entry != nullptr);
+    BENCH_CHECK(unaged_entry->ageInTicks == MEM_LIVE_ALLOCATION_AGE_UNKNOWN && unaged_entry->sizeInBytes == 24);
+
+    BENCH_CHECK(old_entry->sizeInBytes == 100 && old_entry->alignmentInBytes == 8);
+    BENCH_CHECK(aligned_entry->sizeInBytes == 3000 && aligned_entry->alignmentInBytes == 64);
+    BENCH_CHECK(other_entry->sizeInBytes == 40 && other_entry->alignmentInBytes == 16);
+    // The clock only moves once per scheduler tick, up to 10ms apart
+    BENCH_CHECK(old_entry->ageInTicks >= 40 * MEM_TICKS_PER_SECOND / 1000);
+    BENCH_CHECK(old_entry->ageInTicks > aligned_entry->ageInTicks);
+    BENCH_CHECK(old_entry->threadId != 0 && old_entry->threadId == aligned_entry->threadId);
+    BENCH_CHECK(other_entry->threadId != 0 && other_entry->threadId != old_entry->threadId);
+
+    // Growing a block keeps its age
+    old_block = Mem_generic_align_realloc(old_block, 5000, 8);
+    allocations = snapshot();
+    old_entry = find(allocations, old_block);
+    BENCH_CHECK(old_entry != nullptr && old_entry->sizeInBytes == 5000);
+    BENCH_CHECK(old_entry->ageInTicks >= 40 * MEM_TICKS_PER_SECOND / 1000);
+
+    // A short buffer gets what fits, and the full count comes back
+    MemLiveAllocation short_buffer[2] = {};
+    BENCH_CHECK(Mem_SnapshotLiveAllocations(MEM_LIVE_ALLOCATION_API_LATEST, short_buffer, 1) == baseline + 4);
+    BENCH_CHECK(short_buffer[0].address != 0 && short_buffer[1].address == 0);
+
+    std::string text = read_leak_report();
+
+    char expected[128];
+    snprintf(expected, sizeof(expected), "live allocations: %" PRId64 " blocks", baseline + 4);
+    BENCH_CHECK(text.find(expected) == 0);
+    BENCH_CHECK(text.find("by size class:") != std::string::npos);
+    BENCH_CHECK(text.find("  <=                 8191 bytes:") != std::string::npos);
+    BENCH_CHECK(text.find("by thread:") != std::string::npos);
+
+    snprintf(expected, sizeof(expected), "0x%" PRIxPTR ": 5000 bytes, aligned to 8", reinterpret_cast<uintptr_t>(old_block));
+    BENCH_CHECK(text.find(expected) != std::string::npos);
+
+    Mem_generic_free(unaged_block);
+    Mem_generic_free(old_block);
+    Mem_generic_free(aligned_block);
+    Mem_generic_free(other_thread_block);
+    BENCH_CHECK(Mem_SnapshotLiveAllocations(MEM_LIVE_ALLOCATION_API_LATEST, nullptr, 0) == baseline);
+
+    // Nothing live, so there are no oldest blocks to head
+    if (baseline == 0)
+    {
+        text = read_leak_report();
+        BENCH_CHECK(text.find("live allocations: 0 blocks") == 0);
+        BENCH_CHECK(text.find("oldest blocks:") == std::string::npos);
+        BENCH_CHECK(text.find("no allocation ages") == std::string::npos);
+    }
+
+    printf("LiveAllocationSnapshotTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks the Linux loader instrumentation: loader calls are timed only
+// while recording, errors are kept per thread, the module list has what
+// was loaded, the Chrome trace is written, and GetError and PrintLibs
+// leave stdout alone.
+
+#include "BenchmarkCommon.h"
+#include "LoaderTrace.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+extern "C" void *DLLH_create_context();
+extern "C" void DLLH_destroy_context(void *context);
+extern "C" void *DLLH_load_library_at_path(void *ctx, const char *library_path);
+extern "C" void *DLLH_load_function_with_name(void *ctx, void *library_handle, const char *function);
+extern "C" size_t DLLH_release_functions(void *ctx, void *library_handle);
+extern "C" bool DLLH_unload_library_at_path(void *ctx, void *library_handle);
+extern "C" void DLLH_set_loader_trace(bool enabled);
+extern "C" int64_t DLLH_query_loader_info(int32_t api_version, int32_t query, void *buffer, uint64_t capacity);
+extern "C" bool DLLH_write_loader_chrome_trace(const char *path);
+extern "C" void GetError();
+extern "C" void PrintLibs();
+
+static const char *kStandInExportsPath = "build/tests/libStandInEOSExports.so";
+static const char *kMissingPath = "build/tests/libStandInMissing.so";
+static const char *kTracePath = "build/tests/loader_trace.json";
+
+//-------------------------------------------------------------------------
+static std::vector<DLLHLoaderEvent> recorded_events()
+{
+    const int64_t count = DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_EVENTS, nullptr, 0);
+    BENCH_CHECK(count >= 0);
+
+    std::vector<DLLHLoaderEvent> events(static_cast<size_t>(count));
+    BENCH_CHECK(DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_EVENTS, events.data(), events.size()) == count);
+    return events;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    struct stat stdout_before;
+    BENCH_CHECK(fstat(fileno(stdout), &stdout_before) == 0);
+
+    BENCH_CHECK(DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST + 1, DLLH_LOADER_QUERY_EVENTS, nullptr, 0) == -1);
+    BENCH_CHECK(DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, 42, nullptr, 0) == -1);
+    BENCH_CHECK(DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_LAST_ERROR, nullptr, 0) == 0);
+
+    // Nothing is recorded until asked for
+    void *ctx = DLLH_create_context();
+    void *handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(handle != nullptr);
+    BENCH_CHECK(recorded_events().empty());
+
+    DLLH_set_loader_trace(true);
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, handle, "EOS_StandInExport_042") != nullptr);
+    // Cached, so the loader isn't asked again
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, handle, "EOS_StandInExport_042") != nullptr);
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, handle, "EOS_StandInExport_Missing") == nullptr);
+    BENCH_CHECK(DLLH_load_library_at_path(ctx, kMissingPath) == nullptr);
+    DLLH_release_functions(ctx, handle);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+    DLLH_set_loader_trace(false);
+
+    std::vector<DLLHLoaderEvent> events = recorded_events();
+    BENCH_CHECK(events.size() == 4);
+    BENCH_CHECK(events[0].operation == DLLH_LOADER_SYMBOL && events[0].succeeded && strcmp(events[0].name, "EOS_StandInExport_042") == 0);
+    BENCH_CHECK(events[0].handle == reinterpret_cast<uintptr_t>(handle));
+    BENCH_CHECK(events[1].operation == DLLH_LOADER_SYMBOL && !events[1].succeeded);
+    BENCH_CHECK(events[2].operation == DLLH_LOADER_OPEN && !events[2].succeeded && strcmp(events[2].name, kMissingPath) == 0);
+    BENCH_CHECK(events[3].operation == DLLH_LOADER_CLOSE && events[3].succeeded && events[3].handle == reinterpret_cast<uintptr_t>(handle));
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        BENCH_CHECK(events[i].thread_id != 0);
+        BENCH_CHECK(i == 0 || events[i].start_ns >= events[i - 1].start_ns + events[i - 1].duration_ns);
+    }
+
+    // The missing library was the last thing to go wrong on this thread,
+    // and nothing has gone wrong on a new one
+    DLLHLoaderError error;
+    BENCH_CHECK(DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_LAST_ERROR, &error, 1) == 1);
+    BENCH_CHECK(error.operation == DLLH_LOADER_OPEN && strcmp(error.name, kMissingPath) == 0);
+    BENCH_CHECK(strstr(error.message, "libStandInMissing.so") != nullptr);
+    int64_t other_thread_errors = -1;
+    std::thread([&]() { other_thread_errors = DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_LAST_ERROR, &error, 1); }).join();
+    BENCH_CHECK(other_thread_errors == 0);
+
+    // The module list follows what is loaded
+    handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    const int64_t module_count = DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_MODULES, nullptr, 0);
+    BENCH_CHECK(module_count > 1);
+    std::vector<DLLHModuleInfo> modules(static_cast<size_t>(module_count));
+    BENCH_CHECK(DLLH_query_loader_info(DLLH_LOADER_INFO_API_LATEST, DLLH_LOADER_QUERY_MODULES, modules.data(), modules.size()) == module_count);
+    bool found_stand_in = false;
+    for (const DLLHModuleInfo& module : modules)
+    {
+        if (strstr(module.path, "libStandInEOSExports.so") != nullptr)
+        {
+            found_stand_in = module.mapped_bytes > 0 && module.segment_count > 0 && module.base_address != 0;
+        }
+    }
+    BENCH_CHECK(found_stand_in);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, handle));
+
+    BENCH_CHECK(DLLH_write_loader_chrome_trace(kTracePath));
+    FILE *trace = fopen(kTracePath, "r");
+    BENCH_CHECK(trace != nullptr);
+    char contents[8192];
+    const size_t length = fread(contents, 1, sizeof(contents) - 1, trace);
+    contents[length] = '\0';
+    fclose(trace);
+    BENCH_CHECK(strncmp(contents, "{\"traceEvents\":[", 16) == 0);
+    BENCH_CHECK(strstr(contents, "\"name\":\"EOS_StandInExport_042\",\"cat\":\"dlsym\",\"ph\":\"X\"") != nullptr);
+    BENCH_CHECK(strstr(contents, "\"cat\":\"dlclose\"") != nullptr);
+
+    // Both write their own files rather than taking over stdout
+    GetError();
+    PrintLibs();
+    struct stat stdout_after;
+    BENCH_CHECK(fstat(fileno(stdout), &stdout_after) == 0);
+    BENCH_CHECK(stdout_before.st_dev == stdout_after.st_dev && stdout_before.st_ino == stdout_after.st_ino);
+    remove("debug.txt");
+    remove("libs.txt");
+
+    DLLH_destroy_context(ctx);
+
+    printf("LoaderTraceTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks the soft and hard memory budgets: the callback is told once per
+// crossing, when events are delivered rather than during the allocation,
+// allocations over the hard limit come out of the emergency arena (and
+// move back out of it), growth is measured from the size a block was asked
+// for, the arena coalesces what's freed, and threads allocating at once
+// can't take usage past the hard limit.
+
+#include "BenchmarkCommon.h"
+#include "EmergencyArena.h"
+#include "Memory.h"
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_SetMemoryBudget(int64_t soft_limit_in_bytes, int64_t hard_limit_in_bytes, uint64_t emergency_arena_in_bytes);
+extern "C" void Mem_SetMemoryBudgetCallback(void *callback, void *user_data);
+extern "C" bool Mem_GetMemoryBudgetStatus(void *data);
+extern "C" uint32_t Mem_DeliverMemoryBudgetEvents();
+
+#define KIB 1024
+#define MIB (1024 * 1024)
+
+static std::atomic<int> s_event_counts[3];
+
+//-------------------------------------------------------------------------
+static void on_budget_event(int32_t budget_event, int64_t, void *user_data)
+{
+    BENCH_CHECK(user_data == &s_event_counts);
+    s_event_counts[budget_event]++;
+}
+
+//-------------------------------------------------------------------------
+static MemBudgetStatus read_status()
+{
+    MemBudgetStatus status = {};
+    status.apiVersion = MEM_BUDGET_STATUS_API_LATEST;
+    BENCH_CHECK(Mem_GetMemoryBudgetStatus(&status));
+    return status;
+}
+
+//-------------------------------------------------------------------------
+// Allocates blocks of block_size until the budget refuses one
+static void allocate_until_refused(size_t block_size, std::vector<void*> *out_blocks)
+{
+    for (;;)
+    {
+        void *block = Mem_generic_align_alloc(block_size, 16);
+        if (block == nullptr)
+        {
+            return;
+        }
+        out_blocks->push_back(block);
+    }
+}
+
+//-------------------------------------------------------------------------
+static void hammer(int seed)
+{
+    bench::Random random(seed);
+    std::vector<void*> blocks(64, nullptr);
+    for (int i = 0; i < 20000; ++i)
+    {
+        void *&block = blocks[random.range(0, blocks.size() - 1)];
+        if (block != nullptr)
+        {
+            Mem_generic_free(block);
+            block = nullptr;
+        }
+        else
+        {
+            block = Mem_generic_align_alloc(random.range(1, 16 * KIB), 16);
+        }
+    }
+    for (void *block : blocks)
+    {
+        Mem_generic_free(block);
+    }
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    MemBudgetStatus unknown_version = {};
+    unknown_version.apiVersion = MEM_BUDGET_STATUS_API_LATEST + 1;
+    BENCH_CHECK(!Mem_GetMemoryBudgetStatus(&unknown_version));
+
+    Mem_SetMemoryBudgetCallback(reinterpret_cast<void*>(&on_budget_event), &s_event_counts);
+
+    const int64_t base = read_status().currentMemoryAllocatedInBytes;
+    BENCH_CHECK(Mem_SetMemoryBudget(base + 1 * MIB, base + 2 * MIB, 1 * MIB));
+
+    void *growing = Mem_generic_align_alloc(1000, 16);
+    BENCH_CHECK(!emergency_arena::owns(growing));
+    memset(growing, 0x3c, 1000);
+
+    // Up to the soft limit, then past it
+    std::vector<void*> blocks;
+    for (int i = 0; i < 3; ++i)
+    {
+        blocks.push_back(Mem_generic_align_alloc(256 * KIB, 16));
+        BENCH_CHECK(s_event_counts[0] == 0);
+    }
+    blocks.push_back(Mem_generic_align_alloc(256 * KIB, 16));
+    blocks.push_back(Mem_generic_align_alloc(256 * KIB, 16));
+    BENCH_CHECK(read_status().isOverSoftLimit == 1);
+
+    // The allocator only flags the event; it's passed on when delivered
+    BENCH_CHECK(s_event_counts[0] == 0);
+    BENCH_CHECK(Mem_DeliverMemoryBudgetEvents() == 1);
+    BENCH_CHECK(s_event_counts[0] == 1);
+    BENCH_CHECK(Mem_DeliverMemoryBudgetEvents() == 0);
+
+    // Up to the hard limit; nothing comes from the arena yet
+    blocks.push_back(Mem_generic_align_alloc(256 * KIB, 16));
+    blocks.push_back(Mem_generic_align_alloc(256 * KIB, 16));
+    BENCH_CHECK(read_status().isOverHardLimit == 0);
+    for (void *block : blocks)
+    {
+        BENCH_CHECK(block != nullptr && !emergency_arena::owns(block));
+    }
+    BENCH_CHECK(s_event_counts[1] == 0);
+
+    // Past it, into the arena until that runs out
+    std::vector<void*> emergency;
+    for (;;)
+    {
+        void *block = Mem_generic_align_alloc(300 * KIB, 4096);
+        if (block == nullptr)
+        {
+            break;
+        }
+        BENCH_CHECK(emergency_arena::owns(block));
+        BENCH_CHECK(reinterpret_cast<uintptr_t>(block) % 4096 == 0);
+        memset(block, 0x5a, 300 * KIB);
+        emergency.push_back(block);
+    }
+    BENCH_CHECK(emergency.size() == 3);
+    BENCH_CHECK(s_event_counts[1] == 0);
+    BENCH_CHECK(Mem_DeliverMemoryBudgetEvents() == 2);
+    BENCH_CHECK(s_event_counts[1] == 1);
+    BENCH_CHECK(s_event_counts[2] == 1);
+
+    MemBudgetStatus status = read_status();
+    BENCH_CHECK(status.isOverHardLimit == 1);
+    BENCH_CHECK(status.emergencyCapacityInBytes >= 1 * MIB);
+    BENCH_CHECK(status.emergencyUsedInBytes >= 3 * 300 * KIB);
+    BENCH_CHECK(status.emergencyExhaustedCount == 1);
+
+    // Resizing the arena while it's in use isn't allowed
+    BENCH_CHECK(!Mem_SetMemoryBudget(base + 1 * MIB, base + 2 * MIB, 2 * MIB));
+
+    // Freed arena blocks coalesce back into one
+    for (void *block : emergency)
+    {
+        Mem_generic_free(block);
+    }
+    emergency.clear();
+    BENCH_CHECK(read_status().emergencyUsedInBytes == 0);
+    void *whole_arena = Mem_generic_align_alloc(1 * MIB - 64, 16);
+    BENCH_CHECK(emergency_arena::owns(whole_arena));
+    Mem_generic_free(whole_arena);
+
+    // A regular block grown past the hard limit moves into the arena...
+    growing = Mem_generic_align_realloc(growing, 300 * KIB, 16);
+    BENCH_CHECK(growing != nullptr && emergency_arena::owns(growing));
+    BENCH_CHECK(static_cast<unsigned char*>(growing)[999] == 0x3c);
+
+    // ...and back out once there's room under the limit again
+    for (void *block : blocks)
+    {
+        Mem_generic_free(block);
+    }
+    blocks.clear();
+    status = read_status();
+    BENCH_CHECK(status.isOverSoftLimit == 0 && status.isOverHardLimit == 0);
+
+    growing = Mem_generic_align_realloc(growing, 301 * KIB, 16);
+    BENCH_CHECK(growing != nullptr && !emergency_arena::owns(growing));
+    BENCH_CHECK(static_cast<unsigned char*>(growing)[999] == 0x3c);
+    Mem_generic_free(growing);
+    BENCH_CHECK(read_status().emergencyUsedInBytes == 0);
+
+    // The soft limit fires again on the next crossing
+    void *big = Mem_generic_align_alloc(1 * MIB + KIB, 16);
+    Mem_DeliverMemoryBudgetEvents();
+    BENCH_CHECK(s_event_counts[0] == 2);
+    Mem_generic_free(big);
+
+    // Many threads against a tight budget; everything has to go back where
+    // it came from
+    BENCH_CHECK(Mem_SetMemoryBudget(base + 256 * KIB, base + 512 * KIB, 1 * MIB));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(hammer, i + 1);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    status = read_status();
+    BENCH_CHECK(status.currentMemoryAllocatedInBytes == base);
+    BENCH_CHECK(status.emergencyUsedInBytes == 0);
+    BENCH_CHECK(status.emergencyPeakInBytes > 0);
+
+    // Slack the backend gave a block doesn't count as room to grow into
+    BENCH_CHECK(Mem_SetMemoryBudget(0, base + 64 * KIB, 1 * MIB));
+    void *slack = Mem_generic_align_alloc(1001, 16);
+    BENCH_CHECK(slack != nullptr && !emergency_arena::owns(slack));
+    BENCH_CHECK(platform::mem_usable_size(slack) >= 1009);
+    void *filler = Mem_generic_align_alloc(64 * KIB - 1001 - 4, 16);
+    BENCH_CHECK(filler != nullptr && !emergency_arena::owns(filler));
+    slack = Mem_generic_align_realloc(slack, 1009, 16);
+    BENCH_CHECK(slack != nullptr && emergency_arena::owns(slack));
+    Mem_generic_free(slack);
+    Mem_generic_free(filler);
+    BENCH_CHECK(read_status().currentMemoryAllocatedInBytes == base);
+    Mem_DeliverMemoryBudgetEvents();
+
+    // Threads racing up to the hard limit, without an arena to fall back
+    // on, get no more than it between them
+    BENCH_CHECK(Mem_SetMemoryBudget(0, base + 4 * MIB, 0));
+    std::vector<std::vector<void*>> racing_blocks(8);
+    threads.clear();
+    for (std::vector<void*>& thread_blocks : racing_blocks)
+    {
+        threads.emplace_back(allocate_until_refused, 64 * KIB, &thread_blocks);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    size_t racing_block_count = 0;
+    for (std::vector<void*>& thread_blocks : racing_blocks)
+    {
+        racing_block_count += thread_blocks.size();
+        for (void *block : thread_blocks)
+        {
+            Mem_generic_free(block);
+        }
+    }
+    BENCH_CHECK(racing_block_count == 4 * MIB / (64 * KIB));
+    BENCH_CHECK(read_status().currentMemoryAllocatedInBytes == base);
+    Mem_DeliverMemoryBudgetEvents();
+
+    // Turning the budget off releases the arena
+    BENCH_CHECK(Mem_SetMemoryBudget(0, 0, 0));
+    status = read_status();
+    BENCH_CHECK(status.emergencyCapacityInBytes == 0);
+    void *unbudgeted = Mem_generic_align_alloc(4 * MIB, 16);
+    BENCH_CHECK(unbudgeted != nullptr && !emergency_arena::owns(unbudgeted));
+    Mem_generic_free(unbudgeted);
+
+    Mem_SetMemoryBudgetCallback(nullptr, nullptr);
+
+    printf("MemoryBudgetTest: ok\n");
+    return 0;
+}
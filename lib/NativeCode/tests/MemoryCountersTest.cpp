@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that Mem_GetAllocationCountersEx reports what the allocator did:
+// totals, peaks, operation counts, the size histogram, and bytes attributed
+// to the thread that allocated them even when another thread frees them,
+// and thread slots handed on once the thread that held them has exited.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include <thread>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_GetAllocationCountersEx(void *data);
+
+//-------------------------------------------------------------------------
+static MemCountersEx read_counters()
+{
+    MemCountersEx counters = {};
+    counters.apiVersion = MEM_COUNTERSEX_API_LATEST;
+    BENCH_CHECK(Mem_GetAllocationCountersEx(&counters));
+    return counters;
+}
+
+//-------------------------------------------------------------------------
+static const MemThreadCounters* find_thread(const MemCountersEx& counters, uint64_t thread_id)
+{
+    for (int32_t i = 0; i < counters.threadCount; ++i)
+    {
+        if (counters.threads[i].threadId == thread_id)
+        {
+            return &counters.threads[i];
+        }
+    }
+    return nullptr;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    MemCountersEx unknown_version = {};
+    unknown_version.apiVersion = MEM_COUNTERSEX_API_LATEST + 1;
+    BENCH_CHECK(!Mem_GetAllocationCountersEx(&unknown_version));
+
+    const MemCountersEx before = read_counters();
+
+    // Totals, peak and histogram
+    void *small = Mem_generic_align_alloc(100, 16);
+    void *large = Mem_generic_align_alloc(5000, 16);
+    large = Mem_generic_align_realloc(large, 9000, 16);
+    MemCountersEx counters = read_counters();
+    BENCH_CHECK(counters.currentMemoryAllocatedInBytes == before.currentMemoryAllocatedInBytes + 9100);
+    BENCH_CHECK(counters.peakMemoryAllocatedInBytes >= before.currentMemoryAllocatedInBytes + 9100);
+    BENCH_CHECK(counters.allocCount == before.allocCount + 2);
+    BENCH_CHECK(counters.reallocCount == before.reallocCount + 1);
+    BENCH_CHECK(counters.sizeHistogram[7] == before.sizeHistogram[7] + 1);   // 100 is in [64, 128)
+    BENCH_CHECK(counters.sizeHistogram[13] == before.sizeHistogram[13] + 1); // 5000 is in [4096, 8192)
+    BENCH_CHECK(counters.sizeHistogram[14] == before.sizeHistogram[14] + 1); // 9000 is in [8192, 16384)
+
+    Mem_generic_free(large);
+    Mem_generic_free(small);
+    counters = read_counters();
+    BENCH_CHECK(counters.currentMemoryAllocatedInBytes == before.currentMemoryAllocatedInBytes);
+    BENCH_CHECK(counters.peakMemoryAllocatedInBytes >= before.currentMemoryAllocatedInBytes + 9100);
+    BENCH_CHECK(counters.freeCount == before.freeCount + 2);
+
+    // Bytes stay with the allocating thread until they're freed, wherever
+    // that happens
+    std::vector<void*> blocks;
+    uint64_t worker_id = 0;
+    std::thread worker([&] {
+        worker_id = platform::current_thread_id();
+        for (int i = 0; i < 10; ++i)
+        {
+            blocks.push_back(Mem_generic_align_alloc(1000, 8));
+        }
+    });
+    worker.join();
+
+    counters = read_counters();
+    const MemThreadCounters *worker_counters = find_thread(counters, worker_id);
+    BENCH_CHECK(worker_counters != nullptr);
+    BENCH_CHECK(worker_counters->currentMemoryAllocatedInBytes == 10000);
+    BENCH_CHECK(worker_counters->totalMemoryAllocatedInBytes == 10000);
+    BENCH_CHECK(worker_counters->allocCount == 10);
+
+    for (void *block : blocks)
+    {
+        Mem_generic_free(block);
+    }
+
+    counters = read_counters();
+    worker_counters = find_thread(counters, worker_id);
+    BENCH_CHECK(worker_counters->currentMemoryAllocatedInBytes == 0);
+    BENCH_CHECK(worker_counters->totalMemoryAllocatedInBytes == 10000);
+    BENCH_CHECK(find_thread(counters, platform::current_thread_id()) != nullptr);
+
+    // Slots of exited threads are handed out again once their blocks are
+    // freed, so threads that come and go never run out of them, and what
+    // the earlier threads did still shows in the totals
+    const MemCountersEx before_short_lived = counters;
+    const int short_lived_count = MEM_COUNTERS_MAX_THREADS * 3;
+    uint64_t last_id = 0;
+    for (int i = 0; i < short_lived_count; ++i)
+    {
+        std::thread short_lived([&] {
+            last_id = platform::current_thread_id();
+            Mem_generic_free(Mem_generic_align_alloc(64, 8));
+        });
+        short_lived.join();
+    }
+
+    counters = read_counters();
+    BENCH_CHECK(counters.threadCount == before_short_lived.threadCount);
+    const MemThreadCounters *last_counters = find_thread(counters, last_id);
+    BENCH_CHECK(last_counters != nullptr);
+    BENCH_CHECK(last_counters->allocCount == 1);
+    BENCH_CHECK(find_thread(counters, worker_id) == nullptr);
+    BENCH_CHECK(counters.allocCount == before_short_lived.allocCount + short_lived_count);
+    BENCH_CHECK(counters.freeCount == before_short_lived.freeCount + short_lived_count);
+    BENCH_CHECK(counters.sizeHistogram[7] == before_short_lived.sizeHistogram[7] + short_lived_count); // 64 is in [64, 128)
+
+    printf("MemoryCountersTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Compares the pooled allocator backend against the platform:: wrappers on
+// allocation patterns typical of the EOS SDK: short lived option structs,
+// a churning set of handles, and an occasional large buffer.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include "MemoryPool.h"
+#include <string.h>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_SetAllocatorBackend(int32_t backend);
+
+static const size_t kIterations = 200000;
+
+struct Allocator
+{
+    const char *name;
+    void *(*alloc)(size_t, size_t);
+    void (*free)(void*);
+};
+
+//-------------------------------------------------------------------------
+// The pooled backend without the allocation tracking done by Mem_generic_*
+static void *pooled_alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    void *pointer = memory_pool::alloc(size_in_bytes, alignment_in_bytes);
+    return pointer != nullptr ? pointer : platform::alloc_aligned(size_in_bytes, alignment_in_bytes);
+}
+
+//-------------------------------------------------------------------------
+static void pooled_free(void *pointer)
+{
+    if (memory_pool::owns(pointer))
+    {
+        memory_pool::free(pointer);
+    }
+    else
+    {
+        platform::free_aligned(pointer);
+    }
+}
+
+//-------------------------------------------------------------------------
+// Build an options struct or two, use them, drop them in reverse order
+static double option_structs(const Allocator& allocator)
+{
+    bench::Random random;
+    void *blocks[8];
+
+    auto start = bench::clock::now();
+    for (size_t i = 0; i < kIterations; ++i)
+    {
+        const size_t count = random.range(1, 8);
+        for (size_t b = 0; b < count; ++b)
+        {
+            blocks[b] = allocator.alloc(random.range(24, 200), 8);
+            memset(blocks[b], 0, 24);
+        }
+        for (size_t b = count; b > 0; --b)
+        {
+            allocator.free(blocks[b - 1]);
+        }
+    }
+    return bench::elapsed_ms(start, bench::clock::now());
+}
+
+//-------------------------------------------------------------------------
+// A few thousand live handles, replaced in random order
+static double handle_churn(const Allocator& allocator)
+{
+    bench::Random random;
+    std::vector<void*> handles(4096);
+
+    for (void*& handle : handles)
+    {
+        handle = allocator.alloc(random.range(16, 512), 16);
+    }
+
+    auto start = bench::clock::now();
+    for (size_t i = 0; i < kIterations * 4; ++i)
+    {
+        void*& handle = handles[random.next() % handles.size()];
+        allocator.free(handle);
+        handle = allocator.alloc(random.range(16, 512), 16);
+        memset(handle, 0, 16);
+    }
+    const double elapsed = bench::elapsed_ms(start, bench::clock::now());
+
+    for (void* handle : handles)
+    {
+        allocator.free(handle);
+    }
+    return elapsed;
+}
+
+//-------------------------------------------------------------------------
+// Mostly small blocks with the odd large buffer that falls through to the
+// system allocator in the pooled backend
+static double mixed_sizes(const Allocator& allocator)
+{
+    bench::Random random;
+    std::vector<void*> blocks(1024);
+
+    for (void*& block : blocks)
+    {
+        block = allocator.alloc(64, 16);
+    }
+
+    auto start = bench::clock::now();
+    for (size_t i = 0; i < kIterations * 2; ++i)
+    {
+        void*& block = blocks[random.next() % blocks.size()];
+        allocator.free(block);
+        const size_t size = (random.next() % 10 == 0) ? random.range(4096, 64 * 1024) : random.range(8, 1024);
+        block = allocator.alloc(size, 16);
+    }
+    const double elapsed = bench::elapsed_ms(start, bench::clock::now());
+
+    for (void* block : blocks)
+    {
+        allocator.free(block);
+    }
+    return elapsed;
+}
+
+//-------------------------------------------------------------------------
+static void check_pooled_backend()
+{
+    BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(MemAllocatorBackend::Pooled)));
+
+    // Every class must honour every alignment it is asked for
+    for (size_t alignment = 1; alignment <= 4096; alignment *= 2)
+    {
+        for (size_t size = 0; size <= 3000; size += 37)
+        {
+            void *block = Mem_generic_align_alloc(size, alignment);
+            BENCH_CHECK(block != nullptr);
+            BENCH_CHECK(reinterpret_cast<uintptr_t>(block) % alignment == 0);
+            memset(block, 0xAB, size);
+            Mem_generic_free(block);
+        }
+    }
+
+    // Growing a pooled block moves it between classes and keeps its contents
+    unsigned char *block = static_cast<unsigned char*>(Mem_generic_align_alloc(20, 8));
+    BENCH_CHECK(memory_pool::owns(block));
+    for (int i = 0; i < 20; ++i)
+    {
+        block[i] = static_cast<unsigned char>(i);
+    }
+    block = static_cast<unsigned char*>(Mem_generic_align_realloc(block, 5000, 8));
+    BENCH_CHECK(!memory_pool::owns(block));
+    for (int i = 0; i < 20; ++i)
+    {
+        BENCH_CHECK(block[i] == i);
+    }
+    Mem_generic_free(block);
+
+    BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(MemAllocatorBackend::System)));
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    check_pooled_backend();
+
+    const Allocator platform_allocator = { "platform::", &platform::alloc_aligned, &platform::free_aligned };
+    const Allocator pooled_allocator = { "pooled", &pooled_alloc, &pooled_free };
+
+    struct Pattern
+    {
+        const char *name;
+        double (*run)(const Allocator&);
+    };
+    const Pattern patterns[] =
+    {
+        { "option structs", &option_structs },
+        { "handle churn", &handle_churn },
+        { "mixed sizes", &mixed_sizes },
+    };
+
+    printf("Pooled backend vs. platform:: wrappers (ms, lower is better)\n");
+    printf("%-16s %12s %12s %10s\n", "pattern", "platform::", "pooled", "speedup");
+    for (const Pattern& pattern : patterns)
+    {
+        const double platform_ms = pattern.run(platform_allocator);
+        const double pooled_ms = pattern.run(pooled_allocator);
+        printf("%-16s %12.2f %12.2f %9.2fx\n", pattern.name, platform_ms, pooled_ms, platform_ms / pooled_ms);
+    }
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Multi-threaded stress test for the allocator backends. The EOS SDK
+// allocates from its own worker threads as well as from the game thread
+// during EOS_Platform_Tick, and blocks are often freed on a different
+// thread from the one that allocated them. Reports throughput at 1, 2, 4
+// and 8 threads for two patterns:
+//
+//   local churn    each thread replaces blocks in its own working set
+//   cross thread   each round, every thread frees the blocks its neighbour
+//                  allocated in the previous round
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include "MemoryPool.h"
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_SetAllocatorBackend(int32_t backend);
+
+static const size_t kOperationsPerThread = 400000;
+static const size_t kWorkingSetSize = 1024;
+static const size_t kBlocksPerRound = 512;
+
+struct Allocator
+{
+    const char *name;
+    void *(*alloc)(size_t, size_t);
+    void (*free)(void*);
+};
+
+//-------------------------------------------------------------------------
+static void *pooled_alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    void *pointer = memory_pool::alloc(size_in_bytes, alignment_in_bytes);
+    return pointer != nullptr ? pointer : platform::alloc_aligned(size_in_bytes, alignment_in_bytes);
+}
+
+//-------------------------------------------------------------------------
+static void pooled_free(void *pointer)
+{
+    if (memory_pool::owns(pointer))
+    {
+        memory_pool::free(pointer);
+    }
+    else
+    {
+        platform::free_aligned(pointer);
+    }
+}
+
+//-------------------------------------------------------------------------
+// std::barrier is C++20
+class Barrier
+{
+public:
+    explicit Barrier(size_t thread_count) : m_thread_count(thread_count) { }
+
+    void arrive_and_wait()
+    {
+        std::unique_lock<std::mutex> scope_lock(m_lock);
+        const size_t generation = m_generation;
+        if (++m_arrived == m_thread_count)
+        {
+            m_arrived = 0;
+            m_generation++;
+            m_released.notify_all();
+        }
+        else
+        {
+            m_released.wait(scope_lock, [&] { return generation != m_generation; });
+        }
+    }
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_released;
+    size_t m_thread_count;
+    size_t m_arrived = 0;
+    size_t m_generation = 0;
+};
+
+//-------------------------------------------------------------------------
+static void local_churn(const Allocator& allocator, size_t thread_index, size_t, Barrier&, std::vector<std::vector<void*>>&)
+{
+    bench::Random random(0x9E3779B97F4A7C15ULL + thread_index);
+    std::vector<void*> blocks(kWorkingSetSize);
+
+    for (void*& block : blocks)
+    {
+        block = allocator.alloc(random.range(16, 512), 16);
+    }
+
+    for (size_t i = 0; i < kOperationsPerThread / 2; ++i)
+    {
+        void*& block = blocks[random.next() % blocks.size()];
+        allocator.free(block);
+        block = allocator.alloc(random.range(16, 512), 16);
+        memset(block, 0, 16);
+    }
+
+    for (void* block : blocks)
+    {
+        allocator.free(block);
+    }
+}
+
+//-------------------------------------------------------------------------
+static void cross_thread(const Allocator& allocator, size_t thread_index, size_t thread_count, Barrier& barrier, std::vector<std::vector<void*>>& outboxes)
+{
+    bench::Random random(0x9E3779B97F4A7C15ULL + thread_index);
+    std::vector<void*>& outbox = outboxes[thread_index];
+    std::vector<void*>& inbox = outboxes[(thread_index + 1) % thread_count];
+
+    for (size_t round = 0; round < kOperationsPerThread / (2 * kBlocksPerRound); ++round)
+    {
+        for (size_t i = 0; i < kBlocksPerRound; ++i)
+        {
+            outbox[i] = allocator.alloc(random.range(16, 512), 16);
+            memset(outbox[i], 0, 16);
+        }
+
+        barrier.arrive_and_wait();
+        for (size_t i = 0; i < kBlocksPerRound; ++i)
+        {
+            allocator.free(inbox[i]);
+        }
+        barrier.arrive_and_wait();
+    }
+}
+
+typedef void (*Pattern)(const Allocator&, size_t, size_t, Barrier&, std::vector<std::vector<void*>>&);
+
+//-------------------------------------------------------------------------
+// Returns millions of operations (an alloc or a free) per second
+static double run(const Allocator& allocator, Pattern pattern, size_t thread_count)
+{
+    Barrier barrier(thread_count);
+    std::vector<std::vector<void*>> outboxes(thread_count, std::vector<void*>(kBlocksPerRound));
+    std::vector<std::thread> threads;
+
+    auto start = bench::clock::now();
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        threads.emplace_back(pattern, std::cref(allocator), i, thread_count, std::ref(barrier), std::ref(outboxes));
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    const double elapsed_ns = bench::elapsed_ns(start, bench::clock::now());
+
+    return static_cast<double>(kOperationsPerThread * thread_count) / elapsed_ns * 1.0e3;
+}
+
+//-------------------------------------------------------------------------
+// Blocks freed on another thread land in that thread's cache. Once both
+// threads have exited every block must be back in its slab, which lets all
+// but a couple of the now empty slabs go back to the system.
+static void check_cross_thread_free()
+{
+    const size_t block_count = 10000;
+    const size_t block_size = 48;
+    std::vector<void*> blocks(block_count);
+
+    std::thread producer([&] {
+        for (void*& block : blocks)
+        {
+            block = memory_pool::alloc(block_size, 16);
+            BENCH_CHECK(block != nullptr);
+            memset(block, 0xCD, block_size);
+        }
+    });
+    producer.join();
+
+    std::thread consumer([&] {
+        for (void* block : blocks)
+        {
+            memory_pool::free(block);
+        }
+    });
+    consumer.join();
+
+    size_t still_pooled = 0;
+    for (void* block : blocks)
+    {
+        still_pooled += memory_pool::owns(block) ? 1 : 0;
+    }
+    BENCH_CHECK(still_pooled <= 2 * (MEMORY_POOL_SLAB_SIZE / block_size));
+
+    // Blocks recycled through another thread's cache are never handed out twice
+    std::thread reuser([&] {
+        std::vector<void*> again(block_count);
+        for (void*& block : again)
+        {
+            block = memory_pool::alloc(block_size, 16);
+        }
+        std::sort(again.begin(), again.end());
+        BENCH_CHECK(std::adjacent_find(again.begin(), again.end()) == again.end());
+        for (void* block : again)
+        {
+            memory_pool::free(block);
+        }
+    });
+    reuser.join();
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    check_cross_thread_free();
+
+    BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(MemAllocatorBackend::Pooled)));
+
+    const Allocator allocators[] =
+    {
+        { "platform::", &platform::alloc_aligned, &platform::free_aligned },
+        { "pooled", &pooled_alloc, &pooled_free },
+        { "Mem_generic_*", &Mem_generic_align_alloc, &Mem_generic_free },
+    };
+    struct NamedPattern
+    {
+        const char *name;
+        Pattern run;
+    };
+    const NamedPattern patterns[] =
+    {
+        { "local churn", &local_churn },
+        { "cross thread", &cross_thread },
+    };
+    const size_t thread_counts[] = { 1, 2, 4, 8 };
+
+    printf("Allocator throughput, %u hardware threads (Mops/s, higher is better)\n", std::thread::hardware_concurrency());
+    for (const NamedPattern& pattern : patterns)
+    {
+        printf("\n%-16s", pattern.name);
+        for (size_t thread_count : thread_counts)
+        {
+            printf(" %7zu thr", thread_count);
+        }
+        printf("\n");
+
+        for (const Allocator& allocator : allocators)
+        {
+            printf("%-16s", allocator.name);
+            for (size_t thread_count : thread_counts)
+            {
+                printf(" %11.2f", run(allocator, pattern.run, thread_count));
+            }
+            printf("\n");
+        }
+    }
+
+    BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(MemAllocatorBackend::System)));
+
+    return 0;
+}
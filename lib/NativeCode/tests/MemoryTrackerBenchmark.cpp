@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Measures the cost of Mem_generic_free / Mem_generic_align_realloc with
+// allocation tracking on, as the number of live blocks grows. With the
+// sharded tracker the per-call cost should stay flat.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include "MemoryTracker.h"
+#include <thread>
+#include <tuple>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" void Mem_GetAllocationCounters(void *data);
+
+static const size_t kOperationCount = 200000;
+static const size_t kAlignment = 16;
+
+//-------------------------------------------------------------------------
+static int64_t current_bytes()
+{
+    MemCounters counters = { };
+    Mem_GetAllocationCounters(&counters);
+    return counters.currentMemoryAllocatedInBytes;
+}
+
+//-------------------------------------------------------------------------
+struct AllocatorFunctions
+{
+    void *(*alloc)(size_t, size_t);
+    void *(*realloc)(void*, size_t, size_t);
+    void (*free)(void*);
+};
+
+struct Timings
+{
+    double free_alloc_ns;
+    double realloc_ns;
+};
+
+//-------------------------------------------------------------------------
+static Timings time_allocator(const AllocatorFunctions& allocator, size_t live_block_count)
+{
+    bench::Random random;
+    std::vector<void*> blocks(live_block_count);
+    Timings timings = { };
+
+    for (void*& block : blocks)
+    {
+        block = allocator.alloc(random.range(16, 512), kAlignment);
+        BENCH_CHECK(block != nullptr);
+    }
+
+    auto start = bench::clock::now();
+    for (size_t i = 0; i < kOperationCount; ++i)
+    {
+        void*& block = blocks[random.next() % live_block_count];
+        allocator.free(block);
+        block = allocator.alloc(random.range(16, 512), kAlignment);
+    }
+    timings.free_alloc_ns = bench::elapsed_ns(start, bench::clock::now()) / kOperationCount;
+
+    start = bench::clock::now();
+    for (size_t i = 0; i < kOperationCount; ++i)
+    {
+        void*& block = blocks[random.next() % live_block_count];
+        block = allocator.realloc(block, random.range(16, 1024), kAlignment);
+    }
+    timings.realloc_ns = bench::elapsed_ns(start, bench::clock::now()) / kOperationCount;
+
+    for (void* block : blocks)
+    {
+        allocator.free(block);
+    }
+
+    return timings;
+}
+
+//-------------------------------------------------------------------------
+// Cost of the lookup the previous tracker did on every free and realloc: a
+// linear search of a vector of (pointer, size) pairs.
+static double time_linear_scan_lookup(size_t live_block_count)
+{
+    const size_t lookup_count = 2000;
+    bench::Random random;
+    std::vector<std::tuple<void*, size_t>> allocated_bytes(live_block_count);
+    volatile size_t found = 0;
+
+    for (size_t i = 0; i < live_block_count; ++i)
+    {
+        allocated_bytes[i] = std::tuple<void*, size_t>(reinterpret_cast<void*>((i + 1) * 16), 16);
+    }
+
+    auto start = bench::clock::now();
+    for (size_t i = 0; i < lookup_count; ++i)
+    {
+        void* wanted = reinterpret_cast<void*>((random.next() % live_block_count + 1) * 16);
+        for (auto iter = allocated_bytes.begin(); iter != allocated_bytes.end(); ++iter)
+        {
+            if (std::get<0>(*iter) == wanted)
+            {
+                found = found + 1;
+                break;
+            }
+        }
+    }
+    return bench::elapsed_ns(start, bench::clock::now()) / lookup_count;
+}
+
+//-------------------------------------------------------------------------
+// The same access pattern is run against the untracked platform:: functions
+// and against the tracked Mem_generic_* entry points; the difference is the
+// cost of tracking, which should not depend on the live block count.
+static void run_with_live_blocks(size_t live_block_count)
+{
+    const AllocatorFunctions untracked = { &platform::alloc_aligned, &platform::realloc_aligned, &platform::free_aligned };
+    const AllocatorFunctions tracked = { &Mem_generic_align_alloc, &Mem_generic_align_realloc, &Mem_generic_free };
+
+    const Timings baseline = time_allocator(untracked, live_block_count);
+    const Timings with_tracking = time_allocator(tracked, live_block_count);
+
+    BENCH_CHECK(memory_tracker::live_allocation_count() == 0);
+    BENCH_CHECK(current_bytes() == 0);
+
+    printf("%12zu %14.1f %14.1f %14.1f %14.1f %18.1f\n",
+        live_block_count,
+        with_tracking.free_alloc_ns, with_tracking.free_alloc_ns - baseline.free_alloc_ns,
+        with_tracking.realloc_ns, with_tracking.realloc_ns - baseline.realloc_ns,
+        time_linear_scan_lookup(live_block_count));
+}
+
+//-------------------------------------------------------------------------
+// Hammer the tracker from several threads at once; the counters must come
+// back to zero afterwards.
+static void run_concurrent(size_t thread_count)
+{
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([t]()
+        {
+            bench::Random random(t + 1);
+            std::vector<void*> blocks(1024);
+            for (void*& block : blocks)
+            {
+                block = Mem_generic_align_alloc(random.range(16, 256), kAlignment);
+            }
+            for (size_t i = 0; i < kOperationCount / 4; ++i)
+            {
+                void*& block = blocks[random.next() % blocks.size()];
+                Mem_generic_free(block);
+                block = Mem_generic_align_alloc(random.range(16, 256), kAlignment);
+            }
+            for (void* block : blocks)
+            {
+                Mem_generic_free(block);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    BENCH_CHECK(memory_tracker::live_allocation_count() == 0);
+    BENCH_CHECK(current_bytes() == 0);
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    printf("Allocation tracker cost vs. live block count\n");
+    printf("(ns per operation; overhead is relative to the untracked platform:: calls)\n");
+    printf("%12s %14s %14s %14s %14s %18s\n", "live blocks", "free+alloc", "overhead", "realloc", "overhead", "old linear lookup");
+
+    const size_t live_block_counts[] = { 100, 1000, 10000, 50000, 100000, 250000 };
+    for (size_t live_block_count : live_block_counts)
+    {
+        run_with_live_blocks(live_block_count);
+    }
+
+    run_concurrent(8);
+    printf("concurrent check with 8 threads: ok\n");
+
+    return 0;
+}
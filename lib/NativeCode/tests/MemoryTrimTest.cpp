@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that Mem_Trim gives back empty pool slabs (including ones held by
+// another thread's cache, once that thread next touches the pool) and
+// spare tracker capacity, that resident memory actually drops, and that
+// the idle policy trims once the allocator has gone quiet.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include "MemoryTrim.h"
+#include <stdio.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_SetAllocatorBackend(int32_t backend);
+extern "C" uint64_t Mem_Trim();
+extern "C" bool Mem_SetIdleTrimTimeout(uint64_t idle_timeout_ms);
+
+#define KIB 1024
+
+//-------------------------------------------------------------------------
+static int64_t resident_bytes()
+{
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+    {
+        return -1;
+    }
+
+    long long total_pages = 0;
+    long long resident_pages = 0;
+    const int read = fscanf(statm, "%lld %lld", &total_pages, &resident_pages);
+    fclose(statm);
+
+    return read == 2 ? resident_pages * 4096 : -1;
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(MemAllocatorBackend::Pooled)));
+    Mem_Trim();
+
+    // Fill a few hundred slabs and the tracker, then let go of everything
+    std::vector<void*> blocks;
+    for (int i = 0; i < 200000; ++i)
+    {
+        void *block = Mem_generic_align_alloc(64 + (i % 8) * 64, 16);
+        static_cast<char*>(block)[0] = 1;
+        blocks.push_back(block);
+    }
+    for (void *block : blocks)
+    {
+        Mem_generic_free(block);
+    }
+    blocks.clear();
+    blocks.shrink_to_fit();
+
+    const int64_t before = resident_bytes();
+    const uint64_t released = Mem_Trim();
+    const int64_t after = resident_bytes();
+
+    // The tracker grew to hold 200000 entries and the pool keeps a couple of
+    // empty slabs per class
+    BENCH_CHECK(released >= 4 * 1024 * KIB);
+    BENCH_CHECK(before < 0 || before - after >= 4 * 1024 * KIB);
+    printf("trim released %.1f MiB, resident %.1f -> %.1f MiB\n",
+        released / (1024.0 * 1024.0), before / (1024.0 * 1024.0), after / (1024.0 * 1024.0));
+
+    // Nothing left to give back
+    BENCH_CHECK(Mem_Trim() == 0);
+
+    // A slab held by another thread's cache is released after that thread
+    // has touched the pool again
+    std::mutex lock;
+    std::condition_variable changed;
+    int step = 0;
+    std::thread other([&]()
+    {
+        std::vector<void*> held;
+        for (int i = 0; i < 40; ++i)
+        {
+            held.push_back(Mem_generic_align_alloc(2048, 16));
+        }
+        for (void *block : held)
+        {
+            Mem_generic_free(block);
+        }
+
+        std::unique_lock<std::mutex> step_lock(lock);
+        step = 1;
+        changed.notify_all();
+        changed.wait(step_lock, [&]() { return step == 2; });
+
+        Mem_generic_free(Mem_generic_align_alloc(16, 16));
+        step = 3;
+        changed.notify_all();
+        changed.wait(step_lock, [&]() { return step == 4; });
+    });
+
+    {
+        std::unique_lock<std::mutex> step_lock(lock);
+        changed.wait(step_lock, [&]() { return step == 1; });
+    }
+    const uint64_t while_cached = Mem_Trim();
+    {
+        std::unique_lock<std::mutex> step_lock(lock);
+        step = 2;
+        changed.notify_all();
+        changed.wait(step_lock, [&]() { return step == 3; });
+    }
+    const uint64_t after_flush = Mem_Trim();
+    BENCH_CHECK(after_flush >= 64 * KIB);
+    printf("cached slabs: %llu bytes while held, %llu after the owner flushed\n",
+        static_cast<unsigned long long>(while_cached), static_cast<unsigned long long>(after_flush));
+    {
+        std::lock_guard<std::mutex> step_lock(lock);
+        step = 4;
+        changed.notify_all();
+    }
+    other.join();
+
+    // Idle policy: nothing happens while the allocator is busy, one trim
+    // once it's been quiet for the timeout, and no more until it's busy again
+    BENCH_CHECK(Mem_SetIdleTrimTimeout(50));
+    const uint64_t idle_trims = memory_trim::idle_trim_count();
+    const auto busy_until = bench::clock::now() + std::chrono::milliseconds(150);
+    while (bench::clock::now() < busy_until)
+    {
+        Mem_generic_free(Mem_generic_align_alloc(256, 16));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    BENCH_CHECK(memory_trim::idle_trim_count() == idle_trims);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    BENCH_CHECK(memory_trim::idle_trim_count() == idle_trims + 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    BENCH_CHECK(memory_trim::idle_trim_count() == idle_trims + 1);
+
+    Mem_generic_free(Mem_generic_align_alloc(256, 16));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    BENCH_CHECK(memory_trim::idle_trim_count() == idle_trims + 2);
+
+    BENCH_CHECK(Mem_SetIdleTrimTimeout(0));
+
+    printf("MemoryTrimTest: ok\n");
+    return 0;
+}
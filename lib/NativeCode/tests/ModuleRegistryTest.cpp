@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that GetModuleHandle finds what LoadLibrary loaded, for as long
+// as the LoadLibrary calls haven't all been matched by FreeLibrary, and
+// that lookups stay right while other threads load and free libraries.
+
+#include "BenchmarkCommon.h"
+#include "ModuleRegistry.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+extern "C" void *LoadLibrary(const char *library_path);
+extern "C" bool FreeLibrary(void *library_handle);
+extern "C" void *GetModuleHandle(const char *stemname);
+
+static const char *kStandInExportsPath = "build/tests/libStandInEOSExports.so";
+static const char *kStandInExportsStem = "libStandInEOSExports";
+static const char *kStandInSDKPath = "build/tests/libStandInEOSSDK.so";
+static const char *kStandInSDKStem = "libStandInEOSSDK";
+
+static const int kReaderCount = 3;
+static const int kWriterRounds = 2000;
+
+//-------------------------------------------------------------------------
+int main()
+{
+    BENCH_CHECK(GetModuleHandle(kStandInExportsStem) == nullptr);
+    BENCH_CHECK(GetModuleHandle(nullptr) == nullptr);
+    BENCH_CHECK(LoadLibrary("build/tests/libStandInMissing.so") == nullptr);
+    BENCH_CHECK(module_registry::module_count() == 0);
+
+    // Found until every LoadLibrary has been matched
+    void *exports_handle = LoadLibrary(kStandInExportsPath);
+    BENCH_CHECK(exports_handle != nullptr);
+    BENCH_CHECK(LoadLibrary(kStandInExportsPath) == exports_handle);
+    BENCH_CHECK(GetModuleHandle(kStandInExportsStem) == exports_handle);
+    BENCH_CHECK(GetModuleHandle("libStandInEOSExports.so") == nullptr);
+    BENCH_CHECK(FreeLibrary(exports_handle));
+    BENCH_CHECK(GetModuleHandle(kStandInExportsStem) == exports_handle);
+    BENCH_CHECK(FreeLibrary(exports_handle));
+    BENCH_CHECK(GetModuleHandle(kStandInExportsStem) == nullptr);
+    BENCH_CHECK(dlopen(kStandInExportsPath, RTLD_NOW | RTLD_NOLOAD) == nullptr);
+    BENCH_CHECK(module_registry::module_count() == 0);
+
+    // One library stays loaded throughout while writers take and drop
+    // references to it, and load and unload another one completely
+    exports_handle = LoadLibrary(kStandInExportsPath);
+    BENCH_CHECK(exports_handle != nullptr);
+
+    std::atomic<bool> writers_done(false);
+    std::atomic<int> wrong_lookups(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kReaderCount; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            while (!writers_done.load())
+            {
+                if (GetModuleHandle(kStandInExportsStem) != exports_handle)
+                {
+                    wrong_lookups.fetch_add(1);
+                }
+                GetModuleHandle(kStandInSDKStem);
+            }
+        });
+    }
+
+    std::thread exports_writer([&]()
+    {
+        for (int round = 0; round < kWriterRounds; ++round)
+        {
+            void *handle = LoadLibrary(kStandInExportsPath);
+            if (handle != exports_handle)
+            {
+                wrong_lookups.fetch_add(1);
+            }
+            FreeLibrary(handle);
+        }
+    });
+    std::thread sdk_writer([&]()
+    {
+        for (int round = 0; round < kWriterRounds; ++round)
+        {
+            void *handle = LoadLibrary(kStandInSDKPath);
+            if (handle == nullptr || GetModuleHandle(kStandInSDKStem) != handle)
+            {
+                wrong_lookups.fetch_add(1);
+            }
+            FreeLibrary(handle);
+        }
+    });
+
+    exports_writer.join();
+    sdk_writer.join();
+    writers_done.store(true);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    BENCH_CHECK(wrong_lookups.load() == 0);
+    BENCH_CHECK(GetModuleHandle(kStandInSDKStem) == nullptr);
+    BENCH_CHECK(GetModuleHandle(kStandInExportsStem) == exports_handle);
+    BENCH_CHECK(module_registry::module_count() == 1);
+    BENCH_CHECK(FreeLibrary(exports_handle));
+    BENCH_CHECK(module_registry::module_count() == 0);
+
+    printf("ModuleRegistryTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Correctness checks for the platform:: memory functions: every block keeps
+// the alignment it was asked for through long chains of reallocs across
+// the small/large boundary, contents survive every move, and resizing to
+// 0 bytes keeps the block valid.
+
+#include "BenchmarkCommon.h"
+#include "Memory.h"
+#include <string.h>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_SetAllocatorBackend(int32_t backend);
+
+typedef void *(*ReallocFunction)(void*, size_t, size_t);
+
+//-------------------------------------------------------------------------
+static bool is_aligned(const void *pointer, size_t alignment_in_bytes)
+{
+    return alignment_in_bytes == 0 || (reinterpret_cast<uintptr_t>(pointer) & (alignment_in_bytes - 1)) == 0;
+}
+
+//-------------------------------------------------------------------------
+static void fill(void *pointer, size_t size_in_bytes, uint8_t seed)
+{
+    uint8_t *bytes = static_cast<uint8_t*>(pointer);
+    for (size_t i = 0; i < size_in_bytes; ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(seed + i * 31);
+    }
+}
+
+//-------------------------------------------------------------------------
+static bool matches(const void *pointer, size_t size_in_bytes, uint8_t seed)
+{
+    const uint8_t *bytes = static_cast<const uint8_t*>(pointer);
+    for (size_t i = 0; i < size_in_bytes; ++i)
+    {
+        if (bytes[i] != static_cast<uint8_t>(seed + i * 31))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Random walks of realloc calls per alignment, with sizes spanning pooled,
+// malloc'd and mapped blocks
+static void check_realloc_sequences(void *(*alloc)(size_t, size_t), ReallocFunction realloc_function, void (*free_function)(void*))
+{
+    bench::Random random;
+    const size_t size_limits[] = { 256, 4096, 64 * 1024, 2 * 1024 * 1024 };
+
+    for (size_t alignment = 1; alignment <= 64 * 1024; alignment *= 2)
+    {
+        for (size_t size_limit : size_limits)
+        {
+            size_t size = random.range(0, size_limit);
+            uint8_t seed = static_cast<uint8_t>(random.next());
+            void *block = alloc(size, alignment);
+            BENCH_CHECK(block != nullptr);
+            BENCH_CHECK(is_aligned(block, alignment));
+            fill(block, size, seed);
+
+            for (int step = 0; step < 40; ++step)
+            {
+                const size_t new_size = random.range(0, size_limit);
+                void *resized = realloc_function(block, new_size, alignment);
+                BENCH_CHECK(resized != nullptr);
+                BENCH_CHECK(is_aligned(resized, alignment));
+                BENCH_CHECK(matches(resized, size < new_size ? size : new_size, seed));
+
+                block = resized;
+                size = new_size;
+                seed = static_cast<uint8_t>(random.next());
+                fill(block, size, seed);
+            }
+
+            free_function(block);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------
+static void check_platform_functions()
+{
+    check_realloc_sequences(&platform::alloc_aligned, &platform::realloc_aligned, &platform::free_aligned);
+
+    // Size lookups come from the block header
+    void *block = platform::alloc_aligned(100, 64);
+    BENCH_CHECK(platform::mem_usable_size(block) >= 100);
+
+    // Growing far past the mapping threshold and back again in place
+    block = platform::realloc_aligned(block, 8 * 1024 * 1024, 64);
+    BENCH_CHECK(block != nullptr && is_aligned(block, 64));
+    BENCH_CHECK(platform::mem_usable_size(block) >= 8 * 1024 * 1024);
+    fill(block, 8 * 1024 * 1024, 7);
+    block = platform::realloc_aligned(block, 16 * 1024 * 1024, 64);
+    BENCH_CHECK(block != nullptr && is_aligned(block, 64));
+    BENCH_CHECK(matches(block, 8 * 1024 * 1024, 7));
+
+    // Resizing to nothing keeps a valid block that can grow again
+    block = platform::realloc_aligned(block, 0, 64);
+    BENCH_CHECK(block != nullptr && is_aligned(block, 64));
+    block = platform::realloc_aligned(block, 32, 64);
+    BENCH_CHECK(block != nullptr && is_aligned(block, 64));
+    platform::free_aligned(block);
+
+    // A realloc may ask for more alignment than the block was allocated with
+    block = platform::alloc_aligned(48, 8);
+    fill(block, 48, 3);
+    block = platform::realloc_aligned(block, 48, 4096);
+    BENCH_CHECK(block != nullptr && is_aligned(block, 4096));
+    BENCH_CHECK(matches(block, 48, 3));
+    platform::free_aligned(block);
+
+    // Zero sized allocations are distinct, freeable blocks
+    void *first = platform::alloc_aligned(0, 16);
+    void *second = platform::alloc_aligned(0, 16);
+    BENCH_CHECK(first != nullptr && second != nullptr && first != second);
+    platform::free_aligned(first);
+    platform::free_aligned(second);
+    platform::free_aligned(nullptr);
+
+    void *pages = platform::alloc_pages(3 * 64 * 1024, 64 * 1024);
+    BENCH_CHECK(pages != nullptr && is_aligned(pages, 64 * 1024));
+    memset(pages, 0xEE, 3 * 64 * 1024);
+    platform::free_pages(pages, 3 * 64 * 1024);
+}
+
+//-------------------------------------------------------------------------
+static void check_generic_functions(MemAllocatorBackend backend)
+{
+    BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(backend)));
+    check_realloc_sequences(&Mem_generic_align_alloc, &Mem_generic_align_realloc, &Mem_generic_free);
+
+    void *block = Mem_generic_align_alloc(64, 16);
+    block = Mem_generic_align_realloc(block, 0, 16);
+    BENCH_CHECK(block != nullptr);
+    Mem_generic_free(block);
+
+    BENCH_CHECK(Mem_SetAllocatorBackend(static_cast<int32_t>(MemAllocatorBackend::System)));
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    check_platform_functions();
+    check_generic_functions(MemAllocatorBackend::System);
+    check_generic_functions(MemAllocatorBackend::Pooled);
+
+    printf("PlatformMemoryTest: ok\n");
+    return 0;
+}
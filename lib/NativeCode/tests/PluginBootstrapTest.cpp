@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Lays out a player's Data directory the way GfxPluginNativeRender expects
+// to find it, with a stand-in for the EOS SDK, and checks that
+// UnityPluginLoad reads the configs next to it and creates the platform
+// from them: the allocator from DynamicLibraryLoaderHelper, log levels,
+// Steam options, the sandbox deployment override, and sandbox and
+// deployment IDs from the command line, and logs how long each phase
+// took. Each load runs in a process of its own, as the plugin's state and
+// command line are per process.
+
+#include "BenchmarkCommon.h"
+#include "StandInEOSPlatform.h"
+#include "eos_sdk.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+typedef void (*UnityPluginLoad_t)(void*);
+typedef void (*UnityPluginUnload_t)();
+typedef void *(*EOS_GetPlatformInterface_t)();
+typedef void (*log_flush_function_t)(const char* str);
+typedef void (*global_log_flush_with_function_t)(log_flush_function_t log_flush_function);
+
+static const char *kPluginName = "libGfxPluginNativeRender-x64.so";
+static const char *kSDKName = "libEOSSDK-Linux-Shipping.so";
+static const char *kDLLHName = "libDynamicLibraryLoaderHelper.so";
+
+static const char *kConfig = R"({
+    "productName": "PluginBootstrapTest",
+    "productVersion": "1.2",
+    "productID": "product",
+    "sandboxID": "sandbox_from_config",
+    "deploymentID": "deployment_from_config",
+    "sandboxDeploymentOverrides": [
+        { "sandboxID": "other_sandbox", "deploymentID": "other_deployment" },
+        { "sandboxID": "sandbox_from_config", "deploymentID": "deployment_from_override" }
+    ],
+    "clientID": "client",
+    "clientSecret": "secret",
+    "platformOptionsFlags": [ "DisableOverlay" ],
+    "tickBudgetInMilliseconds": "5",
+    "ThreadAffinity_networkWork": 3,
+    "memoryAllocatorBackend": "Pooled",
+    "isServer": true
+})";
+
+static const char *kLogLevelConfig = R"({
+    "LogCategoryLevelPairs": [
+        { "Category": "Core", "Level": "Warning" },
+        { "Category": "Auth", "Level": "Error" },
+        { "Category": "AllCategories", "Level": "Info" }
+    ]
+})";
+
+static const char *kSteamConfig = R"({
+    "flags": [ "ManagedBySDK" ],
+    "steamSDKMajorVersion": 1,
+    "steamSDKMinorVersion": "57",
+    "steamApiInterfaceVersionsArray": [ "SteamUser023", "SteamFriends017" ]
+})";
+
+static std::vector<std::string> s_flushed_lines;
+
+//-------------------------------------------------------------------------
+static void collect_log_line(const char *str)
+{
+    s_flushed_lines.emplace_back(str);
+}
+
+//-------------------------------------------------------------------------
+static bool log_has_line(const char *text)
+{
+    for (const std::string& line : s_flushed_lines)
+    {
+        if (line.find(text) != std::string::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//-------------------------------------------------------------------------
+static void write_file(const fs::path& path, const char *contents)
+{
+    std::ofstream file(path, std::ios::binary);
+    file << contents;
+    BENCH_CHECK(file.good());
+}
+
+//-------------------------------------------------------------------------
+// Loads the plugin from the layout under root, as Unity would, and checks
+// what it did against the stand-in
+static int run_load(const fs::path& root, const std::string& expected_sandbox, const std::string& expected_deployment)
+{
+    const fs::path cache_directory = root / "cache";
+    setenv("XDG_CACHE_HOME", cache_directory.c_str(), 1);
+
+    const fs::path plugins_directory = root / "Data" / "Plugins";
+    void *plugin_handle = dlopen((plugins_directory / kPluginName).c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (plugin_handle == nullptr)
+    {
+        fprintf(stderr, "%s\n", dlerror());
+    }
+    BENCH_CHECK(plugin_handle != nullptr);
+
+    auto UnityPluginLoad_ptr = reinterpret_cast<UnityPluginLoad_t>(dlsym(plugin_handle, "UnityPluginLoad"));
+    auto UnityPluginUnload_ptr = reinterpret_cast<UnityPluginUnload_t>(dlsym(plugin_handle, "UnityPluginUnload"));
+    auto EOS_GetPlatformInterface_ptr = reinterpret_cast<EOS_GetPlatformInterface_t>(dlsym(plugin_handle, "EOS_GetPlatformInterface"));
+    auto global_log_flush_with_function_ptr = reinterpret_cast<global_log_flush_with_function_t>(dlsym(plugin_handle, "global_log_flush_with_function"));
+    BENCH_CHECK(UnityPluginLoad_ptr != nullptr && UnityPluginUnload_ptr != nullptr);
+    BENCH_CHECK(EOS_GetPlatformInterface_ptr != nullptr && global_log_flush_with_function_ptr != nullptr);
+
+    BENCH_CHECK(EOS_GetPlatformInterface_ptr() == nullptr);
+    UnityPluginLoad_ptr(nullptr);
+    BENCH_CHECK(EOS_GetPlatformInterface_ptr() == STANDIN_PLATFORM_HANDLE);
+
+    // The plugin loaded the stand-in from next to itself
+    void *sdk_handle = dlopen((plugins_directory / kSDKName).c_str(), RTLD_NOW | RTLD_NOLOAD);
+    BENCH_CHECK(sdk_handle != nullptr);
+    auto StandIn_GetPlatformRecord_ptr = reinterpret_cast<StandIn_GetPlatformRecord_t>(dlsym(sdk_handle, "StandIn_GetPlatformRecord"));
+    BENCH_CHECK(StandIn_GetPlatformRecord_ptr != nullptr);
+    const StandInPlatformRecord& record = *StandIn_GetPlatformRecord_ptr();
+
+    BENCH_CHECK(record.initializeCount == 1 && record.platformCreateCount == 1);
+    BENCH_CHECK(record.productName == "PluginBootstrapTest" && record.productVersion == "1.2");
+    BENCH_CHECK(record.hasAllocatorFunctions);
+    BENCH_CHECK(record.networkWorkAffinity == 3);
+
+    BENCH_CHECK(record.productId == "product");
+    BENCH_CHECK(record.sandboxId == expected_sandbox);
+    BENCH_CHECK(record.deploymentId == expected_deployment);
+    BENCH_CHECK(record.clientId == "client" && record.clientSecret == "secret");
+    BENCH_CHECK(record.cacheDirectory == cache_directory.string() + "/");
+    BENCH_CHECK(record.flags == EOS_PF_DISABLE_OVERLAY);
+    BENCH_CHECK(record.tickBudgetInMilliseconds == 5);
+    BENCH_CHECK(record.isServer);
+
+    // Every category at once in eos_init, then each one in the config but
+    // the last, AllCategories
+    BENCH_CHECK(record.setLogLevelCount == 3);
+    BENCH_CHECK(record.hasLogCallback);
+
+    BENCH_CHECK(record.hasSteamOptions);
+    BENCH_CHECK(record.steamMajorVersion == 1 && record.steamMinorVersion == 57);
+    BENCH_CHECK(record.steamApiInterfaceVersionsArrayBytes == strlen("SteamUser023") + 1 + strlen("SteamFriends017") + 1 + 1);
+
+    // No log file was opened, so the log waits for the managed side
+    global_log_flush_with_function_ptr(&collect_log_line);
+    BENCH_CHECK(log_has_line("On UnityPluginLoad"));
+
+    // Every phase says how long it took, those that ran side by side too
+    const char *phases[] = { "config", "log level config", "steam config", "sdk library", "init", "create" };
+    for (const char *phase : phases)
+    {
+        BENCH_CHECK(log_has_line((std::string("Bootstrap phase ") + phase + " took ").c_str()));
+    }
+    BENCH_CHECK(log_has_line("Bootstrap took "));
+
+    UnityPluginUnload_ptr();
+    BENCH_CHECK(fs::exists(cache_directory / "eos_memory_leak_report.txt"));
+
+    dlclose(sdk_handle);
+    dlclose(plugin_handle);
+    return 0;
+}
+
+//-------------------------------------------------------------------------
+// Runs this test again as run_load, with plugin_arguments on its command line
+static void run_load_in_child(const char *test_path, const fs::path& root, const char *expected_sandbox, const char *expected_deployment, std::vector<const char*> plugin_arguments)
+{
+    std::vector<const char*> arguments = { test_path, "--load", root.c_str(), expected_sandbox, expected_deployment };
+    arguments.insert(arguments.end(), plugin_arguments.begin(), plugin_arguments.end());
+    arguments.push_back(nullptr);
+
+    fflush(stdout);
+    const pid_t pid = fork();
+    BENCH_CHECK(pid >= 0);
+    if (pid == 0)
+    {
+        execv(test_path, const_cast<char* const*>(arguments.data()));
+        _exit(127);
+    }
+
+    int status = 0;
+    BENCH_CHECK(waitpid(pid, &status, 0) == pid);
+    BENCH_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+//-------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc >= 5 && strcmp(argv[1], "--load") == 0)
+    {
+        return run_load(argv[2], argv[3], argv[4]);
+    }
+
+    // Built next to the test, and the plugin and helper above it
+    const fs::path test_directory = fs::absolute(argv[0]).parent_path();
+    const fs::path build_directory = test_directory.parent_path();
+
+    char root_template[] = "/tmp/PluginBootstrapTest.XXXXXX";
+    BENCH_CHECK(mkdtemp(root_template) != nullptr);
+    const fs::path root = root_template;
+
+    const fs::path plugins_directory = root / "Data" / "Plugins";
+    const fs::path config_directory = root / "Data" / "StreamingAssets" / "EOS";
+    fs::create_directories(plugins_directory);
+    fs::create_directories(config_directory);
+    fs::create_directories(root / "cache");
+
+    fs::copy_file(build_directory / kPluginName, plugins_directory / kPluginName);
+    fs::copy_file(build_directory / kDLLHName, plugins_directory / kDLLHName);
+    fs::copy_file(test_directory / "libStandInEOSPlatform.so", plugins_directory / kSDKName);
+
+    write_file(config_directory / "EpicOnlineServicesConfig.json", kConfig);
+    write_file(config_directory / "log_level_config.json", kLogLevelConfig);
+    write_file(config_directory / "eos_steam_config.json", kSteamConfig);
+
+    const fs::path test_path = fs::absolute(argv[0]);
+
+    // The sandbox in the config has a deployment of its own
+    run_load_in_child(test_path.c_str(), root, "sandbox_from_config", "deployment_from_override", {});
+
+    // The command line wins over both, under either spelling
+    run_load_in_child(test_path.c_str(), root, "sandbox_from_command_line", "deployment_from_command_line",
+        { "-eossandboxid=sandbox_from_command_line", "-epicdeploymentid=deployment_from_command_line" });
+
+    // A sandbox from the command line still picks up its override
+    run_load_in_child(test_path.c_str(), root, "other_sandbox", "other_deployment",
+        { "-epicsandboxid=other_sandbox" });
+
+    fs::remove_all(root);
+
+    printf("PluginBootstrapTest: ok\n");
+    return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Stands in for the EOS SDK's export table, which has several hundred
+// functions, for the loader tests and benchmarks. See StandInEOSExports.h.
+
+#include "StandInEOSExports.h"
+
+#define STANDIN_EXPORT extern "C" __attribute__((visibility("default")))
+
+#define STANDIN_EXPORT_FUNCTION(number) STANDIN_EXPORT int32_t EOS_StandInExport_##number() { return 1##number - 1000; }
+#define STANDIN_EXPORT_TENS(prefix) \
+    STANDIN_EXPORT_FUNCTION(prefix##0) STANDIN_EXPORT_FUNCTION(prefix##1) STANDIN_EXPORT_FUNCTION(prefix##2) STANDIN_EXPORT_FUNCTION(prefix##3) STANDIN_EXPORT_FUNCTION(prefix##4) \
+    STANDIN_EXPORT_FUNCTION(prefix##5) STANDIN_EXPORT_FUNCTION(prefix##6) STANDIN_EXPORT_FUNCTION(prefix##7) STANDIN_EXPORT_FUNCTION(prefix##8) STANDIN_EXPORT_FUNCTION(prefix##9)
+#define STANDIN_EXPORT_HUNDREDS(prefix) \
+    STANDIN_EXPORT_TENS(prefix##0) STANDIN_EXPORT_TENS(prefix##1) STANDIN_EXPORT_TENS(prefix##2) STANDIN_EXPORT_TENS(prefix##3) STANDIN_EXPORT_TENS(prefix##4) \
+    STANDIN_EXPORT_TENS(prefix##5) STANDIN_EXPORT_TENS(prefix##6) STANDIN_EXPORT_TENS(prefix##7) STANDIN_EXPORT_TENS(prefix##8) STANDIN_EXPORT_TENS(prefix##9)
+
+STANDIN_EXPORT_HUNDREDS(0)
+STANDIN_EXPORT_HUNDREDS(1)
+STANDIN_EXPORT_HUNDREDS(2)
+STANDIN_EXPORT_HUNDREDS(3)
+STANDIN_EXPORT_HUNDREDS(4)
+STANDIN_EXPORT_HUNDREDS(5)
+STANDIN_EXPORT_HUNDREDS(6)
+STANDIN_EXPORT_HUNDREDS(7)
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Names of the functions exported by the library built from
+// StandInEOSExports.cpp, which stands in for the EOS SDK's export table.
+
+#pragma once
+#include <stdio.h>
+#include <inttypes.h>
+
+// EOS_StandInExport_000 to EOS_StandInExport_799
+#define STANDIN_EXPORT_COUNT 800
+
+// EOS_StandInExport_NNN returns NNN
+typedef int32_t (*StandInExport_t)();
+
+inline void standin_export_name(int index, char *out_name, size_t out_name_size)
+{
+    snprintf(out_name, out_name_size, "EOS_StandInExport_%03d", index);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Exports every function in EOSFunctionTable.inl under its EOS SDK name,
+// for the tests and benchmarks of the dispatch table in EOSFunctions.h.
+// None of them do anything but note that they were called and return
+// zero, which the x86-64 and arm64 calling conventions let them do for
+// whatever arguments the real signature has. StandIn_SumArguments is the
+// exception, for checking that a call arrives with its arguments intact.
+
+#include <stdint.h>
+
+#define STANDIN_EXPORT extern "C" __attribute__((visibility("default")))
+
+namespace
+{
+    const char *s_last_called = nullptr;
+    uint64_t s_call_count = 0;
+}
+
+#define EOS_FUNCTION(name, binding) \
+    STANDIN_EXPORT uintptr_t name() \
+    { \
+        s_last_called = #name; \
+        s_call_count++; \
+        return 0; \
+    }
+#include "EOSFunctionTable.inl"
+#undef EOS_FUNCTION
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT const char * StandIn_LastCalled()
+{
+    return s_last_called;
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT uint64_t StandIn_CallCount()
+{
+    return s_call_count;
+}
+
+//-------------------------------------------------------------------------
+// Takes more integer and floating point arguments than fit in registers,
+// so some of each are passed on the stack. Weighted so that swapping two
+// arguments changes the result.
+STANDIN_EXPORT double StandIn_SumArguments(int64_t i0, int64_t i1, int64_t i2, int64_t i3, int64_t i4, int64_t i5, int64_t i6, int64_t i7,
+    double d0, double d1, double d2, double d3, double d4, double d5, double d6, double d7, double d8, double d9)
+{
+    const int64_t integers[] = { i0, i1, i2, i3, i4, i5, i6, i7 };
+    const double doubles[] = { d0, d1, d2, d3, d4, d5, d6, d7, d8, d9 };
+
+    double sum = 0.0;
+    for (int i = 0; i < 8; ++i)
+    {
+        sum += static_cast<double>(integers[i] * (i + 1));
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        sum += doubles[i] * (i + 11);
+    }
+    return sum;
+}
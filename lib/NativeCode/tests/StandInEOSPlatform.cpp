@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Stands in for the EOS SDK that GfxPluginNativeRender loads at startup,
+// for PluginBootstrapTest. It exports the functions the bootstrap calls,
+// under their SDK names and with their SDK signatures, and notes down what
+// it was asked to do; see StandInEOSPlatform.h. Everything else the
+// dispatch table has is lazy, so the bootstrap never misses it.
+
+#include "StandInEOSPlatform.h"
+#include "eos_sdk.h"
+#include "eos_logging.h"
+
+#define STANDIN_EXPORT extern "C" __attribute__((visibility("default")))
+
+namespace
+{
+    StandInPlatformRecord s_record = {};
+    int s_options_container = 0;
+}
+
+//-------------------------------------------------------------------------
+static std::string string_or_empty(const char *str)
+{
+    return str != nullptr ? std::string(str) : std::string();
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT EOS_EResult EOS_Initialize(const EOS_InitializeOptions *Options)
+{
+    s_record.initializeCount++;
+    s_record.productName = string_or_empty(Options->ProductName);
+    s_record.productVersion = string_or_empty(Options->ProductVersion);
+    s_record.hasAllocatorFunctions = Options->AllocateMemoryFunction != nullptr
+        && Options->ReallocateMemoryFunction != nullptr
+        && Options->ReleaseMemoryFunction != nullptr;
+    s_record.networkWorkAffinity = Options->OverrideThreadAffinity != nullptr ? Options->OverrideThreadAffinity->NetworkWork : 0;
+    return EOS_EResult::EOS_Success;
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT EOS_EResult EOS_Shutdown()
+{
+    return EOS_EResult::EOS_Success;
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT EOS_HPlatform EOS_Platform_Create(const EOS_Platform_Options *Options)
+{
+    s_record.platformCreateCount++;
+    s_record.productId = string_or_empty(Options->ProductId);
+    s_record.sandboxId = string_or_empty(Options->SandboxId);
+    s_record.deploymentId = string_or_empty(Options->DeploymentId);
+    s_record.clientId = string_or_empty(Options->ClientCredentials.ClientId);
+    s_record.clientSecret = string_or_empty(Options->ClientCredentials.ClientSecret);
+    s_record.cacheDirectory = string_or_empty(Options->CacheDirectory);
+    s_record.flags = Options->Flags;
+    s_record.tickBudgetInMilliseconds = Options->TickBudgetInMilliseconds;
+    s_record.isServer = Options->bIsServer == EOS_TRUE;
+    return reinterpret_cast<EOS_HPlatform>(STANDIN_PLATFORM_HANDLE);
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT void EOS_Platform_Release(EOS_HPlatform)
+{
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT EOS_EResult EOS_Logging_SetCallback(EOS_LogMessageFunc Callback)
+{
+    s_record.hasLogCallback = Callback != nullptr;
+    return EOS_EResult::EOS_Success;
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT EOS_EResult EOS_Logging_SetLogLevel(EOS_ELogCategory, EOS_ELogLevel)
+{
+    s_record.setLogLevelCount++;
+    return EOS_EResult::EOS_Success;
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT EOS_EResult EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainer(const EOS_IntegratedPlatform_CreateIntegratedPlatformOptionsContainerOptions *, EOS_HIntegratedPlatformOptionsContainer *OutIntegratedPlatformOptionsContainerHandle)
+{
+    *OutIntegratedPlatformOptionsContainerHandle = reinterpret_cast<EOS_HIntegratedPlatformOptionsContainer>(&s_options_container);
+    return EOS_EResult::EOS_Success;
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT EOS_EResult EOS_IntegratedPlatformOptionsContainer_Add(EOS_HIntegratedPlatformOptionsContainer, const EOS_IntegratedPlatformOptionsContainer_AddOptions *InOptions)
+{
+    const EOS_IntegratedPlatform_Options *options = InOptions->Options;
+    if (options == nullptr || options->Type == nullptr || std::string(options->Type) != EOS_IPT_Steam)
+    {
+        return EOS_EResult::EOS_InvalidParameters;
+    }
+
+    const auto *steam_options = static_cast<const EOS_IntegratedPlatform_Steam_Options*>(options->InitOptions);
+    s_record.hasSteamOptions = true;
+    s_record.steamMajorVersion = steam_options->SteamMajorVersion;
+    s_record.steamMinorVersion = steam_options->SteamMinorVersion;
+    s_record.steamApiInterfaceVersionsArrayBytes = steam_options->SteamApiInterfaceVersionsArrayBytes;
+    return EOS_EResult::EOS_Success;
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT void EOS_IntegratedPlatformOptionsContainer_Release(EOS_HIntegratedPlatformOptionsContainer)
+{
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT const StandInPlatformRecord * StandIn_GetPlatformRecord()
+{
+    return &s_record;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// What the stand-in EOS SDK in StandInEOSPlatform.cpp was asked to do, for
+// PluginBootstrapTest to check the bootstrap's work against.
+
+#pragma once
+#include <stdint.h>
+#include <string>
+
+struct StandInPlatformRecord
+{
+    uint32_t initializeCount;
+    uint32_t platformCreateCount;
+    // Calls to EOS_Logging_SetLogLevel, whichever the category
+    uint32_t setLogLevelCount;
+    bool hasLogCallback;
+
+    // From EOS_Initialize
+    std::string productName;
+    std::string productVersion;
+    bool hasAllocatorFunctions;
+    uint64_t networkWorkAffinity;
+
+    // From EOS_Platform_Create
+    std::string productId;
+    std::string sandboxId;
+    std::string deploymentId;
+    std::string clientId;
+    std::string clientSecret;
+    std::string cacheDirectory;
+    uint64_t flags;
+    uint32_t tickBudgetInMilliseconds;
+    bool isServer;
+
+    // From the Steam options added to the integrated platform container
+    bool hasSteamOptions;
+    uint32_t steamMajorVersion;
+    uint32_t steamMinorVersion;
+    uint32_t steamApiInterfaceVersionsArrayBytes;
+};
+
+typedef const StandInPlatformRecord *(*StandIn_GetPlatformRecord_t)();
+
+// The handle EOS_Platform_Create hands back
+#define STANDIN_PLATFORM_HANDLE reinterpret_cast<void*>(static_cast<uintptr_t>(0x5eed))
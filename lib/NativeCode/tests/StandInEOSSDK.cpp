@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Pretends to be the EOS SDK for EOSAllocatorHookTest: EOS_Initialize takes
+// the memory hooks and, like the real SDK, keeps some state allocated
+// through them until EOS_Shutdown; StandIn_Tick churns blocks of the sizes
+// and alignments the SDK asks for while it runs. With no hooks it falls
+// back to malloc, as the SDK does.
+
+#include "StandInEOSSDK.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define STANDIN_EXPORT extern "C" __attribute__((visibility("default")))
+
+// Number of blocks EOS_Initialize keeps until EOS_Shutdown
+#define STANDIN_RESIDENT_BLOCK_COUNT 64
+
+namespace
+{
+    struct StandInBlock
+    {
+        void *pointer;
+        size_t size_in_bytes;
+        size_t alignment;
+    };
+
+    bool s_initialized = false;
+    StandInAllocateMemoryFunc s_allocate = nullptr;
+    StandInReallocateMemoryFunc s_reallocate = nullptr;
+    StandInReleaseMemoryFunc s_release = nullptr;
+    std::vector<StandInBlock> s_resident_blocks;
+    StandInStats s_stats = {};
+    uint64_t s_random_state = 0x9e3779b97f4a7c15ULL;
+
+    const size_t s_alignments[] = { 8, 16, 32, 64, 4096 };
+}
+
+//-------------------------------------------------------------------------
+static uint32_t next_random()
+{
+    s_random_state ^= s_random_state << 13;
+    s_random_state ^= s_random_state >> 7;
+    s_random_state ^= s_random_state << 17;
+    return static_cast<uint32_t>(s_random_state);
+}
+
+//-------------------------------------------------------------------------
+static void check_alignment(const void *pointer, size_t alignment)
+{
+    if (pointer != nullptr && reinterpret_cast<uintptr_t>(pointer) % alignment != 0)
+    {
+        s_stats.misalignedCount++;
+    }
+}
+
+//-------------------------------------------------------------------------
+static StandInBlock allocate_block(size_t size_in_bytes, size_t alignment)
+{
+    StandInBlock block = { nullptr, size_in_bytes, alignment };
+    block.pointer = s_allocate != nullptr ? s_allocate(size_in_bytes, alignment) : malloc(size_in_bytes);
+    if (block.pointer != nullptr)
+    {
+        memset(block.pointer, 0xcd, size_in_bytes);
+        check_alignment(block.pointer, alignment);
+        s_stats.liveBytes += static_cast<int64_t>(size_in_bytes);
+        s_stats.allocCount++;
+    }
+    return block;
+}
+
+//-------------------------------------------------------------------------
+static void reallocate_block(StandInBlock& block, size_t size_in_bytes)
+{
+    void *pointer = s_reallocate != nullptr ? s_reallocate(block.pointer, size_in_bytes, block.alignment) : realloc(block.pointer, size_in_bytes);
+    if (pointer == nullptr)
+    {
+        return;
+    }
+
+    check_alignment(pointer, block.alignment);
+    s_stats.liveBytes += static_cast<int64_t>(size_in_bytes) - static_cast<int64_t>(block.size_in_bytes);
+    s_stats.reallocCount++;
+    block.pointer = pointer;
+    block.size_in_bytes = size_in_bytes;
+}
+
+//-------------------------------------------------------------------------
+static void release_block(StandInBlock& block)
+{
+    if (block.pointer == nullptr)
+    {
+        return;
+    }
+
+    if (s_release != nullptr)
+    {
+        s_release(block.pointer);
+    }
+    else
+    {
+        free(block.pointer);
+    }
+    s_stats.liveBytes -= static_cast<int64_t>(block.size_in_bytes);
+    s_stats.freeCount++;
+    block.pointer = nullptr;
+}
+
+//-------------------------------------------------------------------------
+// The SDK wants all three hooks or none of them
+STANDIN_EXPORT int32_t EOS_Initialize(const StandInInitializeOptions *options)
+{
+    if (options == nullptr || options->ApiVersion != STANDIN_EOS_INITIALIZE_API_LATEST)
+    {
+        return STANDIN_EOS_INVALID_PARAMETERS;
+    }
+
+    const bool has_any_hook = options->AllocateMemoryFunction != nullptr || options->ReallocateMemoryFunction != nullptr || options->ReleaseMemoryFunction != nullptr;
+    const bool has_all_hooks = options->AllocateMemoryFunction != nullptr && options->ReallocateMemoryFunction != nullptr && options->ReleaseMemoryFunction != nullptr;
+    if (has_any_hook && !has_all_hooks)
+    {
+        return STANDIN_EOS_INVALID_PARAMETERS;
+    }
+
+    if (s_initialized)
+    {
+        return STANDIN_EOS_ALREADY_CONFIGURED;
+    }
+
+    s_initialized = true;
+    s_allocate = options->AllocateMemoryFunction;
+    s_reallocate = options->ReallocateMemoryFunction;
+    s_release = options->ReleaseMemoryFunction;
+
+    for (int i = 0; i < STANDIN_RESIDENT_BLOCK_COUNT; ++i)
+    {
+        const size_t alignment = s_alignments[i % (sizeof(s_alignments) / sizeof(s_alignments[0]))];
+        s_resident_blocks.push_back(allocate_block(256 + (next_random() % 4096), alignment));
+    }
+
+    return STANDIN_EOS_SUCCESS;
+}
+
+//-------------------------------------------------------------------------
+// Unlike the real SDK, this one can be initialized again after shutting
+// down, so that the test can try every backend in one process
+STANDIN_EXPORT int32_t EOS_Shutdown()
+{
+    if (!s_initialized)
+    {
+        return STANDIN_EOS_INVALID_PARAMETERS;
+    }
+
+    for (StandInBlock& block : s_resident_blocks)
+    {
+        release_block(block);
+    }
+    s_resident_blocks.clear();
+
+    s_initialized = false;
+    s_allocate = nullptr;
+    s_reallocate = nullptr;
+    s_release = nullptr;
+
+    return STANDIN_EOS_SUCCESS;
+}
+
+//-------------------------------------------------------------------------
+// Allocates, grows and frees short lived blocks, leaving the resident ones
+// alone
+STANDIN_EXPORT void StandIn_Tick(uint32_t operation_count)
+{
+    StandInBlock scratch[16] = {};
+    for (uint32_t i = 0; i < operation_count; ++i)
+    {
+        StandInBlock& block = scratch[next_random() % 16];
+        if (block.pointer == nullptr)
+        {
+            const size_t alignment = s_alignments[next_random() % (sizeof(s_alignments) / sizeof(s_alignments[0]))];
+            block = allocate_block(1 + (next_random() % 2048), alignment);
+        }
+        else if (next_random() % 2 == 0)
+        {
+            reallocate_block(block, block.size_in_bytes * 2 + 1);
+        }
+        else
+        {
+            release_block(block);
+        }
+    }
+
+    for (StandInBlock& block : scratch)
+    {
+        release_block(block);
+    }
+}
+
+//-------------------------------------------------------------------------
+STANDIN_EXPORT void StandIn_GetStats(StandInStats *out_stats)
+{
+    *out_stats = s_stats;
+}
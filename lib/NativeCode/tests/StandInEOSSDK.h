@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// The subset of the EOS SDK's eos_init.h that the allocator hook test
+// needs, laid out the same way, so that the test can run on Linux without
+// the real SDK. See StandInEOSSDK.cpp.
+
+#pragma once
+#include <stddef.h>
+#include <inttypes.h>
+
+#define STANDIN_EOS_SUCCESS 0
+#define STANDIN_EOS_INVALID_PARAMETERS 2
+#define STANDIN_EOS_ALREADY_CONFIGURED 14
+
+#define STANDIN_EOS_INITIALIZE_API_LATEST 4
+
+typedef void* (*StandInAllocateMemoryFunc)(size_t size_in_bytes, size_t alignment);
+typedef void* (*StandInReallocateMemoryFunc)(void *pointer, size_t size_in_bytes, size_t alignment);
+typedef void (*StandInReleaseMemoryFunc)(void *pointer);
+
+struct StandInInitializeOptions
+{
+    int32_t ApiVersion;
+    StandInAllocateMemoryFunc AllocateMemoryFunction;
+    StandInReallocateMemoryFunc ReallocateMemoryFunction;
+    StandInReleaseMemoryFunc ReleaseMemoryFunction;
+    const char *ProductName;
+    const char *ProductVersion;
+    void *Reserved;
+    void *SystemInitializeOptions;
+    const void *OverrideThreadAffinity;
+};
+
+// What the stand-in has seen, for the test to check against the counters
+struct StandInStats
+{
+    // Bytes the stand-in is holding on to right now
+    int64_t liveBytes;
+    uint64_t allocCount;
+    uint64_t reallocCount;
+    uint64_t freeCount;
+    // Blocks that came back without the alignment asked for
+    uint64_t misalignedCount;
+};
+
+typedef int32_t (*EOS_Initialize_t)(const StandInInitializeOptions *options);
+typedef int32_t (*EOS_Shutdown_t)();
+typedef void (*StandIn_Tick_t)(uint32_t operation_count);
+typedef void (*StandIn_GetStats_t)(StandInStats *out_stats);
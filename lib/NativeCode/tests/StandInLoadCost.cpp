@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Stands in for a large SDK library when measuring how long dlopen takes,
+// for the library preloading benchmark. The EOS SDK spends most of its
+// load time on symbol relocations for its vtables and function tables;
+// here each table holds the address of every exported function, and since
+// those are interposable every entry is a symbol relocation that the
+// loader has to look up. STANDIN_LOAD_COST_TABLES sets how many there are.
+
+#include <inttypes.h>
+
+#ifndef STANDIN_LOAD_COST_TABLES
+#define STANDIN_LOAD_COST_TABLES 8
+#endif
+
+#define STANDIN_EXPORT extern "C" __attribute__((visibility("default")))
+
+#define STANDIN_FOR_TENS(visit, prefix) \
+    visit(prefix##0) visit(prefix##1) visit(prefix##2) visit(prefix##3) visit(prefix##4) \
+    visit(prefix##5) visit(prefix##6) visit(prefix##7) visit(prefix##8) visit(prefix##9)
+#define STANDIN_FOR_HUNDREDS(visit, prefix) \
+    STANDIN_FOR_TENS(visit, prefix##0) STANDIN_FOR_TENS(visit, prefix##1) STANDIN_FOR_TENS(visit, prefix##2) STANDIN_FOR_TENS(visit, prefix##3) STANDIN_FOR_TENS(visit, prefix##4) \
+    STANDIN_FOR_TENS(visit, prefix##5) STANDIN_FOR_TENS(visit, prefix##6) STANDIN_FOR_TENS(visit, prefix##7) STANDIN_FOR_TENS(visit, prefix##8) STANDIN_FOR_TENS(visit, prefix##9)
+#define STANDIN_FOR_EACH_FUNCTION(visit) \
+    STANDIN_FOR_HUNDREDS(visit, 0) STANDIN_FOR_HUNDREDS(visit, 1) STANDIN_FOR_HUNDREDS(visit, 2) STANDIN_FOR_HUNDREDS(visit, 3) \
+    STANDIN_FOR_HUNDREDS(visit, 4) STANDIN_FOR_HUNDREDS(visit, 5) STANDIN_FOR_HUNDREDS(visit, 6) STANDIN_FOR_HUNDREDS(visit, 7)
+
+#define STANDIN_LOAD_COST_FUNCTION(number) STANDIN_EXPORT int32_t EOS_StandInLoadCost_##number() { return 1##number - 1000; }
+#define STANDIN_LOAD_COST_ADDRESS(number) reinterpret_cast<void*>(&EOS_StandInLoadCost_##number),
+
+STANDIN_FOR_EACH_FUNCTION(STANDIN_LOAD_COST_FUNCTION)
+
+// STANDIN_LOAD_COST_TABLES has to be a power of two up to 64
+#define STANDIN_LOAD_COST_TABLE { STANDIN_FOR_EACH_FUNCTION(STANDIN_LOAD_COST_ADDRESS) },
+#define STANDIN_LOAD_COST_TABLES_1 STANDIN_LOAD_COST_TABLE
+#define STANDIN_LOAD_COST_TABLES_2 STANDIN_LOAD_COST_TABLES_1 STANDIN_LOAD_COST_TABLES_1
+#define STANDIN_LOAD_COST_TABLES_4 STANDIN_LOAD_COST_TABLES_2 STANDIN_LOAD_COST_TABLES_2
+#define STANDIN_LOAD_COST_TABLES_8 STANDIN_LOAD_COST_TABLES_4 STANDIN_LOAD_COST_TABLES_4
+#define STANDIN_LOAD_COST_TABLES_16 STANDIN_LOAD_COST_TABLES_8 STANDIN_LOAD_COST_TABLES_8
+#define STANDIN_LOAD_COST_TABLES_32 STANDIN_LOAD_COST_TABLES_16 STANDIN_LOAD_COST_TABLES_16
+#define STANDIN_LOAD_COST_TABLES_64 STANDIN_LOAD_COST_TABLES_32 STANDIN_LOAD_COST_TABLES_32
+#define STANDIN_LOAD_COST_EXPAND_TABLES(count) STANDIN_LOAD_COST_TABLES_##count
+#define STANDIN_LOAD_COST_ALL_TABLES(count) STANDIN_LOAD_COST_EXPAND_TABLES(count)
+
+extern "C"
+{
+    __attribute__((visibility("default"))) void *EOS_StandInLoadCost_Tables[STANDIN_LOAD_COST_TABLES][800] =
+    {
+        STANDIN_LOAD_COST_ALL_TABLES(STANDIN_LOAD_COST_TABLES)
+    };
+}
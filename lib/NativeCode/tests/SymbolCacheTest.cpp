@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Checks that the Linux DLLHContext's symbol cache hands back what dlsym
+// would, including for names prefilled from the dynamic symbol table, and
+// that nothing stale survives a library being unloaded, whether through
+// the context, FreeLibrary or behind its back, or is kept for a library the context
+// didn't load.
+
+#include "BenchmarkCommon.h"
+#include "StandInEOSExports.h"
+#include <dlfcn.h>
+#include <stdio.h>
+
+extern "C" void *DLLH_create_context();
+extern "C" void DLLH_destroy_context(void *context);
+extern "C" void *DLLH_load_library_at_path(void *ctx, const char *library_path);
+extern "C" void *DLLH_load_function_with_name(void *ctx, void *library_handle, const char *function);
+extern "C" size_t DLLH_prefill_symbol_cache(void *ctx, void *library_handle);
+extern "C" size_t DLLH_release_functions(void *ctx, void *library_handle);
+extern "C" bool DLLH_unload_library_at_path(void *ctx, void *library_handle);
+extern "C" void *LoadLibrary(const char *library_path);
+extern "C" bool FreeLibrary(void *library_handle);
+
+static const char *kStandInExportsPath = "build/tests/libStandInEOSExports.so";
+static const char *kStandInSDKPath = "build/tests/libStandInEOSSDK.so";
+
+//-------------------------------------------------------------------------
+// Every stand-in export resolves through the context to what dlsym says
+static void check_exports(void *ctx, void *library_handle)
+{
+    for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+    {
+        char name[64];
+        standin_export_name(i, name, sizeof(name));
+
+        void *function = DLLH_load_function_with_name(ctx, library_handle, name);
+        BENCH_CHECK(function != nullptr && function == dlsym(library_handle, name));
+        BENCH_CHECK(reinterpret_cast<StandInExport_t>(function)() == i);
+    }
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    void *ctx = DLLH_create_context();
+
+    // Prefilled from the symbol table
+    void *exports_handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(exports_handle != nullptr);
+    BENCH_CHECK(DLLH_prefill_symbol_cache(ctx, exports_handle) >= STANDIN_EXPORT_COUNT);
+    BENCH_CHECK(DLLH_prefill_symbol_cache(ctx, exports_handle) == 0);
+    check_exports(ctx, exports_handle);
+
+    // Misses are cached as misses
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, exports_handle, "EOS_StandInExport_Missing") == nullptr);
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, exports_handle, "EOS_StandInExport_Missing") == nullptr);
+
+    // Unloading through the context drops the cache, even if the next
+    // library gets the same handle
+    BENCH_CHECK(DLLH_release_functions(ctx, exports_handle) > 0);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, exports_handle));
+    void *sdk_handle = DLLH_load_library_at_path(ctx, kStandInSDKPath);
+    BENCH_CHECK(sdk_handle != nullptr);
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, sdk_handle, "EOS_StandInExport_001") == nullptr);
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, sdk_handle, "EOS_Initialize") == dlsym(sdk_handle, "EOS_Initialize"));
+    BENCH_CHECK(DLLH_load_function_with_name(ctx, sdk_handle, "EOS_Initialize") != nullptr);
+
+    // Filled lazily this time, then unloaded without the context knowing
+    exports_handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(exports_handle != nullptr);
+    check_exports(ctx, exports_handle);
+    BENCH_CHECK(dlclose(exports_handle) == 0);
+    BENCH_CHECK(dlopen(kStandInExportsPath, RTLD_NOW | RTLD_NOLOAD) == nullptr);
+
+    exports_handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(exports_handle != nullptr);
+    check_exports(ctx, exports_handle);
+
+    // The reference the context held before the dlclose went with it, so
+    // one unload is enough
+    DLLH_release_functions(ctx, exports_handle);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, exports_handle));
+    BENCH_CHECK(dlopen(kStandInExportsPath, RTLD_NOW | RTLD_NOLOAD) == nullptr);
+
+    // Prefilled, then unloaded through FreeLibrary and loaded again without
+    // the context, likely with the same handle. The context mustn't answer
+    // from, or count functions against, the entry for the first load.
+    exports_handle = DLLH_load_library_at_path(ctx, kStandInExportsPath);
+    BENCH_CHECK(exports_handle != nullptr);
+    BENCH_CHECK(DLLH_prefill_symbol_cache(ctx, exports_handle) >= STANDIN_EXPORT_COUNT);
+    DLLH_release_functions(ctx, sdk_handle);
+    BENCH_CHECK(DLLH_unload_library_at_path(ctx, sdk_handle));
+    BENCH_CHECK(FreeLibrary(exports_handle));
+    BENCH_CHECK(dlopen(kStandInExportsPath, RTLD_NOW | RTLD_NOLOAD) == nullptr);
+    void *reloaded_handle = LoadLibrary(kStandInExportsPath);
+    BENCH_CHECK(reloaded_handle != nullptr);
+    check_exports(ctx, reloaded_handle);
+    BENCH_CHECK(DLLH_release_functions(ctx, reloaded_handle) == 0);
+    BENCH_CHECK(FreeLibrary(reloaded_handle));
+    DLLH_destroy_context(ctx);
+
+    // Looked up, but nothing kept, for a library the context didn't load
+    ctx = DLLH_create_context();
+    void *foreign_handle = dlopen(kStandInExportsPath, RTLD_NOW);
+    BENCH_CHECK(foreign_handle != nullptr);
+    check_exports(ctx, foreign_handle);
+    BENCH_CHECK(DLLH_prefill_symbol_cache(ctx, foreign_handle) == 0);
+    BENCH_CHECK(DLLH_release_functions(ctx, foreign_handle) == 0);
+    BENCH_CHECK(!DLLH_unload_library_at_path(ctx, foreign_handle));
+    BENCH_CHECK(dlclose(foreign_handle) == 0);
+    DLLH_destroy_context(ctx);
+
+    printf("SymbolCacheTest: ok\n");
+    return 0;
+}
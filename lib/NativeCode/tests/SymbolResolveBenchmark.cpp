@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Times resolving every export of a stand-in with as many functions as
+// the EOS SDK: straight through dlsym, through the Linux DLLHContext's
+// symbol cache when it is cold, warm and prefilled, and one name per call
+// against one DLLH_load_functions_with_names call, plus the cold cache
+// again with loader tracing on to show what recording costs. The managed
+// side also saves a P/Invoke transition and a string marshal per function
+// when it batches, which isn't measured here.
+
+#include "BenchmarkCommon.h"
+#include "StandInEOSExports.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+extern "C" void *DLLH_create_context();
+extern "C" void DLLH_destroy_context(void *context);
+extern "C" void *DLLH_load_library_at_path(void *ctx, const char *library_path);
+extern "C" void *DLLH_load_function_with_name(void *ctx, void *library_handle, const char *function);
+extern "C" size_t DLLH_load_functions_with_names(void *ctx, void *library_handle, const char **function_names, void **out_functions, size_t count);
+extern "C" size_t DLLH_prefill_symbol_cache(void *ctx, void *library_handle);
+extern "C" size_t DLLH_release_functions(void *ctx, void *library_handle);
+extern "C" bool DLLH_unload_library_at_path(void *ctx, void *library_handle);
+extern "C" void DLLH_set_loader_trace(bool enabled);
+
+static const char *kStandInPath = "build/tests/libStandInEOSExports.so";
+static const int kRounds = 50;
+
+//-------------------------------------------------------------------------
+static void check_functions(void *const *functions)
+{
+    for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+    {
+        BENCH_CHECK(functions[i] != nullptr);
+        BENCH_CHECK(reinterpret_cast<StandInExport_t>(functions[i])() == i);
+    }
+}
+
+//-------------------------------------------------------------------------
+int main()
+{
+    std::vector<std::string> names(STANDIN_EXPORT_COUNT);
+    std::vector<const char*> name_pointers(STANDIN_EXPORT_COUNT + 1);
+    for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+    {
+        char name[64];
+        standin_export_name(i, name, sizeof(name));
+        names[i] = name;
+        name_pointers[i] = names[i].c_str();
+    }
+    name_pointers[STANDIN_EXPORT_COUNT] = "EOS_StandInExport_Missing";
+
+    void *ctx = DLLH_create_context();
+    void *library_handle = DLLH_load_library_at_path(ctx, kStandInPath);
+    BENCH_CHECK(library_handle != nullptr);
+
+    // Missing functions come back null and aren't counted
+    std::vector<void*> functions(STANDIN_EXPORT_COUNT + 1);
+    BENCH_CHECK(DLLH_load_functions_with_names(ctx, library_handle, name_pointers.data(), functions.data(), functions.size()) == STANDIN_EXPORT_COUNT);
+    BENCH_CHECK(functions[STANDIN_EXPORT_COUNT] == nullptr);
+    check_functions(functions.data());
+
+    enum Case { Dlsym, ColdCache, WarmCache, WarmCacheBatched, PrefilledBatched, ColdCacheTraced, CaseCount };
+    const char *case_names[CaseCount] = { "dlsym", "cold cache", "warm cache", "warm cache, batched", "prefill, batched", "cold cache, traced" };
+    double best_ns[CaseCount];
+    std::fill(best_ns, best_ns + CaseCount, 1.0e30);
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        auto start = bench::clock::now();
+        for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+        {
+            functions[i] = dlsym(library_handle, name_pointers[i]);
+        }
+        best_ns[Dlsym] = std::min(best_ns[Dlsym], bench::elapsed_ns(start, bench::clock::now()));
+        check_functions(functions.data());
+
+        // A fresh context each round starts with nothing cached
+        void *round_ctx = DLLH_create_context();
+        BENCH_CHECK(DLLH_load_library_at_path(round_ctx, kStandInPath) == library_handle);
+
+        start = bench::clock::now();
+        for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+        {
+            functions[i] = DLLH_load_function_with_name(round_ctx, library_handle, name_pointers[i]);
+        }
+        best_ns[ColdCache] = std::min(best_ns[ColdCache], bench::elapsed_ns(start, bench::clock::now()));
+        check_functions(functions.data());
+
+        start = bench::clock::now();
+        for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+        {
+            functions[i] = DLLH_load_function_with_name(round_ctx, library_handle, name_pointers[i]);
+        }
+        best_ns[WarmCache] = std::min(best_ns[WarmCache], bench::elapsed_ns(start, bench::clock::now()));
+        check_functions(functions.data());
+
+        std::fill(functions.begin(), functions.end(), nullptr);
+        start = bench::clock::now();
+        DLLH_load_functions_with_names(round_ctx, library_handle, name_pointers.data(), functions.data(), STANDIN_EXPORT_COUNT);
+        best_ns[WarmCacheBatched] = std::min(best_ns[WarmCacheBatched], bench::elapsed_ns(start, bench::clock::now()));
+        check_functions(functions.data());
+
+        DLLH_release_functions(round_ctx, library_handle);
+        BENCH_CHECK(DLLH_unload_library_at_path(round_ctx, library_handle));
+        DLLH_destroy_context(round_ctx);
+
+        round_ctx = DLLH_create_context();
+        BENCH_CHECK(DLLH_load_library_at_path(round_ctx, kStandInPath) == library_handle);
+
+        std::fill(functions.begin(), functions.end(), nullptr);
+        start = bench::clock::now();
+        DLLH_prefill_symbol_cache(round_ctx, library_handle);
+        DLLH_load_functions_with_names(round_ctx, library_handle, name_pointers.data(), functions.data(), STANDIN_EXPORT_COUNT);
+        best_ns[PrefilledBatched] = std::min(best_ns[PrefilledBatched], bench::elapsed_ns(start, bench::clock::now()));
+        check_functions(functions.data());
+
+        DLLH_release_functions(round_ctx, library_handle);
+        BENCH_CHECK(DLLH_unload_library_at_path(round_ctx, library_handle));
+        DLLH_destroy_context(round_ctx);
+
+        round_ctx = DLLH_create_context();
+        BENCH_CHECK(DLLH_load_library_at_path(round_ctx, kStandInPath) == library_handle);
+
+        DLLH_set_loader_trace(true);
+        start = bench::clock::now();
+        for (int i = 0; i < STANDIN_EXPORT_COUNT; ++i)
+        {
+            functions[i] = DLLH_load_function_with_name(round_ctx, library_handle, name_pointers[i]);
+        }
+        best_ns[ColdCacheTraced] = std::min(best_ns[ColdCacheTraced], bench::elapsed_ns(start, bench::clock::now()));
+        DLLH_set_loader_trace(false);
+        check_functions(functions.data());
+
+        DLLH_release_functions(round_ctx, library_handle);
+        BENCH_CHECK(DLLH_unload_library_at_path(round_ctx, library_handle));
+        DLLH_destroy_context(round_ctx);
+    }
+
+    printf("Resolving %d functions, best of %d rounds (us, lower is better)\n", STANDIN_EXPORT_COUNT, kRounds);
+    printf("%-24s %10s %14s\n", "", "total", "ns/function");
+    for (int i = 0; i < CaseCount; ++i)
+    {
+        printf("%-24s %10.1f %14.1f\n", case_names[i], best_ns[i] / 1000.0, best_ns[i] / STANDIN_EXPORT_COUNT);
+    }
+
+    dlclose(library_handle);
+    DLLH_destroy_context(ctx);
+    return 0;
+}
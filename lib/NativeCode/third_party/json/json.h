@@ -115,6 +115,13 @@ enum json_parse_flags_e {
   /* allow multi line string values. */
   json_parse_flags_allow_multi_line_strings = 0x2000,
 
+  /* let strings without escape sequences point into the source rather than
+     being copied into the allocation. Those strings aren't null terminated,
+     so only string_size says where they end, and the source has to outlive
+     the parsed value. Not part of upstream json.h; added for the EOS plugin's
+     config reading. */
+  json_parse_flags_strings_in_source = 0x4000,
+
   /* allow simplified JSON to be parsed. Simplified JSON is an enabling of a set
      of other parsing options. */
   json_parse_flags_allow_simplified_json =
@@ -661,6 +668,7 @@ int json_get_string_size(struct json_parse_state_s *state, size_t is_key) {
   const size_t flags_bitset = state->flags_bitset;
   unsigned long codepoint;
   unsigned long high_surrogate = 0;
+  int has_escape = 0;
 
   if ((json_parse_flags_allow_location_information & flags_bitset) != 0 &&
       is_key != 0) {
@@ -697,6 +705,8 @@ int json_get_string_size(struct json_parse_state_s *state, size_t is_key) {
     }
 
     if ('\\' == src[offset]) {
+      has_escape = 1;
+
       /* skip reverse solidus character. */
       offset++;
 
@@ -819,11 +829,14 @@ int json_get_string_size(struct json_parse_state_s *state, size_t is_key) {
   /* skip trailing '"' or '\''. */
   offset++;
 
-  /* add enough space to store the string. */
-  state->data_size += data_size;
+  /* a string that will point into the source needs no space of its own. */
+  if (!(json_parse_flags_strings_in_source & flags_bitset) || has_escape) {
+    /* add enough space to store the string. */
+    state->data_size += data_size;
 
-  /* one more byte for null terminator ending the string! */
-  state->data_size++;
+    /* one more byte for null terminator ending the string! */
+    state->data_size++;
+  }
 
   /* update offset. */
   state->offset = offset;
@@ -1415,6 +1428,23 @@ void json_parse_string(struct json_parse_state_s *state,
   unsigned long high_surrogate = 0;
   unsigned long codepoint;
 
+  if (json_parse_flags_strings_in_source & state->flags_bitset) {
+    /* the string was validated when it was sized, so has a closing quote. */
+    size_t end = offset + 1;
+    while ((quote_to_use != src[end]) && ('\\' != src[end])) {
+      end++;
+    }
+
+    if (quote_to_use == src[end]) {
+      string->string = src + offset + 1;
+      string->string_size = end - offset - 1;
+
+      /* skip past the trailing '"' or '\''. */
+      state->offset = end + 1;
+      return;
+    }
+  }
+
   string->string = data;
 
   /* skip leading '"' or '\''. */
@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Replays a trace written by Mem_StartAllocationTrace against one of the
+// allocator backends and reports how long it took, the peak resident set
+// and how much of it was fragmentation rather than live blocks.
+//
+//   AllocationTraceReplay <trace> [system|pooled|libc|all]
+//
+// Events are replayed on a single thread in timestamp order, so contention
+// between threads isn't reproduced; the allocation pattern is. Every block
+// is touched once per page so that the resident set reflects what the SDK
+// would have paid for. With "all", each backend is replayed by a fresh copy
+// of the tool.
+
+#include "Memory.h"
+#include "AllocationTrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+#include <vector>
+
+extern "C" void *Mem_generic_align_alloc(size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void *Mem_generic_align_realloc(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+extern "C" void Mem_generic_free(void *ptr);
+extern "C" bool Mem_SetAllocatorBackend(int32_t backend);
+
+// Events between resident set samples; sampling isn't counted in the time
+#define REPLAY_SAMPLE_INTERVAL 1024
+
+#define REPLAY_PAGE_SIZE 4096
+
+namespace
+{
+    struct ReplayBackend
+    {
+        const char *name;
+        void *(*alloc)(size_t size_in_bytes, size_t alignment_in_bytes);
+        void *(*realloc)(void *ptr, size_t size_in_bytes, size_t alignment_in_bytes);
+        void (*free)(void *ptr);
+        // < 0 for backends that don't go through Mem_generic_*
+        int32_t allocator_backend;
+    };
+
+    struct LiveBlock
+    {
+        // The pointer as it was in the trace; 0 marks an empty slot
+        uint64_t key;
+        void *pointer;
+        size_t size_in_bytes;
+    };
+
+    // Open addressing with backward shift deletion, sized up front so that
+    // its pages are part of the baseline resident set rather than being
+    // counted against the backend.
+    class LiveBlockTable
+    {
+    public:
+        explicit LiveBlockTable(size_t max_live_blocks)
+        {
+            capacity = 16;
+            while (capacity < max_live_blocks * 2)
+            {
+                capacity *= 2;
+            }
+            slots.assign(capacity, LiveBlock{ 0, nullptr, 0 });
+        }
+
+        LiveBlock* find(uint64_t key)
+        {
+            LiveBlock& slot = slots[probe(key)];
+            return slot.key == key && key != 0 ? &slot : nullptr;
+        }
+
+        void insert(const LiveBlock& block)
+        {
+            slots[probe(block.key)] = block;
+        }
+
+        void erase(LiveBlock *block)
+        {
+            size_t hole = static_cast<size_t>(block - slots.data());
+            size_t index = hole;
+            slots[hole].key = 0;
+
+            for (;;)
+            {
+                index = (index + 1) & (capacity - 1);
+                if (slots[index].key == 0)
+                {
+                    break;
+                }
+
+                const size_t home = hash(slots[index].key) & (capacity - 1);
+                const bool home_in_range = hole <= index
+                    ? (hole < home && home <= index)
+                    : (hole < home || home <= index);
+                if (!home_in_range)
+                {
+                    slots[hole] = slots[index];
+                    slots[index].key = 0;
+                    hole = index;
+                }
+            }
+        }
+
+        template<typename Function>
+        void for_each(Function function)
+        {
+            for (LiveBlock& slot : slots)
+            {
+                if (slot.key != 0)
+                {
+                    function(slot);
+                }
+            }
+        }
+
+    private:
+        static uint64_t hash(uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            return key;
+        }
+
+        size_t probe(uint64_t key) const
+        {
+            size_t index = hash(key) & (capacity - 1);
+            while (slots[index].key != 0 && slots[index].key != key)
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+            return index;
+        }
+
+        std::vector<LiveBlock> slots;
+        size_t capacity;
+    };
+
+    struct ReplayResult
+    {
+        uint64_t operations = 0;
+        uint64_t unmatched = 0;
+        double elapsed_ns = 0;
+        int64_t peak_live_bytes = 0;
+        int64_t peak_resident_bytes = 0;
+    };
+}
+
+//-------------------------------------------------------------------------
+static void *libc_alloc(size_t size_in_bytes, size_t alignment_in_bytes)
+{
+    void *pointer = nullptr;
+    const size_t alignment = alignment_in_bytes < sizeof(void*) ? sizeof(void*) : alignment_in_bytes;
+    return posix_memalign(&pointer, alignment, size_in_bytes) == 0 ? pointer : nullptr;
+}
+
+//-------------------------------------------------------------------------
+// Doesn't keep alignments above what malloc gives, which is fine for
+// comparing costs
+static void *libc_realloc(void *ptr, size_t size_in_bytes, size_t)
+{
+    return realloc(ptr, size_in_bytes == 0 ? 1 : size_in_bytes);
+}
+
+static const ReplayBackend s_backends[] =
+{
+    { "system", Mem_generic_align_alloc, Mem_generic_align_realloc, Mem_generic_free, static_cast<int32_t>(MemAllocatorBackend::System) },
+    { "pooled", Mem_generic_align_alloc, Mem_generic_align_realloc, Mem_generic_free, static_cast<int32_t>(MemAllocatorBackend::Pooled) },
+    { "libc", libc_alloc, libc_realloc, free, -1 },
+};
+
+//-------------------------------------------------------------------------
+// Uses plain reads so that sampling doesn't allocate
+static int64_t resident_bytes()
+{
+    const int statm = open("/proc/self/statm", O_RDONLY);
+    if (statm < 0)
+    {
+        return 0;
+    }
+
+    char text[128];
+    const ssize_t length = read(statm, text, sizeof(text) - 1);
+    close(statm);
+    if (length <= 0)
+    {
+        return 0;
+    }
+    text[length] = '\0';
+
+    long long total_pages = 0;
+    long long resident_pages = 0;
+    if (sscanf(text, "%lld %lld", &total_pages, &resident_pages) != 2)
+    {
+        return 0;
+    }
+
+    return resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+//-------------------------------------------------------------------------
+static void touch(void *pointer, size_t from, size_t to)
+{
+    char *bytes = static_cast<char*>(pointer);
+    for (size_t offset = from; offset < to; offset += REPLAY_PAGE_SIZE)
+    {
+        bytes[offset] = 1;
+    }
+    if (from < to)
+    {
+        bytes[to - 1] = 1;
+    }
+}
+
+//-------------------------------------------------------------------------
+// Returns false if the file isn't a trace this tool understands
+static bool load_trace(const char *path, std::vector<AllocationTraceEvent>& events, uint64_t& dropped)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "can't open %s\n", path);
+        return false;
+    }
+
+    AllocationTraceHeader header = {};
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || memcmp(header.magic, ALLOCATION_TRACE_MAGIC, sizeof(ALLOCATION_TRACE_MAGIC)) != 0
+        || header.version != ALLOCATION_TRACE_VERSION
+        || header.event_size != sizeof(AllocationTraceEvent))
+    {
+        fprintf(stderr, "%s isn't a version %d allocation trace\n", path, ALLOCATION_TRACE_VERSION);
+        fclose(file);
+        return false;
+    }
+
+    AllocationTraceEvent event;
+    while (fread(&event, sizeof(event), 1, file) == 1)
+    {
+        switch (event.type)
+        {
+        case AllocationTraceEventType::Alloc:
+        case AllocationTraceEventType::Realloc:
+        case AllocationTraceEventType::Free:
+            events.push_back(event);
+            break;
+        case AllocationTraceEventType::Dropped:
+            dropped += event.size_in_bytes;
+            break;
+        default:
+            break;
+        }
+    }
+    fclose(file);
+
+    // Rings are drained one thread at a time
+    std::stable_sort(events.begin(), events.end(), [](const AllocationTraceEvent& a, const AllocationTraceEvent& b)
+    {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// A dry run that only tracks which trace pointers are live
+static size_t count_max_live_blocks(const std::vector<AllocationTraceEvent>& events)
+{
+    std::unordered_set<uint64_t> live;
+    size_t max_live = 0;
+
+    for (const AllocationTraceEvent& event : events)
+    {
+        if (event.type != AllocationTraceEventType::Alloc)
+        {
+            live.erase(event.type == AllocationTraceEventType::Free ? event.pointer : event.old_pointer);
+        }
+        if (event.type != AllocationTraceEventType::Free)
+        {
+            live.insert(event.pointer);
+        }
+        max_live = std::max(max_live, live.size());
+    }
+
+    return max_live;
+}
+
+//-------------------------------------------------------------------------
+// Blocks allocated before the trace started, or whose events were dropped,
+// can't be matched up. Frees of those are skipped and reallocs become
+// allocations.
+static ReplayResult replay(const std::vector<AllocationTraceEvent>& events, size_t max_live_blocks, const ReplayBackend& backend)
+{
+    ReplayResult result;
+    LiveBlockTable live_blocks(max_live_blocks);
+    int64_t live_bytes = 0;
+
+    const int64_t baseline = resident_bytes();
+
+    auto release = [&](LiveBlock *block)
+    {
+        live_bytes -= static_cast<int64_t>(block->size_in_bytes);
+        backend.free(block->pointer);
+        live_blocks.erase(block);
+    };
+
+    for (size_t first = 0; first < events.size(); first += REPLAY_SAMPLE_INTERVAL)
+    {
+        const size_t last = std::min(events.size(), first + REPLAY_SAMPLE_INTERVAL);
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = first; i < last; ++i)
+        {
+            const AllocationTraceEvent& event = events[i];
+            const size_t alignment = static_cast<size_t>(1) << event.alignment_log2;
+
+            if (event.type == AllocationTraceEventType::Free)
+            {
+                LiveBlock *block = live_blocks.find(event.pointer);
+                if (block == nullptr)
+                {
+                    result.unmatched++;
+                    continue;
+                }
+                release(block);
+                continue;
+            }
+
+            // Two threads racing on the same address can leave events out of
+            // order by a few nanoseconds; treat the stale block as freed
+            if (event.type == AllocationTraceEventType::Alloc || event.pointer != event.old_pointer)
+            {
+                LiveBlock *stale = live_blocks.find(event.pointer);
+                if (stale != nullptr)
+                {
+                    release(stale);
+                }
+            }
+
+            LiveBlock *old_block = nullptr;
+            if (event.type == AllocationTraceEventType::Realloc)
+            {
+                old_block = live_blocks.find(event.old_pointer);
+                if (old_block == nullptr)
+                {
+                    result.unmatched++;
+                }
+            }
+
+            void *pointer = nullptr;
+            size_t old_size = 0;
+            if (old_block != nullptr)
+            {
+                old_size = old_block->size_in_bytes;
+                pointer = backend.realloc(old_block->pointer, event.size_in_bytes, alignment);
+                if (pointer == nullptr)
+                {
+                    continue;
+                }
+                live_bytes -= static_cast<int64_t>(old_size);
+                live_blocks.erase(old_block);
+            }
+            else
+            {
+                pointer = backend.alloc(event.size_in_bytes, alignment);
+                if (pointer == nullptr)
+                {
+                    continue;
+                }
+            }
+
+            touch(pointer, std::min(old_size, event.size_in_bytes), event.size_in_bytes);
+            live_blocks.insert({ event.pointer, pointer, event.size_in_bytes });
+            live_bytes += static_cast<int64_t>(event.size_in_bytes);
+            result.peak_live_bytes = std::max(result.peak_live_bytes, live_bytes);
+        }
+
+        result.elapsed_ns += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        result.operations += last - first;
+        result.peak_resident_bytes = std::max(result.peak_resident_bytes, resident_bytes() - baseline);
+    }
+
+    live_blocks.for_each([&](LiveBlock& block)
+    {
+        backend.free(block.pointer);
+    });
+
+    return result;
+}
+
+//-------------------------------------------------------------------------
+static void run_backend(const std::vector<AllocationTraceEvent>& events, size_t max_live_blocks, const ReplayBackend& backend)
+{
+    if (backend.allocator_backend >= 0)
+    {
+        Mem_SetAllocatorBackend(backend.allocator_backend);
+    }
+
+    const ReplayResult result = replay(events, max_live_blocks, backend);
+
+    // Pages only partly covered by live blocks count as fragmentation too,
+    // which is what they cost the process
+    const double fragmentation = result.peak_resident_bytes > result.peak_live_bytes
+        ? 100.0 * static_cast<double>(result.peak_resident_bytes - result.peak_live_bytes) / static_cast<double>(result.peak_resident_bytes)
+        : 0.0;
+
+    printf("%-8s %10llu ops %10.2f ms %8.1f ns/op  peak live %9.2f MiB  peak rss %9.2f MiB  fragmentation %5.1f%%  unmatched %llu\n",
+        backend.name,
+        static_cast<unsigned long long>(result.operations),
+        result.elapsed_ns / 1.0e6,
+        result.operations != 0 ? result.elapsed_ns / static_cast<double>(result.operations) : 0.0,
+        static_cast<double>(result.peak_live_bytes) / (1024.0 * 1024.0),
+        static_cast<double>(result.peak_resident_bytes) / (1024.0 * 1024.0),
+        fragmentation,
+        static_cast<unsigned long long>(result.unmatched));
+    fflush(stdout);
+}
+
+//-------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <trace> [system|pooled|libc|all]\n", argv[0]);
+        return 2;
+    }
+
+    const char *backend_name = argc > 2 ? argv[2] : "all";
+
+    std::vector<AllocationTraceEvent> events;
+    uint64_t dropped = 0;
+    if (!load_trace(argv[1], events, dropped))
+    {
+        return 1;
+    }
+
+    const size_t max_live_blocks = count_max_live_blocks(events);
+
+    if (strcmp(backend_name, "all") == 0)
+    {
+        printf("%s: %zu events", argv[1], events.size());
+        if (dropped != 0)
+        {
+            printf(", %llu dropped while recording", static_cast<unsigned long long>(dropped));
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    bool found = false;
+    for (const ReplayBackend& backend : s_backends)
+    {
+        if (strcmp(backend_name, "all") != 0)
+        {
+            if (strcmp(backend_name, backend.name) == 0)
+            {
+                run_backend(events, max_live_blocks, backend);
+                found = true;
+            }
+            continue;
+        }
+
+        // A fresh process per backend, so none inherits another's resident
+        // pages or warmed up caches. argv[0] isn't a usable path when the
+        // tool was found through PATH.
+        found = true;
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            char *child_argv[] = { argv[0], argv[1], const_cast<char*>(backend.name), nullptr };
+            execv("/proc/self/exe", child_argv);
+            _exit(127);
+        }
+
+        int status = 0;
+        if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            fprintf(stderr, "replaying against %s failed\n", backend.name);
+            return 1;
+        }
+    }
+
+    if (!found)
+    {
+        fprintf(stderr, "unknown backend %s\n", backend_name);
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2021 PlayEveryWare
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Writes the list of every function the EOS SDK headers declare with
+// EOS_DECLARE_FUNC, which EOSFunctions.h turns into a typed dispatch
+// struct and a table of names to resolve it from.
+//
+//   GenerateEOSFunctionTable <sdk include dir> <output dir> [--check]
+//
+// Two files are written: EOSFunctionTable.inl, one EOS_FUNCTION(name,
+// binding) line per function grouped by the header declaring it, and
+// EOSFunctionHeaders.inl, which includes those headers. With --check
+// nothing is written; the exit code says whether the files in the output
+// directory are what would have been written, so a build can catch an SDK
+// update that didn't regenerate them.
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct DeclaringFile
+    {
+        std::string file_name;
+        std::vector<std::string> functions;
+    };
+
+    // The bootstrap can't go on without these, so they're resolved up front
+    // and a library missing any of them is rejected. Everything else is
+    // looked up the first time it's called.
+    const char *s_required_functions[] =
+    {
+        "EOS_Initialize",
+        "EOS_Shutdown",
+        "EOS_Platform_Create",
+        "EOS_Platform_Release",
+    };
+
+    const char *s_generated_notice =
+        "// Generated by tools/GenerateEOSFunctionTable.cpp from the EOS SDK headers.\n"
+        "// Don't edit by hand; run `make eos_function_table` after updating the SDK.\n";
+}
+
+//-------------------------------------------------------------------------
+static bool read_file(const fs::path& path, std::string& out_contents)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        return false;
+    }
+
+    std::ostringstream contents;
+    contents << stream.rdbuf();
+    out_contents = contents.str();
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// Comments are blanked first so that examples in doc comments and the
+// macro's own definition in eos_base.h aren't picked up
+static std::vector<std::string> find_declared_functions(std::string contents)
+{
+    static const std::regex comment_pattern(R"(/\*[\s\S]*?\*/|//[^\n]*)");
+    static const std::regex declaration_pattern(R"(EOS_DECLARE_FUNC\s*\([^;{]*?\)\s*(EOS_\w+)\s*\()");
+
+    contents = std::regex_replace(contents, comment_pattern, " ");
+
+    std::vector<std::string> functions;
+    for (std::sregex_iterator match(contents.begin(), contents.end(), declaration_pattern), end; match != end; ++match)
+    {
+        functions.push_back((*match)[1].str());
+    }
+    return functions;
+}
+
+//-------------------------------------------------------------------------
+static bool is_required(const std::string& function)
+{
+    for (const char *required : s_required_functions)
+    {
+        if (function == required)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//-------------------------------------------------------------------------
+// Platform specific headers live in subdirectories and aren't scanned;
+// none of them declare functions
+static bool collect_declaring_files(const fs::path& include_dir, std::vector<DeclaringFile>& out_files)
+{
+    std::vector<fs::path> paths;
+    std::error_code error;
+    for (const fs::directory_entry& entry : fs::directory_iterator(include_dir, error))
+    {
+        const std::string extension = entry.path().extension().string();
+        if (entry.is_regular_file() && (extension == ".h" || extension == ".inl"))
+        {
+            paths.push_back(entry.path());
+        }
+    }
+    if (error)
+    {
+        fprintf(stderr, "can't read %s: %s\n", include_dir.string().c_str(), error.message().c_str());
+        return false;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::set<std::string> seen;
+    for (const fs::path& path : paths)
+    {
+        std::string contents;
+        if (!read_file(path, contents))
+        {
+            fprintf(stderr, "can't read %s\n", path.string().c_str());
+            return false;
+        }
+
+        DeclaringFile file = { path.filename().string(), {} };
+        for (const std::string& function : find_declared_functions(contents))
+        {
+            if (seen.insert(function).second)
+            {
+                file.functions.push_back(function);
+            }
+        }
+        if (!file.functions.empty())
+        {
+            out_files.push_back(file);
+        }
+    }
+
+    for (const char *required : s_required_functions)
+    {
+        if (seen.count(required) == 0)
+        {
+            fprintf(stderr, "%s isn't declared in %s\n", required, include_dir.string().c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+static std::string format_table(const std::vector<DeclaringFile>& files)
+{
+    std::string table = s_generated_notice;
+    table += "//\n";
+    table += "// EOS_FUNCTION(name, binding), where binding is EOS_FUNCTION_REQUIRED or\n";
+    table += "// EOS_FUNCTION_LAZY. See EOSFunctions.h.\n";
+
+    for (const DeclaringFile& file : files)
+    {
+        table += "\n// " + file.file_name + "\n";
+        for (const std::string& function : file.functions)
+        {
+            table += "EOS_FUNCTION(" + function + (is_required(function) ? ", EOS_FUNCTION_REQUIRED)\n" : ", EOS_FUNCTION_LAZY)\n");
+        }
+    }
+    return table;
+}
+
+//-------------------------------------------------------------------------
+// The .inl files are included by the _types.h headers that go with them
+static std::string format_headers(const std::vector<DeclaringFile>& files)
+{
+    std::string headers = s_generated_notice;
+    headers += "\n";
+
+    for (const DeclaringFile& file : files)
+    {
+        if (fs::path(file.file_name).extension() == ".h")
+        {
+            headers += "#include \"" + file.file_name + "\"\n";
+        }
+    }
+    return headers;
+}
+
+//-------------------------------------------------------------------------
+static bool write_or_check(const fs::path& path, const std::string& contents, bool check)
+{
+    if (check)
+    {
+        std::string existing;
+        if (!read_file(path, existing) || existing != contents)
+        {
+            fprintf(stderr, "%s is out of date with the EOS SDK headers\n", path.string().c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream << contents;
+    if (!stream)
+    {
+        fprintf(stderr, "can't write %s\n", path.string().c_str());
+        return false;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc < 3 || (argc > 3 && strcmp(argv[3], "--check") != 0))
+    {
+        fprintf(stderr, "usage: %s <sdk include dir> <output dir> [--check]\n", argv[0]);
+        return 2;
+    }
+
+    const bool check = argc > 3;
+    const fs::path output_dir = argv[2];
+
+    std::vector<DeclaringFile> files;
+    if (!collect_declaring_files(argv[1], files))
+    {
+        return 1;
+    }
+
+    size_t function_count = 0;
+    for (const DeclaringFile& file : files)
+    {
+        function_count += file.functions.size();
+    }
+
+    const bool table_ok = write_or_check(output_dir / "EOSFunctionTable.inl", format_table(files), check);
+    const bool headers_ok = write_or_check(output_dir / "EOSFunctionHeaders.inl", format_headers(files), check);
+    if (!table_ok || !headers_ok)
+    {
+        return 1;
+    }
+
+    printf("%s: %zu functions in %zu files\n", check ? "up to date" : "written", function_count, files.size());
+    return 0;
+}